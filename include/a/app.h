@@ -180,13 +180,13 @@ O_EXTERN
 bool a_app_suspend_paused_set(bool suspend_during_pause);
 
 /**
- * @return the total number of allocated pool blocks
+ * @return the total number of allocated blocks of the app root allocator (slab allocator)
  */
 O_EXTERN
 int a_app_pool_blocks_num(void);
 
 /**
- * @return the number of used pool blocks
+ * @return the number of used blocks of the app root allocator (slab allocator)
  * @note if this grows each frame, you may have a memory leak
  */
 O_EXTERN
@@ -35,6 +35,9 @@ typedef struct {
     // list of parents (internal struct), if dropping to 0, the OJoin deletes itself
     oobj parents;
 
+    // SDL_atomic_t number of parents, for lock free reads, see OJoin_num_parents_atomic
+    void *parents_num;
+
     // list of weak parents (internal struct) (must be OWeak)
     // an OWeakjoin can check if the OJoin is valid, and get a temporary parent to the OJoin
     oobj weaks;
@@ -109,6 +112,15 @@ void OJoin_del(oobj obj);
 O_EXTERN
 osize OJoin_num_parents(oobj obj);
 
+/**
+ * Same as OJoin_num_parents, but does not lock the OJoin
+ * @param obj OJoin object
+ * @return current number of parents, could change immediately...
+ * @threadsafe lock free, so may be called from a real time thread, like the audio callback
+ */
+O_EXTERN
+osize OJoin_num_parents_atomic(oobj obj);
+
 /**
  * Adds a parent to the join.
  * @param obj OJoin object
@@ -14,6 +14,11 @@
  *
  * CAUTION: name duplicates can easily occur and are NOT checked!
  *
+ * Objects and arrays build an index of their children lazily on the first OJson_num, OJson_at or OJson_get.
+ * The index is rebuilt after the children changed (see OObj_children_stamp),
+ *     so the lookups are O(1) and do not allocate for a read only tree.
+ * The index is built under the object's lock, so several threads may read the same tree.
+ *
  * Operators:
  * o_num -> OJson_num
  * o_at -> OJson_at
@@ -56,6 +61,9 @@ typedef struct {
 
     // inherit from the parent, set with OJson_packed_set
     bool packed;
+
+    // lazy index of the children for objects and arrays, see OJson_get
+    struct OJson_index *index;
 } OJson;
 
 
@@ -465,6 +473,7 @@ osize OJson_num(oobj obj);
  * @param obj OJson object
  * @param idx in the OJson_list
  * @return the OJson object with that index or NULL if not in range or wrong type
+ * @note O(1) with the lazy index of the children
  */
 O_EXTERN
 struct oobj_opt OJson_at(oobj obj, osize idx);
@@ -473,12 +482,26 @@ struct oobj_opt OJson_at(oobj obj, osize idx);
  * Get a specific child of an OJson_TYPE_OBJECT
  * @param obj OJson object
  * @param name the name to search
- * @return the OJson object with that name or NULL if not found
- * @note asserts name!=NULL
+ * @return the OJson object with that name or NULL if not found.
+ *         If multiple children have that name, the last one is returned
+ * @note asserts name!=NULL.
+ *       Uses a hashed index of the children, built on the first call and after the children changed
  */
 O_EXTERN
 struct oobj_opt OJson_get(oobj obj, const char *name);
 
+/**
+ * Get a child in the tree by a path like "scenes.3.name".
+ * Each '.' separated part is the name of an object child, or the index of an array child.
+ * @param obj OJson object
+ * @param path the path to search, "" returns obj
+ * @return the OJson object of that path or NULL if not found
+ * @note asserts path!=NULL.
+ *       Uses the lazy indices of OJson_get and OJson_at, so no lists are created
+ */
+O_EXTERN
+struct oobj_opt OJson_get_path(oobj obj, const char *path);
+
 /**
  * writes the json element tree into the given stream
  * @param obj OJson object
@@ -0,0 +1,269 @@
+#ifndef O_OJSONDOC_H
+#define O_OJSONDOC_H
+
+/**
+ * @file OJsonDoc.h
+ *
+ * Object
+ *
+ * A read only json document, parsed in a single pass over a contiguous buffer.
+ * All nodes and strings live in arenas (o_allocator_arena_new) of the document,
+ *     so parsing a document needs just a few allocations, instead of an OJson object per element.
+ * Strings are unescaped in place, in a copy of the input in the arena.
+ * Children of objects and arrays are stored contiguously, so OJsonDoc_node_at is O(1).
+ *
+ * Use OJsonDoc_node_to_json to create a mutable OJson tree from a node.
+ *
+ * Operators:
+ * o_num -> OJsonDoc_node_num(OJsonDoc_root)
+ */
+
+
+#include "OObj.h"
+#include "OJson.h"
+#include "allocator.h"
+
+
+/** object id */
+#define OJsonDoc_ID OObj_ID "OJsonDoc"
+
+/** max nesting of objects and arrays, deeper documents fail to parse */
+#define OJsonDoc_DEPTH_MAX 512
+
+
+/**
+ * A read only node of the document, valid as long as the OJsonDoc lives
+ */
+struct OJsonDoc_node {
+    enum OJson_type type;
+
+    // number of children for OJson_TYPE_OBJECT and OJson_TYPE_ARRAY
+    oi32 num;
+
+    // name, if the parent is an object, else NULL
+    const char *name;
+
+    union {
+        bool boolean;
+        double number;
+        const char *string;
+        // num children
+        const struct OJsonDoc_node *children;
+    } data;
+};
+
+typedef struct {
+    OObj super;
+
+    // OArray of struct o_allocator_i arenas, the last one is used for new allocations
+    oobj arenas;
+
+    // parse stack of children of the open objects and arrays
+    struct OJsonDoc_node *stack;
+    osize stack_size;
+
+    struct OJsonDoc_node root;
+} OJsonDoc;
+
+
+/**
+ * Initializes the object, as document with a null root
+ * @param obj OJsonDoc object
+ * @param parent to inherit from
+ * @return obj casted as OJsonDoc
+ */
+O_EXTERN
+OJsonDoc *OJsonDoc_init(oobj obj, oobj parent);
+
+/**
+ * Creates a new the OJsonDoc object, as document with a null root
+ * @param parent to inherit from
+ * @return The new object
+ */
+O_INLINE
+OJsonDoc *OJsonDoc_new(oobj parent)
+{
+    OObj_DECL_IMPL_NEW(OJsonDoc, parent);
+}
+
+/**
+ * Creates a new OJsonDoc by parsing the given buffer.
+ * @param parent to inherit from
+ * @param data json ascii (utf8) text, gets copied
+ * @param len length of data in bytes, or -1 if data is null terminated
+ * @return The new object, or NULL if parsing failed
+ * @warning MAY RETURN NULL
+ */
+O_EXTERN
+struct oobj_opt OJsonDoc_new_read_buffer(oobj parent, const char *data, osize len);
+
+/**
+ * Creates a new OJsonDoc by parsing the given string.
+ * @param parent to inherit from
+ * @param string null terminated json ascii (utf8) text
+ * @return The new object, or NULL if parsing failed
+ * @warning MAY RETURN NULL
+ */
+O_INLINE
+struct oobj_opt OJsonDoc_new_read_string(oobj parent, const char *string)
+{
+    return OJsonDoc_new_read_buffer(parent, string, -1);
+}
+
+/**
+ * Creates a new OJsonDoc by reading the stream until its end and parsing it
+ * @param parent to inherit from
+ * @param stream OStream object to read the json text from
+ * @return The new object, or NULL if parsing failed
+ * @note reads the whole stream into a temporary buffer before parsing
+ * @warning MAY RETURN NULL
+ */
+O_EXTERN
+struct oobj_opt OJsonDoc_new_read_stream(oobj parent, oobj stream);
+
+/**
+ * Creates a new OJsonDoc by parsing a .json file
+ * @param parent to inherit from
+ * @param file filepath to an .json file to read in
+ * @return The new object, or NULL if parsing failed
+ * @warning MAY RETURN NULL
+ */
+O_EXTERN
+struct oobj_opt OJsonDoc_new_read_file(oobj parent, const char *file);
+
+
+//
+// virtual implementations:
+//
+
+/**
+ * Default deletor that deletes the arenas
+ * @param obj OJsonDoc object
+ */
+O_EXTERN
+void OJsonDoc__v_del(oobj obj);
+
+/**
+ * virtual operator function
+ * @param obj OJsonDoc object
+ * @return the number of children of the root node
+ */
+O_EXTERN
+osize OJsonDoc__v_op_num(oobj obj);
+
+
+//
+// object functions:
+//
+
+/**
+ * @param obj OJsonDoc object
+ * @return the root node of the document
+ */
+O_INLINE
+const struct OJsonDoc_node *OJsonDoc_root(oobj obj)
+{
+    OObj_assert(obj, OJsonDoc);
+    OJsonDoc *self = obj;
+    return &self->root;
+}
+
+/**
+ * @param obj OJsonDoc object
+ * @return the bytes allocated for the arenas of the document
+ */
+O_EXTERN
+osize OJsonDoc_arena_size(oobj obj);
+
+
+//
+// node functions:
+//
+
+/**
+ * @param node of an OJsonDoc
+ * @return number of children for objects and arrays, else 0
+ */
+O_INLINE
+osize OJsonDoc_node_num(const struct OJsonDoc_node *node)
+{
+    if(node->type != OJson_TYPE_OBJECT && node->type != OJson_TYPE_ARRAY) {
+        return 0;
+    }
+    return node->num;
+}
+
+/**
+ * @param node of an OJsonDoc
+ * @param idx index of the child
+ * @return the indexed child of an object or array, or NULL if not in range or wrong type
+ */
+O_INLINE
+const struct OJsonDoc_node *OJsonDoc_node_at(const struct OJsonDoc_node *node, osize idx)
+{
+    if(idx < 0 || idx >= OJsonDoc_node_num(node)) {
+        return NULL;
+    }
+    return &node->data.children[idx];
+}
+
+/**
+ * @param node of an OJsonDoc
+ * @param name of the child to search
+ * @return the last child of an object with that name, or NULL if not found or wrong type
+ * @note linear search
+ */
+O_EXTERN
+const struct OJsonDoc_node *OJsonDoc_node_get(const struct OJsonDoc_node *node, const char *name);
+
+/**
+ * @param node of an OJsonDoc, NULL safe
+ * @return the number, or NULL if node is NULL or not a number
+ */
+O_INLINE
+const double *OJsonDoc_node_number(const struct OJsonDoc_node *node)
+{
+    if(!node || node->type != OJson_TYPE_NUMBER) {
+        return NULL;
+    }
+    return &node->data.number;
+}
+
+/**
+ * @param node of an OJsonDoc, NULL safe
+ * @return the boolean, or NULL if node is NULL or not a boolean
+ */
+O_INLINE
+const bool *OJsonDoc_node_boolean(const struct OJsonDoc_node *node)
+{
+    if(!node || node->type != OJson_TYPE_BOOLEAN) {
+        return NULL;
+    }
+    return &node->data.boolean;
+}
+
+/**
+ * @param node of an OJsonDoc, NULL safe
+ * @return the (unescaped) string, or NULL if node is NULL or not a string
+ */
+O_INLINE
+const char *OJsonDoc_node_string(const struct OJsonDoc_node *node)
+{
+    if(!node || node->type != OJson_TYPE_STRING) {
+        return NULL;
+    }
+    return node->data.string;
+}
+
+/**
+ * Creates a mutable OJson tree of the node
+ * @param node of an OJsonDoc
+ * @param parent to inherit from (may be a json object or array)
+ * @param name if the parent is an object, NULL safe
+ * @return the new OJson tree
+ */
+O_EXTERN
+OJson *OJsonDoc_node_to_json(const struct OJsonDoc_node *node, oobj parent, const char *name);
+
+
+#endif //O_OJSONDOC_H
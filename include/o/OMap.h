@@ -7,6 +7,9 @@
  * Object
  *
  * The map object represents a hash map with generic key and value types
+ * The key value pairs are stored densely in an OArray (iterate with OMap_key_at / OMap_value_at),
+ *   an open addressing table (robin hood, linear probing) with cached hashes indexes into that array.
+ *   The table grows automatically, so approx_num is just a hint.
  * @note do not use OMap_set("NO direct string keys", "NO direct string values!");
  *       Always pass a pointer to the key and values (so a pointer to char *)
  *
@@ -47,17 +50,29 @@ typedef bool (*OMap__key_equals_fn)(const void *key_a, const void *key_b);
 typedef void *(*OMap__key_clone_fn)(oobj obj, const void *key);
 
 
+/**
+ * A slot of the internal open addressing table.
+ */
+typedef struct {
+    // cached hash of the key
+    ou32 hash;
+    // pair index + 1, 0 if empty
+    ou32 pair;
+} OMap_slot;
+
 typedef struct {
     OObj super;
 
     // fix
     osize key_size, value_size;
 
-    // OArray array of key value pairs
+    // OArray array of key value pairs (and the cached hash at the end of each pair)
     oobj pairs;
 
-    // internal hashmap, key -> pair idx
-    oobj hashmap;
+    // internal open addressing table, hash -> pair idx
+    // size is 1<<slots_bits
+    OMap_slot *slots;
+    int slots_bits;
 
     // vfuncs
     OMap__key_hash_fn v_hash;
@@ -263,7 +278,7 @@ osize OMap_set(oobj obj, const void *key, const void *value);
 
 /**
  * Will remove the key pair from the map.
- * Heavy call, must check the whole hashmap and reduce the associated indices
+ * The last key pair is moved into the removed index, so the order of pairs changes.
  * @param obj OMap object
  * @param key to remove from the map
  * @return true if found and removed
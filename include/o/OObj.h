@@ -10,6 +10,7 @@
  * So each object will get its properties like:
  *  - class name as id, built up like: "OObjFoo" for a class called Foo,
  *          or "OObjFooBar" for the class Bar, that inherits Foo
+ *          the ids are interned into an OObj_type, so type checks only compare integers
  *  - allocator, which is inherit|copied by its parent
  *  - mem(ory):
  *    - list of allocates memory on this object
@@ -19,7 +20,7 @@
  *    - list of OObj children to form the object tree hierarchy, all delete'd on delete
  *  - a parent object (exists so "o_del" can work to del an object created by *_new)
  *  - mutex to synchronize multi threaded code (also locks on resource functions)
- *      only for MIA_OPTION_THREAD
+ *      only for MIA_OPTION_THREAD, lazy created on the first o_lock
  *  - a virtual deletor function
  *  - optional instance name, may be set by the library (see for example: OJson)
  *  - userdata, which is not used by the library and really for user data, see o_user_ref
@@ -58,6 +59,27 @@
 /** Buffer size for the null terminated string */
 #define OObj_ID_BUFFER_SIZE (OObj_ID_MAX + 1)
 
+/**
+ * Number of mem entries stored directly in the object.
+ * Only if an object needs more, the list is allocated with the allocator.
+ * @note an object created by *_new already holds itself in that list
+ */
+#define OObj_MEM_INLINE 3
+
+/**
+ * Number of children entries stored directly in the object.
+ * Only if an object needs more, the list is allocated with the allocator.
+ * @note kept small, so that OObj fits into the 256 byte slab size class
+ */
+#define OObj_CHILDREN_INLINE 2
+
+/**
+ * If an object holds more mem entries than this threshold,
+ * an index (mem pointer -> list slot) is created, so that o_free, o_realloc, o_mem_move, ...
+ * do not need to search through the whole list.
+ */
+#define OObj_MEM_INDEX_THRESHOLD 32
+
 /**
  * Each object has a virtual delete function.
  * @param obj: The object to delete
@@ -97,6 +119,27 @@ typedef void *(*OObj__op_at_fn)(oobj obj, osize idx);
 #define OObj_ID "OObj"
 
 
+/**
+ * Interned object type of an id string, see OObj_type_intern and OObj_type_literal.
+ * Each prefix of the id gets a unique number, the same prefix string always the same number.
+ * So a type Bar inherits the type Foo, if Bar's prefix number at Foo's length equals Foo's number.
+ * Types live for the whole program, they are never deleted.
+ */
+struct OObj_type {
+    // interned id string, like "OObjFooBar"
+    const char *id;
+
+    // o_strlen(id)
+    oi32 len;
+
+    // unique number of the full id, same as prefix[len]
+    ou32 node;
+
+    // unique numbers of each id prefix with the prefix length as index, so len+1 entries
+    const ou32 *prefix;
+};
+
+
 /**
  * Object base class.
  */
@@ -111,6 +154,12 @@ typedef struct {
      */
     char id[OObj_ID_BUFFER_SIZE];
 
+    /**
+     * Interned type of the id, used for the type checks
+     * @sa OObj_type_intern
+     */
+    const struct OObj_type *type;
+
     /**
      * Each object may have a name that can be set with OObj_name_set.
      * It has no meaningful purpose, but objects can be found this way
@@ -138,19 +187,44 @@ typedef struct {
     oobj parent;
 
 #ifdef MIA_OPTION_THREAD
-    /** each object holds its own mutex, see o_lock, o_unlock, o_lock_block */
+    /**
+     * each object holds its own mutex, see o_lock, o_unlock, o_lock_block
+     * NULL until the first o_lock (or o_lock_try), so small objects that never lock dont need one
+     */
     void *mutex;
 #endif
 
-    /** managed memory, will all be free'd in the deletor */
+    /**
+     * managed memory, will all be free'd in the deletor
+     * points to mem_inline until more than OObj_MEM_INLINE entries are needed
+     */
     void **mem;
     osize mem_capacity;
     osize mem_num;
+
+    /**
+     * open addressing index into mem, NULL until mem_num > OObj_MEM_INDEX_THRESHOLD
+     * keeps lookups and removal in the mem list O(1) for objects that own lots of allocations
+     */
+    void *mem_index;
     
-    /** managed OObj children, will be delete'd in the deletor */
+    /**
+     * managed OObj children, will be delete'd in the deletor
+     * points to children_inline until more than OObj_CHILDREN_INLINE entries are needed
+     */
     oobj *children;
     osize children_capacity;
     osize children_num;
+
+    /**
+     * incremented each time a child is added or removed, or a child is renamed.
+     * used to invalidate lazy indices of the children, like the name index of OJson
+     */
+    ou32 children_stamp;
+
+    /** inline storage for the first entries of mem and children */
+    void *mem_inline[OObj_MEM_INLINE];
+    oobj children_inline[OObj_CHILDREN_INLINE];
     
     //
     // vfuncs
@@ -178,6 +252,81 @@ typedef struct {
 
 
 
+//
+// type functions
+//
+
+/**
+ * Interns the given id string into a type, compares the string content.
+ * @param id any id string, like "OObjFoo", may be a temporary buffer
+ * @return the interned type, equal for equal id strings
+ * @threadsafe the lookup is lock free, new types are added with a spinlock
+ */
+O_EXTERN
+const struct OObj_type *OObj_type_intern(const char *id);
+
+/**
+ * Returns the interned type of a string literal id (like the *_ID macros).
+ * The type is interned once per call site and kept in a static pointer,
+ *     so a repeated call is a single load.
+ * @param id string literal id, a non-literal does not compile, use OObj_type_intern for those
+ * @return the interned type
+ * @threadsafe the static pointer is accessed atomically, a race just interns twice
+ */
+#if defined __GNUC__
+#define OObj_type_literal(id) (__extension__ ({ \
+    static const struct OObj_type *OObj__type_site; \
+    const struct OObj_type *OObj__type = __atomic_load_n(&OObj__type_site, __ATOMIC_ACQUIRE); \
+    if (!OObj__type) { \
+        OObj__type = OObj_type_intern("" id ""); \
+        __atomic_store_n(&OObj__type_site, OObj__type, __ATOMIC_RELEASE); \
+    } \
+    OObj__type; \
+}))
+#else
+#define OObj_type_literal(id) OObj_type_intern("" id "")
+#endif
+
+/**
+ * @param type the type to check
+ * @param base the wanted (base) type
+ * @return true if type is base or inherits from it, so its id begins with the id of base
+ * @threadsafe
+ */
+O_INLINE
+bool OObj_type_is(const struct OObj_type *type, const struct OObj_type *base)
+{
+    return type == base || (base->len <= type->len && type->prefix[base->len] == base->node);
+}
+
+/**
+ * @param obj OObj object
+ * @return the interned type of the object
+ * @threadsafe
+ */
+O_INLINE
+const struct OObj_type *OObj_type(oobj obj)
+{
+    OObj *self = (OObj *) obj;
+    assert(self && self->type && "invalid obj");
+    return self->type;
+}
+
+/**
+ * @param obj The object, may be NULL
+ * @param type the wanted (base) type
+ * @return true if the object is of the given type or inherits from it
+ * @threadsafe because ids must not be changed
+ */
+O_INLINE
+bool OObj_type_check(oobj obj, const struct OObj_type *type)
+{
+    OObj *self = (OObj *) obj;
+    // the leading "OObj" of the id rejects garbage, before its type is accessed
+    return self != NULL && memcmp(self->id, OObj_ID, sizeof OObj_ID - 1) == 0
+           && OObj_type_is(self->type, type);
+}
+
 //
 // id functions
 //
@@ -185,15 +334,14 @@ typedef struct {
 /**
  * @return true if the given objects id begins with the given id
  *         So an object of type OObjFooBar would be true for id "OObjFoo", but NOT vice versa
+ * @note the id is interned with OObj_type_intern on each call, prefer OObj_check for *_ID macros
  * @threadsafe because ids must not be changed
  */
 O_INLINE
 bool OObj_id_check(oobj obj, const char *id)
 {
     assert(id && "id must not be NULL");
-    OObj *self = (OObj *) obj;
-    // uses strlen instead of o_strlen, because we are in a static header function
-    return self != NULL && strncmp(self->id, id, strlen(id)) == 0;
+    return OObj_type_check(obj, OObj_type_intern(id));
 }
 
 /**
@@ -201,9 +349,10 @@ bool OObj_id_check(oobj obj, const char *id)
  * @param type an Object type like OObjData (without "")
  * @return true if the obj type matches
  * @note concatenates _ID to the type, so OObjData would be OObjData_ID which will be "OObjData"
+ *       the id is resolved once per call site, see OObj_type_literal
  * @threadsafe because ids must not be changed
  */
-#define OObj_check(obj, type) OObj_id_check((obj), type ##_ID)
+#define OObj_check(obj, type) OObj_type_check((obj), OObj_type_literal(type ##_ID))
 
 /**
  * Logs a wtf message, containing obj info and the wanted id
@@ -227,6 +376,25 @@ bool OObj_id_check_wtf(oobj obj, const char *id, const char *func)
     return check;
 }
 
+/**
+ * Same as OObj_type_check, but logs a wtf message, if failed
+ * @param obj The object, may be NULL
+ * @param type the wanted (base) type
+ * @param id the id string of type, for the log
+ * @param func the calling function, for the log
+ * @return true if the object is of the given type or inherits from it
+ * @threadsafe because ids must not be changed
+ */
+O_INLINE
+bool OObj_type_check_wtf(oobj obj, const struct OObj_type *type, const char *id, const char *func)
+{
+    bool check = OObj_type_check(obj, type);
+    if(!check) {
+        OObj_id_mismatch_log_wtf(obj, id, func);
+    }
+    return check;
+}
+
 /**
  * Same as OObj_id_check, but logs a wtf message, if failed
  * @param obj The object
@@ -235,7 +403,8 @@ bool OObj_id_check_wtf(oobj obj, const char *id, const char *func)
  * @note concatenates _ID to the type, so OObjData would be OObjData_ID which will be "OObjData"
  * @threadsafe because ids must not be changed
  */
-#define OObj_check_wtf(obj, type) OObj_id_check_wtf((obj), type ##_ID)
+#define OObj_check_wtf(obj, type) \
+        OObj_type_check_wtf((obj), OObj_type_literal(type ##_ID), type ##_ID, __func__)
 
 /**
  * Asserts the given object id
@@ -252,19 +421,21 @@ bool OObj_id_check_wtf(oobj obj, const char *id, const char *func)
  * @note concatenates _ID to the type, so OObjData would be OObjData_ID which will be "OObjData"
  * @threadsafe because ids must not be changed
  */
-#define OObj_assert(obj, type) assert(OObj_id_check_wtf((obj), type ## _ID, __func__) && "invalid obj, expected:" #type)
+#define OObj_assert(obj, type) \
+        assert(OObj_type_check_wtf((obj), OObj_type_literal(type ## _ID), type ## _ID, __func__) \
+               && "invalid obj, expected:" #type)
 
 
 /**
  * @param obj OObj object
- * @return the objects id
+ * @return the objects id, interned, so valid for the program lifetime
  * @threadsafe
  */
 O_INLINE
 const char *OObj_id(oobj obj) {
     OObj_assert(obj, OObj);
     OObj *self = obj;
-    return self->id;
+    return self->type->id;
 }
 
 //
@@ -403,6 +574,7 @@ void *o_at(oobj obj, osize idx)
 /**
  * Locks an objects mutex (each object has its own)
  * Waits until other threads lock em
+ * The mutex is created on the first call
  * @param obj The object to synchronize
  * @threadsafe
  */
@@ -497,6 +669,19 @@ osize OObj_children_num(oobj obj)
     return self->children_num;
 }
 
+/**
+ * @param obj OObj object
+ * @return a counter that changes if a child is added, removed or renamed
+ * @note used to check if lazy caches of the children list are still valid
+ */
+O_INLINE
+ou32 OObj_children_stamp(oobj obj)
+{
+    OObj_assert(obj, OObj);
+    OObj *self = obj;
+    return self->children_stamp;
+}
+
 
 /**
  * Searches for the parent of the memory in recursion.
@@ -573,6 +758,91 @@ oobj *OObj_list_id(oobj obj, osize *opt_out_num, const char *id);
  */
 #define OObj_list(obj, opt_out_num, type) OObj_list_id((obj), (opt_out_num), type ##_ID)
 
+
+/** Maximal depth of a recursive OObj_iter, so r_level is clamped to OObj_ITER_DEPTH_MAX-1 */
+#define OObj_ITER_DEPTH_MAX 16
+
+/**
+ * Iterator over the children of an object, in contrast to OObj_list, without any allocation.
+ * Each step locks the iterated object only while it picks the next child,
+ *     so the loop body may break, add or delete children.
+ * Children removed before they were visited are skipped, added ones may be visited.
+ * The iterated object itself must not be deleted while iterating.
+ * @sa o_foreach_child, o_foreach_child_reverse, o_foreach_child_r
+ */
+struct OObj_iter {
+    // current child, valid inside the loop body
+    oobj child;
+
+    // level of the current child, 0 for direct children
+    oi32 level;
+
+    // private:
+    const struct OObj_type *type;
+    bool reverse;
+    oi32 r_level;
+    oi32 depth;
+
+    // visited child to descend into with the next step (recursive mode)
+    oobj descend;
+
+    struct {
+        oobj obj;
+        oobj last;
+        osize idx;
+        ou32 stamp;
+    } frames[OObj_ITER_DEPTH_MAX];
+};
+
+/**
+ * Creates an iterator over the children of obj, see o_foreach_child.
+ * @param obj The object to iterate over
+ * @param id only children of this type are visited (children of other types are still descended into)
+ * @param reverse if true, starts with the last child
+ * @param r_level 0 for direct children, else the recursion depth (depth first, parents before their children)
+ * @return the iterator, call OObj_iter_next to get the first child
+ */
+O_EXTERN
+struct OObj_iter OObj_iter_new(oobj obj, const char *id, bool reverse, oi32 r_level);
+
+/**
+ * Moves the iterator to the next child
+ * @param it the iterator
+ * @return true if it->child is the next child, false if done
+ * @threadsafe locks the objects for each step
+ */
+O_EXTERN
+bool OObj_iter_next(struct OObj_iter *it);
+
+/**
+ * Loops over the direct children of the given type, without allocations.
+ * @param obj The object
+ * @param type an Object type like OObjData (without "")
+ * @param it name of the struct OObj_iter, it.child is the current child
+ * @note usage: o_foreach_child(obj, OJson, it) { OJson *child = it.child; ... }
+ */
+#define o_foreach_child(obj, type, it) \
+for (struct OObj_iter it = OObj_iter_new((obj), type ## _ID, false, 0); OObj_iter_next(&it);)
+
+/**
+ * Loops over the direct children of the given type, starting with the last one, without allocations.
+ * @param obj The object
+ * @param type an Object type like OObjData (without "")
+ * @param it name of the struct OObj_iter, it.child is the current child
+ */
+#define o_foreach_child_reverse(obj, type, it) \
+for (struct OObj_iter it = OObj_iter_new((obj), type ## _ID, true, 0); OObj_iter_next(&it);)
+
+/**
+ * Loops depth first over the children of the given type, up to r_level, without allocations.
+ * @param obj The object
+ * @param type an Object type like OObjData (without "")
+ * @param r_level 0 for direct children only, 1 to include the grand children, ...
+ * @param it name of the struct OObj_iter, it.child is the current child, it.level its level
+ */
+#define o_foreach_child_r(obj, type, r_level, it) \
+for (struct OObj_iter it = OObj_iter_new((obj), type ## _ID, false, (r_level)); OObj_iter_next(&it);)
+
 /**
  * Searches for the first object with a matching name and id.
  * In recursion mode, first looks for a matching name in the object, than traverses through the objects in recursion
@@ -13,6 +13,7 @@
  */
 
 #include "OObj.h"
+#include "OObj_builder.h"
 
 /** object id */
 #define OObjRoot_ID OObj_ID "ORoot"
@@ -42,6 +43,7 @@ OObj *OObjRoot_new(struct o_allocator_i allocator)
     OObjRoot_init(&stacked_self, allocator);
     OObj *self = o_new(&stacked_self, OObj, 1);
     *self = stacked_self;
+    OObj__relocate(self, &stacked_self);
     return self;
 }
 
@@ -84,4 +86,18 @@ OObj *OObjRoot_new_pool(void)
     return OObjRoot_new_pool_ex(-1, -1, -1);
 }
 
+/**
+ * Creates a object root, (so no parent) with a slab allocator,
+ * which is faster for small allocations and scales with multiple threads
+ * Call its deletor to delete the full managed object tree
+ * @return The new allocated root OObj
+ * @note uses the slab defaults.
+ *       when deleting this root object, the allocator is >NOT< deleted, see "o_allocator_slab_del".
+ */
+O_INLINE
+OObj *OObjRoot_new_slab(void)
+{
+    return OObjRoot_new(o_allocator_slab_new(-1));
+}
+
 #endif //O_OOBJ_ROOT_H
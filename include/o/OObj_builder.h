@@ -13,19 +13,29 @@
 #include "OObj.h"
 
 /**
- * Set the id of an object, should only be done in *_init constructors!
+ * Set the id and type of an object, see OObj_id_set
  * @param obj The object to set the id on
  * @param id The new id for the object
+ * @param type the interned type of id
  */
 O_INLINE
-void OObj_id_set(oobj obj, const char *id)
+void OObj_id_type_set(oobj obj, const char *id, const struct OObj_type *type)
 {
     assert(id && strlen(id) <= OObj_ID_MAX && "type id NULL or too long ");
+    assert(type && strcmp(type->id, id) == 0 && "type does not match the id");
     OObj *self = (OObj *) obj;
     strcpy(self->id, id);
+    self->type = type;
     OObj_assert(self, OObj);
 }
 
+/**
+ * Set the id of an object, should only be done in *_init constructors!
+ * @param obj The object to set the id on
+ * @param id The new id for the object, a string literal like the *_ID macros, see OObj_type_literal
+ */
+#define OObj_id_set(obj, id) OObj_id_type_set((obj), (id), OObj_type_literal(id))
+
 /**
  * Default virtual destructor for the vfunc v_del.
  * When overwriting the v_del deletor, direct childs must call this function at the end of their v_del function.
@@ -36,5 +46,14 @@ void OObj_id_set(oobj obj, const char *id)
 O_EXTERN
 void OObj__v_del(oobj obj);
 
+/**
+ * Must be called if the base OObj struct was copied into another memory location (like OObjRoot_new does).
+ * Rebases the internal lists, which may point to the inline storage of the old location.
+ * @param obj The object which holds the copied data
+ * @param from The old location of the object, not accessed, just for the pointer arithmetic
+ */
+O_EXTERN
+void OObj__relocate(oobj obj, const void *from);
+
 
 #endif //O_OOBJ_BUILDER_H
@@ -9,6 +9,14 @@
  * For matching a pattern on a string or an data array.
  * With lua-like pattern matching, see: Lua Patterns: https://www.lua.org/pil/20.2.html
  *
+ * The pattern is compiled into a list of groups, which are matched with backtracking.
+ * Additionally the groups are lowered into a DFA with a first byte set of the match.
+ * The DFA is compiled lazily on the second find, so one shot patterns (o_str_pattern_*) skip its cost.
+ * Finding a match with the DFA skips non candidate positions (memchr for a single first byte)
+ *     and needs no backtracking.
+ * Captures are reconstructed with the backtracking matcher at the found match start.
+ * If the DFA would get too large, only the backtracking matcher is used.
+ *
  * @sa str.h o_str_pattern_* if you just want a single run
  */
 
@@ -71,6 +79,20 @@ typedef struct {
     struct o_str_range *captures;
     osize captures_size;
 
+    // compiled matcher, NULL if not compiled yet or the pattern could not be lowered, see OPattern_dfa_available
+    // published atomically, so finds with a compiled DFA do not lock
+    struct OPattern_dfa *dfa;
+
+    // number of finds, the DFA is compiled on the second one
+    osize finds;
+    bool dfa_compiled;
+
+    // SDL_SpinLock for finds and dfa_compiled, so finds do not take the object lock
+    int dfa_lock;
+
+    // true by default, if false, always uses the backtracking matcher
+    bool dfa_enabled;
+
 } OPattern;
 
 
@@ -113,6 +135,19 @@ osize OPattern_captures(oobj obj)
     return self->captures_size;
 }
 
+/**
+ * @param obj OPattern object
+ * @return true if the pattern can be compiled into a DFA, compiles it if not done yet
+ */
+O_EXTERN
+bool OPattern_dfa_available(oobj obj);
+
+/**
+ * @param obj OPattern object
+ * @return true (default) if the DFA is used if available, false to always use the backtracking matcher
+ */
+OObj_DECL_GETSET(OPattern, bool, dfa_enabled)
+
 /**
  * Finds the next valid pattern on the given data.
  * @param obj OPattern object
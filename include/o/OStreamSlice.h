@@ -0,0 +1,84 @@
+#ifndef O_OSTREAMSLICE_H
+#define O_OSTREAMSLICE_H
+
+/**
+ * @file OStreamSlice.h
+ *
+ * Object
+ *
+ * OStream implementation which reads a region (offset, size) of another seekable stream, without copying it.
+ * Each read locks the base stream and seeks to the slices position,
+ *     so multiple slices can share the same base stream (also in different threads).
+ * The slice is read only.
+ *
+ * @note the base stream must outlive the slice
+ */
+
+#include "OStream.h"
+
+/** object id */
+#define OStreamSlice_ID OStream_ID "Slice"
+
+
+typedef struct {
+    OStream super;
+
+    oobj base;
+    osize offset;
+    osize size;
+
+    // in bytes, relative to offset
+    osize pos;
+} OStreamSlice;
+
+
+/**
+ * Initializes the object
+ * @param obj OStreamSlice object
+ * @param parent to inherit from
+ * @param base the seekable OStream to read from
+ * @param offset in bytes in the base stream
+ * @param size of the slice in bytes
+ * @return obj casted as OStreamSlice
+ */
+O_EXTERN
+OStreamSlice *OStreamSlice_init(oobj obj, oobj parent, oobj base, osize offset, osize size);
+
+
+/**
+ * Creates a new OStreamSlice object
+ * @param parent to inherit from
+ * @param base the seekable OStream to read from
+ * @param offset in bytes in the base stream
+ * @param size of the slice in bytes
+ * @return The new object
+ */
+O_INLINE
+OStreamSlice *OStreamSlice_new(oobj parent, oobj base, osize offset, osize size)
+{
+    OObj_DECL_IMPL_NEW(OStreamSlice, parent, base, offset, size);
+}
+
+//
+// virtual implementations:
+//
+
+O_EXTERN
+bool OStreamSlice__v_valid(oobj obj);
+
+O_EXTERN
+osize OStreamSlice__v_size(oobj obj);
+
+O_EXTERN
+osize OStreamSlice__v_seek(oobj obj, osize offset, enum OStream_seek_whence whence);
+
+O_EXTERN
+osize OStreamSlice__v_read_try(oobj obj, void *data, osize element_size, osize num);
+
+O_EXTERN
+osize OStreamSlice__v_write(oobj obj, const void *data, osize element_size, osize num);
+
+O_EXTERN
+bool OStreamSlice__v_close(oobj obj);
+
+#endif //O_OSTREAMSLICE_H
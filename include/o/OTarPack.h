@@ -0,0 +1,266 @@
+#ifndef O_OTARPACK_H
+#define O_OTARPACK_H
+
+/**
+ * @file OTarPack.h
+ *
+ * Object
+ *
+ * An indexed .tar archive, for example an asset pack.
+ * In contrast to o_tar_read_stream, only the headers are scanned once into a hashed name index,
+ *     the members are read lazily.
+ *
+ * Members can be opened as zero-copy OStream slices, read into caller buffers (also in parallel),
+ *     or accessed as memory view, if the archive is memory mapped (OTarPack_new_file on unix).
+ *
+ * A pack can be mounted, so that o_file_open and o_file_read (and with that OJson_new_read_file,
+ *     s_ogg_load_*, o_img_new_file, RTex_new_file, UImg_new_file, ...) resolve paths through the pack first.
+ *
+ * Member names are stored without a leading "./", directories are skipped.
+ *
+ * Operators:
+ * o_num -> OTarPack_num
+ */
+
+
+#include "OObj.h"
+
+/** object id */
+#define OTarPack_ID OObj_ID "OTarPack"
+
+/** maximal number of mounted packs */
+#define OTarPack_MOUNT_MAX 16
+
+
+// mapping and base stream, shared with open mounted streams
+struct OTarPack_backing;
+
+/**
+ * Position of a member in the archive
+ */
+struct OTarPack_entry {
+    // byte offset of the data in the archive
+    osize offset;
+    // byte size of the data
+    osize size;
+};
+
+/**
+ * A job for OTarPack_read_parallel
+ */
+struct OTarPack_read_job {
+    // member name
+    const char *name;
+
+    // buffer to read the member data into, of size out_size
+    void *out_data;
+    osize out_size;
+
+    // set to the number of bytes read, or -1 if the member was not found
+    osize out_read;
+};
+
+typedef struct {
+    OObj super;
+
+    // base stream of the archive, or NULL if memory mapped, owned by the backing
+    oobj stream;
+
+    // archive file, if created with OTarPack_new_file, used for parallel reads with own streams
+    char *file;
+
+    // memory mapped archive, or NULL, owned by the backing
+    const obyte *map;
+    osize map_size;
+
+    // reference counted, so mounted streams may outlive the pack
+    struct OTarPack_backing *backing;
+
+    // OMap of member name -> struct OTarPack_entry
+    oobj index;
+
+    // prefix if mounted, else NULL
+    char *mount_prefix;
+} OTarPack;
+
+
+/**
+ * Initializes the object and scans the headers of the archive
+ * @param obj OTarPack object
+ * @param parent to inherit from
+ * @param stream seekable OStream of the .tar archive, moved into the pack
+ * @return obj casted as OTarPack
+ * @note if the stream is not a valid archive, the pack may be empty or partial (logs a warning)
+ */
+O_EXTERN
+OTarPack *OTarPack_init(oobj obj, oobj parent, oobj stream);
+
+/**
+ * Creates a new OTarPack object and scans the headers of the archive
+ * @param parent to inherit from
+ * @param stream seekable OStream of the .tar archive, moved into the pack
+ * @return The new object
+ * @note if the stream is not a valid archive, the pack may be empty or partial (logs a warning)
+ */
+O_INLINE
+OTarPack *OTarPack_new(oobj parent, oobj stream)
+{
+    OObj_DECL_IMPL_NEW(OTarPack, parent, stream);
+}
+
+/**
+ * Creates a new OTarPack object for a .tar file.
+ * On unix, the file is memory mapped, so members can be accessed with OTarPack_view.
+ * Otherwise the file is opened as stream.
+ * @param parent to inherit from
+ * @param file the .tar archive
+ * @return The new object, or NULL if the file could not be opened
+ * @warning MAY RETURN NULL
+ */
+O_EXTERN
+struct oobj_opt OTarPack_new_file(oobj parent, const char *file);
+
+
+//
+// virtual implementations:
+//
+
+/**
+ * Default deletor that also unmounts the pack.
+ * The mapping and base stream are freed with the last open mounted stream.
+ * @param obj OTarPack object
+ */
+O_EXTERN
+void OTarPack__v_del(oobj obj);
+
+/**
+ * virtual operator function
+ * @param obj OTarPack object
+ * @return number of members
+ */
+O_EXTERN
+osize OTarPack__v_op_num(oobj obj);
+
+
+//
+// object functions:
+//
+
+/**
+ * @param obj OTarPack object
+ * @return number of members
+ */
+O_EXTERN
+osize OTarPack_num(oobj obj);
+
+/**
+ * @param obj OTarPack object
+ * @param idx member index
+ * @return the name of the member at idx
+ * @note asserts idx bounds
+ */
+O_EXTERN
+const char *OTarPack_name_at(oobj obj, osize idx);
+
+/**
+ * @param obj OTarPack object
+ * @param name member name
+ * @param out_opt_entry if not NULL, set to the position of the member
+ * @return true if the member was found
+ */
+O_EXTERN
+bool OTarPack_find(oobj obj, const char *name, struct OTarPack_entry *out_opt_entry);
+
+/**
+ * @param obj OTarPack object
+ * @param name member name
+ * @param out_opt_size if not NULL, set to the byte size of the member
+ * @return a pointer to the member data, if the archive is memory mapped and the member was found, else NULL
+ * @note valid as long as the pack lives
+ */
+O_EXTERN
+const void *OTarPack_view(oobj obj, const char *name, osize *out_opt_size);
+
+/**
+ * Opens a member as read only stream, without copying the data.
+ * @param obj OTarPack object
+ * @param parent to inherit the stream from
+ * @param name member name
+ * @return an OStreamMem on the mapped memory or an OStreamSlice of the archive stream, or NULL if not found
+ * @note the pack must outlive the stream
+ * @warning MAY RETURN NULL
+ */
+O_EXTERN
+struct oobj_opt OTarPack_stream(oobj obj, oobj parent, const char *name);
+
+/**
+ * Reads a member into the given buffer
+ * @param obj OTarPack object
+ * @param name member name
+ * @param out_data buffer to read into
+ * @param out_size size of the buffer, reads up to out_size bytes
+ * @return the number of bytes read, or -1 if not found
+ * @threadsafe
+ */
+O_EXTERN
+osize OTarPack_read(oobj obj, const char *name, void *out_data, osize out_size);
+
+/**
+ * Reads multiple members in parallel into caller provided buffers, see o_parallel_for.
+ * Memory mapped archives are copied in parallel, archives from a file open a stream for each worker.
+ * @param obj OTarPack object
+ * @param jobs list of jobs, each out_read is set
+ * @param jobs_num number of jobs
+ * @return the number of jobs which were found and fully read (out_read == member size or out_size)
+ */
+O_EXTERN
+osize OTarPack_read_parallel(oobj obj, struct OTarPack_read_job *jobs, osize jobs_num);
+
+
+//
+// mount functions:
+//
+
+/**
+ * Mounts the pack, so that o_file_open and o_file_read resolve paths through it.
+ * Later mounted packs are searched first.
+ * @param obj OTarPack object
+ * @param opt_prefix path prefix for the members, like "res/", NULL for no prefix
+ * @return false if already mounted or OTarPack_MOUNT_MAX packs are mounted
+ * @note automatically unmounted in the deletor, open mounted streams stay valid
+ */
+O_EXTERN
+bool OTarPack_mount(oobj obj, const char *opt_prefix);
+
+/**
+ * Unmounts the pack, safe to call if not mounted
+ * @param obj OTarPack object
+ */
+O_EXTERN
+void OTarPack_unmount(oobj obj);
+
+/**
+ * Searches the mounted packs for the given file path
+ * @param file path to search, like "res/tex/hero.png"
+ * @param out_opt_name if not NULL and found, set to the member name (points into file, without the prefix)
+ * @return the mounted pack which contains the file, or NULL
+ * @note the pack is not acquired, other threads should use OTarPack_mounted_stream instead
+ * @warning MAY RETURN NULL
+ */
+O_EXTERN
+struct oobj_opt OTarPack_mounted(const char *file, const char **out_opt_name);
+
+/**
+ * Opens a file of the mounted packs as stream, see OTarPack_stream
+ * @param parent to inherit the stream from
+ * @param file path to search, like "res/tex/hero.png"
+ * @return the stream, or NULL if not found in any mounted pack.
+ *         The stream keeps the mapping or base stream of the pack alive, so it may outlive the pack
+ * @threadsafe
+ * @warning MAY RETURN NULL
+ */
+O_EXTERN
+struct oobj_opt OTarPack_mounted_stream(oobj parent, const char *file);
+
+
+#endif //O_OTARPACK_H
@@ -8,6 +8,11 @@
  * Object
  *
  * The ThreadPool obj creates multiple threads to fast'n up OFuture calls
+ * Work stealing scheduler:
+ *   Each thread owns a deque of futures (Chase-Lev).
+ *   Futures run from inside of a pool thread are pushed to its own deque (LIFO for the owner),
+ *   futures run from other threads are pushed to a shared queue.
+ *   Idle threads take from the shared queue and steal from the top of random other deques.
  * @sa OFuture.h
  */
 
@@ -16,6 +21,9 @@
 /** object id */
 #define OThreadpool_ID OObj_ID "OThreadpool"
 
+// scheduler state with the deques and atomic counters, defined in OThreadpool.c
+struct OThreadpool_sched;
+
 typedef struct {
     OObj super;
 
@@ -23,12 +31,11 @@ typedef struct {
     oobj *threads;
     osize threads_size;
 
-    // actively running
-    oobj *running_futures;
-    osize running_futures_size;
+    // futures pushed from outside of the pool, OArray of OFuture, locked by the pool
+    oobj shared_queue;
 
-    // an OQueue of Futures to start
-    oobj task_queue;
+    // per thread work stealing deques and counters
+    struct OThreadpool_sched *sched;
 } OThreadpool;
 
 
@@ -107,6 +114,13 @@ osize OThreadpool_available_threads(oobj obj)
 O_EXTERN
 osize OThreadpool_queuing(oobj obj);
 
+/**
+ * @param obj OThreadpool object
+ * @return true if the calling thread is one of the threads of this pool
+ */
+O_EXTERN
+bool OThreadpool_in_pool(oobj obj);
+
 
 #endif //O_OTHREADPOOL_H
 #endif //MIA_OPTION_THREAD
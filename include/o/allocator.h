@@ -36,6 +36,16 @@ struct o_allocator_i;
 typedef void *(*o_allocator_i__realloc_try_fn)(struct o_allocator_i iface, void *restrict mem, osize element_size,
                                              osize num);
 
+/**
+ * Counts the calls of o_allocator_i_realloc_try (alloc, realloc and free) of the calling thread.
+ * Useful to verify that a code path (like the audio callback) does not allocate.
+ * Only counted with MIA_OPTION_ALLOCATOR_COUNT (set by the cmake USE_ALLOCATOR_COUNT or USE_TESTS),
+ *      so the allocation hot path stays free of the thread local counter in other builds.
+ * @return number of calls on this thread, since the thread started, always 0 without MIA_OPTION_ALLOCATOR_COUNT
+ */
+O_EXTERN
+osize o_allocator_thread_calls(void);
+
 /**
  * Allocator interface.
  * Consisting only of an implementation pointer and the virtual realloc function.
@@ -61,6 +71,12 @@ struct o_allocator_i {
 O_INLINE
 void *o_allocator_i_realloc_try(struct o_allocator_i iface, void *mem, osize element_size, osize num)
 {
+#ifdef MIA_OPTION_ALLOCATOR_COUNT
+    // protected, see o_allocator_thread_calls
+    O_EXTERN
+    void o_allocator__thread_calls_inc(void);
+    o_allocator__thread_calls_inc();
+#endif
     return iface.realloc_try(iface, mem, element_size, num);
 }
 
@@ -165,6 +181,89 @@ bool o_allocator_pool_pointer_pooled(struct o_allocator_i self, const void *mem)
 
 
 
+//
+// Slab
+//
+
+/**
+ * Creates an allocator, that allocates small blocks from slabs in multiple power of two size classes.
+ * (16, 32, 64, ... up to max_block_size), bigger allocations fall back to the heap.
+ * Each thread holds a cache of free blocks per size class,
+ *      only if a cache runs empty or full, a batch of blocks is exchanged with the shared (locked) state.
+ * Slabs are 64 KiB aligned with a header in front, so the owner of a pointer is found in O(1).
+ * Can be used in place of the pool allocator, also with multiple threads (like OThreadpool workers).
+ * @param max_block_size maximal size for an allocation to make use of a slab (<=0 for default 1024),
+ *                       rounded up to a power of two, max 8192
+ * @return the allocator interface.
+ * @sa OObjRoot_new_slab
+ */
+O_EXTERN
+struct o_allocator_i o_allocator_slab_new(int max_block_size);
+
+/**
+ * Deletes the allocator and its allocated slabs, but NOT the heap allocated pointers!
+ * @param self a reference to the slab interface, which will he cleared
+ * @note >NOT< thread safe, other threads must not use the allocator anymore
+ */
+O_EXTERN
+void o_allocator_slab_del(struct o_allocator_i *self);
+
+/**
+ * @param self a reference to the slab interface
+ * @return maximal byte size of a block (maximal byte size to be slabbed)
+           or 0 if not a slab allocator
+ */
+O_EXTERN
+int o_allocator_slab_block_size_max(struct o_allocator_i self);
+
+/**
+ * @param self a reference to the slab interface
+ * @return number of allocated slabs (each 64 KiB)
+           or 0 if not a slab allocator
+ */
+O_EXTERN
+int o_allocator_slab_slabs_num(struct o_allocator_i self);
+
+/**
+ * @param self a reference to the slab interface
+ * @return number of total blocks in all slabs (of all size classes)
+           or 0 if not a slab allocator
+ */
+O_EXTERN
+int o_allocator_slab_blocks_num(struct o_allocator_i self);
+
+/**
+ * @param self a reference to the slab interface
+ * @return number of available blocks, including the ones in the thread caches
+           or 0 if not a slab allocator
+ * @note approximated, if other threads are allocating at the same time
+ */
+O_EXTERN
+int o_allocator_slab_blocks_available(struct o_allocator_i self);
+
+/**
+ * @param self a reference to the slab interface
+ * @return number of used blocks
+           or 0 if not a slab allocator
+ * @note approximated, if other threads are allocating at the same time
+ */
+O_INLINE
+int o_allocator_slab_blocks_used(struct o_allocator_i self)
+{
+    return o_allocator_slab_blocks_num(self)
+             - o_allocator_slab_blocks_available(self);
+}
+
+/**
+ * @param self a reference to the slab interface
+ * @param mem a pointer which was allocated with this allocator
+ * @return true if the given pointer was allocated in a slab (false if allocator is not a slab)
+ * @note O(1), safe to call with any pointer
+ */
+O_EXTERN
+bool o_allocator_slab_pointer_slabbed(struct o_allocator_i self, const void *mem);
+
+
 //
 // Arena
 //
@@ -91,6 +91,9 @@ typedef void (*o_file_event_fn)(void *user_data, const char *file, const char *o
  * This function supports Unicode filenames, but they must be encoded in UTF-8
  * format, regardless of the underlying operating system.
  *
+ * Read only modes ("r", "rb", ...) resolve the file through the mounted OTarPack's first,
+ *     returning a stream of the packed member.
+ *
  * @param parent OStream will be a resource of parent.
  * @param file a UTF-8 string representing the filename to open.
  * @param mode an ASCII string representing the mode to be used for opening.
@@ -29,6 +29,7 @@
 #include "file.h"
 #include "img.h"
 #include "log.h"
+#include "parallel.h"
 #include "str.h"
 #include "tar.h"
 #include "terminalcolor.h"
@@ -43,6 +44,7 @@
 #include "ODelcallback.h"
 #include "OJoin.h"
 #include "OJson.h"
+#include "OJsonDoc.h"
 #include "OMap.h"
 #include "OPattern.h"
 #include "OPtr.h"
@@ -50,6 +52,8 @@
 #include "OStreamArray.h"
 #include "OStreamBuffered.h"
 #include "OStreamMem.h"
+#include "OStreamSlice.h"
+#include "OTarPack.h"
 #include "OTask.h"
 #include "OWeakjoin.h"
 
@@ -0,0 +1,105 @@
+#ifndef O_PARALLEL_H
+#define O_PARALLEL_H
+
+/**
+ * @file parallel.h
+ *
+ * Data parallel helpers, that split an index range into chunks of grain size and run them on an OThreadpool.
+ * The calling thread works on chunks, too.
+ * Without MIA_OPTION_THREAD, or on a single core, the functions simply call fn inline for the full range.
+ *
+ * @note called from a thread of the pool itself, the range is processed inline to avoid waiting on the own pool.
+ *       fn must be thread safe, so no allocations on a shared object without locking, etc.
+ */
+
+#include "common.h"
+
+
+/**
+ * Function to process the index range [begin, end)
+ * @param begin first index of the chunk
+ * @param end one after the last index of the chunk
+ * @param user passed user data
+ */
+typedef void (*o_parallel_fn)(osize begin, osize end, void *user);
+
+/**
+ * Function to process the index range [begin, end) into a partial result
+ * @param begin first index of the chunk
+ * @param end one after the last index of the chunk
+ * @param inout_partial partial result of the current thread, starts as a copy of the initial result
+ * @param user passed user data
+ */
+typedef void (*o_parallel_reduce_fn)(osize begin, osize end, void *inout_partial, void *user);
+
+/**
+ * Function to join a partial result into the result
+ * @param inout_result the result to join into
+ * @param partial a partial result of a thread
+ * @param user passed user data
+ */
+typedef void (*o_parallel_join_fn)(void *inout_result, const void *partial, void *user);
+
+/**
+ * Function to process a tile of a 2d range
+ * @param col_begin, col_end columns [begin, end) of the tile
+ * @param row_begin, row_end rows [begin, end) of the tile
+ * @param user passed user data
+ */
+typedef void (*o_parallel_tile_fn)(int col_begin, int col_end, int row_begin, int row_end, void *user);
+
+
+/**
+ * @return the default OThreadpool for the o_parallel_* functions (created on first call), or NULL
+ * @note returns NULL on a single core or without MIA_OPTION_THREAD.
+ *       The pool has one thread less than the number of cores, because the calling thread works, too.
+ */
+O_EXTERN
+oobj o_parallel_pool(void);
+
+/**
+ * Runs fn for the index range [0, num) split into chunks of grain size.
+ * Returns after all chunks are processed.
+ * @param opt_pool OThreadpool to run in or NULL to use o_parallel_pool
+ * @param num size of the index range
+ * @param grain minimal size of a chunk, <=0 to choose one
+ * @param fn function to process a chunk
+ * @param user passed to fn
+ */
+O_EXTERN
+void o_parallel_for(oobj opt_pool, osize num, osize grain, o_parallel_fn fn, void *user);
+
+
+/**
+ * Runs fn for the index range [0, num) split into chunks of grain size, each thread into its own partial result.
+ * The partial results are joined into inout_result afterwards, with the calling thread.
+ * Returns after all chunks are processed.
+ * @param opt_pool OThreadpool to run in or NULL to use o_parallel_pool
+ * @param num size of the index range
+ * @param grain minimal size of a chunk, <=0 to choose one
+ * @param inout_result initial (neutral) value, each partial result starts as a copy of it. Joined result.
+ * @param result_size size of the result in bytes
+ * @param fn function to process a chunk into a partial result
+ * @param join function to join a partial result into inout_result
+ * @param user passed to fn and join
+ */
+O_EXTERN
+void o_parallel_reduce(oobj opt_pool, osize num, osize grain, void *inout_result, osize result_size,
+                       o_parallel_reduce_fn fn, o_parallel_join_fn join, void *user);
+
+
+/**
+ * Runs fn for the 2d range cols x rows split into tiles.
+ * Returns after all tiles are processed.
+ * @param opt_pool OThreadpool to run in or NULL to use o_parallel_pool
+ * @param cols, rows size of the 2d range
+ * @param tile_cols size of a tile, <=0 for full rows
+ * @param tile_rows size of a tile, <=0 to choose one
+ * @param fn function to process a tile
+ * @param user passed to fn
+ */
+O_EXTERN
+void o_parallel_for_2d(oobj opt_pool, int cols, int rows, int tile_cols, int tile_rows,
+                       o_parallel_tile_fn fn, void *user);
+
+#endif //O_PARALLEL_H
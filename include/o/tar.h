@@ -8,6 +8,9 @@
  * A .tar is just a collection of uncompressed files "tape archive".
  *
  * Makes use of microtar: "https://github.com/rxi/microtar"
+ *
+ * To load single members of a large archive (asset packs), see OTarPack,
+ *     which indexes the headers once and reads the members lazily.
  */
 
 #include "common.h"
@@ -6,7 +6,15 @@
  *
  * Object
  *
- * A gl vertex buffer object with an associated vertex array object
+ * A gl vertex buffer object with an associated vertex array object.
+ *
+ * The gl buffer storage grows geometrically and is tracked as capacity, separated from num.
+ * Full updates orphan the storage (glBufferData with NULL), so the driver can hand out new memory
+ *      instead of waiting for draw calls still reading the old data.
+ * Range updates only send the changed elements with glBufferSubData.
+ * struct RBuffer_dirty collects a few changed spans for RBuffer_update_dirty,
+ *      which falls back to a single orphaning full upload if most elements changed.
+ * Uploaded bytes are counted in r_stats_frame()->buffer_uploaded_bytes.
  */
 
 #include "o/OObj.h"
@@ -21,12 +29,38 @@ typedef struct {
     osize element_size;
     osize num;
 
+    // allocated elements of the gl buffer storage
+    osize capacity;
+
     ou32 gl_vao;
     ou32 gl_vbo;
 
 } RBuffer;
 
 
+/** maximal number of separate dirty spans, further spans merge the closest ones */
+#define RBuffer_DIRTY_SPANS_MAX 4
+
+/** half open element range [begin, end) */
+struct RBuffer_span {
+    osize begin, end;
+};
+
+/**
+ * Changed elements of an owner array, see RBuffer_dirty_mark and RBuffer_update_dirty.
+ * Zero initialized, tracking is disabled and each update uploads all elements.
+ */
+struct RBuffer_dirty {
+    // enabled by the first RBuffer_dirty_mark
+    bool tracking;
+    // forces a full upload in the next update
+    bool all;
+    // sorted spans with gaps in between
+    struct RBuffer_span spans[RBuffer_DIRTY_SPANS_MAX];
+    int spans_num;
+};
+
+
 /**
  * Initializes the object
  * @param obj RBuffer object
@@ -78,6 +112,12 @@ OObj_DECL_GET(RBuffer, osize, element_size)
  */
 OObj_DECL_GET(RBuffer, int, num)
 
+/**
+ * @param obj RBuffer object
+ * @return number of elements the gl buffer storage can hold without reallocation
+ */
+OObj_DECL_GET(RBuffer, osize, capacity)
+
 
 /**
  * @param obj RBuffer object
@@ -104,7 +144,8 @@ ou32 RBuffer_vbo(oobj obj)
 }
 
 /**
- * Binds this vertex array and buffer object
+ * Uploads all elements into the buffer.
+ * Orphans the old storage and grows the capacity if needed.
  * @param obj RBuffer object
  * @param data to be updated into the buffer
  * @param num of elements in data with RBuffer_element_size
@@ -112,6 +153,41 @@ ou32 RBuffer_vbo(oobj obj)
 O_EXTERN
 void RBuffer_update(oobj obj, const void *data, osize num);
 
+/**
+ * Uploads only the elements [begin, begin+n) into the buffer with glBufferSubData.
+ * Falls back to RBuffer_update, if num exceeds the current capacity.
+ * @param obj RBuffer object
+ * @param data all elements, as in RBuffer_update (not offset by begin)
+ * @param num of elements in data with RBuffer_element_size
+ * @param begin first changed element
+ * @param n number of changed elements, clamped to num
+ */
+O_EXTERN
+void RBuffer_update_range(oobj obj, const void *data, osize num, osize begin, osize n);
+
+/**
+ * Marks elements as changed, so that the next RBuffer_update_dirty only uploads the marked spans.
+ * Enables dirty tracking: from now on, unmarked changes are NOT uploaded, except a changed num or dirty->all.
+ * Touching spans are merged. Above RBuffer_DIRTY_SPANS_MAX, the two spans with the smallest gap are merged.
+ * @param dirty the spans to mark in
+ * @param idx first changed element
+ * @param n number of changed elements
+ */
+O_EXTERN
+void RBuffer_dirty_mark(struct RBuffer_dirty *dirty, osize idx, osize n);
+
+/**
+ * Uploads the dirty elements and resets the spans.
+ * A full upload (RBuffer_update) is used if tracking is disabled, dirty->all is set, num changed
+ *      or more than half of the elements are dirty, else each span is sent with RBuffer_update_range.
+ * @param obj RBuffer object
+ * @param dirty the marked spans, reset afterwards
+ * @param data all elements, as in RBuffer_update
+ * @param num of elements in data with RBuffer_element_size
+ */
+O_EXTERN
+void RBuffer_update_dirty(oobj obj, struct RBuffer_dirty *dirty, const void *data, osize num);
+
 /**
  * Binds this vertex array and buffer object
  * @param obj RBuffer object, NULL safe -> calls bind with 0
@@ -123,6 +199,18 @@ void RBuffer_use(oobj obj);
 // location setter
 //
 
+/**
+ * Generic attribute setup, for packed element layouts
+ * @param obj RBuffer object
+ * @param location in the vertex shader in variable
+ * @param size number of components [1:4]
+ * @param gl_type component type, like GL_FLOAT, GL_HALF_FLOAT or GL_UNSIGNED_BYTE
+ * @param normalized if true, integer types are mapped into [0:1] (or [-1:1] for signed types)
+ * @param offset of the attribute in the element (offsetof)
+ */
+O_EXTERN
+void RBuffer_location(oobj obj, int location, int size, ou32 gl_type, bool normalized, osize offset);
+
 /**
  * @param obj RBuffer object
  * @param location in the vertex shader in variable
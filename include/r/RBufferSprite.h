@@ -0,0 +1,46 @@
+#ifndef R_RBUFFERSPRITE_H
+#define R_RBUFFERSPRITE_H
+
+/**
+ * @file RBufferSprite.h
+ *
+ * Object
+ *
+ * An RBuffer initialized for struct r_sprite.
+ * Packed attributes: floats for the positions, half floats for sizes and the angle, normalized bytes for the color
+ */
+
+#include "RBuffer.h"
+
+
+/** object id */
+#define RBufferSprite_ID RBuffer_ID "Sprite"
+
+typedef struct {
+    RBuffer super;
+
+} RBufferSprite;
+
+
+/**
+ * Initializes the object
+ * @param obj RBuffer object
+ * @param parent to inherit from
+ * @return obj casted as RBuffer
+ */
+O_EXTERN
+RBufferSprite *RBufferSprite_init(oobj obj, oobj parent);
+
+/**
+ * Creates a new the RBuffer object
+ * @param parent to inherit from
+ * @return The new object
+ */
+O_INLINE
+RBufferSprite *RBufferSprite_new(oobj parent)
+{
+    OObj_DECL_IMPL_NEW(RBufferSprite, parent);
+}
+
+
+#endif //R_RBUFFERSPRITE_H
@@ -7,8 +7,16 @@
  * Object
  *
  * Renders all (direct) child RObj's 
+ *
+ * Optional batching mode (RObjGroup_batch_set):
+ * Consecutive RObjQuad children (and RObjText's with a translation only pose),
+ *      which use a single plain RShaderQuad with the same program, tex, blend and stuv uniforms,
+ *      are merged into a shared streaming buffer and rendered with a single draw call.
+ * Only neighbours are merged, so the draw order stays the same.
+ * Merged RObjQuad's are not updated by the group, their quads are copied each render.
  */
  
+#include "o/OArray.h"
 #include "RObj.h"
 #include "RTex.h"
 #include "quad.h"
@@ -18,6 +26,19 @@
 
 typedef struct {
     RObj super;
+
+    // see RObjGroup_batch_set
+    bool batch;
+
+    // RBufferQuad, shared streaming buffer for all batches
+    oobj batch_buffer;
+
+    // OArray of struct r_quad, collects the quads of the pending batch
+    OArray *batch_quads;
+
+    // RShaderQuad and RTex of the pending batch, or NULL
+    oobj batch_shader;
+    oobj batch_tex;
 } RObjGroup;
 
 
@@ -72,4 +93,18 @@ RObj **RObjGroup_list(oobj obj, osize *opt_out_size) {
     return (RObj **) OObj_list(obj, opt_out_size, RObj);
 }
 
+/**
+ * @param obj RObjGroup object
+ * @return true if batching is enabled
+ */
+OObj_DECL_GET(RObjGroup, bool, batch)
+
+/**
+ * Enables or disables the batching mode, see the file description
+ * @param obj RObjGroup object
+ * @param batch true to enable batching
+ */
+O_EXTERN
+void RObjGroup_batch_set(oobj obj, bool batch);
+
 #endif //R_ROBJGROUP_H
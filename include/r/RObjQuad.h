@@ -8,6 +8,9 @@
  *
  * Renders a batch of quads.
  *
+ * RObj_update uploads all quads to the gpu.
+ * After a call to RObjQuad_mark_dirty, only the marked quads are uploaded instead.
+ *
  * Operators:
  * o_num -> RObjQuad_num
  * o_at -> RObjQuad_at
@@ -16,6 +19,7 @@
 #include "o/OArray.h"
 #include "RObj.h"
 #include "RTex.h"
+#include "RBuffer.h"
 #include "quad.h"
 
 /** object id */
@@ -34,6 +38,9 @@ typedef struct {
     // RBufferQuad
     oobj buffer;
 
+    // enabled by RObjQuad_mark_dirty, so that updates only upload the marked spans
+    struct RBuffer_dirty dirty;
+
     // may be moved into this object
     RTex *tex;
     
@@ -170,6 +177,7 @@ OArray *RObjQuad_quads_set(oobj obj, oobj quads, bool del_old)
         o_del(self->quads);
     }
     self->quads = quads;
+    self->dirty.all = true;
     return self->quads;
 }
 
@@ -204,6 +212,23 @@ struct r_quad *RObjQuad_at(oobj obj, osize idx)
     return OArray_at(self->quads, idx, struct r_quad);
 }
 
+/**
+ * Marks quads as changed, so that the next RObj_update only uploads the marked quads.
+ * Enables dirty tracking for this object:
+ * from now on, unmarked changes are NOT uploaded, except a changed quad num or RObjQuad_quads_set.
+ * Up to RBuffer_DIRTY_SPANS_MAX separate spans are uploaded on their own, see RBuffer_dirty_mark.
+ * @param obj RObjQuad object
+ * @param idx first changed quad
+ * @param n number of changed quads
+ */
+O_INLINE
+void RObjQuad_mark_dirty(oobj obj, osize idx, osize n)
+{
+    OObj_assert(obj, RObjQuad);
+    RObjQuad *self = obj;
+    RBuffer_dirty_mark(&self->dirty, idx, n);
+}
+
 /**
  * @param obj RObjQuad object
  * @return The used RTex
@@ -0,0 +1,216 @@
+#ifndef R_ROBJSPRITE_H
+#define R_ROBJSPRITE_H
+
+/**
+ * @file RObjSprite.h
+ *
+ * Object
+ *
+ * Renders a batch of compact sprites (struct r_sprite, 32 bytes each).
+ * Use it instead of RObjQuad for large amounts of simple 2d sprites, to save memory bandwidth.
+ *
+ * RObj_update uploads all sprites to the gpu.
+ * After a call to RObjSprite_mark_dirty, only the marked sprites are uploaded instead.
+ *
+ * Operators:
+ * o_num -> RObjSprite_num
+ * o_at -> RObjSprite_at
+ */
+
+#include "o/OArray.h"
+#include "RObj.h"
+#include "RTex.h"
+#include "RBuffer.h"
+#include "RShaderSprite.h"
+#include "sprite.h"
+
+/** object id */
+#define RObjSprite_ID RObj_ID "Sprite"
+
+typedef struct {
+    RObj super;
+
+    // OArray of "struct r_sprite"
+    OArray *sprites;
+
+    // can be set lower num, o_min(num, num_rendered) is used to render
+    // init with oi32_MAX
+    int num_rendered;
+
+    // RBufferSprite
+    oobj buffer;
+
+    // may be moved into this object
+    RTex *tex;
+
+    RShaderSprite *shader;
+
+    // see RObjQuad
+    struct RBuffer_dirty dirty;
+
+} RObjSprite;
+
+
+/**
+ * Initializes the object
+ * @param obj RObjSprite object
+ * @param parent to inherit from
+ * @param num of sprites
+ * @param tex RTex object, NULL safe
+ * @param move_tex if true, tex is o_move'd into this object
+ * @return obj casted as RObjSprite
+ */
+O_EXTERN
+RObjSprite *RObjSprite_init(oobj obj, oobj parent, int num, oobj tex, bool move_tex);
+
+
+/**
+ * Creates a new RObjSprite object
+ * @param parent to inherit from
+ * @param num of sprites
+ * @param tex RTex object, NULL safe;
+ * @param move_tex if true, tex is o_move'd into this object
+ * @return The new object
+ */
+O_INLINE
+RObjSprite *RObjSprite_new(oobj parent, int num, oobj tex, bool move_tex)
+{
+    OObj_DECL_IMPL_NEW(RObjSprite, parent, num, tex, move_tex);
+}
+
+
+//
+// virtual implementations:
+//
+
+/**
+ * virtual operator function
+ * @param obj RObjSprite object
+ * @return number of r_sprite's
+ */
+O_EXTERN
+osize RObjSprite__v_op_num(oobj obj);
+
+/**
+ * virtual operator function
+ * @param obj RObjSprite object
+ * @return r_sprite at given idx
+ */
+O_EXTERN
+void *RObjSprite__v_op_at(oobj obj, osize idx);
+
+
+O_EXTERN
+void RObjSprite__v_update(oobj obj);
+
+O_EXTERN
+void RObjSprite__v_render(oobj obj, oobj tex, const struct r_proj *proj);
+
+
+//
+// object functions:
+//
+
+/**
+ * @param obj RObjSprite object
+ * @return internal OArray of struct r_sprite
+ */
+OObj_DECL_GET(RObjSprite, OArray *, sprites)
+
+/**
+ * @param obj RObjSprite object
+ * @param sprites The new OArray of struct r_sprite
+ * @param del_old if true, o_del old used OArray
+ * @return == sprites
+ */
+O_INLINE
+OArray *RObjSprite_sprites_set(oobj obj, oobj sprites, bool del_old)
+{
+    OObj_assert(obj, RObjSprite);
+    RObjSprite *self = obj;
+    if(del_old) {
+        o_del(self->sprites);
+    }
+    self->sprites = sprites;
+    self->dirty.all = true;
+    return self->sprites;
+}
+
+/**
+ * @param obj RObjSprite object
+ * @return number of r_sprite's
+ */
+O_INLINE
+osize RObjSprite_num(oobj obj)
+{
+    OObj_assert(obj, RObjSprite);
+    RObjSprite *self = obj;
+    return OArray_num(self->sprites);
+}
+
+/**
+ * @param obj RObjSprite object
+ * @return number of rendered r_sprite's (o_min(num, num_rendered))
+ */
+OObj_DECL_GETSET(RObjSprite, int, num_rendered)
+
+/**
+ * @param obj RObjSprite object
+ * @return r_sprite at given index
+ * @note asserts bounds
+ */
+O_INLINE
+struct r_sprite *RObjSprite_at(oobj obj, osize idx)
+{
+    OObj_assert(obj, RObjSprite);
+    RObjSprite *self = obj;
+    return OArray_at(self->sprites, idx, struct r_sprite);
+}
+
+/**
+ * Marks sprites as changed, so that the next RObj_update only uploads the marked sprites.
+ * Enables dirty tracking for this object, see RObjQuad_mark_dirty.
+ * @param obj RObjSprite object
+ * @param idx first changed sprite
+ * @param n number of changed sprites
+ */
+O_INLINE
+void RObjSprite_mark_dirty(oobj obj, osize idx, osize n)
+{
+    OObj_assert(obj, RObjSprite);
+    RObjSprite *self = obj;
+    RBuffer_dirty_mark(&self->dirty, idx, n);
+}
+
+/**
+ * @param obj RObjSprite object
+ * @return The used RTex
+ */
+OObj_DECL_GET(RObjSprite, RTex *, tex)
+
+/**
+ * @param obj RObjSprite object
+ * @param tex The new RTex
+ * @param del_old if true, o_del old used RTex
+ * @return == tex
+ */
+O_INLINE
+RTex *RObjSprite_tex_set(oobj obj, oobj tex, bool del_old)
+{
+    OObj_assert(obj, RObjSprite);
+    RObjSprite *self = obj;
+    if(del_old) {
+        o_del(self->tex);
+    }
+    self->tex = tex;
+    return self->tex;
+}
+
+/**
+ * @param obj RObjSprite object
+ * @return The RShaderSprite used to render
+ */
+OObj_DECL_GET(RObjSprite, RShaderSprite *, shader)
+
+
+#endif //R_ROBJSPRITE_H
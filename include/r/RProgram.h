@@ -36,6 +36,10 @@ typedef struct {
 
     ou32 gl_program;
     int num_draw_buffers;
+
+    // unique for each initialized program, never 0.
+    // Used as cache key instead of the object address or gl_program, which both get reused after a delete.
+    ou32 generation;
     
     // OMap with string keys of the uniform names to cache the location
     oobj uniforms;
@@ -123,6 +127,21 @@ ou32 RProgram_program(oobj obj)
     return self->gl_program;
 }
 
+/**
+ * @param obj RProgram object, NULL safe
+ * @return unique number of this program, to key caches with, or 0 if obj==NULL
+ */
+O_INLINE
+ou32 RProgram_generation(oobj obj)
+{
+    if(!obj) {
+        return 0;
+    }
+    OObj_assert(obj, RProgram);
+    RProgram *self = obj;
+    return self->generation;
+}
+
 /**
  * @param obj RProgram object, NULL safe
  * @return The number of "out vec4 f_rgba" in fragment shader (typically 1)
@@ -150,6 +169,7 @@ ou32 RProgram_use(oobj obj);
  * @param obj RProgram object, NULL safe -> will return -1
  * @param name of the uniform to locate
  * @return the cached location of the uniform (cached in an OMap with string keys...)
+ * @note use the location as handle for the RProgram_handle_* setters, to skip the name lookup on each call
  */
 O_EXTERN
 oi32 RProgram_uniform(oobj obj, const char *name);
@@ -170,7 +190,7 @@ O_EXTERN
 void RProgram_uniform_tex(oobj obj, const char *name, int pos, ou32 tex);
 
 /**
- * unbinds a tex
+ * Noop, the tex binding is kept in the gl state cache (see r/state.h), to skip rebinding the same tex.
  * @param obj RProgram object, NULL safe
  */
 O_EXTERN
@@ -286,4 +306,119 @@ void RProgram_uniform_ivec2(oobj obj, const char *name, const ivec2 *data, int n
 O_EXTERN
 void RProgram_uniform_int(oobj obj, const char *name, const int *data, int num);
 
+
+//
+// uniform handle wrapper
+// handles are the locations from RProgram_uniform, resolve them once (for example in the shaders init)
+// set into the currently used program (RProgram_use)
+//
+
+/**
+ * Sets and activates a tex
+ * @param handle location of the "sampler2D" uniform
+ * @param pos enumeration number of "sampler2D" in the shader [0, 1, ...]
+ * @param tex RTex_tex
+ */
+O_EXTERN
+void RProgram_handle_tex(oi32 handle, int pos, ou32 tex);
+
+/**
+ * Sets uniform values.
+ * @param handle location of the uniform, -1 is ignored
+ * @param data to be passed into the uniform
+ * @param num array length, typically 1
+ */
+O_EXTERN
+void RProgram_handle_mat4(oi32 handle, const mat4 *data, int num);
+
+/**
+ * Sets uniform values.
+ * @param handle location of the uniform, -1 is ignored
+ * @param data to be passed into the uniform
+ * @param num array length, typically 1
+ */
+O_EXTERN
+void RProgram_handle_mat3(oi32 handle, const mat3 *data, int num);
+
+/**
+ * Sets uniform values.
+ * @param handle location of the uniform, -1 is ignored
+ * @param data to be passed into the uniform
+ * @param num array length, typically 1
+ */
+O_EXTERN
+void RProgram_handle_mat2(oi32 handle, const mat2 *data, int num);
+
+/**
+ * Sets uniform values.
+ * @param handle location of the uniform, -1 is ignored
+ * @param data to be passed into the uniform
+ * @param num array length, typically 1
+ */
+O_EXTERN
+void RProgram_handle_vec4(oi32 handle, const vec4 *data, int num);
+
+/**
+ * Sets uniform values.
+ * @param handle location of the uniform, -1 is ignored
+ * @param data to be passed into the uniform
+ * @param num array length, typically 1
+ */
+O_EXTERN
+void RProgram_handle_vec3(oi32 handle, const vec3 *data, int num);
+
+/**
+ * Sets uniform values.
+ * @param handle location of the uniform, -1 is ignored
+ * @param data to be passed into the uniform
+ * @param num array length, typically 1
+ */
+O_EXTERN
+void RProgram_handle_vec2(oi32 handle, const vec2 *data, int num);
+
+/**
+ * Sets uniform values.
+ * @param handle location of the uniform, -1 is ignored
+ * @param data to be passed into the uniform
+ * @param num array length, typically 1
+ */
+O_EXTERN
+void RProgram_handle_float(oi32 handle, const float *data, int num);
+
+/**
+ * Sets uniform values.
+ * @param handle location of the uniform, -1 is ignored
+ * @param data to be passed into the uniform
+ * @param num array length, typically 1
+ */
+O_EXTERN
+void RProgram_handle_ivec4(oi32 handle, const ivec4 *data, int num);
+
+/**
+ * Sets uniform values.
+ * @param handle location of the uniform, -1 is ignored
+ * @param data to be passed into the uniform
+ * @param num array length, typically 1
+ */
+O_EXTERN
+void RProgram_handle_ivec3(oi32 handle, const ivec3 *data, int num);
+
+/**
+ * Sets uniform values.
+ * @param handle location of the uniform, -1 is ignored
+ * @param data to be passed into the uniform
+ * @param num array length, typically 1
+ */
+O_EXTERN
+void RProgram_handle_ivec2(oi32 handle, const ivec2 *data, int num);
+
+/**
+ * Sets uniform values.
+ * @param handle location of the uniform, -1 is ignored
+ * @param data to be passed into the uniform
+ * @param num array length, typically 1
+ */
+O_EXTERN
+void RProgram_handle_int(oi32 handle, const int *data, int num);
+
 #endif // R_RPROGRAM_H
@@ -106,4 +106,67 @@ OObj_DECL_GETSET(RShader, oobj, program)
 OObj_DECL_GETSET(RShader, bool, blend)
 
 
+//
+// uniform handles
+//
+
+/** maximal number of additional uniform handles of a shader, see RShader_handles_get */
+#define RShader_HANDLES_EXTRA_MAX 4
+
+/** number of programs a single shader caches the handles for */
+#define RShader_HANDLES_CACHE_SIZE 4
+
+/**
+ * Uniform handles (see RProgram_handle_*) of the common uniforms,
+ *      used by the quad, rect and sprite shaders
+ */
+struct RShader_handles {
+    // RProgram_generation the handles were resolved for, 0 if unused
+    ou32 generation;
+
+    oi32 viewport_scale_double;
+    oi32 viewport_size_half;
+    oi32 viewport_even_offset;
+    oi32 vp;
+    oi32 tex_scale;
+    oi32 tex;
+
+    // additional uniforms of the shader, in the order of the names passed to RShader_handles_get
+    oi32 extra[RShader_HANDLES_EXTRA_MAX];
+};
+
+/**
+ * Resolved handles of the last used programs of a shader.
+ * Shared shaders that switch their program (like the RTex manipulation shaders) keep a hit for each program.
+ * Zero initialized.
+ */
+struct RShader_handles_cache {
+    struct RShader_handles entries[RShader_HANDLES_CACHE_SIZE];
+    // entry to replace on the next miss
+    int next;
+};
+
+/**
+ * Returns the cached handles for the program, or resolves them into the oldest entry.
+ * Cached by RProgram_generation, so a new program never hits the handles of a deleted one.
+ * @param cache of the shader
+ * @param program RProgram to get the handles for
+ * @param opt_extra_names NULL terminated list of additional uniform names (up to RShader_HANDLES_EXTRA_MAX),
+ *                        must be the same list for each call on cache
+ * @return the handles, valid until the next call on cache
+ */
+O_EXTERN
+const struct RShader_handles *RShader_handles_get(struct RShader_handles_cache *cache, oobj program,
+                                                  const char *const *opt_extra_names);
+
+/**
+ * Sets the common uniforms: u_c_viewport_*, u_vp, u_tex_scale and u_tex (at pos 0)
+ * @param handles resolved with RShader_handles_get
+ * @param proj the camera projection
+ * @param tex RTex to sample from, NULL safe
+ */
+O_EXTERN
+void RShader_handles_set_common(const struct RShader_handles *handles, const struct r_proj *proj, oobj tex);
+
+
 #endif //R_RSHADER_H
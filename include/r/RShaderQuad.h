@@ -26,6 +26,9 @@ typedef struct
 
     // may be moved into this object
     RTex* tex;
+
+    // resolved in the render call
+    struct RShader_handles_cache handles;
 } RShaderQuad;
 
 
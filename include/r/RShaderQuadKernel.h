@@ -11,6 +11,7 @@
  * - _contour_inv (erode)
  * - _bloom
  * - _conv Convolution
+ * - _sep separable convolution pass with linear merged taps (see RTex_new_kernel_sep)
  * 
  */
 
@@ -0,0 +1,107 @@
+#ifndef R_RSHADERSPRITE_H
+#define R_RSHADERSPRITE_H
+
+/**
+ * @file RShaderSprite.h
+ *
+ * Object
+ *
+ * Shader to render a batch of Sprites, see RBufferSprite or RObjSprite
+ */
+
+#include "r/RShader.h"
+#include "r/RTex.h"
+
+
+/** object id */
+#define RShaderSprite_ID RShader_ID "Sprite"
+
+typedef struct
+{
+    RShader super;
+
+    // u_color, multiplied with each sprite color
+    // init as vec4_(1)
+    vec4 color;
+
+    // may be moved into this object
+    RTex* tex;
+
+    // resolved in the render call
+    struct RShader_handles_cache handles;
+} RShaderSprite;
+
+
+/**
+ * Initializes the object
+ * @param obj RShaderSprite object
+ * @param parent to inherit from
+ * @param tex RTex object, NULL safe
+ * @param move_tex if true, tex is o_move'd into this object
+ * @return obj casted as RShaderSprite
+ */
+O_EXTERN
+RShaderSprite* RShaderSprite_init(oobj obj, oobj parent, oobj tex, bool move_tex);
+
+/**
+ * Creates a new RShaderSprite object
+ * @param parent to inherit from
+ * @param tex RTex object, NULL safe
+ * @param move_tex if true, tex is o_move'd into this object
+ * @return The new object
+ */
+O_INLINE
+RShaderSprite* RShaderSprite_new(oobj parent, oobj tex, bool move_tex)
+{
+    OObj_DECL_IMPL_NEW(RShaderSprite, parent, tex, move_tex);
+}
+
+//
+// virtual implementations:
+//
+
+void RShaderSprite__v_render(oobj obj, oobj program, int num, const struct r_proj* proj);
+
+
+//
+// object functions:
+//
+
+/**
+ * @param obj RShaderSprite object
+ * @return reference color uniform
+ */
+O_INLINE
+vec4* RShaderSprite_color(oobj obj)
+{
+    OObj_assert(obj, RShaderSprite);
+    RShaderSprite* self = obj;
+    return &self->color;
+}
+
+/**
+ * @param obj RShaderSprite object
+ * @return The used RTex
+ */
+OObj_DECL_GET(RShaderSprite, RTex *, tex)
+
+/**
+ * @param obj RShaderSprite object
+ * @param tex The new RTex
+ * @param del_old if true, o_del old used RTex
+ * @return == tex
+ */
+O_INLINE
+RTex* RShaderSprite_tex_set(oobj obj, oobj tex, bool del_old)
+{
+    OObj_assert(obj, RShaderSprite);
+    RShaderSprite* self = obj;
+    if (del_old) {
+        o_del(self->tex);
+    }
+    self->tex = tex;
+    return self->tex;
+}
+
+
+#endif //R_RSHADERSPRITE_H
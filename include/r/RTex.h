@@ -125,6 +125,20 @@ RTex* RTex_new(oobj parent, const void* opt_buffer, int cols, int rows)
 O_EXTERN
 RTex* RTex_new_file(oobj parent, const char* file);
 
+/**
+ * Creates a new the RTex object, which loads the image in the background.
+ * Returns a 1x1 transparent placeholder right away.
+ * The image is decoded in an OThreadpool and uploaded on the render thread with a per frame budget.
+ * Once finished, the storage (and size!) of the placeholder is replaced.
+ * @param parent to inherit from
+ * @param file to load the tex from, either png or jpg, loaded with SDL_image
+ * @return The new (placeholder) object.
+ * @note uses RTexLoader_default, see RTexLoader.h.
+ *       If the file failed to read, the placeholder is kept.
+ */
+O_EXTERN
+RTex* RTex_new_file_async(oobj parent, const char* file);
+
 /**
  * Creates a new the RTex object.
  * Blits the current back buffer into the new RTex.
@@ -162,6 +176,51 @@ RTex *RTex_new_kernel(oobj parent, int cols, int rows, float set, bool plus, flo
 O_EXTERN
 RTex *RTex_new_kernel_gauss(oobj parent, int cols, int rows, vec2 sigma, float normalize);
 
+/**
+ * Computes the weights of a 1d gauss kernel, as used by RTex_new_kernel_gauss for each axis.
+ * @param out_weights n values, normalized to a sum of 1.0
+ * @param n kernel size
+ * @param sigma gauss factor, pass <=0 to auto scale
+ */
+O_EXTERN
+void RTex_kernel_gauss_weights(float *out_weights, int n, float sigma);
+
+/**
+ * Creates a 1d kernel tex for a separable convolution pass (program QuadKernel_sep).
+ * Two neighbouring weights are merged into a single tap, which is sampled with a linear filter between both texels.
+ * @param parent to inherit from
+ * @param weights n weights (>=0), weights[i] for the pixel offset i - n/2 (like RTex_conv)
+ * @param n kernel size
+ * @param vertical if true, the kernel is 1 x taps for a vertical pass, else taps x 1
+ * @return The new object
+ * @note R_FORMAT_RGBA_32F is used internally: .r tap weight, .g tap offset in pixels
+ */
+O_EXTERN
+RTex *RTex_new_kernel_sep(oobj parent, const float *weights, int n, bool vertical);
+
+/**
+ * Creates a 1d box kernel tex for a separable convolution pass.
+ * @param parent to inherit from
+ * @param n kernel size
+ * @param vertical if true, for a vertical pass
+ * @return The new object
+ * @note normalized to a sum of 1.0, see RTex_new_kernel_sep
+ */
+O_EXTERN
+RTex *RTex_new_kernel_sep_box(oobj parent, int n, bool vertical);
+
+/**
+ * Creates a 1d gauss kernel tex for a separable convolution pass.
+ * @param parent to inherit from
+ * @param n kernel size
+ * @param sigma gauss factor, pass <=0 to auto scale
+ * @param vertical if true, for a vertical pass
+ * @return The new object
+ * @note normalized to a sum of 1.0, see RTex_new_kernel_sep
+ */
+O_EXTERN
+RTex *RTex_new_kernel_sep_gauss(oobj parent, int n, float sigma, bool vertical);
+
 
 //
 // virtual implementations:
@@ -532,6 +591,18 @@ void RTex_set(oobj obj, const void* buffer)
     RTex_set_ex(obj, buffer, R_FORMAT_RGBA_8);
 }
 
+/**
+ * Sets some rows of the buffer
+ * @param obj RTex object
+ * @param buffer a buffer of (at least) cols * rows * r_format_size(format), beginning at row
+ * @param row first row to set
+ * @param rows number of rows to set
+ * @param format for the buffer pixels
+ * @note internal and given format may be different
+ */
+O_EXTERN
+void RTex_set_rows_ex(oobj obj, const void* buffer, int row, int rows, enum r_format format);
+
 /**
  * Save the tex image as .png file (rgba 8bit)
  * @param obj RTex object
@@ -542,6 +613,32 @@ void RTex_set(oobj obj, const void* buffer)
 O_EXTERN
 bool RTex_write_file(oobj obj, const char* file);
 
+/**
+ * Retrieves the current buffer asynchronous, without stalling the render pipeline.
+ * @param obj RTex object
+ * @param parent to inherit the returned RTexReadback from
+ * @param format for the data pixels
+ * @param opt_callback if not NULL, called on the render thread once the readback has finished
+ * @return a new RTexReadback object, poll it or wait for the callback
+ * @sa RTexReadback.h
+ */
+O_EXTERN
+oobj RTex_get_async(oobj obj, oobj parent, enum r_format format, OObj__event_fn opt_callback);
+
+/**
+ * Save the tex image as .png file (rgba 8bit), asynchronous.
+ * The readback does not stall the render pipeline, the png encoding runs in an OFuture.
+ * @param obj RTex object
+ * @param parent to inherit the returned RTexReadback from
+ * @param file png file to write into
+ * @param opt_threadpool if not NULL, the encoding runs in this OThreadpool, else in a new thread
+ * @param opt_callback if not NULL, called on the render thread once the file has been written
+ * @return a new RTexReadback object, see RTexReadback_saved
+ * @note without MIA_OPTION_THREAD, the encoding runs synchronous while polling
+ */
+O_EXTERN
+oobj RTex_write_file_async(oobj obj, oobj parent, const char* file, oobj opt_threadpool, OObj__event_fn opt_callback);
+
 /**
  * @param obj RTex object
  * @return a reference the default render projection, defaults to a minradius -> min units cam
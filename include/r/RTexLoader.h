@@ -0,0 +1,175 @@
+#ifndef R_RTEXLOADER_H
+#define R_RTEXLOADER_H
+
+/**
+ * @file RTexLoader.h
+ *
+ * Object
+ *
+ * A loader queue to load images in the background.
+ * Images are decoded with o_img_new_file in an OFuture (OThreadpool) into a staging buffer.
+ * RTexLoader_update uploads the decoded images on the render thread, row by row, with a per frame budget.
+ * Once a texture is fully uploaded, its storage is swapped into the placeholder RTex.
+ *
+ * The default loader (RTexLoader_default) is updated in r_frame_begin.
+ * RTex_new_file_async and UImg_new_file_async use the default loader.
+ *
+ * Without MIA_OPTION_THREAD, the images are decoded synchronous in RTexLoader_update, one per call.
+ */
+
+#include "o/OObj.h"
+#include "o/OArray.h"
+#include "o/img.h"
+#include "r/common.h"
+
+/** object id */
+#define RTexLoader_ID OObj_ID "RTexLoader"
+
+/** default upload budget per frame in bytes */
+#define RTexLoader_BUDGET_BYTES_DEFAULT (4 * 1024 * 1024)
+
+/** default upload budget per frame in millis */
+#define RTexLoader_BUDGET_MS_DEFAULT 2.0
+
+
+/**
+ * Function to receive a decoded image, instead of uploading it into an RTex.
+ * @param target the object passed to RTexLoader_load_img
+ * @param img the decoded image, allocated on the loader and freed after this call, so copy the data
+ */
+typedef void (*RTexLoader__img_fn)(oobj target, struct o_img *img);
+
+typedef struct {
+    OObj super;
+
+    oobj opt_threadpool;
+
+    // per frame budgets for RTexLoader_update, <=0 for unlimited
+    osize budget_bytes;
+    double budget_ms;
+
+    // OArray of struct RTexLoader_job *
+    OArray *jobs;
+
+    // progress of the current batch, reset if a job is added to an empty queue
+    int batch_jobs;
+    int batch_done;
+} RTexLoader;
+
+
+/**
+ * Initializes the object
+ * @param obj RTexLoader object
+ * @param parent to inherit from
+ * @param opt_threadpool OThreadpool to decode the images, if NULL, each image gets its own thread
+ * @return obj casted as RTexLoader
+ */
+O_EXTERN
+RTexLoader *RTexLoader_init(oobj obj, oobj parent, oobj opt_threadpool);
+
+/**
+ * Creates a new the RTexLoader object
+ * @param parent to inherit from
+ * @param opt_threadpool OThreadpool to decode the images, if NULL, each image gets its own thread
+ * @return The new object
+ */
+O_INLINE
+RTexLoader *RTexLoader_new(oobj parent, oobj opt_threadpool)
+{
+    OObj_DECL_IMPL_NEW(RTexLoader, parent, opt_threadpool);
+}
+
+/**
+ * @return the default loader, which is updated in r_frame_begin.
+ *         Decodes with the o_parallel_pool.
+ */
+O_EXTERN
+RTexLoader *RTexLoader_default(void);
+
+//
+// virtual implementations:
+//
+
+/**
+ * Default deletor that waits for running decodes
+ * @param obj RTexLoader object
+ */
+O_EXTERN
+void RTexLoader__v_del(oobj obj);
+
+
+//
+// object functions:
+//
+
+/**
+ * Starts to load an image file into the tex.
+ * Once uploaded, the storage (and size) of the tex gets replaced.
+ * @param obj RTexLoader object
+ * @param tex RTex object to load into, if deleted before finished, the job is cancelled
+ * @param file to load the tex from, either png or jpg, loaded with SDL_image
+ */
+O_EXTERN
+void RTexLoader_load(oobj obj, oobj tex, const char *file);
+
+/**
+ * Starts to load an image file and passes it to the function.
+ * @param obj RTexLoader object
+ * @param target object passed to fn, if deleted before finished, the job is cancelled
+ * @param file to load the image from, either png or jpg, loaded with SDL_image
+ * @param fn called in RTexLoader_update on the render thread (not on failure)
+ */
+O_EXTERN
+void RTexLoader_load_img(oobj obj, oobj target, const char *file, RTexLoader__img_fn fn);
+
+/**
+ * Hands over decoded images and uploads textures, until the budget is reached.
+ * @param obj RTexLoader object
+ * @note must be called on the render thread, the default loader is updated in r_frame_begin
+ */
+O_EXTERN
+void RTexLoader_update(oobj obj);
+
+/**
+ * @param obj RTexLoader object
+ * @return number of pending jobs
+ */
+O_INLINE
+int RTexLoader_num(oobj obj)
+{
+    OObj_assert(obj, RTexLoader);
+    RTexLoader *self = obj;
+    return (int) OArray_num(self->jobs);
+}
+
+/**
+ * @param obj RTexLoader object
+ * @return true if all jobs are finished
+ */
+O_INLINE
+bool RTexLoader_idle(oobj obj)
+{
+    return RTexLoader_num(obj) == 0;
+}
+
+/**
+ * @param obj RTexLoader object
+ * @return progress [0.0-1.0] of the current batch (jobs added since the queue was empty), 1.0 if idle
+ */
+O_EXTERN
+float RTexLoader_progress(oobj obj);
+
+
+/**
+ * @param obj RTexLoader object
+ * @return per frame upload budget in bytes, <=0 for unlimited
+ */
+OObj_DECL_GETSET(RTexLoader, osize, budget_bytes)
+
+/**
+ * @param obj RTexLoader object
+ * @return per frame upload budget in millis, <=0 for unlimited
+ */
+OObj_DECL_GETSET(RTexLoader, double, budget_ms)
+
+#endif //R_RTEXLOADER_H
@@ -0,0 +1,188 @@
+#ifndef R_RTEXREADBACK_H
+#define R_RTEXREADBACK_H
+
+/**
+ * @file RTexReadback.h
+ *
+ * Object
+ *
+ * Asynchronous readback of an RTex, created with RTex_get_async or RTex_write_file_async.
+ * The pixels are copied into a pixel buffer object (PBO) and a fence sync is inserted.
+ * The render thread does not stall, the data is mapped once the gpu has signaled the fence.
+ *
+ * Pending readbacks are polled in r_frame_begin, so the callback gets called in one of the next frames.
+ * RTexReadback_poll can be called at any time (on the render thread) to check without blocking.
+ * RTexReadback_wait blocks until the data is available (the same cost as RTex_get).
+ *
+ * RTex_write_file_async encodes the .png file in an OFuture (OThreadpool) after the readback.
+ * Without MIA_OPTION_THREAD, the encoding is done synchronous in the poll call.
+ *
+ * @note the callback and the poll functions must be called on the render thread (gl context)
+ */
+
+#include "o/OObj.h"
+#include "r/common.h"
+#include "r/format.h"
+
+/** object id */
+#define RTexReadback_ID OObj_ID "RTexReadback"
+
+/** readbacks simple state machine */
+enum RTexReadback_state {
+    RTexReadback_PENDING,
+    RTexReadback_ENCODING,
+    RTexReadback_FINISHED,
+    RTexReadback_NUM_STATES
+};
+
+typedef struct {
+    OObj super;
+
+    enum RTexReadback_state state;
+
+    ivec2 size;
+    enum r_format format;
+
+    // 0 if finished
+    ou32 gl_pbo;
+    // GLsync, NULL if finished
+    void *gl_sync;
+
+    // RTexReadback_data_size bytes, NULL until the readback has finished
+    void *data;
+
+    // called once the readback (and encoding) has finished
+    OObj__event_fn opt_callback;
+
+    // RTex_write_file_async only
+    char *opt_file;
+    oobj opt_threadpool;
+    oobj future;
+    bool saved;
+
+    // intrusive list of the pending readbacks
+    void *prev, *next;
+} RTexReadback;
+
+
+/**
+ * Initializes the object and starts the readback.
+ * @param obj RTexReadback object
+ * @param parent to inherit from
+ * @param tex RTex object to read from
+ * @param format for the data pixels
+ * @param opt_callback if not NULL, called on the render thread once the readback has finished
+ * @return obj casted as RTexReadback
+ * @note RTex_get_async is the common way to create a readback
+ */
+O_EXTERN
+RTexReadback *RTexReadback_init(oobj obj, oobj parent, oobj tex, enum r_format format, OObj__event_fn opt_callback);
+
+/**
+ * Creates a new RTexReadback object and starts the readback.
+ * @param parent to inherit from
+ * @param tex RTex object to read from
+ * @param format for the data pixels
+ * @param opt_callback if not NULL, called on the render thread once the readback has finished
+ * @return The new object
+ */
+O_INLINE
+RTexReadback *RTexReadback_new(oobj parent, oobj tex, enum r_format format, OObj__event_fn opt_callback)
+{
+    OObj_DECL_IMPL_NEW(RTexReadback, parent, tex, format, opt_callback);
+}
+
+//
+// virtual implementations:
+//
+
+/**
+ * Default deletor that waits for a running png encoding and frees the gl resources.
+ * @param obj RTexReadback object
+ */
+O_EXTERN
+void RTexReadback__v_del(oobj obj);
+
+
+//
+// object functions:
+//
+
+/**
+ * Checks if the gpu has finished the copy and maps the data, without blocking.
+ * Calls the callback, if just finished.
+ * @param obj RTexReadback object
+ * @return true if finished
+ */
+O_EXTERN
+bool RTexReadback_poll(oobj obj);
+
+/**
+ * Blocks until the readback (and encoding) has finished.
+ * Calls the callback, if not already done.
+ * @param obj RTexReadback object
+ */
+O_EXTERN
+void RTexReadback_wait(oobj obj);
+
+/**
+ * Polls all pending readbacks.
+ * Called automatically in r_frame_begin.
+ */
+O_EXTERN
+void RTexReadback_poll_all(void);
+
+
+/**
+ * @param obj RTexReadback object
+ * @return the current state, without polling
+ */
+OObj_DECL_GET(RTexReadback, enum RTexReadback_state, state)
+
+/**
+ * @param obj RTexReadback object
+ * @return true if finished, without polling
+ */
+O_INLINE
+bool RTexReadback_finished(oobj obj)
+{
+    return RTexReadback_state(obj) == RTexReadback_FINISHED;
+}
+
+/**
+ * @param obj RTexReadback object
+ * @return size of the read tex in pixels
+ */
+OObj_DECL_GET(RTexReadback, ivec2, size)
+
+/**
+ * @param obj RTexReadback object
+ * @return format of the data pixels
+ */
+OObj_DECL_GET(RTexReadback, enum r_format, format)
+
+/**
+ * @param obj RTexReadback object
+ * @return the read pixels, row major, beginning at bottom left, or NULL if not finished yet
+ */
+OObj_DECL_GET(RTexReadback, void *, data)
+
+/**
+ * @param obj RTexReadback object
+ * @return the size of data in bytes
+ */
+O_INLINE
+osize RTexReadback_data_size(oobj obj)
+{
+    OObj_assert(obj, RTexReadback);
+    RTexReadback *self = obj;
+    return (osize) self->size.x * self->size.y * r_format_size(self->format);
+}
+
+/**
+ * @param obj RTexReadback object
+ * @return true if the .png file was written by RTex_write_file_async
+ */
+OObj_DECL_GET(RTexReadback, bool, saved)
+
+#endif //R_RTEXREADBACK_H
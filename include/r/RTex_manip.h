@@ -7,9 +7,14 @@
  * Object extension
  *
  * texture manipulate functions
+ *
+ * The generators (without _into) create their result with r_texpool_new.
+ * So in the r_texpool transient mode, the results are pooled render targets (see r/texpool.h).
+ * The _into functions use cached kernel textures (see r/tex.h), instead of creating them each call.
  */
 
 #include "RTex.h"
+#include "texpool.h"
 
 
 //
@@ -32,7 +37,7 @@ void RTex_add_scaled_into(oobj obj, vec4 add, vec4 scale, oobj into);
 O_INLINE
 RTex *RTex_add_scaled(oobj obj, vec4 add, vec4 scale, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_add_scaled_into(obj, add, scale, res);
     return res;
 }
@@ -65,7 +70,7 @@ void RTex_mixer_into(oobj obj, mat4 rgba_matrix, oobj into);
 O_INLINE
 RTex *RTex_mixer(oobj obj, mat4 rgba_matrix, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_mixer_into(obj, rgba_matrix, res);
     return res;
 }
@@ -89,7 +94,7 @@ void RTex_inv_into(oobj obj, vec4 inv_mask, oobj into);
 O_INLINE
 RTex *RTex_inv(oobj obj, vec4 inv_mask, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_inv_into(obj, inv_mask, res);
     return res;
 }
@@ -119,7 +124,7 @@ void RTex_channels_into(oobj obj, ivec4 channel, oobj into);
 O_INLINE
 RTex *RTex_channels(oobj obj, ivec4 channel, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_channels_into(obj, channel, res);
     return res;
 }
@@ -169,7 +174,7 @@ void RTex_channels_merge_into(oobj r, oobj g, oobj b, oobj a, oobj into);
 O_INLINE
 RTex *RTex_channels_merge(oobj r, oobj g, oobj b, oobj a, enum r_format format)
 {
-    RTex *res = RTex_new_ex(r, NULL, m_2(RTex_size(r)), format, format);
+    RTex *res = r_texpool_new(r, RTex_size_int(r), format);
     RTex_channels_merge_into(r, g, b, a, res);
     return res;
 }
@@ -195,7 +200,7 @@ void RTex_color_into(oobj obj, vec4 rgba, vec4 hsva, oobj into);
 O_INLINE
 RTex* RTex_color(oobj obj, vec4 rgba, vec4 hsva, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_color_into(obj, rgba, hsva, res);
     return res;
 }
@@ -217,7 +222,7 @@ void RTex_rgba_to_hsva_into(oobj obj, oobj into);
 O_INLINE
 RTex* RTex_rgba_to_hsva(oobj obj, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_rgba_to_hsva_into(obj, res);
     return res;
 }
@@ -239,7 +244,7 @@ void RTex_hsva_rgba_into(oobj obj, oobj into);
 O_INLINE
 RTex* RTex_hsva_rgba(oobj obj, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_hsva_rgba_into(obj, res);
     return res;
 }
@@ -268,65 +273,100 @@ void RTex_conv_into(oobj obj, oobj kernel, ivec2 offset, oobj into);
 O_INLINE
 RTex* RTex_conv(oobj obj, oobj kernel, ivec2 offset, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_conv_into(obj, kernel, offset, res);
     return res;
 }
 
 
 /**
- * Runs a convolution with the given kernel on this image and returns a new RTex with the result
+ * Runs a box blur on this image and renders the result into the given RTex
  * @param obj RTex object
  * @param size for the kernel, asserts max
  * @param into RTex object to render into
- * @note calls RTex_conv internally
+ * @note separable: a horizontal and a vertical pass with linear merged taps,
+ *       so about (size.x + size.y) / 2 texture fetches per pixel, instead of size.x * size.y.
+ *       Same result as RTex_conv_into with RTex_new_kernel(..., 1.0f, false, 1.0f), but an 8 bit rounding in between.
  */
 O_EXTERN
 void RTex_blur_into(oobj obj, ivec2 size, oobj into);
 
+/**
+ * Runs an approximated box blur for large kernel sizes, with a constant cost per pixel.
+ * Downsamples the image (2x2 averages, like a mipmap) until the kernel is small,
+ *      blurs that level with RTex_blur_into and upsamples the result linear into the given RTex.
+ * @param obj RTex object
+ * @param size for the kernel
+ * @param into RTex object to render into
+ * @note for small kernels (<= R_BLUR_LARGE_KERNEL) just calls RTex_blur_into
+ */
+O_EXTERN
+void RTex_blur_large_into(oobj obj, ivec2 size, oobj into);
+
+/** kernel size for the downsampled level of RTex_blur_large_into */
+#define R_BLUR_LARGE_KERNEL 8
+
 
 /**
- * Runs a convolution with the given kernel on this image and returns a new RTex with the result
+ * Runs a box blur on this image and returns a new RTex with the result
  * @param obj RTex object
  * @param size for the kernel, asserts max
  * @param format for the resulting RTex
  * @return RTex allocated on obj
- * @note calls RTex_conv internally
+ * @note calls RTex_blur_into internally
  */
 O_INLINE
 RTex* RTex_blur(oobj obj, ivec2 size, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_blur_into(obj, size, res);
     return res;
 }
 
+/**
+ * Runs an approximated box blur for large kernel sizes and returns a new RTex with the result
+ * @param obj RTex object
+ * @param size for the kernel
+ * @param format for the resulting RTex
+ * @return RTex allocated on obj
+ * @note calls RTex_blur_large_into internally
+ */
+O_INLINE
+RTex* RTex_blur_large(oobj obj, ivec2 size, enum r_format format)
+{
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
+    RTex_blur_large_into(obj, size, res);
+    return res;
+}
+
 
 /**
- * Runs a convolution with the given kernel on this image and returns a new RTex with the result
+ * Runs a gauss blur on this image and renders the result into the given RTex
  * @param obj RTex object
  * @param size for the kernel, asserts max
  * @param sigma gauss factor for x and y axis, pass <=0 to auto scale (vec2_(-1))
  * @param into RTex object to render into
- * @note calls RTex_conv internally
+ * @note separable: a horizontal and a vertical pass with linear merged taps,
+ *       so about (size.x + size.y) / 2 texture fetches per pixel, instead of size.x * size.y.
+ *       Same result as RTex_conv_into with RTex_new_kernel_gauss(..., 1.0f), but an 8 bit rounding in between.
  */
 O_EXTERN
 void RTex_gauss_into(oobj obj, ivec2 size, vec2 sigma, oobj into);
 
 
 /**
- * Runs a convolution with the given kernel on this image and returns a new RTex with the result
+ * Runs a gauss blur on this image and returns a new RTex with the result
  * @param obj RTex object
  * @param size for the kernel, asserts max
  * @param sigma gauss factor for x and y axis, pass <=0 to auto scale (vec2_(-1))
  * @param format for the resulting RTex
  * @return RTex allocated on obj
- * @note calls RTex_conv internally
+ * @note calls RTex_gauss_into internally
  */
 O_INLINE
 RTex* RTex_gauss(oobj obj, ivec2 size, vec2 sigma, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_gauss_into(obj, size, sigma, res);
     return res;
 }
@@ -358,7 +398,7 @@ void RTex_dilate_into(oobj obj, oobj kernel, ivec2 offset, vec4 mask, vec4 color
 O_INLINE
 RTex* RTex_dilate(oobj obj, oobj kernel, ivec2 offset, vec4 mask, vec4 color, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_dilate_into(obj, kernel, offset, mask, color, res);
     return res;
 }
@@ -388,7 +428,7 @@ void RTex_erode_into(oobj obj, oobj kernel, ivec2 offset, vec4 mask, vec4 color,
 O_INLINE
 RTex* RTex_erode(oobj obj, oobj kernel, ivec2 offset, vec4 mask, vec4 color, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_erode_into(obj, kernel, offset, mask, color, res);
     return res;
 }
@@ -422,7 +462,7 @@ void RTex_contour_into(oobj obj, oobj kernel, ivec2 offset, vec4 mask, vec4 colo
 O_INLINE
 RTex* RTex_contour(oobj obj, oobj kernel, ivec2 offset, vec4 mask, vec4 color, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_contour_into(obj, kernel, offset, mask, color, res);
     return res;
 }
@@ -458,7 +498,7 @@ void RTex_outline_into(oobj obj, ivec2 size, ivec2 offset, vec4 mask, vec4 color
 O_INLINE
 RTex* RTex_outline(oobj obj, ivec2 size, ivec2 offset, vec4 mask, vec4 color, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_outline_into(obj, size, offset, mask, color, res);
     return res;
 }
@@ -502,7 +542,7 @@ void RTex_merge_into(oobj obj, oobj tex, oobj opt_mask_a, oobj opt_mask_b, vec4
 O_INLINE
 RTex *RTex_merge(oobj obj, oobj tex, oobj opt_mask_a, oobj opt_mask_b, vec4 rgba, enum r_format format)
 {
-    RTex *res = RTex_new_ex(obj, NULL, m_2(RTex_size(obj)), format, format);
+    RTex *res = r_texpool_new(obj, RTex_size_int(obj), format);
     RTex_merge_into(obj, tex, opt_mask_a, opt_mask_b, rgba, res);
     return res;
 }
@@ -115,6 +115,55 @@ O_EXTERN
 void r_frame_begin(int back_cols, int window_rows);
 
 
+/**
+ * Render statistics of a single frame
+ */
+struct r_stats {
+    // bytes sent to vertex buffers (RBuffer_update, RBuffer_update_range)
+    osize buffer_uploaded_bytes;
+    // full uploads that orphaned the vertex buffer storage (RBuffer_update)
+    osize buffer_full_uploads;
+
+    // RShader_render_ex calls
+    int draw_calls;
+
+    // changed program, vertex buffer, target or blend between draws and changed bound textures
+    int state_changes;
+
+    // gl state calls issued and skipped by the state cache (see r/state.h)
+    int gl_calls;
+    int gl_calls_skipped;
+
+    // uniform handles resolved on a miss of a shader handles cache (see RShader_handles_get)
+    int shader_handles_resolved;
+
+    // bytes uploaded by the background loader (see r/RTexLoader.h)
+    osize tex_uploaded_bytes;
+
+    // created textures and framebuffers (see r/texpool.h to avoid them)
+    int gl_allocations;
+};
+
+/**
+ * @return the counters of the current frame, added up by the r modules and reset in r_frame_begin
+ */
+O_EXTERN
+struct r_stats *r_stats_frame(void);
+
+/**
+ * @return the counters of the last finished frame (copied in r_frame_begin)
+ */
+O_EXTERN
+struct r_stats r_stats_last(void);
+
+/**
+ * Logs the stats as info
+ * @param stats to log, for example r_stats_last()
+ */
+O_EXTERN
+void r_stats_log(struct r_stats stats);
+
+
 /**
  * Checks for OpenGL errors
  */
@@ -38,9 +38,11 @@ r_program_DECL(QuadKernel_bloom, 1)
 r_program_DECL(QuadKernel_contour, 1)
 r_program_DECL(QuadKernel_contour_inv, 1)
 r_program_DECL(QuadKernel_conv, 1)
+r_program_DECL(QuadKernel_sep, 1)
 r_program_DECL(QuadMerge, 1)
 r_program_DECL(Rect, 1)
 r_program_DECL(Rect_color, 1)
+r_program_DECL(Sprite, 1)
 
 
 #undef r_program_DECL
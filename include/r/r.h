@@ -24,7 +24,10 @@
 #include "proj.h"
 #include "quad.h"
 #include "rect.h"
+#include "sprite.h"
+#include "state.h"
 #include "tex.h"
+#include "texpool.h"
 
 
 //
@@ -37,6 +40,8 @@
 #include "RShader.h"
 #include "RTex.h"
 #include "RTex_manip.h"
+#include "RTexLoader.h"
+#include "RTexReadback.h"
 
 //
 // buffers 'n shaders
@@ -50,6 +55,8 @@
 #include "RShaderQuadMerge.h"
 #include "RBufferRect.h"
 #include "RShaderRect.h"
+#include "RBufferSprite.h"
+#include "RShaderSprite.h"
 
 
 //
@@ -60,6 +67,7 @@
 #include "RObjGroup.h"
 #include "RObjQuad.h"
 #include "RObjRect.h"
+#include "RObjSprite.h"
 #include "RObjText.h"
 
 #endif //R_R_H
@@ -0,0 +1,106 @@
+#ifndef R_SPRITE_H
+#define R_SPRITE_H
+
+/**
+ * @file sprite.h
+ *
+ * Defines a compact render sprite.
+ * 32 bytes instead of the 192 bytes of an r_quad.
+ * Supports position, size, rotation, an axis aligned uv rect and a color.
+ * Use r_quad (RObjQuad) for full 3d poses, uv rotations and the stuv shader parameters.
+ */
+
+#include "quad.h"
+#include "m/types/byte.h"
+
+
+struct r_sprite {
+    vec2 pos;           // center position
+
+    ou16 size[2];       // half float width and height (negative to mirror)
+    ou16 angle;         // half float rotation in [rad]
+    ou16 reserved;      // keeps the 4 byte alignment, init 0
+
+    vec2 uv_pos;        // uv center in texels, relative to the tex center (same as the r_quad uv pose)
+    ou16 uv_size[2];    // half float uv width and height (negative to mirror)
+
+    bvec4 color;        // normalized rgba, multiplied with the texture
+};
+
+/**
+ * @param f float value
+ * @return f packed as IEEE 754 half float (round to nearest even)
+ */
+O_EXTERN
+ou16 r_sprite_half_pack(float f);
+
+/**
+ * @param h IEEE 754 half float
+ * @return h unpacked into a float
+ */
+O_EXTERN
+float r_sprite_half_unpack(ou16 h);
+
+/**
+ * Initializes the sprite
+ * @param tex_cols, tex_rows to set the size for the sprite and the uv
+ * @return a new default initialized sprite
+ * @note color = bvec4_(255)
+ */
+O_EXTERN
+struct r_sprite r_sprite_new(int tex_cols, int tex_rows);
+
+/**
+ * @param sprite to convert
+ * @return a r_quad with the same pose, uv and s=color (t = u = v = vec4_(0))
+ */
+O_EXTERN
+struct r_quad r_sprite_to_quad(struct r_sprite sprite);
+
+/**
+ * @param quad to convert
+ * @return a sprite from the quad
+ * @note the uv rotation and t, u, v are dropped, the pose is reduced to position, size and angle,
+ *       s is clamped into the color
+ */
+O_EXTERN
+struct r_sprite r_sprite_from_quad(const struct r_quad *quad);
+
+
+//
+// inline helpers
+//
+
+/**
+ * @param sprite sprite to edit
+ * @param w, h size to set
+ */
+O_INLINE
+void r_sprite_size_set(struct r_sprite *sprite, float w, float h)
+{
+    sprite->size[0] = r_sprite_half_pack(w);
+    sprite->size[1] = r_sprite_half_pack(h);
+}
+
+/**
+ * @param sprite sprite to edit
+ * @param angle_rad rotation to set
+ */
+O_INLINE
+void r_sprite_angle_set(struct r_sprite *sprite, float angle_rad)
+{
+    sprite->angle = r_sprite_half_pack(angle_rad);
+}
+
+/**
+ * @param sprite sprite to edit
+ * @param uv_w, uv_h uv size to set
+ */
+O_INLINE
+void r_sprite_uv_size_set(struct r_sprite *sprite, float uv_w, float uv_h)
+{
+    sprite->uv_size[0] = r_sprite_half_pack(uv_w);
+    sprite->uv_size[1] = r_sprite_half_pack(uv_h);
+}
+
+#endif //R_SPRITE_H
@@ -0,0 +1,117 @@
+#ifndef R_STATE_H
+#define R_STATE_H
+
+/**
+ * @file state.h
+ *
+ * Central cache of the bound OpenGL state.
+ * The r module binds programs, textures, vertex arrays, buffers, framebuffers, the viewport and the blend mode
+ *      through these functions, so that redundant gl calls are skipped.
+ * Issued and skipped calls are counted in r_stats_frame()->gl_calls and ->gl_calls_skipped.
+ *
+ * Bindings are kept after a draw, instead of unbinding them.
+ * Call r_state_invalidate after changing the gl state outside of the r module.
+ * Call the r_state_*_deleted functions before deleting a gl object, gl unbinds deleted objects.
+ */
+
+#include "common.h"
+
+/** number of cached texture units */
+#define R_STATE_TEX_UNITS 8
+
+
+/**
+ * Forgets all cached state, so the next calls are issued for sure.
+ * Called by r_frame_begin
+ */
+O_EXTERN
+void r_state_invalidate(void);
+
+/**
+ * glUseProgram
+ * @param gl_program program handle or 0
+ */
+O_EXTERN
+void r_state_program(ou32 gl_program);
+
+/**
+ * glBindVertexArray
+ * @param gl_vao vertex array handle or 0
+ */
+O_EXTERN
+void r_state_vao(ou32 gl_vao);
+
+/**
+ * glBindBuffer(GL_ARRAY_BUFFER, ...)
+ * @param gl_vbo buffer handle or 0
+ */
+O_EXTERN
+void r_state_array_buffer(ou32 gl_vbo);
+
+/**
+ * glActiveTexture + glBindTexture(GL_TEXTURE_2D, ...)
+ * @param unit texture unit [0:R_STATE_TEX_UNITS)
+ * @param gl_tex texture handle or 0
+ */
+O_EXTERN
+void r_state_tex(int unit, ou32 gl_tex);
+
+/**
+ * glEnable|glDisable(GL_BLEND) and the default blend function
+ * @param on true to enable blending
+ */
+O_EXTERN
+void r_state_blend(bool on);
+
+/**
+ * glBindFramebuffer(GL_DRAW_FRAMEBUFFER, ...)
+ * @param gl_fbo framebuffer handle
+ */
+O_EXTERN
+void r_state_draw_framebuffer(ou32 gl_fbo);
+
+/**
+ * glBindFramebuffer(GL_READ_FRAMEBUFFER, ...)
+ * @param gl_fbo framebuffer handle
+ */
+O_EXTERN
+void r_state_read_framebuffer(ou32 gl_fbo);
+
+/**
+ * glViewport
+ * @param viewport as x, y, cols, rows
+ */
+O_EXTERN
+void r_state_viewport(ivec4 viewport);
+
+
+//
+// deleted objects
+//
+
+/**
+ * @param gl_program about to be deleted
+ */
+O_EXTERN
+void r_state_program_deleted(ou32 gl_program);
+
+/**
+ * @param gl_vao about to be deleted
+ * @param gl_vbo about to be deleted
+ */
+O_EXTERN
+void r_state_buffer_deleted(ou32 gl_vao, ou32 gl_vbo);
+
+/**
+ * @param gl_tex about to be deleted
+ */
+O_EXTERN
+void r_state_tex_deleted(ou32 gl_tex);
+
+/**
+ * @param gl_fbo about to be deleted
+ */
+O_EXTERN
+void r_state_framebuffer_deleted(ou32 gl_fbo);
+
+#endif //R_STATE_H
@@ -10,6 +10,8 @@
  */
 
 #include "o/common.h"
+#include "m/types/int.h"
+#include "m/types/flt.h"
 
 /**
  * @return A shared RTex which is a 1x1 white pixel.
@@ -60,6 +62,60 @@ oobj r_tex_kernel_plus3(bool normalized);
 O_EXTERN
 oobj r_tex_kernel_gauss9(bool normalized);
 
+/** number of kernels kept by r_tex_kernel_cached and r_tex_kernel_gauss_cached */
+#define R_TEX_KERNEL_CACHE_SIZE 16
+
+/**
+ * Cached version of RTex_new_kernel, keyed by all parameters.
+ * @param size cols, rows of the kernel
+ * @param set for all values
+ * @param plus if true, edges cleared to 0.0
+ * @param normalize if >0.0: normalize to given
+ * @return A shared RTex kernel from a small least recently used cache
+ * @note DO NOT delete it, will assert fail.
+ *       DO NOT change the internal buffer.
+ *       Only valid until R_TEX_KERNEL_CACHE_SIZE other kernels are requested, so use it directly.
+ */
+O_EXTERN
+oobj r_tex_kernel_cached(ivec2 size, float set, bool plus, float normalize);
+
+/**
+ * Cached version of RTex_new_kernel_gauss, keyed by all parameters.
+ * @param size cols, rows of the kernel
+ * @param sigma gauss factor for x and y axis, pass <=0 to auto scale (vec2_(-1))
+ * @param normalize, if <=0: center is 1.0
+ *                     else: normalized to given value (... 1.0f)
+ * @return A shared RTex kernel from a small least recently used cache
+ * @note DO NOT delete it, will assert fail.
+ *       DO NOT change the internal buffer.
+ *       Only valid until R_TEX_KERNEL_CACHE_SIZE other kernels are requested, so use it directly.
+ */
+O_EXTERN
+oobj r_tex_kernel_gauss_cached(ivec2 size, vec2 sigma, float normalize);
+
+/**
+ * Cached version of RTex_new_kernel_sep_box.
+ * @param n kernel size
+ * @param vertical if true, for a vertical pass
+ * @return A shared RTex kernel from the same cache as r_tex_kernel_cached
+ * @note DO NOT delete it, will assert fail.
+ *       Only valid until R_TEX_KERNEL_CACHE_SIZE other kernels are requested, so use it directly.
+ */
+O_EXTERN
+oobj r_tex_kernel_sep_box_cached(int n, bool vertical);
+
+/**
+ * Cached version of RTex_new_kernel_sep_gauss.
+ * @param n kernel size
+ * @param sigma gauss factor, pass <=0 to auto scale
+ * @param vertical if true, for a vertical pass
+ * @return A shared RTex kernel from the same cache as r_tex_kernel_cached
+ * @note DO NOT delete it, will assert fail.
+ *       Only valid until R_TEX_KERNEL_CACHE_SIZE other kernels are requested, so use it directly.
+ */
+O_EXTERN
+oobj r_tex_kernel_sep_gauss_cached(int n, float sigma, bool vertical);
+
 
 //
 // files
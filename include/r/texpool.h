@@ -0,0 +1,93 @@
+#ifndef R_TEXPOOL_H
+#define R_TEXPOOL_H
+
+/**
+ * @file texpool.h
+ *
+ * Pool of transient render targets (RTex), keyed by size and format.
+ * Effect chains (blur, bloom, contour, ...) can draw their intermediate and result textures from this pool,
+ *      so steady state effect rendering does not allocate textures or framebuffers on the gpu.
+ *
+ * An acquired RTex is in use until r_texpool_release or the next r_frame_begin.
+ * Afterwards it's free for the next acquire of the same size and format.
+ * Free targets that were not used for R_TEXPOOL_KEEP_FRAMES frames get deleted.
+ *
+ * The RTex_manip generators (RTex_blur, RTex_gauss, ...) use r_texpool_new for their result.
+ * Between r_texpool_transient_begin and _end, these results are pooled targets, instead of new RTex's:
+ *      r_texpool_transient_begin();
+ *      oobj blurred = RTex_gauss(scene, ivec2_(9), vec2_(-1), R_FORMAT_RGBA_8);
+ *      oobj bloom = RTex_add_scaled(blurred, vec4_(0), vec4_(2), R_FORMAT_RGBA_8);
+ *      r_texpool_transient_end();
+ *      RTex_blend(NULL, bloom, 0, 0);
+ *
+ * @note DO NOT delete pooled RTex's, will assert fail. Use r_texpool_release instead.
+ *       Pooled RTex's have an undefined content after acquiring.
+ */
+
+#include "o/common.h"
+#include "m/types/int.h"
+#include "r/format.h"
+
+/** free targets are deleted after this number of unused frames */
+#define R_TEXPOOL_KEEP_FRAMES 4
+
+
+/**
+ * @param size of the RTex
+ * @param format internal format of the RTex
+ * @return a pooled RTex, in use until r_texpool_release or the next r_frame_begin
+ * @note the viewport is reset to the full RTex
+ */
+O_EXTERN
+oobj r_texpool_acquire(ivec2 size, enum r_format format);
+
+/**
+ * Gives an acquired RTex back to the pool, before the next frame
+ * @param tex pooled RTex object, noop if NULL
+ */
+O_EXTERN
+void r_texpool_release(oobj tex);
+
+/**
+ * @param tex RTex object
+ * @return true if tex is owned by the pool
+ */
+O_EXTERN
+bool r_texpool_owns(oobj tex);
+
+/**
+ * Starts the transient mode, in which r_texpool_new acquires from the pool.
+ * Can be nested, must be closed with r_texpool_transient_end
+ */
+O_EXTERN
+void r_texpool_transient_begin(void);
+
+/**
+ * Ends the transient mode
+ */
+O_EXTERN
+void r_texpool_transient_end(void);
+
+/**
+ * Creates a new RTex for the RTex_manip generators
+ * @param parent to inherit from, if not in the transient mode
+ * @param size of the RTex
+ * @param format internal format of the RTex
+ * @return in the transient mode, r_texpool_acquire, else RTex_new_ex
+ */
+O_EXTERN
+oobj r_texpool_new(oobj parent, ivec2 size, enum r_format format);
+
+/**
+ * Deletes all free targets
+ */
+O_EXTERN
+void r_texpool_clear(void);
+
+/**
+ * @return number of pooled targets (in use and free)
+ */
+O_EXTERN
+int r_texpool_num(void);
+
+#endif //R_TEXPOOL_H
@@ -0,0 +1,186 @@
+#ifndef S_SRESAMPLER_H
+#define S_SRESAMPLER_H
+
+/**
+ * @file SResampler.h
+ *
+ * Object
+ *
+ * Streaming resampler from a src spec into a dst spec (frequency and channels).
+ * Carries its filter history between calls, so that consecutive chunks are resampled without discontinuities.
+ *
+ * It works in a pull model, like STrack_retr:
+ *      SResampler_src_ticks returns the src span needed for a dst span,
+ *      SResampler_run resamples that src span into the dst span.
+ * A dst span is consecutive, if its time follows the last one, else the history is reset (a seek).
+ * Because of the filter width, the src span reaches a few ticks ahead of the dst span,
+ *      but each src tick is requested only once, while consecutive.
+ *
+ * Channels are up/down mixed: a mono src is copied into all channels, a mono dst gets the average.
+ * Else dst channel c gets src channel c%src_channels, or the average of all src channels k with k%dst_channels==c.
+ *
+ * SResampler_run does not allocate, if reserved for the dst span length (SResampler_reserve).
+ */
+
+
+#include "o/OObj.h"
+#include "common.h"
+
+/** object id */
+#define SResampler_ID OObj_ID "SResampler"
+
+enum SResampler_quality {
+    // linear interpolation, cheap but aliases
+    SResampler_LINEAR,
+    // kaiser windowed sinc, polyphase table with SResampler_SINC_PHASES
+    SResampler_SINC,
+    SResampler_NUM_QUALITIES
+};
+
+/** default quality used by STrack's */
+#define SResampler_QUALITY_DEFAULT SResampler_SINC
+
+/** sinc zero crossings on each side of the filter (for a cutoff of 1.0) */
+#define SResampler_SINC_ZEROS 8
+
+/** sinc polyphase table resolution, linear interpolated in between */
+#define SResampler_SINC_PHASES 64
+
+
+typedef struct {
+    OObj super;
+
+    struct s_audio_spec dst_spec, src_spec;
+    enum SResampler_quality quality;
+
+    // filter taps (a multiple of 4 for sinc) and taps before the src position
+    int taps, lead;
+
+    // (SResampler_SINC_PHASES+1) * taps filter coefficients, NULL for linear or equal frequencies
+    float *table;
+    // taps coefficients, interpolated from the table for the current fraction
+    float *coef;
+
+    // next consecutive dst time, or -1 after a reset
+    osize dst_next;
+    // next src tick to pull
+    osize src_next;
+
+    // planar, taps + work_ticks per dst channel
+    // the first taps ticks are the history (the ticks before src_next)
+    float *work;
+    osize work_ticks;
+} SResampler;
+
+
+/**
+ * Initializes the object
+ * @param obj SResampler object
+ * @param parent to inherit from
+ * @param dst_spec spec of the output
+ * @param src_spec spec of the input
+ * @param quality SResampler_LINEAR or SResampler_SINC
+ * @return obj casted as SResampler
+ */
+O_EXTERN
+SResampler *SResampler_init(oobj obj, oobj parent, struct s_audio_spec dst_spec, struct s_audio_spec src_spec,
+                            enum SResampler_quality quality);
+
+/**
+ * Creates a new the SResampler object
+ * @param parent to inherit from
+ * @param dst_spec spec of the output
+ * @param src_spec spec of the input
+ * @param quality SResampler_LINEAR or SResampler_SINC
+ * @return The new object
+ */
+O_INLINE
+SResampler *SResampler_new(oobj parent, struct s_audio_spec dst_spec, struct s_audio_spec src_spec,
+                           enum SResampler_quality quality)
+{
+    OObj_DECL_IMPL_NEW(SResampler, parent, dst_spec, src_spec, quality);
+}
+
+
+//
+// object functions
+//
+
+/**
+ * @param obj SResampler object
+ * @return spec of the output
+ */
+OObj_DECL_GET(SResampler, struct s_audio_spec, dst_spec)
+
+/**
+ * @param obj SResampler object
+ * @return spec of the input
+ */
+OObj_DECL_GET(SResampler, struct s_audio_spec, src_spec)
+
+/**
+ * @param obj SResampler object
+ * @return SResampler_LINEAR or SResampler_SINC
+ */
+OObj_DECL_GET(SResampler, enum SResampler_quality, quality)
+
+/**
+ * Reconfigures the resampler, noop if nothing changed. Else resets the history
+ * @param obj SResampler object
+ * @param dst_spec spec of the output
+ * @param src_spec spec of the input
+ * @param quality SResampler_LINEAR or SResampler_SINC
+ * @note allocates the filter table
+ */
+O_EXTERN
+void SResampler_setup(oobj obj, struct s_audio_spec dst_spec, struct s_audio_spec src_spec,
+                      enum SResampler_quality quality);
+
+/**
+ * Clears the history, the next dst span starts from silence
+ * @param obj SResampler object
+ */
+O_EXTERN
+void SResampler_reset(oobj obj);
+
+/**
+ * Preallocates the work buffer, so that SResampler_run does not allocate for dst spans up to dst_len
+ * @param obj SResampler object
+ * @param dst_len number of dst ticks
+ */
+O_EXTERN
+void SResampler_reserve(oobj obj, osize dst_len);
+
+/**
+ * @param obj SResampler object
+ * @param dst_len number of dst ticks
+ * @return maximal number of src ticks, that SResampler_src_ticks may return for dst_len
+ */
+O_EXTERN
+osize SResampler_src_ticks_max(oobj obj, osize dst_len);
+
+/**
+ * Returns the src span needed to resample the dst span
+ * @param obj SResampler object
+ * @param dst_len number of dst ticks
+ * @param dst_time time of the first dst tick
+ * @param out_src_time time of the first needed src tick
+ * @return number of needed src ticks, may be 0
+ */
+O_EXTERN
+osize SResampler_src_ticks(oobj obj, osize dst_len, osize dst_time, osize *out_src_time);
+
+/**
+ * Resamples the src span, returned by SResampler_src_ticks, into the dst span
+ * @param obj SResampler object
+ * @param out_dst dst_len * dst_spec.channels floats
+ * @param dst_len number of dst ticks
+ * @param dst_time time of the first dst tick
+ * @param src src_len * src_spec.channels floats, as returned by SResampler_src_ticks
+ * @param src_len number of src ticks, as returned by SResampler_src_ticks
+ */
+O_EXTERN
+void SResampler_run(oobj obj, float *out_dst, osize dst_len, osize dst_time, const float *src, osize src_len);
+
+
+#endif //S_SRESAMPLER_H
@@ -16,9 +16,20 @@
  * Because they derive from the special object OJoin, do not directly call o_del.
  * Delete the parent instead!
  *
+ * Real time path:
+ * STrack_play*, STrack_played_remove, STrack_played_amp_set and STrack_reset do not lock the STrack.
+ * They push a command into a lock free single producer single consumer ring buffer,
+ *      which is drained by the retr'ieving thread (the audio callback) at the begin of the next retr.
+ * (Multiple producer threads are serialized by a producer lock, which the retr'ieving thread never takes.)
+ * The retr'ieving thread does not allocate or free:
+ *      the played tracks are kept alive by a hold object created by the producer,
+ *      scratch buffers are preallocated for s_audio_block_ticks,
+ *      and ended tracks and SFilter's are passed back to be deleted by STrack_collect (see s_update).
+ *
  */
 
 #include "s/common.h"
+#include "s/SResampler.h"
 #include "o/OJoin.h"
 
 /** object id */
@@ -46,12 +57,43 @@ typedef osize (*STrack__duration_fn)(oobj obj);
 // protected
 struct STrack__played {
     osize handle_idx;
-    oobj weak;
-    oobj opt_parent;
+
+    // played STrack and a parent of it (OJoin), keeping it alive while playing
+    oobj track;
+    oobj hold;
+
+    // if false, stops playing if only holds are left as parents of the track (deleted by the user)
+    bool keep;
+
     osize start_ticks;
     float amp;
+
+    // higher is more important, used by STrackArena to choose the mixed tracks
+    int priority;
+
+    // amp used at the end of the last retr, changes are ramped over a block to avoid clicks
+    float amp_mixed;
+
+    // virtual: fades out and is then skipped, while its time keeps advancing (set by an STrackArena)
+    bool virtualized;
+
+    // fades out during the next retr and is done afterwards (stolen by an STrackArena)
+    bool stopping;
+
+    // ended or removed, waits to be passed back for STrack_collect
+    bool done;
 };
 
+// protected
+struct STrack__scratch {
+    void *data;
+    osize size;
+    bool in_use;
+};
+
+// protected, see STrack.c
+struct STrack__queue;
+
 typedef struct
 {
     OJoin super;
@@ -68,8 +110,19 @@ typedef struct
     bool endable;
 
     // OArray of registered tracks to be played (struct STrack__played)
+    // only used by the retr'ieving thread, changes are passed through the queue
     oobj played;
-    osize played_idx;
+
+    // command and collect ring buffers, and the hold counter
+    struct STrack__queue *queue;
+
+    // preallocated buffers for retr, see STrack_reserve
+    struct STrack__scratch scratch_mix;
+    struct STrack__scratch scratch_resample;
+
+    // SResampler into the wanted spec of STrack_retr, created if the specs differ
+    oobj resampler;
+    enum SResampler_quality resample_quality;
 
     // OArray of applied SFilter's
     oobj filter;
@@ -194,8 +247,17 @@ double STrack_duration(oobj obj)
  */
 OObj_DECL_GETSET(STrack, bool, endable)
 
+/**
+ * @param obj STrack object
+ * @return quality of the SResampler used by STrack_retr, default is SResampler_QUALITY_DEFAULT
+ * @note applied in the next STrack_reserve or retr, which then allocates the filter
+ */
+OObj_DECL_GETSET(STrack, enum SResampler_quality, resample_quality)
+
 /**
  * Calls the vfunc and will convert the data to the wanted spec, if unequal.
+ * Converts with a streaming SResampler, so consecutive retr's (time_ticks following the last one) are seamless.
+ *      (A track played on multiple tracks in different specs or times, resets the resampler on each switch)
  * Filled with silence (0.0f) if no data is available.
  * After data has been retrieved, it will get filtered with the applied SFilter's (STrack_filters)
  * @param obj STrack object
@@ -302,12 +364,33 @@ void STrack_seekthrough_all(oobj obj, const struct s_audio_spec *opt_spec)
 
 
 /**
- * Reset time and remove all played tracks
+ * Preallocates the scratch buffers of STrack_retr, so that retr'ieving up to len ticks does not allocate.
+ * Larger retr's (like STrack_retr_span) allocate temporary buffers instead.
  * @param obj STrack object
+ * @param len number of ticks in the wanted spec
+ * @param opt_spec the wanted specification of STrack_retr, if NULL uses system specs
+ * @note STrack_new reserves for s_audio_block_ticks, STrack_play* for the played track
+ */
+O_EXTERN
+void STrack_reserve(oobj obj, osize len, const struct s_audio_spec *opt_spec);
+
+/**
+ * Remove all played tracks
+ * @param obj STrack object
+ * @note applied on the next retr
  */
 O_EXTERN
 void STrack_reset(oobj obj);
 
+/**
+ * Deletes the holds of ended or removed tracks and expired SFilter's,
+ *      which are passed back by the retr'ieving thread, so that it never frees.
+ * @param obj STrack object
+ * @note called by the other STrack_play* and STrack_played_* functions, s_update calls it for s_audio_track
+ */
+O_EXTERN
+void STrack_collect(oobj obj);
+
 
 /**
  * Extended play function, using time ticks instead of seconds
@@ -315,12 +398,14 @@ void STrack_reset(oobj obj);
  * @param track STrack object to be played
  * @param time_ticks start in time ticks (freq), added to the current time
  * @param amp amplification, 1.0f for simple copy
- * @param keep if true, this obj STrack will create an object as new additional parent for the track,
- *             deleted if played to end
+ * @param keep if true, the track keeps playing until its end, even if the user deleted it.
+ *             else playing stops, if the user deleted the track
+ * @param priority higher is more important, see STrack_played_priority_set, applied together with the play
  * @return handle for the STrack_played_* functions
+ * @note the command is applied on the next retr, time_ticks is relative to the time of that retr
  */
 O_EXTERN
-osize STrack_play_ex(oobj obj, oobj track, osize time_ticks, float amp, bool keep);
+osize STrack_play_ex(oobj obj, oobj track, osize time_ticks, float amp, bool keep, int priority);
 
 /**
  * Plays a sound/music once, will be removed at the end
@@ -334,7 +419,7 @@ O_INLINE
 osize STrack_play(oobj obj, oobj track, double time_seconds, float amp)
 {
     assert(time_seconds>=0);
-    return STrack_play_ex(obj, track, (osize) (time_seconds * STrack_spec(obj).freq), amp, false);
+    return STrack_play_ex(obj, track, (osize) (time_seconds * STrack_spec(obj).freq), amp, false, 0);
 }
 
 /**
@@ -349,7 +434,7 @@ O_INLINE
 osize STrack_play_keep(oobj obj, oobj track, double time_seconds, float amp)
 {
     assert(time_seconds>=0);
-    return STrack_play_ex(obj, track, (osize) (time_seconds * STrack_spec(obj).freq), amp, true);
+    return STrack_play_ex(obj, track, (osize) (time_seconds * STrack_spec(obj).freq), amp, true, 0);
 }
 
 
@@ -357,12 +442,13 @@ osize STrack_play_keep(oobj obj, oobj track, double time_seconds, float amp)
  * @param obj STrack object
  * @param handle from STrack_play* function
  * @return true if the track is available and not removed yet
+ * @note tracks that ended are available, until the retr'ieving thread passed them back (STrack_collect)
  */
 O_EXTERN
 bool STrack_played_available(oobj obj, osize handle);
 
 /**
- * Removes a played track from the list, stopping the audio directly
+ * Removes a played track from the list, stopping the audio on the next retr
  * @param obj STrack object
  * @param handle from STrack_play* function
  * @return true if the track was available and is now removed
@@ -375,10 +461,21 @@ bool STrack_played_remove(oobj obj, osize handle);
  * @param handle from STrack_play* function
  * @param amp amplification, 1.0f for simple copy
  * @return true if the track was available
+ * @note applied on the next retr
  */
 O_EXTERN
 bool STrack_played_amp_set(oobj obj, osize handle, float amp);
 
+/**
+ * @param obj STrack object
+ * @param handle from STrack_play* function
+ * @param priority higher is more important, default is 0
+ * @return true if the track was available
+ * @note applied on the next retr, used by STrackArena to choose which tracks are mixed or stolen
+ */
+O_EXTERN
+bool STrack_played_priority_set(oobj obj, osize handle, int priority);
+
 
 /**
  * @param obj STrack object
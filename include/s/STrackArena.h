@@ -6,8 +6,13 @@
  *
  * Object (derives STrack)
  *
- * STrack implementation that only mixe's up to "limit" played tracks.
- * If a new track is played and limit is already reached, the oldest track is discarded.
+ * STrack implementation that only mixe's up to "real_limit" played tracks.
+ * The others are virtual: not retr'ieved nor mixed, but their time keeps advancing,
+ *     so they fade in at the right position, when they are mixed again.
+ * Tracks are ranked by their priority (see STrack_played_priority_set), then their amp, then newer first.
+ * Tracks with an amp at or below virtual_amp are always virtual.
+ * If more than "limit" tracks are played, the lowest ranked are stolen: faded out within one block and discarded.
+ * The real voice budget can follow the cpu load, see STrackArena_load_target_set.
  * Useful to reduce the mixing overhead when playing a lot of tracks in parallel.
  */
 
@@ -16,11 +21,43 @@
 /** object id */
 #define STrackArena_ID STrack_ID "Arena"
 
+/** default for virtual_amp, -60 dB */
+#define STrackArena_VIRTUAL_AMP_DEFAULT 0.001f
+
+
+/**
+ * Voices of the last retr and the adapted budget, see STrackArena_stats
+ */
+struct STrackArena_stats {
+    // mixed and virtual tracks
+    int real_voices, virtual_voices;
+
+    // tracks stolen to stay in limit, counted since creation
+    osize stolen;
+
+    // current number of mixable tracks, real_limit or less if the load is too high
+    int real_budget;
+
+    // smoothed time of a retr relative to the time of the retr'ieved block
+    float load;
+};
 
 typedef struct {
     STrack super;
 
+    // maximal played tracks, real + virtual
     int limit;
+
+    // maximal mixed tracks
+    int real_limit;
+
+    // tracks at or below are virtual
+    float virtual_amp;
+
+    // if > 0, the real budget is reduced to keep the load below (0.5 for half of the block time)
+    float load_target;
+
+    struct STrackArena_stats stats;
 } STrackArena;
 
 
@@ -32,7 +69,7 @@ typedef struct {
  * @param limit maximal parallel played tracks
  * @param opt_spec specification to be used, NULL for system spec
  * @return The new object
- * @note inits endable to false and time_ticks_auto to true
+ * @note inits endable to false and time_ticks_auto to true, real_limit to limit (so no virtual tracks)
  */
 O_EXTERN
 STrackArena *STrackArena_new_super(osize object_size, oobj parent, int limit, const struct s_audio_spec *opt_spec);
@@ -43,7 +80,7 @@ STrackArena *STrackArena_new_super(osize object_size, oobj parent, int limit, co
  * @param limit maximal parallel played tracks
  * @param opt_spec specification to be used, NULL for system spec
  * @return The new object
- * @note inits endable to false and time_ticks_auto to true
+ * @note inits endable to false and time_ticks_auto to true, real_limit to limit (so no virtual tracks)
  */
 O_INLINE
 STrackArena *STrackArena_new(oobj parent, int limit, const struct s_audio_spec *opt_spec)
@@ -57,8 +94,8 @@ STrackArena *STrackArena_new(oobj parent, int limit, const struct s_audio_spec *
 
 /**
  * virtual function.
- * First checks if tracks need to be removed to clamp to the limit,
- * then calls STrack__v_retr to mix the remaining.
+ * Ranks the played tracks, steals the ones over limit and virtualizes the ones over the real budget,
+ * then calls STrack__v_retr to mix the real ones.
  * @param obj STrackArena object
  * @param out_data to write into
  * @param len frequency ticks
@@ -73,11 +110,49 @@ bool STrackArena__v_retr(oobj obj, float *out_data, osize len, osize time_ticks)
 //
 
 
+/**
+ * Plays a track with a priority
+ * @param obj STrackArena object
+ * @param track STrack object to be played
+ * @param time_seconds start in seconds, added to the current time
+ * @param amp amplification, 1.0f for simple copy
+ * @param priority higher is more important, see STrack_played_priority_set
+ * @return handle for the STrack_played_* functions
+ */
+O_EXTERN
+osize STrackArena_play(oobj obj, oobj track, double time_seconds, float amp, int priority);
+
+/**
+ * @param obj STrackArena object
+ * @return voices of the last retr and the adapted budget
+ */
+O_EXTERN
+struct STrackArena_stats STrackArena_stats(oobj obj);
+
 /**
  * @param obj OStreamArena object
- * @return maximal parallel played tracks
+ * @return maximal parallel played tracks, real + virtual
  */
 OObj_DECL_GETSET(STrackArena, int, limit)
 
+/**
+ * @param obj STrackArena object
+ * @return maximal mixed tracks, the others are virtual
+ */
+OObj_DECL_GETSET(STrackArena, int, real_limit)
+
+/**
+ * @param obj STrackArena object
+ * @return tracks with an amp at or below are always virtual (default is STrackArena_VIRTUAL_AMP_DEFAULT)
+ */
+OObj_DECL_GETSET(STrackArena, float, virtual_amp)
+
+/**
+ * @param obj STrackArena object
+ * @return if > 0, the real budget is reduced while the retr takes longer than this part of the block time.
+ *         0 (default) always uses real_limit
+ */
+OObj_DECL_GETSET(STrackArena, float, load_target)
+
 
 #endif //S_STRACKARENA_H
@@ -0,0 +1,202 @@
+#ifndef S_STRACKOGGSTREAM_H
+#define S_STRACKOGGSTREAM_H
+
+/**
+ * @file STrackOggStream.h
+ *
+ * Object (derives STrack)
+ *
+ * Streams a .ogg (music) file instead of decoding it completely like s_ogg_load_track.
+ * Only the compressed file data is kept in memory.
+ * It is decoded ahead into a small ring buffer (STrackOggStream_RING_MS_DEFAULT) by a dedicated decoding thread.
+ * The retr only copies out of the ring buffer, so the audio thread never decodes, locks the decoder or allocates.
+ *
+ * The spec of the track is the native spec of the .ogg file, STrack_retr converts if needed.
+ * A retr with a time_ticks, that is not in the ring buffer, seeks the decoder (stb_vorbis_seek).
+ * Until the decoder has refilled the ring buffer, the track returns silence (counted as underrun).
+ * Use STrackOggStream_seek to seek before playing.
+ *
+ * The decoding thread runs while streams exist and refills all ring buffers.
+ * The retr wakes it up (lock free) when a ring buffer drops below half,
+ *      so the refill does not depend on the main thread and survives main thread stalls, like level loads.
+ * Without MIA_OPTION_THREAD, STrackOggStream_update (called by s_update for all streams) decodes synchronous,
+ *      so the main loop must run at least once per ring buffer duration, else the stream underruns.
+ *
+ * For offline retr's (like STrack_retr_all) set STrackOggStream_blocking_set to decode inside the retr.
+ */
+
+#include "STrack.h"
+
+/** object id */
+#define STrackOggStream_ID STrack_ID "OggStream"
+
+/** default ring buffer duration in millis */
+#define STrackOggStream_RING_MS_DEFAULT 250
+
+// protected, see STrackOggStream.c
+struct STrackOggStream__ring;
+
+typedef struct {
+    STrack super;
+
+    // OArray of the compressed .ogg file data
+    oobj data;
+
+    // opened on data, only used by the decoder (stb_vorbis *)
+    void *vorbis;
+
+    // stream length in ticks
+    osize length;
+
+    // ring buffer of decoded pcm data, ring_ticks * spec.channels floats
+    float *ring_data;
+    osize ring_ticks;
+
+    // read, write positions, seek requests and stats, shared with the decoding thread
+    struct STrackOggStream__ring *ring;
+
+    // if true, retr decodes itself on an underrun (for offline retr's)
+    bool blocking;
+} STrackOggStream;
+
+
+/**
+ * Creates a new the STrackOggStream object.
+ * This function can be used to init an derived OJoin (for thread safe stuff as an example)
+ * @param object_size size to allocate (asserts >= sizeof(STrackOggStream)
+ * @param parent to inherit from
+ * @param data .ogg file data, copied into the track
+ * @param data_size size of data in bytes
+ * @param ring_ticks size of the ring buffer in ticks, <=0 for STrackOggStream_RING_MS_DEFAULT
+ * @return The new object or NULL if the data could not be opened as .ogg
+ * @note the ring buffer is filled synchronous before returning, so the track is ready to play
+ */
+O_EXTERN
+struct oobj_opt STrackOggStream_new_super(osize object_size, oobj parent, const void *data, osize data_size,
+                                          osize ring_ticks);
+
+/**
+ * Creates a new the STrackOggStream object.
+ * @param parent to inherit from
+ * @param data .ogg file data, copied into the track
+ * @param data_size size of data in bytes
+ * @return The new object or NULL if the data could not be opened as .ogg
+ */
+O_INLINE
+struct oobj_opt STrackOggStream_new(oobj parent, const void *data, osize data_size)
+{
+    return STrackOggStream_new_super(sizeof(STrackOggStream), parent, data, data_size, 0);
+}
+
+/**
+ * Creates a new the STrackOggStream object, by reading the .ogg file into memory
+ * @param parent to inherit from
+ * @param file .ogg file to stream
+ * @return The new object or NULL if failed
+ */
+O_EXTERN
+struct oobj_opt STrackOggStream_new_file(oobj parent, const char *file);
+
+
+//
+// virtual implementations:
+//
+
+/**
+ * Default deletor, waits for a running decode and closes the decoder
+ * @param obj STrackOggStream object
+ */
+O_EXTERN
+void STrackOggStream__v_del(oobj obj);
+
+/**
+ * virtual function
+ * First calls super STrack__v_retr to mix played tracks.
+ * Then mix's in the decoded data from the ring buffer, seeks if time_ticks is not in the ring buffer.
+ * @param obj STrackOggStream object
+ * @param out_data to write into
+ * @param len frequency ticks
+ * @param time_ticks current track time
+ * @return true if end was reached
+ */
+O_EXTERN
+bool STrackOggStream__v_retr(oobj obj, float *out_data, osize len, osize time_ticks);
+
+/**
+ * Virtual getter for an optional duration
+ * @param obj STrackOggStream object
+ * @return duration from the stream length
+ */
+O_EXTERN
+osize STrackOggStream__v_duration(oobj obj);
+
+
+//
+// object functions
+//
+
+/**
+ * @param obj STrackOggStream object
+ * @return if true, retr decodes itself on an underrun instead of returning silence (default is false)
+ * @note useful for offline retr's, like STrack_retr_all. Do not set while played by the audio thread.
+ */
+OObj_DECL_GET(STrackOggStream, bool, blocking)
+
+/**
+ * @param obj STrackOggStream object
+ * @param set if true, retr decodes itself on an underrun instead of returning silence
+ * @note waits for a running decode
+ */
+O_EXTERN
+void STrackOggStream_blocking_set(oobj obj, bool set);
+
+/**
+ * @param obj STrackOggStream object
+ * @return number of ticks, that could not be retr'ieved in time (or while seeking)
+ */
+O_EXTERN
+osize STrackOggStream_underruns(oobj obj);
+
+/**
+ * @param obj STrackOggStream object
+ * @return number of ticks decoded ahead in the ring buffer, 0 while a seek is pending
+ */
+O_EXTERN
+osize STrackOggStream_buffered(oobj obj);
+
+/**
+ * @param obj STrackOggStream object
+ * @return resident memory in bytes: compressed data, ring buffer and decoder state
+ */
+O_EXTERN
+osize STrackOggStream_memory(oobj obj);
+
+/**
+ * Seeks the decoder, so that a retr from time_ticks on can be served without underruns
+ * @param obj STrackOggStream object
+ * @param time_ticks stream time to seek to
+ * @param wait if true, waits until the ring buffer is refilled
+ */
+O_EXTERN
+void STrackOggStream_seek(oobj obj, osize time_ticks, bool wait);
+
+/**
+ * Wakes up the decoding thread if the ring buffer has free space or a seek is requested.
+ * Without MIA_OPTION_THREAD, decodes synchronous instead.
+ * @param obj STrackOggStream object
+ * @note called by s_update for all streams, not needed with MIA_OPTION_THREAD, the retr wakes the decoder itself.
+ *       Like STrackOggStream_seek, _wait and _blocking_set, call it from the main thread.
+ */
+O_EXTERN
+void STrackOggStream_update(oobj obj);
+
+/**
+ * Waits for a running decode and does the pending decoding work of this stream on the calling thread,
+ *      so the ring buffer is filled (or a seek done) afterwards.
+ * @param obj STrackOggStream object
+ */
+O_EXTERN
+void STrackOggStream_wait(oobj obj);
+
+
+#endif //S_STRACKOGGSTREAM_H
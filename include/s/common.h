@@ -24,6 +24,30 @@ struct s_audio_spec_ex {
     int samples;
 };
 
+/**
+ * Measurements of the audio callback, see s_audio_instrument_set
+ */
+struct s_audio_stats {
+    // number of recorded callbacks (the percentiles use the last S_AUDIO_STATS_WINDOW of them)
+    osize callbacks;
+
+    // callback durations
+    double p50_ms, p95_ms, p99_ms, max_ms;
+
+    // time of a callback block (samples / freq), the callback should stay well below
+    double budget_ms;
+
+    // callbacks that took longer than budget_ms
+    osize overruns;
+
+    // calls of the allocator made on the audio thread, should stay 0.
+    // Only counted with MIA_OPTION_ALLOCATOR_COUNT, see o_allocator_thread_calls
+    osize allocations;
+};
+
+/** number of callback durations used for the percentiles in struct s_audio_stats */
+#define S_AUDIO_STATS_WINDOW 1024
+
 /**
  * @return default values for the audio spec's.
  * @note dependend on the platform, for example MIA_PLATFORM_EMSCRIPTEN reduces the frequency and sample size
@@ -146,6 +170,50 @@ void s_audio_play(void);
 O_EXTERN
 oobj s_audio_track(void);
 
+/**
+ * @return ticks of an audio callback block (samples of the opened device or the init spec)
+ * @note STrack's preallocate their scratch buffers for this size, so the callback does not need to allocate
+ */
+O_EXTERN
+int s_audio_block_ticks(void);
+
+/**
+ * Frees the resources of tracks that ended or were removed on the audio thread.
+ * The audio thread never frees, it passes them back. Call this once per frame (a_app does)
+ * Also starts the decoding jobs of all STrackOggStream's (STrackOggStream_update).
+ * @note STrack_play* also collect the resources of their STrack
+ */
+O_EXTERN
+void s_update(void);
+
+/**
+ * Enables the instrumented mode of the audio callback (default is off).
+ * Records the callback durations and counts the allocations on the audio thread.
+ * @param set true to enable, false to disable. Enabling resets the stats
+ */
+O_EXTERN
+void s_audio_instrument_set(bool set);
+
+/**
+ * @return true if the instrumented mode is enabled
+ */
+O_EXTERN
+bool s_audio_instrument(void);
+
+/**
+ * @return the measurements of the instrumented mode
+ * @note sorts a copy of the recorded durations, so not for hot loops
+ */
+O_EXTERN
+struct s_audio_stats s_audio_stats(void);
+
+/**
+ * Logs the stats as info
+ * @param stats to log, see s_audio_stats
+ */
+O_EXTERN
+void s_audio_stats_log(struct s_audio_stats stats);
+
 
 /**
  * Opens the hardware audio device for record.
@@ -210,7 +278,9 @@ osize s_play_keep(oobj track, double time_seconds, float amp);
  * @param mix_amp amplification for the mix data (default is 1.0f)
  * @param channels from the spec
  * @param len number of ticks
- * @note not to be confused with math mix functions. This mix works by adding and clamping
+ * @note not to be confused with math mix functions. This mix works by adding without clamping,
+ *       the audio callback limits the final mix once (see s/mix.h).
+ *       Long buffers are mixed with o_parallel_for, audio callback sized buffers inline.
  */
 O_EXTERN
 void s_mix_into(float * restrict in_out_data, const float * restrict mix_data, float mix_amp, int channels, osize len);
@@ -225,7 +295,9 @@ osize s_resample_dst_ticks(struct s_audio_spec dst_spec, struct s_audio_spec src
 }
 
 /**
- * Resamples a track
+ * Resamples a track in one go, the dst has s_resample_dst_ticks ticks
+ * @note allocates a temporary SResampler (SResampler_QUALITY_DEFAULT).
+ *       Use an SResampler directly to resample consecutive chunks without discontinuities.
  */
 O_EXTERN
 void s_resample(struct s_audio_spec dst_spec, struct s_audio_spec src_spec,
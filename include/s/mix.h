@@ -0,0 +1,67 @@
+#ifndef S_MIX_H
+#define S_MIX_H
+
+/**
+ * @file mix.h
+ *
+ * Kernels for the mixing bus.
+ * Tracks are summed up in float without clamping, so nested STrack's do not clip each other.
+ * The audio callback limits the final mix once with s_mix_limit.
+ *
+ * Uses SSE or NEON if available.
+ * Buffers are interleaved, num is the number of floats, len the number of ticks.
+ */
+
+#include "common.h"
+
+
+/**
+ * Knee of s_mix_limit, samples below pass unchanged
+ */
+#define S_MIX_LIMIT_KNEE 0.8f
+
+
+/**
+ * Adds src into bus, scaled by gain
+ * @param num number of floats (ticks * channels)
+ */
+O_EXTERN
+void s_mix_add(float *restrict bus, const float *restrict src, float gain, osize num);
+
+/**
+ * Adds src into bus, scaled by a linear gain ramp
+ * @param gain for the first tick
+ * @param step added to the gain for each tick, so tick i uses gain + i*step
+ * @param channels from the spec
+ * @param len number of ticks
+ */
+O_EXTERN
+void s_mix_add_ramp(float *restrict bus, const float *restrict src, float gain, float step, int channels, osize len);
+
+/**
+ * Scales data by gain
+ * @param num number of floats (ticks * channels)
+ */
+O_EXTERN
+void s_mix_gain(float *data, float gain, osize num);
+
+/**
+ * Scales data by a linear gain ramp
+ * @param gain for the first tick
+ * @param step added to the gain for each tick, so tick i uses gain + i*step
+ * @param channels from the spec
+ * @param len number of ticks
+ */
+O_EXTERN
+void s_mix_gain_ramp(float *data, float gain, float step, int channels, osize len);
+
+/**
+ * Soft limiter for the final mix.
+ * Samples below S_MIX_LIMIT_KNEE pass unchanged, louder ones are compressed smoothly into [-1 : +1]
+ * @param num number of floats (ticks * channels)
+ */
+O_EXTERN
+void s_mix_limit(float *data, osize num);
+
+
+#endif //S_MIX_H
@@ -20,6 +20,7 @@ struct oobj_opt s_ogg_load_array(oobj parent, const char *file, const struct s_a
 /**
  * Loads a .ogg (music) file and resamples it to the used frequency (if neccessary)
  * @return STrackArray of the resulting loaded track or NULL if failed
+ * @note decodes the whole file into memory, see STrackOggStream to stream long music files
  */
 O_EXTERN
 struct oobj_opt s_ogg_load_track(oobj parent, const char *file, const struct s_audio_spec *opt_spec);
@@ -17,6 +17,7 @@
 //
 
 #include "common.h"
+#include "mix.h"
 #include "ogg.h"
 #include "wav.h"
 
@@ -27,9 +28,11 @@
 
 #include "SFilter.h"
 #include "SFilterFade.h"
+#include "SResampler.h"
 #include "STrack.h"
 #include "STrackArena.h"
 #include "STrackArray.h"
+#include "STrackOggStream.h"
 
 
 #endif //S_S_H
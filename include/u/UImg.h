@@ -7,6 +7,7 @@
  * Object
  *
  * An image to load, save and manipulate.
+ * Pixel operations on large images are split across cores with o_parallel_for (o/parallel.h).
  *
  * Operators:
  * o_num -> UImg_num
@@ -102,6 +103,18 @@ UImg* UImg_new_0(oobj parent, int cols, int rows, enum r_format format);
 O_EXTERN
 struct oobj_opt UImg_new_file(oobj parent, const char* file);
 
+/**
+ * Creates a new the UImg object, which loads the image in the background.
+ * Returns an empty (0x0) image right away, data and size are set once decoded.
+ * @param parent to inherit from
+ * @param file to load the image from, either .jpg or .png
+ * @return The new object, check UImg_size or RTexLoader_idle to know when loaded
+ * @note uses R_FORMAT_RGBA_8 and RTexLoader_default, see r/RTexLoader.h.
+ *       If the file failed to read, the image stays empty.
+ */
+O_EXTERN
+UImg* UImg_new_file_async(oobj parent, const char* file);
+
 /**
  * Creates a new the UImg object.
  * @param parent to inherit from
@@ -458,6 +471,7 @@ UImg* UImg_collage(const oobj* srcs, int n,
 /**
  * Creates a distance transform of the given UImg.
  * Uses .r>0 for the distance in general.
+ * Without full, distances saturate at 255.
  * @param obj UImg object
  * @param full if true, also diagonal checks are done
  * @return UImg allocated on obj, as R_FORMAT_R_8
@@ -465,6 +479,29 @@ UImg* UImg_collage(const oobj* srcs, int n,
 O_EXTERN
 UImg* UImg_distance_transform(oobj obj, bool full);
 
+/**
+ * Creates a box blurred copy of the UImg, as reference for RTex_blur.
+ * Separable running sum, so the costs are independent of the blur size.
+ * Pixels outside are clamped to the edge.
+ * @param obj UImg object
+ * @param size kernel size for each axis, the window for a pixel p is [p - size/2, p - size/2 + size - 1]
+ * @return UImg allocated on obj, with the same format
+ */
+O_EXTERN
+UImg* UImg_blur(oobj obj, ivec2 size);
+
+/**
+ * Creates a gauss blurred copy of the UImg, as reference for RTex_gauss.
+ * Separable, uses the weights of RTex_kernel_gauss_weights.
+ * Pixels outside are clamped to the edge.
+ * @param obj UImg object
+ * @param size kernel size for each axis
+ * @param sigma gauss factor for each axis, pass <=0 to auto scale
+ * @return UImg allocated on obj, with the same format
+ */
+O_EXTERN
+UImg* UImg_gauss(oobj obj, ivec2 size, vec2 sigma);
+
 
 
 #endif //U_UIMAGE_H
@@ -46,7 +46,8 @@ oobj u_splash_new(oobj parent,
  * @param bg_color for the full background (RTex_clear_full)
  * @param text_color for the author text
  * @paragraph author text to be displayed
- * @param min_time minimal time this splash is running (more if actual scene blocks while loading)
+ * @param min_time minimal time this splash is running (more if actual scene blocks while loading,
+ *                 or while the default RTexLoader has pending jobs, which shows a progress bar)
  * @param fade_time last part of the splash is linear fading away in that time span
  * @return AScene of the splash screen
  */
@@ -0,0 +1,107 @@
+#ifdef MIA_SHADER_VERTEX
+
+// packed r_sprite (see r/sprite.h and RBufferSprite)
+layout(location = 0) in vec2 in_pos;
+layout(location = 1) in vec4 in_size_angle;
+// xy: size, z: angle, w: reserved
+layout(location = 2) in vec2 in_uv_pos;
+layout(location = 3) in vec2 in_uv_size;
+layout(location = 4) in vec4 in_color;
+
+out vec2 v_tex_coord;
+flat out vec4 v_color;
+
+uniform mat4 u_vp;
+
+uniform vec2 u_tex_scale;
+
+//
+//// common
+//////
+uniform float u_c_viewport_scale_double;
+uniform vec2 u_c_viewport_size_half;
+uniform vec2 u_c_viewport_even_offset;
+const vec4 c_quad_vertices[4] = vec4[](
+vec4(-1.0, +1.0, 0, 1),
+vec4(+1.0, +1.0, 0, 1),
+vec4(-1.0, -1.0, 0, 1),
+vec4(+1.0, -1.0, 0, 1)
+);
+// rounds the pose center to half a pixel (thats why _double == 2*viewport_scale)
+mat4 c_quad_pose_round_center(mat4 pose)
+{
+    pose[3][0] = (0.1 + round(pose[3][0] * u_c_viewport_scale_double)) / u_c_viewport_scale_double;
+    pose[3][1] = (0.1 + round(pose[3][1] * u_c_viewport_scale_double)) / u_c_viewport_scale_double;
+    return pose;
+}
+// basic pose to vertex transformation
+vec4 c_quad_pose_vertex_transform(mat4 vp, mat4 pose)
+{
+    return vp * pose * c_quad_vertices[gl_VertexID];
+}
+// a vertex to be exactly on a pixel
+vec4 c_quad_vertex_round(vec4 vertex)
+{
+    vertex.xy = (round(vertex.xy * u_c_viewport_size_half) - u_c_viewport_even_offset) / u_c_viewport_size_half;
+    return vertex;
+}
+// combines basic transformation to generate a vertex from a pose on an exact pixel
+vec4 c_quad_vertex(mat4 vp, mat4 pose)
+{
+    pose = c_quad_pose_round_center(pose);
+    vec4 vertex = c_quad_pose_vertex_transform(vp, pose);
+    vertex = c_quad_vertex_round(vertex);
+    return vertex;
+}
+// basic pose to tex_coord transformation
+vec2 c_quad_tex_coord(mat4 uv, vec2 tex_scale)
+{
+    vec2 tex_coord = (uv * c_quad_vertices[gl_VertexID]).xy;
+    tex_coord = tex_coord * tex_scale + vec2(0.5);
+    return tex_coord;
+}
+//////
+//// end common
+//
+
+// r_sprite to pose, see u_pose_new_angle
+mat4 sprite_pose()
+{
+    float c = cos(in_size_angle.z);
+    float s = sin(in_size_angle.z);
+    vec2 half_size = in_size_angle.xy * 0.5;
+    return mat4(
+    c * half_size.x, s * half_size.x, 0.0, 0.0,
+    -s * half_size.y, c * half_size.y, 0.0, 0.0,
+    0.0, 0.0, 1.0, 0.0,
+    in_pos.x, in_pos.y, 0.0, 1.0
+    );
+}
+
+void main() {
+    gl_Position = c_quad_vertex(u_vp, sprite_pose());
+
+    vec2 uv = in_uv_pos + in_uv_size * 0.5 * c_quad_vertices[gl_VertexID].xy;
+    v_tex_coord = uv * u_tex_scale + vec2(0.5);
+
+    v_color = in_color;
+}
+#endif
+
+
+#ifdef MIA_SHADER_FRAGMENT
+
+in vec2 v_tex_coord;
+flat in vec4 v_color;
+
+layout(location = 0) out vec4 f_rgba;
+
+uniform sampler2D u_tex;
+
+uniform vec4 u_color;
+
+void main() {
+    f_rgba = texture(u_tex, v_tex_coord) * v_color * u_color;
+}
+
+#endif
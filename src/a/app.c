@@ -132,7 +132,7 @@ void init(const struct a_app_run_options *opt_options)
     assert(!app_L.init);
     app_L.init = true;
     o_init();
-    app_L.root = OObjRoot_new_pool();
+    app_L.root = OObjRoot_new_slab();
     OObj_name_set(app_L.root, "a_app_root");
     ODelcallback_new_assert(app_L.root, "a_app_root", "deleted!");
 
@@ -224,6 +224,13 @@ void init(const struct a_app_run_options *opt_options)
     o_log_debug_s(__func__, "test finished successfully");
 #endif
 
+#ifdef MIA_OPTION_BENCH
+    o_log_trace_s(__func__, "bench...");
+    void o__bench_main(void);
+    o__bench_main();
+    o_log_debug_s(__func__, "bench finished");
+#endif
+
 }
 
 O_STATIC
@@ -407,6 +414,9 @@ void main_loop(void)
         }
     }
 
+    // deletes the tracks that ended on the audio thread
+    s_update();
+
 
     // window size (updated by the sdl event system, so handle_events() first...)
     ivec2 window_size;
@@ -696,14 +706,14 @@ bool a_app_suspend_paused_set(bool suspend_during_pause)
 
 int a_app_pool_blocks_num(void)
 {
-    return o_allocator_pool_blocks_num(
+    return o_allocator_slab_blocks_num(
             OObj_allocator(app_L.root));
 }
 
 
 int a_app_pool_blocks_used(void)
 {
-    return o_allocator_pool_blocks_used(
+    return o_allocator_slab_blocks_used(
             OObj_allocator(app_L.root));
 }
 
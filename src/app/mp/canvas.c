@@ -3,6 +3,7 @@
 #include "r/RShaderQuad.h"
 #include "r/RShaderQuadDab.h"
 #include "r/RTex_manip.h"
+#include "r/RTexReadback.h"
 #include "r/program.h"
 #include "u/pose.h"
 #include "app/mp/brush.h"
@@ -110,6 +111,15 @@ void set_quad(struct r_quad *q, vec2 pos, float pressure)
     u_pose_set(&q->pose, m_2(pos), m_2(sprite_size), 0);
 }
 
+O_STATIC
+void download_saved(oobj readback)
+{
+    if (RTexReadback_saved(readback)) {
+        o_file_download("image.png", NULL, NULL);
+    }
+    o_del(readback);
+}
+
 #include "r/gl.h"
 void mp_canvas_pointer(struct a_pointer pointer)
 {
@@ -125,8 +135,8 @@ void mp_canvas_pointer(struct a_pointer pointer)
 
         if(canvas_L.dbl_tap_time > 0) {
                 o_log("download by dbl tap!");
-                RTex_write_file(canvas_L.img, "image.png");
-                o_file_download("image.png", NULL, NULL);
+                // readback and png encoding without a frame hitch
+                RTex_write_file_async(canvas_L.img, canvas_L.o, "image.png", NULL, download_saved);
         }
         canvas_L.dbl_tap_time = 0.5;
     } else if(pointer.active) {
@@ -4,6 +4,10 @@
 #include "o/OObj_builder.h"
 #include <SDL2/SDL_mutex.h>
 
+// protected
+O_EXTERN
+void *OObj__mutex(oobj obj);
+
 OCondition *OCondition_init(oobj obj, oobj parent)
 {
     OCondition *self = obj;
@@ -55,7 +59,7 @@ void OCondition_wait(oobj obj, oobj mutex)
     OObj_assert(mutex, OObj);
     OCondition *self = obj;
     OObj *self_mutex = mutex;
-    int ret = SDL_CondWait(self->sdl_cond, self_mutex->mutex);
+    int ret = SDL_CondWait(self->sdl_cond, OObj__mutex(self_mutex));
     o_assume(ret == 0, "SDL_CondWait failed");
 }
 
@@ -65,7 +69,7 @@ bool OCondition_wait_timeout(oobj obj, oobj mutex, int timeout_ms)
     OObj_assert(mutex, OObj);
     OCondition *self = obj;
     OObj *self_mutex = mutex;
-    int ret = SDL_CondWaitTimeout(self->sdl_cond, self_mutex->mutex, timeout_ms);
+    int ret = SDL_CondWaitTimeout(self->sdl_cond, OObj__mutex(self_mutex), timeout_ms);
     o_assume(ret != 0 && ret != SDL_MUTEX_TIMEDOUT, "SDL_CondWait failed");
     return ret == 0;
 }
@@ -4,22 +4,23 @@
 #include "o/OObj_builder.h"
 #include "o/OCondition.h"
 #include "o/OThreadpool.h"
-#include "o/OQueue.h"
 #include "o/OThread.h"
 
 
+// protected in OThreadpool.c
+O_EXTERN
+void OThreadpool__push(oobj obj, oobj future);
+
+
 //
 // protected
 // used by OThreadpool.c
 //
 
 O_EXTERN
-void OFuture__thread_runnable(oobj future_holder)
+void OFuture__run(oobj obj)
 {
-    // future_holder may or may not be an OThread!
-    // but it should have been packed with the OFuture self in o_user...
-
-    OFuture *self = o_user(future_holder);
+    OFuture *self = obj;
     OObj_assert(self, OFuture);
 
     o_lock_block(self) {
@@ -35,6 +36,14 @@ void OFuture__thread_runnable(oobj future_holder)
 }
 
 
+O_STATIC
+void OFuture__thread_runnable(oobj thread)
+{
+    // OThread packed with the OFuture self in o_user
+    OFuture__run(o_user(thread));
+}
+
+
 OFuture *OFuture_init(oobj obj, oobj parent, OObj__event_fn fn, oobj opt_threadpool)
 {
     OFuture *self = obj;
@@ -78,9 +87,7 @@ void OFuture_run(oobj obj)
         if(self->state == OFuture_INIT) {
             self->state = OFuture_PREPARING;
             if(self->opt_threadpool) {
-                OObj_assert(self->opt_threadpool, OThreadpool);
-                OThreadpool *pool = self->opt_threadpool;
-                OQueue_push(pool->task_queue, &self);
+                OThreadpool__push(self->opt_threadpool, self);
             } else {
                 self->thread = OThread_new_run(self, OFuture__thread_runnable, "OFuture", self);
             }
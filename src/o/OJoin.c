@@ -2,6 +2,7 @@
 #include "o/OObj_builder.h"
 #include "o/OArray.h"
 #include "o/ODelcallback.h"
+#include <SDL2/SDL_atomic.h>
 
 #define O_LOG_LIB "o"
 #include "o/log.h"
@@ -116,6 +117,7 @@ O_STATIC
 void init_parents_weaks(OJoin *self, oobj *parents, osize parents_size)
 {
     self->parents = OArray_new_dyn(self, NULL, sizeof(struct parent *), 0, 8);
+    self->parents_num = o_new0(self, SDL_atomic_t, 1);
     if(parents_size<=0) {
         parents_size = o_list_num(parents);
     }
@@ -139,6 +141,7 @@ OJoin *OJoin_new_super(osize object_size, oobj *parents, osize parents_size, str
     join_init_base(&stacked_self, allocator);
     OJoin *self = o_alloc0(&stacked_self, object_size, 1);
     *self = stacked_self;
+    OObj__relocate(self, &stacked_self);
     // needs a fixed OJoin object handle...
     init_parents_weaks(self, parents, parents_size);
     return self;
@@ -218,6 +221,13 @@ osize OJoin_num_parents(oobj obj)
     return num;
 }
 
+osize OJoin_num_parents_atomic(oobj obj)
+{
+    OObj_assert(obj, OJoin);
+    OJoin *self = obj;
+    return SDL_AtomicGet(self->parents_num);
+}
+
 void OJoin_add(oobj obj, oobj parent)
 {
     OObj_assert(obj, OJoin);
@@ -229,6 +239,7 @@ void OJoin_add(oobj obj, oobj parent)
         p->parent = parent;
 
         OArray_push(self->parents, &p);
+        SDL_AtomicSet(self->parents_num, (int) o_num(self->parents));
 
         // create a del callback that is called, when parent gets deleted
         p->delcb = ODelcallback_new(parent, autoremove_parent);
@@ -286,6 +297,7 @@ bool OJoin_remove(oobj obj, oobj parent)
 
         o_free(self, p);
         OArray_pop_at(self->parents, idx, NULL);
+        SDL_AtomicSet(self->parents_num, (int) o_num(self->parents));
 
         deleted = OArray_num(self->parents) == 0;
     }
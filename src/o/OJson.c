@@ -7,6 +7,7 @@
 #include "o/file.h"
 #include "o/str.h"
 #include <stdlib.h>
+#include <string.h>
 
 #define O_LOG_LIB "o"
 #include "o/log.h"
@@ -60,35 +61,28 @@ O_STATIC
 osize write_stream_object(oobj container, OJson *json_object, OStream *stream, int lvl)
 {
     osize written = 0;
-    OJson **list = OJson_list(json_object, NULL);
-
-    // not a single child found
-    if (*list == NULL) {
-        written += OStream_print(stream, "{}");
-        o_free(json_object, list);
-        return written;
-    }
+    bool empty = true;
 
     written += OStream_print(stream, "{");
-    OJson **it = list;
-    while (*it) {
-        OJson *child = *it++;
+    o_foreach_child(json_object, OJson, it) {
+        OJson *child = it.child;
+        if (!empty) {
+            written += OStream_print(stream, ",");
+        }
+        empty = false;
         if (!json_object->packed) {
             written += write_stream_newline(stream, lvl + 1);
         }
         written += OStream_printf(stream, "\"%s\": ", o_or(OObj_name(child), OJson_NAME_DEFAULT));
         written += write_stream_r(container, child, stream, lvl + 1);
-        if (*it != NULL) {
-            written += OStream_print(stream, ",");
-        }
     }
 
-    if (!json_object->packed) {
+    // not a single child found -> "{}"
+    if (!empty && !json_object->packed) {
         written += write_stream_newline(stream, lvl);
     }
     written += OStream_print(stream, "}");
 
-    o_free(json_object, list);
     return written;
 }
 
@@ -96,34 +90,26 @@ O_STATIC
 osize write_stream_array(oobj container, OJson *json_array, OStream *stream, int lvl)
 {
     osize written = 0;
-    OJson **list = OJson_list(json_array, NULL);
-
-    // not a single child found, replacing with null
-    if (*list == NULL) {
-        written += OStream_print(stream, "[]");
-        o_free(json_array, list);
-        return written;
-    }
+    bool empty = true;
 
     written += OStream_print(stream, "[");
-    OJson **it = list;
-    while (*it) {
-        OJson *child = *it++;
+    o_foreach_child(json_array, OJson, it) {
+        if (!empty) {
+            written += OStream_print(stream, ",");
+        }
+        empty = false;
         if (!json_array->packed) {
             written += write_stream_newline(stream, lvl + 1);
         }
-        written += write_stream_r(container, child, stream, lvl + 1);
-        if (*it != NULL) {
-            written += OStream_print(stream, ",");
-        }
+        written += write_stream_r(container, it.child, stream, lvl + 1);
     }
 
-    if (!json_array->packed) {
+    // not a single child found -> "[]"
+    if (!empty && !json_array->packed) {
         written += write_stream_newline(stream, lvl);
     }
     written += OStream_print(stream, "]");
 
-    o_free(json_array, list);
     return written;
 }
 
@@ -435,6 +421,159 @@ bool parse_stream_r(oobj parent, oobj stream, const char *name)
 }
 
 
+//
+// children index
+//
+
+// OJson_list in order, and a hash table into it for objects
+struct OJson_index {
+    ou32 stamp;
+    osize num;
+    osize capacity;
+    int slots_bits;
+    // capacity entries
+    OJson **list;
+    // capacity entries, name hashes of the list
+    ou32 *hashes;
+    // 1<<slots_bits entries, idx+1 into list, 0 for empty
+    ou32 *slots;
+};
+
+#define INDEX_CAPACITY_MIN 8
+
+// same as o_str_hash, but for a not null terminated name
+O_STATIC
+ou32 index_hash(const char *name, osize len)
+{
+    ou32 hash = 5381;
+    for (osize i = 0; i < len; i++) {
+        hash = ((hash << 5u) + hash) + (ou32) name[i];
+    }
+    return hash;
+}
+
+O_STATIC
+bool index_name_equals(OJson *child, const char *name, osize len)
+{
+    const char *child_name = OObj_name(child);
+    return child_name && strncmp(child_name, name, len) == 0 && child_name[len] == '\0';
+}
+
+O_STATIC
+void index_build(OJson *self)
+{
+    OObj *super = &self->super;
+    struct OJson_index *index = self->index;
+
+    if (!index || index->capacity < super->children_num) {
+        osize capacity = INDEX_CAPACITY_MIN;
+        while (capacity < super->children_num) {
+            capacity *= 2;
+        }
+        // slots with load factor <= 0.5
+        int slots_bits = 1;
+        while (((osize) 1 << slots_bits) < capacity * 2) {
+            slots_bits++;
+        }
+        osize slots_num = (osize) 1 << slots_bits;
+        osize size = (osize) sizeof *index
+                     + capacity * (osize) (sizeof *index->list + sizeof *index->hashes)
+                     + slots_num * (osize) sizeof *index->slots;
+        index = o_realloc(self, self->index, 1, size);
+        index->capacity = capacity;
+        index->slots_bits = slots_bits;
+        index->list = (OJson **) (index + 1);
+        index->hashes = (ou32 *) (index->list + capacity);
+        index->slots = index->hashes + capacity;
+        self->index = index;
+    }
+
+    index->stamp = super->children_stamp;
+    index->num = 0;
+    for (osize i = 0; i < super->children_num; i++) {
+        if (OObj_check(super->children[i], OJson)) {
+            index->list[index->num++] = super->children[i];
+        }
+    }
+
+    if (self->type != OJson_TYPE_OBJECT) {
+        return;
+    }
+
+    ou32 mask = ((ou32) 1 << index->slots_bits) - 1;
+    o_clear(index->slots, sizeof *index->slots, (osize) mask + 1);
+    for (osize i = 0; i < index->num; i++) {
+        const char *name = o_or(OObj_name(index->list[i]), "");
+        osize len = o_strlen(name);
+        ou32 hash = index_hash(name, len);
+        index->hashes[i] = hash;
+        ou32 pos = (hash * 2654435769u) >> (32 - index->slots_bits);
+        for (;;) {
+            ou32 slot = index->slots[pos];
+            if (slot == 0) {
+                index->slots[pos] = (ou32) i + 1;
+                break;
+            }
+            if (index->hashes[slot - 1] == hash && index_name_equals(index->list[slot - 1], name, len)) {
+                // duplicate name, the last one wins
+                index->slots[pos] = (ou32) i + 1;
+                break;
+            }
+            pos = (pos + 1) & mask;
+        }
+    }
+}
+
+// returns the index (rebuilt if the children changed) or NULL if not an object or array
+// obj must be locked, so readers of other threads do not race on the rebuild
+O_STATIC
+struct OJson_index *index_get(oobj obj)
+{
+    OObj_assert(obj, OJson);
+    OJson *self = obj;
+    if (self->type != OJson_TYPE_OBJECT && self->type != OJson_TYPE_ARRAY) {
+        return NULL;
+    }
+    if (!self->index || self->index->stamp != self->super.children_stamp) {
+        index_build(self);
+    }
+    return self->index;
+}
+
+// obj must be locked
+O_STATIC
+OJson *index_find_locked(oobj obj, const char *name, osize len)
+{
+    struct OJson_index *index = index_get(obj);
+    if (!index || OJson_type(obj) != OJson_TYPE_OBJECT || index->num == 0) {
+        return NULL;
+    }
+    ou32 hash = index_hash(name, len);
+    ou32 mask = ((ou32) 1 << index->slots_bits) - 1;
+    ou32 pos = (hash * 2654435769u) >> (32 - index->slots_bits);
+    for (;;) {
+        ou32 slot = index->slots[pos];
+        if (slot == 0) {
+            return NULL;
+        }
+        if (index->hashes[slot - 1] == hash && index_name_equals(index->list[slot - 1], name, len)) {
+            return index->list[slot - 1];
+        }
+        pos = (pos + 1) & mask;
+    }
+}
+
+O_STATIC
+OJson *index_find(oobj obj, const char *name, osize len)
+{
+    OJson *res = NULL;
+    o_lock_block(obj) {
+        res = index_find_locked(obj, name, len);
+    }
+    return res;
+}
+
+
 //
 // public
 //
@@ -521,19 +660,22 @@ struct oobj_opt OJson_new_read_stream(oobj parent, const char *name, oobj stream
         o_del(move_container);
         return oobj_opt(NULL);
     }
-    OJson **list = OJson_list(move_container, NULL);
-    if(list[0] == NULL) {
+    OJson *ret = NULL;
+    o_foreach_child(move_container, OJson, it) {
+        if(ret) {
+            o_log_warn_s("OJson_new_read_stream",
+                       "valid, but got multiple OJson objects?");
+            break;
+        }
+        ret = it.child;
+    }
+    if(!ret) {
         o_log_wtf_s("OJson_new_read_stream",
                    "valid, but got no OJson objects?");
         o_del(move_container);
         return oobj_opt(NULL);
     }
-    if(list[1] != NULL) {
-        o_log_warn_s("OJson_new_read_stream",
-                   "valid, but got multiple OJson objects?");
-    }
 
-    OJson *ret = list[0];
     o_move(ret, parent);
     o_del(move_container);
     return oobj_opt(ret);
@@ -600,50 +742,63 @@ void OJson_string_set(oobj obj, const char *string)
 
 osize OJson_num(oobj obj)
 {
-    osize num;
-    OJson **list = NULL;
-    enum OJson_type type = OJson_type(obj);
-    if(type != OJson_TYPE_ARRAY && type != OJson_TYPE_OBJECT) {
-        return 0;
+    osize num = 0;
+    o_lock_block(obj) {
+        struct OJson_index *index = index_get(obj);
+        num = index ? index->num : 0;
     }
-    list = OJson_list(obj, &num);
-    o_free(obj, list);
     return num;
 }
 
 struct oobj_opt OJson_at(oobj obj, osize idx)
 {
-    osize num;
-    OJson **list = NULL;
-    oobj res = NULL;
-    enum OJson_type type = OJson_type(obj);
-    if(type != OJson_TYPE_ARRAY && type != OJson_TYPE_OBJECT) {
-        goto CLEAN_UP;
-    }
-    list = OJson_list(obj, &num);
-    if(idx < 0 || idx>=num) {
-        goto CLEAN_UP;
+    OJson *res = NULL;
+    o_lock_block(obj) {
+        struct OJson_index *index = index_get(obj);
+        if (index && idx >= 0 && idx < index->num) {
+            res = index->list[idx];
+        }
     }
-    res = list[idx];
-
-    CLEAN_UP:
-    o_free(obj, list);
     return oobj_opt(res);
 }
 
 struct oobj_opt OJson_get(oobj obj, const char *name)
 {
     assert(name);
-    OJson **list = OJson_list(obj, NULL);
-    OJson *ret = NULL;
-    for(OJson **it = list; *it; it++) {
-        OJson *child = *it;
-        if (o_str_equals(OObj_name(child), name)) {
-            ret = child;
+    return oobj_opt(index_find(obj, name, o_strlen(name)));
+}
+
+struct oobj_opt OJson_get_path(oobj obj, const char *path)
+{
+    assert(path);
+    OJson *json = obj;
+    if (*path == '\0') {
+        return oobj_opt(json);
+    }
+    while (json) {
+        const char *end = path;
+        while (*end && *end != '.') {
+            end++;
+        }
+        osize len = end - path;
+        if (OJson_type(json) == OJson_TYPE_ARRAY) {
+            osize idx = 0;
+            for (const char *it = path; it < end; it++) {
+                if (*it < '0' || *it > '9' || idx > osize_MAX / 10 - 10) {
+                    return oobj_opt(NULL);
+                }
+                idx = idx * 10 + (*it - '0');
+            }
+            json = len > 0 ? OJson_at(json, idx).o : NULL;
+        } else {
+            json = index_find(json, path, len);
         }
+        if (*end == '\0') {
+            break;
+        }
+        path = end + 1;
     }
-    o_free(obj, list);
-    return oobj_opt(ret);
+    return oobj_opt(json);
 }
 
 osize OJson_write_stream(oobj obj, oobj stream)
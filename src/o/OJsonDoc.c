@@ -0,0 +1,648 @@
+#include "o/OJsonDoc.h"
+#include "o/OObj_builder.h"
+#include "o/OArray.h"
+#include "o/OStream.h"
+#include "o/file.h"
+#include "o/str.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define O_LOG_LIB "o"
+#include "o/log.h"
+
+// arena size for a document of len bytes, copy of the text + roughly the nodes
+#define DOC_ARENA_SIZE(len) ((len) * 2 + 4096)
+
+#define DOC_STACK_SIZE_MIN 64
+
+#define DOC_STREAM_BLOCK 4096
+
+#define LOG_PREV 16
+#define LOG_NEXT 8
+
+// parsing context of a single document
+struct doc_parser {
+    OJsonDoc *self;
+    const char *begin;
+    char *it;
+    osize stack_num;
+    int depth;
+};
+
+O_STATIC
+void doc_log_parse_failed(struct doc_parser *p, const char *msg)
+{
+    _Static_assert(LOG_PREV < 32 && LOG_NEXT < 32, "invalid buffer");
+    char prev[32] = {0};
+    char next[32] = {0};
+    int prev_num = (int) o_min(LOG_PREV, p->it - p->begin);
+    o_memcpy(prev, p->it - prev_num, 1, prev_num);
+    for (int i = 0; i < LOG_NEXT && p->it[i]; i++) {
+        next[i] = p->it[i];
+    }
+
+    o_str_replace_char_this(prev, '\n', ' ');
+    o_str_replace_char_this(next, '\n', ' ');
+
+    o_log_warn_s("OJsonDoc_new_read_buffer",
+                 "Parsing failed: %s at: [..]%s<!!!>%s[..]", msg, prev, next);
+}
+
+// allocates from the last arena, or creates a new bigger one
+O_STATIC
+void *doc_arena_alloc(OJsonDoc *self, osize size)
+{
+    osize arenas_num = OArray_num(self->arenas);
+    struct o_allocator_i *arenas = OArray_data_void(self->arenas);
+    // check the remaining space first, a failing arena allocation would log
+    if (arenas_num > 0 && o_allocator_arena_remaining(arenas[arenas_num - 1]) >= size + 2 * O_ALIGN_SYSTEM_MAX) {
+        void *mem = o_allocator_i_realloc_try(arenas[arenas_num - 1], NULL, 1, size);
+        if (mem) {
+            return mem;
+        }
+    }
+    osize arena_size = arenas_num > 0 ? o_allocator_arena_size(arenas[arenas_num - 1]) * 2 : 0;
+    arena_size = o_max(arena_size, DOC_ARENA_SIZE(size));
+    struct o_allocator_i arena = o_allocator_arena_new(arena_size);
+    OArray_push(self->arenas, &arena);
+    void *mem = o_allocator_i_realloc_try(arena, NULL, 1, size);
+    o_assume(mem, "new arena too small?");
+    return mem;
+}
+
+O_STATIC
+struct OJsonDoc_node *doc_stack_push(struct doc_parser *p)
+{
+    OJsonDoc *self = p->self;
+    if (p->stack_num >= self->stack_size) {
+        self->stack_size = o_max(DOC_STACK_SIZE_MIN, self->stack_size * 2);
+        self->stack = o_renew(self, self->stack, *self->stack, self->stack_size);
+    }
+    return &self->stack[p->stack_num++];
+}
+
+// moves the children from the stack into the arena
+O_STATIC
+void doc_stack_pop_into(struct doc_parser *p, struct OJsonDoc_node *container, osize stack_begin)
+{
+    osize num = p->stack_num - stack_begin;
+    container->num = (oi32) num;
+    container->data.children = NULL;
+    if (num > 0) {
+        struct OJsonDoc_node *children = doc_arena_alloc(p->self, num * (osize) sizeof *children);
+        o_memcpy(children, &p->self->stack[stack_begin], sizeof *children, num);
+        container->data.children = children;
+    }
+    p->stack_num = stack_begin;
+}
+
+O_STATIC
+void doc_skip_space(struct doc_parser *p)
+{
+    char *it = p->it;
+    while (*it == ' ' || *it == '\n' || *it == '\r' || *it == '\t') {
+        it++;
+    }
+    p->it = it;
+}
+
+O_STATIC
+int doc_hex_value(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+O_STATIC
+ou32 doc_hex_read(const char *it, int digits)
+{
+    ou32 value = 0;
+    for (int i = 0; i < digits; i++) {
+        int h = doc_hex_value(it[i]);
+        if (h < 0) {
+            return ou32_MAX;
+        }
+        value = (value << 4) | (ou32) h;
+    }
+    return value;
+}
+
+O_STATIC
+char *doc_utf8_write(char *w, ou32 cp)
+{
+    if (cp < 0x80) {
+        *w++ = (char) cp;
+    } else if (cp < 0x800) {
+        *w++ = (char) (0xC0 | (cp >> 6));
+        *w++ = (char) (0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *w++ = (char) (0xE0 | (cp >> 12));
+        *w++ = (char) (0x80 | ((cp >> 6) & 0x3F));
+        *w++ = (char) (0x80 | (cp & 0x3F));
+    } else {
+        *w++ = (char) (0xF0 | (cp >> 18));
+        *w++ = (char) (0x80 | ((cp >> 12) & 0x3F));
+        *w++ = (char) (0x80 | ((cp >> 6) & 0x3F));
+        *w++ = (char) (0x80 | (cp & 0x3F));
+    }
+    return w;
+}
+
+// p->it is behind the opening '\"', unescapes in place and null terminates
+// also supports the \' and \xHH escapes of o_str_escape, used by OJson_write_stream
+O_STATIC
+const char *doc_parse_string(struct doc_parser *p)
+{
+    char *str = p->it;
+    char *r = str;
+
+    // fast path, until the first escape, no copy needed
+    while (*r != '\"' && *r != '\\' && *r != '\0') {
+        r++;
+    }
+    char *w = r;
+
+    while (*r != '\"') {
+        if (*r == '\0') {
+            p->it = r;
+            doc_log_parse_failed(p, "unterminated string");
+            return NULL;
+        }
+        if (*r != '\\') {
+            *w++ = *r++;
+            continue;
+        }
+        r++;
+        switch (*r++) {
+            case '\"': *w++ = '\"'; break;
+            case '\\': *w++ = '\\'; break;
+            case '/': *w++ = '/'; break;
+            case '\'': *w++ = '\''; break;
+            case 'b': *w++ = '\b'; break;
+            case 'f': *w++ = '\f'; break;
+            case 'n': *w++ = '\n'; break;
+            case 'r': *w++ = '\r'; break;
+            case 't': *w++ = '\t'; break;
+            case 'x': {
+                ou32 byte = doc_hex_read(r, 2);
+                if (byte == ou32_MAX) {
+                    p->it = r;
+                    doc_log_parse_failed(p, "invalid \\x escape");
+                    return NULL;
+                }
+                *w++ = (char) byte;
+                r += 2;
+                break;
+            }
+            case 'u': {
+                ou32 cp = doc_hex_read(r, 4);
+                if (cp == ou32_MAX) {
+                    p->it = r;
+                    doc_log_parse_failed(p, "invalid \\u escape");
+                    return NULL;
+                }
+                r += 4;
+                // utf16 surrogate pair
+                if (cp >= 0xD800 && cp <= 0xDBFF && r[0] == '\\' && r[1] == 'u') {
+                    ou32 low = doc_hex_read(r + 2, 4);
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        r += 6;
+                    }
+                }
+                w = doc_utf8_write(w, cp);
+                break;
+            }
+            default:
+                p->it = r - 1;
+                doc_log_parse_failed(p, "invalid escape sequence");
+                return NULL;
+        }
+    }
+
+    // r is at the closing '\"', w <= r
+    *w = '\0';
+    p->it = r + 1;
+    return str;
+}
+
+// exact powers of ten for the fast path
+static const double DOC_POW10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+O_STATIC
+bool doc_parse_number(struct doc_parser *p, double *out_number)
+{
+    char *begin = p->it;
+    char *it = begin;
+    bool negative = false;
+    if (*it == '-' || *it == '+') {
+        negative = *it == '-';
+        it++;
+    }
+
+    // mantissa digits, up to 19 fit into an ou64
+    ou64 mantissa = 0;
+    int digits = 0;
+    int exp10 = 0;
+    char *digits_begin = it;
+    while (*it >= '0' && *it <= '9') {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (ou64) (*it - '0');
+            if (mantissa > 0) {
+                digits++;
+            }
+        } else {
+            exp10++;
+        }
+        it++;
+    }
+    if (*it == '.') {
+        it++;
+        while (*it >= '0' && *it <= '9') {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (ou64) (*it - '0');
+                if (mantissa > 0) {
+                    digits++;
+                }
+                exp10--;
+            }
+            it++;
+        }
+    }
+    if (it == digits_begin || (it == digits_begin + 1 && *digits_begin == '.')) {
+        doc_log_parse_failed(p, "failed to parse the number");
+        return false;
+    }
+    if (*it == 'e' || *it == 'E') {
+        char *exp_begin = it;
+        it++;
+        bool exp_negative = false;
+        if (*it == '-' || *it == '+') {
+            exp_negative = *it == '-';
+            it++;
+        }
+        if (*it < '0' || *it > '9') {
+            p->it = exp_begin;
+            doc_log_parse_failed(p, "failed to parse the number exponent");
+            return false;
+        }
+        int exp = 0;
+        while (*it >= '0' && *it <= '9') {
+            if (exp < 10000) {
+                exp = exp * 10 + (*it - '0');
+            }
+            it++;
+        }
+        exp10 += exp_negative ? -exp : exp;
+    }
+    p->it = it;
+
+    // fast path: mantissa and power of ten are exact doubles, so a single rounding
+    if (digits <= 15 && exp10 >= -22 && exp10 <= 22) {
+        double number = (double) mantissa;
+        number = exp10 < 0 ? number / DOC_POW10[-exp10] : number * DOC_POW10[exp10];
+        *out_number = negative ? -number : number;
+        return true;
+    }
+
+    // slow path, the text is validated and terminated by a non number char
+    *out_number = strtod(begin, NULL);
+    return true;
+}
+
+O_STATIC
+bool doc_parse_literal(struct doc_parser *p, const char *literal, osize len)
+{
+    if (strncmp(p->it, literal, len) != 0) {
+        doc_log_parse_failed(p, "invalid literal");
+        return false;
+    }
+    p->it += len;
+    return true;
+}
+
+// needed by doc_parse_object, doc_parse_array for recursion
+O_STATIC
+bool doc_parse_value(struct doc_parser *p, struct OJsonDoc_node *out_node);
+
+O_STATIC
+bool doc_parse_object(struct doc_parser *p, struct OJsonDoc_node *out_node)
+{
+    // '{' was already read
+    osize stack_begin = p->stack_num;
+    doc_skip_space(p);
+    if (*p->it == '}') {
+        p->it++;
+        doc_stack_pop_into(p, out_node, stack_begin);
+        return true;
+    }
+    for (;;) {
+        doc_skip_space(p);
+        if (*p->it != '\"') {
+            doc_log_parse_failed(p, "expected beginning of an object name");
+            return false;
+        }
+        p->it++;
+        const char *name = doc_parse_string(p);
+        if (!name) {
+            return false;
+        }
+        doc_skip_space(p);
+        if (*p->it != ':') {
+            doc_log_parse_failed(p, "expected a \':\'");
+            return false;
+        }
+        p->it++;
+
+        struct OJsonDoc_node child;
+        if (!doc_parse_value(p, &child)) {
+            return false;
+        }
+        child.name = name;
+        *doc_stack_push(p) = child;
+
+        doc_skip_space(p);
+        char c = *p->it++;
+        if (c == '}') {
+            doc_stack_pop_into(p, out_node, stack_begin);
+            return true;
+        }
+        if (c != ',') {
+            p->it--;
+            doc_log_parse_failed(p, "expected a \',\'");
+            return false;
+        }
+    }
+}
+
+O_STATIC
+bool doc_parse_array(struct doc_parser *p, struct OJsonDoc_node *out_node)
+{
+    // '[' was already read
+    osize stack_begin = p->stack_num;
+    doc_skip_space(p);
+    if (*p->it == ']') {
+        p->it++;
+        doc_stack_pop_into(p, out_node, stack_begin);
+        return true;
+    }
+    for (;;) {
+        struct OJsonDoc_node child;
+        if (!doc_parse_value(p, &child)) {
+            return false;
+        }
+        *doc_stack_push(p) = child;
+
+        doc_skip_space(p);
+        char c = *p->it++;
+        if (c == ']') {
+            doc_stack_pop_into(p, out_node, stack_begin);
+            return true;
+        }
+        if (c != ',') {
+            p->it--;
+            doc_log_parse_failed(p, "expected a \',\'");
+            return false;
+        }
+    }
+}
+
+O_STATIC
+bool doc_parse_value(struct doc_parser *p, struct OJsonDoc_node *out_node)
+{
+    doc_skip_space(p);
+    out_node->num = 0;
+    out_node->name = NULL;
+
+    char c = *p->it;
+    switch (c) {
+        case 'n':
+            out_node->type = OJson_TYPE_NULL;
+            return doc_parse_literal(p, "null", 4);
+        case 't':
+            out_node->type = OJson_TYPE_BOOLEAN;
+            out_node->data.boolean = true;
+            return doc_parse_literal(p, "true", 4);
+        case 'f':
+            out_node->type = OJson_TYPE_BOOLEAN;
+            out_node->data.boolean = false;
+            return doc_parse_literal(p, "false", 5);
+        case '\"':
+            p->it++;
+            out_node->type = OJson_TYPE_STRING;
+            out_node->data.string = doc_parse_string(p);
+            return out_node->data.string != NULL;
+        case '{':
+        case '[': {
+            if (p->depth >= OJsonDoc_DEPTH_MAX) {
+                doc_log_parse_failed(p, "max depth reached");
+                return false;
+            }
+            p->it++;
+            p->depth++;
+            bool ok;
+            if (c == '{') {
+                out_node->type = OJson_TYPE_OBJECT;
+                ok = doc_parse_object(p, out_node);
+            } else {
+                out_node->type = OJson_TYPE_ARRAY;
+                ok = doc_parse_array(p, out_node);
+            }
+            p->depth--;
+            return ok;
+        }
+        default:
+            break;
+    }
+    if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.') {
+        out_node->type = OJson_TYPE_NUMBER;
+        return doc_parse_number(p, &out_node->data.number);
+    }
+
+    if (c == '\0') {
+        doc_log_parse_failed(p, "unexpected end");
+    } else {
+        doc_log_parse_failed(p, "invalid element start");
+    }
+    return false;
+}
+
+
+//
+// public
+//
+
+OJsonDoc *OJsonDoc_init(oobj obj, oobj parent)
+{
+    OJsonDoc *self = obj;
+    o_clear(self, sizeof *self, 1);
+
+    OObj_init(self, parent);
+    OObj_id_set(self, OJsonDoc_ID);
+
+    self->arenas = OArray_new_dyn(self, NULL, sizeof(struct o_allocator_i), 0, 4);
+    self->root.type = OJson_TYPE_NULL;
+
+    // vfuncs
+    self->super.v_del = OJsonDoc__v_del;
+    self->super.v_op_num = OJsonDoc__v_op_num;
+
+    return self;
+}
+
+struct oobj_opt OJsonDoc_new_read_buffer(oobj parent, const char *data, osize len)
+{
+    if (len < 0) {
+        len = o_strlen(data);
+    }
+    OJsonDoc *self = OJsonDoc_new(parent);
+
+    // copy of the text, null terminated, strings get unescaped in place
+    char *text = doc_arena_alloc(self, len + 1);
+    o_memcpy(text, data, 1, len);
+    text[len] = '\0';
+
+    struct doc_parser p = {self, text, text, 0, 0};
+    bool ok = doc_parse_value(&p, &self->root);
+    if (ok) {
+        doc_skip_space(&p);
+        if (*p.it != '\0') {
+            doc_log_parse_failed(&p, "unexpected data after the root element");
+            ok = false;
+        }
+    }
+
+    // parse stack not needed anymore
+    o_free(self, self->stack);
+    self->stack = NULL;
+    self->stack_size = 0;
+
+    if (!ok) {
+        o_del(self);
+        return oobj_opt(NULL);
+    }
+    return oobj_opt(self);
+}
+
+struct oobj_opt OJsonDoc_new_read_stream(oobj parent, oobj stream)
+{
+    oobj container = OObj_new(parent);
+    osize size = DOC_STREAM_BLOCK;
+    osize len = 0;
+    char *text = o_new(container, char, size);
+    for (;;) {
+        osize read = OStream_read(stream, text + len, 1, size - len);
+        if (read <= 0) {
+            break;
+        }
+        len += read;
+        if (len < size) {
+            break;
+        }
+        size *= 2;
+        text = o_renew(container, text, char, size);
+    }
+    struct oobj_opt res = OJsonDoc_new_read_buffer(parent, text, len);
+    o_del(container);
+    return res;
+}
+
+struct oobj_opt OJsonDoc_new_read_file(oobj parent, const char *file)
+{
+    struct oobj_opt data = o_file_read(parent, file, true, 1);
+    if (!data.o) {
+        o_log_warn_s("OJsonDoc_new_read_file",
+                     "failed to open the file: %s", file);
+        return oobj_opt(NULL);
+    }
+    struct oobj_opt res = OJsonDoc_new_read_buffer(parent, OArray_data_void(data.o), OArray_num(data.o));
+    o_del(data.o);
+    return res;
+}
+
+//
+// virtual implementations:
+//
+
+void OJsonDoc__v_del(oobj obj)
+{
+    OObj_assert(obj, OJsonDoc);
+    OJsonDoc *self = obj;
+
+    struct o_allocator_i *arenas = OArray_data_void(self->arenas);
+    for (osize i = 0; i < OArray_num(self->arenas); i++) {
+        o_allocator_arena_del(&arenas[i]);
+    }
+
+    // deletes the arenas list
+    OObj__v_del(self);
+}
+
+osize OJsonDoc__v_op_num(oobj obj)
+{
+    return OJsonDoc_node_num(OJsonDoc_root(obj));
+}
+
+//
+// object functions:
+//
+
+osize OJsonDoc_arena_size(oobj obj)
+{
+    OObj_assert(obj, OJsonDoc);
+    OJsonDoc *self = obj;
+    osize size = 0;
+    struct o_allocator_i *arenas = OArray_data_void(self->arenas);
+    for (osize i = 0; i < OArray_num(self->arenas); i++) {
+        size += o_allocator_arena_size(arenas[i]);
+    }
+    return size;
+}
+
+//
+// node functions:
+//
+
+const struct OJsonDoc_node *OJsonDoc_node_get(const struct OJsonDoc_node *node, const char *name)
+{
+    if (node->type != OJson_TYPE_OBJECT) {
+        return NULL;
+    }
+    // last one wins, as in OJson_get
+    for (osize i = node->num - 1; i >= 0; i--) {
+        if (o_str_equals(node->data.children[i].name, name)) {
+            return &node->data.children[i];
+        }
+    }
+    return NULL;
+}
+
+OJson *OJsonDoc_node_to_json(const struct OJsonDoc_node *node, oobj parent, const char *name)
+{
+    switch (node->type) {
+        case OJson_TYPE_BOOLEAN:
+            return OJson_new_boolean(parent, name, node->data.boolean);
+        case OJson_TYPE_NUMBER:
+            return OJson_new_number(parent, name, node->data.number);
+        case OJson_TYPE_STRING:
+            return OJson_new_string(parent, name, node->data.string);
+        case OJson_TYPE_OBJECT:
+        case OJson_TYPE_ARRAY: {
+            OJson *json = node->type == OJson_TYPE_OBJECT
+                          ? OJson_new_object(parent, name)
+                          : OJson_new_array(parent, name);
+            for (osize i = 0; i < node->num; i++) {
+                const struct OJsonDoc_node *child = &node->data.children[i];
+                OJsonDoc_node_to_json(child, json, child->name);
+            }
+            return json;
+        }
+        default:
+            return OJson_new_null(parent, name);
+    }
+}
@@ -31,6 +31,150 @@ void *key_string_clone(oobj obj, const void *key)
 }
 
 
+//
+// open addressing table
+//
+
+// smallest table size is 1<<SLOTS_BITS_MIN
+#define SLOTS_BITS_MIN 3
+
+O_STATIC
+osize pair_size(OMap *self)
+{
+    return o_align_size_max(self->key_size) + o_align_size_max(self->value_size) + o_align_size_max(sizeof(ou32));
+}
+
+O_STATIC
+ou32 *pair_hash(OMap *self, osize idx)
+{
+    obyte *kv_pair = OArray_at_void(self->pairs, idx);
+    return (ou32 *) (kv_pair + o_align_size_max(self->key_size) + o_align_size_max(self->value_size));
+}
+
+O_STATIC
+ou32 slot_home(OMap *self, ou32 hash)
+{
+    // fibonacci hashing, to spread weak hashes (like o_str_hash) over the table
+    return (ou32) (hash * 2654435769u) >> (32 - self->slots_bits);
+}
+
+O_STATIC
+ou32 slot_dist(OMap *self, ou32 pos)
+{
+    ou32 mask = ((ou32) 1 << self->slots_bits) - 1;
+    return (pos - slot_home(self, self->slots[pos].hash)) & mask;
+}
+
+// robin hood insert, the pair must not be in the table yet
+O_STATIC
+void slot_insert(OMap *self, ou32 hash, ou32 pair)
+{
+    ou32 mask = ((ou32) 1 << self->slots_bits) - 1;
+    OMap_slot entry = {hash, pair};
+    ou32 pos = slot_home(self, hash);
+    ou32 dist = 0;
+    for (;;) {
+        OMap_slot *slot = &self->slots[pos];
+        if (!slot->pair) {
+            *slot = entry;
+            return;
+        }
+        ou32 slot_d = slot_dist(self, pos);
+        if (slot_d < dist) {
+            // rich slot, take its place and move on with the poor one
+            OMap_slot tmp = *slot;
+            *slot = entry;
+            entry = tmp;
+            dist = slot_d;
+        }
+        pos = (pos + 1) & mask;
+        dist++;
+    }
+}
+
+// returns the slot position of the key, or -1
+O_STATIC
+osize slot_find(OMap *self, const void *key, ou32 hash)
+{
+    ou32 mask = ((ou32) 1 << self->slots_bits) - 1;
+    const obyte *pairs = OArray_data_void(self->pairs);
+    osize stride = pair_size(self);
+    ou32 pos = slot_home(self, hash);
+    ou32 dist = 0;
+    for (;;) {
+        OMap_slot *slot = &self->slots[pos];
+        if (!slot->pair) {
+            return -1;
+        }
+        if (slot->hash == hash && self->v_equals(key, pairs + (slot->pair - 1) * stride)) {
+            return pos;
+        }
+        if (slot_dist(self, pos) < dist) {
+            // robin hood invariant: the key would have been placed before
+            return -1;
+        }
+        pos = (pos + 1) & mask;
+        dist++;
+    }
+}
+
+// returns the slot position of the pair idx
+O_STATIC
+osize slot_find_pair(OMap *self, osize idx)
+{
+    ou32 mask = ((ou32) 1 << self->slots_bits) - 1;
+    ou32 pos = slot_home(self, *pair_hash(self, idx));
+    while (self->slots[pos].pair != (ou32) idx + 1) {
+        assert(self->slots[pos].pair && "OMap table corrupt");
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+// removes the slot with backward shift deletion (no tombstones)
+O_STATIC
+void slot_remove(OMap *self, ou32 pos)
+{
+    ou32 mask = ((ou32) 1 << self->slots_bits) - 1;
+    ou32 next = (pos + 1) & mask;
+    while (self->slots[next].pair && slot_dist(self, next) > 0) {
+        self->slots[pos] = self->slots[next];
+        pos = next;
+        next = (next + 1) & mask;
+    }
+    self->slots[pos] = (OMap_slot) {0};
+}
+
+// (re)creates the table with 1<<bits slots and inserts all pairs with their cached hash
+O_STATIC
+void slots_rehash(OMap *self, int bits)
+{
+    if (self->slots) {
+        o_free(self, self->slots);
+    }
+    self->slots_bits = bits;
+    self->slots = o_new0(self, OMap_slot, (osize) 1 << bits);
+    osize num = OArray_num(self->pairs);
+    for (osize i = 0; i < num; i++) {
+        slot_insert(self, *pair_hash(self, i), (ou32) i + 1);
+    }
+}
+
+O_STATIC
+int slots_bits_for(osize num)
+{
+    int bits = SLOTS_BITS_MIN;
+    // max load factor of 3/4
+    while (((osize) 1 << bits) * 3 / 4 < num) {
+        bits++;
+    }
+    return bits;
+}
+
+//
+// public
+//
+
 OMap *OMap_init(oobj obj, oobj parent, osize key_size, osize value_size, osize approx_num,
                 OMap__key_hash_fn hash_fn, OMap__key_equals_fn equals_fn, OMap__key_clone_fn clone_fn)
 {
@@ -43,13 +187,11 @@ OMap *OMap_init(oobj obj, oobj parent, osize key_size, osize value_size, osize a
     self->key_size = key_size;
     self->value_size = value_size;
 
-    // pairs of key and value elements
-    osize key_size_aligned = o_align_size_max(key_size);
-    osize value_size_aligned = o_align_size_max(value_size);
-    self->pairs = OArray_new_dyn(self, NULL, key_size_aligned + value_size_aligned, 0, approx_num);
+    // pairs of key and value elements, followed by the cached hash
+    self->pairs = OArray_new_dyn(self, NULL, pair_size(self), 0, approx_num);
 
-    // the hashmap is at first a list of possible DataDyn arrays
-    self->hashmap = OArray_new(self, NULL, sizeof(oobj), approx_num);
+    // open addressing table, grows automatically
+    slots_rehash(self, slots_bits_for(approx_num));
 
     // vfuncs
     self->super.v_op_num = OMap__v_op_num;
@@ -104,28 +246,11 @@ osize OMap_get_idx(oobj obj, const void *key)
 {
     OObj_assert(obj, OMap);
     OMap *self = obj;
-    ou32 hash = self->v_hash(key);
-
-    // the first hashmap returns a list of keys that may fit
-    // list is an OArray of osize elements, which are indices into the self->pairs list
-    oobj list = *OArray_at(self->hashmap, hash % OArray_num(self->hashmap), oobj);
-    if (!list) {
-        // list under that hash% not available, so pair not available, too
+    osize pos = slot_find(self, key, self->v_hash(key));
+    if (pos < 0) {
         return -1;
     }
-
-    // search in the list for the key
-    osize idx = -1;
-    for (osize i = 0; i < OArray_num(list); i++) {
-        osize test_idx = *OArray_at(list, i, osize);
-        if (self->v_equals(key, OMap_key_at_void(self, test_idx))) {
-            idx = test_idx;
-            break;
-        }
-    }
-
-    // -1 if failed, else the valid idx
-    return idx;
+    return (osize) self->slots[pos].pair - 1;
 }
 
 osize OMap_set(oobj obj, const void *key, const void *value)
@@ -134,33 +259,27 @@ osize OMap_set(oobj obj, const void *key, const void *value)
     OMap *self = obj;
     ou32 hash = self->v_hash(key);
 
-    // the first hashmap returns a list of keys that may fit
-    // list is an OArray of osize elements, which are indices into the self->pairs list
-    oobj *list_ptr = OArray_at(self->hashmap, hash % OArray_num(self->hashmap), oobj);
-    if (!*list_ptr) {
-        // list under that hash% not created yet:
-        *list_ptr = OArray_new_dyn(self, NULL, sizeof(osize), 0, 4);
-    }
-
-    // search in the list for the key
-    osize idx = -1;
-    for (osize i = 0; i < OArray_num(*list_ptr); i++) {
-        osize test_idx = *OArray_at(*list_ptr, i, osize);
-        if (self->v_equals(key, OMap_key_at_void(self, test_idx))) {
-            idx = test_idx;
-            break;
+    osize idx;
+    osize pos = slot_find(self, key, hash);
+    if (pos >= 0) {
+        idx = (osize) self->slots[pos].pair - 1;
+    } else {
+        // key not found, add it
+        osize num = OArray_num(self->pairs) + 1;
+        if (num > ((osize) 1 << self->slots_bits) * 3 / 4) {
+            slots_rehash(self, self->slots_bits + 1);
         }
-    }
 
-    // key not found, add it
-    if (idx < 0) {
+        // clone before pushing, key may point into the pairs
+        void *clone = self->v_clone(self, key);
+
         // add a pair and copy the key to it
         void *kv_pair = OArray_push(self->pairs, NULL);
         char **new_key_ptr = kv_pair;
-        *new_key_ptr = self->v_clone(self, key);
-        // update idx to the new pair and add it to the list
-        idx = OArray_num(self->pairs) - 1;
-        OArray_push(*list_ptr, &idx);
+        *new_key_ptr = clone;
+        idx = num - 1;
+        *pair_hash(self, idx) = hash;
+        slot_insert(self, hash, (ou32) num);
     }
 
     // set the value
@@ -172,55 +291,25 @@ bool OMap_remove(oobj obj, const void *key)
 {
     OObj_assert(obj, OMap);
     OMap *self = obj;
-    ou32 hash = self->v_hash(key);
-
-    // the first hashmap returns a list of keys that may fit
-    // list is an OArray of osize elements, which are indices into the self->pairs list
-    oobj list = *OArray_at(self->hashmap, hash % OArray_num(self->hashmap), oobj);
-    if (!list) {
-        // list under that hash% not available, so pair not available, too
-        return false;
-    }
-
-    // search in the list for the key
-    osize idx = -1;
-    osize list_i = 0;
-    for (osize i = 0; i < OArray_num(list); i++) {
-        osize test_idx = *OArray_at(list, i, osize);
-        if (self->v_equals(key, OMap_key_at_void(self, test_idx))) {
-            idx = test_idx;
-            list_i = i;
-            break;
-        }
-    }
+    osize pos = slot_find(self, key, self->v_hash(key));
 
     // key not found
-    if (idx < 0) {
+    if (pos < 0) {
         return false;
     }
+    // key may point into the pairs, so not valid from here on
 
-    // remove the key value pair
-    OArray_pop_at(self->pairs, idx, NULL);
+    osize idx = (osize) self->slots[pos].pair - 1;
+    slot_remove(self, (ou32) pos);
 
-
-    // remove the idx entry in the list
-    OArray_pop_at(list, list_i, NULL);
-
-    // traverse the whole hashmap to reduce indices, greater the removed idx
-    for (osize i = 0; i < OArray_num(self->hashmap); i++) {
-        list = *OArray_at(self->hashmap, i, oobj);
-        if (!list) {
-            continue;
-        }
-        for (osize l = 0; l < OArray_num(list); l++) {
-            osize *index = OArray_at(list, l, osize);
-
-            // check if index>idx and reduce it by one
-            if (*index > idx) {
-                (*index)--;
-            }
-        }
+    // swap remove, move the last pair into the removed idx
+    osize last = OArray_num(self->pairs) - 1;
+    if (idx != last) {
+        pos = slot_find_pair(self, last);
+        self->slots[pos].pair = (ou32) idx + 1;
+        o_memcpy(OArray_at_void(self->pairs, idx), OArray_at_void(self->pairs, last), 1, pair_size(self));
     }
+    OArray_pop(self->pairs, NULL);
 
     return true;
 }
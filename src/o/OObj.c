@@ -2,14 +2,15 @@
 #include "o/OObjRoot.h"
 #include "o/str.h"
 #include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_atomic.h>
 
 #define O_LOG_LIB "o"
 
 #include "o/log.h"
 
+// a larger object would take a 512 byte block of the slab allocator
+static_assert(sizeof(OObj) <= 256, "OObj does not fit into the 256 byte size class");
 
-// pointer size should be maximal 8 bytes, so the default pool block size of 256
-#define RESOURCES_START_CAPACITY 32
 
 // protected
 O_EXTERN
@@ -21,24 +22,43 @@ void OObj__init_base(oobj obj, struct o_allocator_i allocator)
     OObj_id_set(self, OObj_ID);
     self->allocator = allocator;
 
-    // manually alloc memory array
-    self->mem_capacity = RESOURCES_START_CAPACITY;
+    // the first entries are stored inline, the mutex is created lazy in o_lock
+    self->mem = self->mem_inline;
+    self->mem_capacity = OObj_MEM_INLINE;
 
-    self->mem = o_allocator_i_realloc_try(self->allocator,
-                                          NULL, sizeof *self->mem,
-                                          self->mem_capacity);
-
-
-#ifdef MIA_OPTION_THREAD
-    self->mutex = SDL_CreateMutex();
-    o_assume(self->mutex, "SDL_CreateMutex failed");
-#endif
+    self->children = self->children_inline;
+    self->children_capacity = OObj_CHILDREN_INLINE;
 
     self->v_del = OObj__v_del;
+}
+
+void OObj__relocate(oobj obj, const void *from)
+{
+    OObj *self = obj;
+    const OObj *old = from;
+    if (self->mem == old->mem_inline) {
+        self->mem = self->mem_inline;
+    }
+    if (self->children == old->children_inline) {
+        self->children = self->children_inline;
+    }
+}
 
-    // the mem list is now normally functionable
-    self->children = o_new(self, *self->children, RESOURCES_START_CAPACITY);
-    self->children_capacity = RESOURCES_START_CAPACITY;
+// grows a list of pointers, moving out of the inline storage, if necessary
+O_STATIC
+void **list_grow(OObj *self, void **list, void **list_inline, osize num, osize *capacity)
+{
+    *capacity = num * 2;
+    if (list == list_inline) {
+        list = o_allocator_i_realloc_try(self->allocator, NULL, sizeof *list, *capacity);
+        o_assume(list, "resource list allocation failed");
+        o_memcpy(list, list_inline, sizeof *list, num);
+        return list;
+    }
+    // manually relloc
+    list = o_allocator_i_realloc_try(self->allocator, list, sizeof *list, *capacity);
+    o_assume(list, "resource list allocation failed");
+    return list;
 }
 
 O_STATIC
@@ -46,10 +66,11 @@ void child_add(OObj *parent, OObj *child)
 {
     osize old_num = parent->children_num++;
     if (parent->children_num > parent->children_capacity) {
-        parent->children_capacity = old_num * 2;
-        parent->children = o_renew(parent, parent->children, oobj, parent->children_capacity);
+        parent->children = list_grow(parent, parent->children, parent->children_inline,
+                                     old_num, &parent->children_capacity);
     }
     parent->children[old_num] = child;
+    parent->children_stamp++;
 }
 
 O_STATIC
@@ -73,6 +94,130 @@ void child_rem(OObj *parent, OObj *child)
     parent->children_num--;
     o_memmove(&parent->children[idx], &parent->children[idx + 1], sizeof *parent->children,
               (parent->children_num - idx));
+    parent->children_stamp++;
+}
+
+
+//
+// mem index
+// open addressing with linear probing and backward shift deletion (no tombstones)
+// maps a mem pointer to its slot in the mem list
+//
+
+struct mem_index_entry {
+    void *mem;
+    osize slot;
+};
+
+struct mem_index {
+    // always a power of 2
+    osize capacity;
+    osize num;
+    struct mem_index_entry entries[];
+};
+
+O_STATIC
+osize mem_index_hash(const struct mem_index *index, const void *mem)
+{
+    // fibonacci hashing, allocations are aligned, so the lower bits are (nearly) always 0
+    ou64 h = ((ou64) (uintptr_t) mem >> 4) * 11400714819323198485llu;
+    return (osize) (h >> 32) & (index->capacity - 1);
+}
+
+O_STATIC
+struct mem_index *mem_index_new(OObj *self, osize capacity)
+{
+    struct mem_index *index = o_allocator_i_realloc_try(self->allocator, NULL, 1,
+                                                        sizeof *index + sizeof *index->entries * capacity);
+    o_assume(index, "mem index allocation failed");
+    index->capacity = capacity;
+    index->num = 0;
+    o_clear(index->entries, sizeof *index->entries, capacity);
+    return index;
+}
+
+// returns the position in the entries, or -1 if not found
+O_STATIC
+osize mem_index_find(const struct mem_index *index, const void *mem)
+{
+    osize mask = index->capacity - 1;
+    for (osize i = mem_index_hash(index, mem);; i = (i + 1) & mask) {
+        if (index->entries[i].mem == mem) {
+            return i;
+        }
+        if (!index->entries[i].mem) {
+            return -1;
+        }
+    }
+}
+
+// inserts or updates an entry, does not grow
+O_STATIC
+void mem_index_put(struct mem_index *index, void *mem, osize slot)
+{
+    osize mask = index->capacity - 1;
+    osize i = mem_index_hash(index, mem);
+    while (index->entries[i].mem && index->entries[i].mem != mem) {
+        i = (i + 1) & mask;
+    }
+    if (!index->entries[i].mem) {
+        index->num++;
+    }
+    index->entries[i] = (struct mem_index_entry) {mem, slot};
+}
+
+O_STATIC
+void mem_index_remove(struct mem_index *index, const void *mem)
+{
+    osize mask = index->capacity - 1;
+    osize hole = mem_index_find(index, mem);
+    assert(hole >= 0 && "invalid mem index remove");
+    index->num--;
+
+    // backward shift the following cluster into the hole
+    for (osize i = (hole + 1) & mask; index->entries[i].mem; i = (i + 1) & mask) {
+        osize home = mem_index_hash(index, index->entries[i].mem);
+        // is home cyclically outside of (hole, i]?
+        bool movable = hole <= i
+                       ? (home <= hole || home > i)
+                       : (home <= hole && home > i);
+        if (movable) {
+            index->entries[hole] = index->entries[i];
+            hole = i;
+        }
+    }
+    index->entries[hole] = (struct mem_index_entry) {0};
+}
+
+// (re)builds the index from the mem list, with a load factor <= 0.25
+O_STATIC
+void mem_index_build(OObj *self)
+{
+    osize capacity = 64;
+    while (capacity < self->mem_num * 4) {
+        capacity *= 2;
+    }
+    if (self->mem_index) {
+        o_allocator_i_realloc_try(self->allocator, self->mem_index, 0, 0);
+    }
+    struct mem_index *index = mem_index_new(self, capacity);
+    for (osize i = 0; i < self->mem_num; i++) {
+        mem_index_put(index, self->mem[i], i);
+    }
+    self->mem_index = index;
+}
+
+// sets the slot for mem and grows the index if necessary
+O_STATIC
+void mem_index_set(OObj *self, void *mem, osize slot)
+{
+    struct mem_index *index = self->mem_index;
+    if ((index->num + 1) * 2 > index->capacity) {
+        // the mem list already holds mem at slot, so a rebuild includes it
+        mem_index_build(self);
+        return;
+    }
+    mem_index_put(index, mem, slot);
 }
 
 
@@ -81,17 +226,30 @@ void mem_add(OObj *self, void *mem)
 {
     osize old_num = self->mem_num++;
     if (self->mem_num > self->mem_capacity) {
-        self->mem_capacity = old_num * 2;
-        // manually relloc
-        self->mem = o_allocator_i_realloc_try(self->allocator, self->mem, sizeof *self->mem, self->mem_capacity);
-        o_assume(self->mem, "memory list allocation failed");
+        self->mem = list_grow(self, self->mem, self->mem_inline, old_num, &self->mem_capacity);
     }
     self->mem[old_num] = mem;
+
+    if (self->mem_index) {
+        mem_index_set(self, mem, old_num);
+    } else if (self->mem_num > OObj_MEM_INDEX_THRESHOLD) {
+        mem_index_build(self);
+    }
 }
 
 O_STATIC
 osize mem_idx(OObj *self, void *mem)
 {
+    if (self->mem_index) {
+        // most recent allocation first, like the linear search below
+        if (self->mem[self->mem_num - 1] == mem) {
+            return self->mem_num - 1;
+        }
+        struct mem_index *index = self->mem_index;
+        osize pos = mem_index_find(index, mem);
+        return pos >= 0 ? index->entries[pos].slot : -1;
+    }
+
     // search back, faster in most cases
     for (osize i = self->mem_num - 1; i >= 0; i--) {
         if (self->mem[i] == mem) {
@@ -102,13 +260,34 @@ osize mem_idx(OObj *self, void *mem)
 }
 
 // does NOT free it
+// the last entry takes the slot of the removed one
 O_STATIC
 void mem_rem(OObj *self, void *mem)
 {
     osize idx = mem_idx(self, mem);
     assert(idx >= 0 && "invalid memory remove");
     self->mem_num--;
-    o_memmove(&self->mem[idx], &self->mem[idx + 1], sizeof *self->mem, (self->mem_num - idx));
+    void *last = self->mem[self->mem_num];
+    self->mem[idx] = last;
+
+    if (self->mem_index) {
+        mem_index_remove(self->mem_index, mem);
+        if (idx != self->mem_num) {
+            mem_index_put(self->mem_index, last, idx);
+        }
+    }
+}
+
+// replaces the entry in slot idx with a reallocated mem
+O_STATIC
+void mem_replace(OObj *self, osize idx, void *mem)
+{
+    void *old_mem = self->mem[idx];
+    self->mem[idx] = mem;
+    if (self->mem_index && old_mem != mem) {
+        mem_index_remove(self->mem_index, old_mem);
+        mem_index_put(self->mem_index, mem, idx);
+    }
 }
 
 
@@ -144,7 +323,7 @@ void OObj__v_del(oobj obj)
 
     bool self_in_mem = false;
 
-    // free memory (also contains the children list)
+    // free memory
     for (osize i = 0; i < self->mem_num; i++) {
         if (self->mem[i] == self) {
             self_in_mem = true;
@@ -152,12 +331,22 @@ void OObj__v_del(oobj obj)
         }
         o_allocator_i_realloc_try(self->allocator, self->mem[i], 0, 0);
     }
-    // manually free the mem list
-    o_allocator_i_realloc_try(self->allocator, self->mem, 0, 0);
+    // manually free the lists, if they grew out of the inline storage
+    if (self->mem != self->mem_inline) {
+        o_allocator_i_realloc_try(self->allocator, self->mem, 0, 0);
+    }
+    if (self->children != self->children_inline) {
+        o_allocator_i_realloc_try(self->allocator, self->children, 0, 0);
+    }
+    if (self->mem_index) {
+        o_allocator_i_realloc_try(self->allocator, self->mem_index, 0, 0);
+    }
 
 #ifdef MIA_OPTION_THREAD
-    // kill the mutex
-    SDL_DestroyMutex(self->mutex);
+    // kill the mutex, if it was ever created
+    if (self->mutex) {
+        SDL_DestroyMutex(self->mutex);
+    }
 #endif
 
     if (self_in_mem) {
@@ -169,6 +358,141 @@ void OObj__v_del(oobj obj)
 }
 
 
+//
+// type registry
+//
+
+#define TYPE_BUCKETS 1024
+
+// type, chained by the hash of the id string
+struct type_entry {
+    struct OObj_type type;
+    ou32 hash;
+    struct type_entry *next;
+};
+
+// the chains are only prepended (under the lock), so lookups can run lock free
+static struct {
+    SDL_SpinLock lock;
+    struct type_entry *types[TYPE_BUCKETS];
+
+    // trie of all id prefixes as open addressing map: (parent node << 8 | char) -> node
+    ou64 *trie_keys;
+    ou32 *trie_nodes;
+    osize trie_capacity;
+    osize trie_num;
+    ou32 nodes_num;
+} L_types;
+
+O_STATIC
+ou32 type_hash(const char *id)
+{
+    // fnv-1a
+    ou32 hash = 2166136261u;
+    for (; *id; id++) {
+        hash = (hash ^ (ou8) *id) * 16777619u;
+    }
+    return hash;
+}
+
+O_STATIC
+osize type_trie_slot(ou64 key, osize capacity)
+{
+    return (osize) ((key * 0x9E3779B97F4A7C15ull) >> 32) & (capacity - 1);
+}
+
+// returns the child node of parent for the char c, creates it if necessary, lock must be held
+O_STATIC
+ou32 type_trie_child(ou32 parent, char c)
+{
+    if ((L_types.trie_num + 1) * 4 > L_types.trie_capacity * 3) {
+        osize capacity = o_max(256, L_types.trie_capacity * 2);
+        ou64 *keys = SDL_calloc((size_t) capacity, sizeof *keys);
+        ou32 *nodes = SDL_malloc((size_t) capacity * sizeof *nodes);
+        o_assume(keys && nodes, "OObj type trie allocation failed");
+        for (osize i = 0; i < L_types.trie_capacity; i++) {
+            if (!L_types.trie_keys[i]) {
+                continue;
+            }
+            osize slot = type_trie_slot(L_types.trie_keys[i], capacity);
+            while (keys[slot]) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            keys[slot] = L_types.trie_keys[i];
+            nodes[slot] = L_types.trie_nodes[i];
+        }
+        SDL_free(L_types.trie_keys);
+        SDL_free(L_types.trie_nodes);
+        L_types.trie_keys = keys;
+        L_types.trie_nodes = nodes;
+        L_types.trie_capacity = capacity;
+    }
+
+    // chars are never 0, so neither are the keys
+    ou64 key = ((ou64) parent << 8) | (ou8) c;
+    osize slot = type_trie_slot(key, L_types.trie_capacity);
+    while (L_types.trie_keys[slot]) {
+        if (L_types.trie_keys[slot] == key) {
+            return L_types.trie_nodes[slot];
+        }
+        slot = (slot + 1) & (L_types.trie_capacity - 1);
+    }
+    L_types.trie_keys[slot] = key;
+    L_types.trie_nodes[slot] = ++L_types.nodes_num;
+    L_types.trie_num++;
+    return L_types.trie_nodes[slot];
+}
+
+O_STATIC
+const struct OObj_type *type_find(const char *id, ou32 hash)
+{
+    struct type_entry *entry = SDL_AtomicGetPtr((void **) &L_types.types[hash & (TYPE_BUCKETS - 1)]);
+    for (; entry; entry = entry->next) {
+        if (entry->hash == hash && strcmp(entry->type.id, id) == 0) {
+            return &entry->type;
+        }
+    }
+    return NULL;
+}
+
+const struct OObj_type *OObj_type_intern(const char *id)
+{
+    assert(id && "id must not be NULL");
+    ou32 hash = type_hash(id);
+    const struct OObj_type *type = type_find(id, hash);
+    if (type) {
+        return type;
+    }
+
+    SDL_AtomicLock(&L_types.lock);
+    // may have been added in the meantime
+    type = type_find(id, hash);
+    if (!type) {
+        // entry, prefix numbers and id string in a single block
+        osize len = o_strlen(id);
+        struct type_entry *entry = SDL_malloc(sizeof *entry + (len + 1) * sizeof(ou32) + len + 1);
+        o_assume(entry, "OObj type allocation failed");
+        ou32 *prefix = (ou32 *) (entry + 1);
+        char *entry_id = (char *) (prefix + len + 1);
+        o_memcpy(entry_id, id, 1, len + 1);
+
+        prefix[0] = 0;
+        for (osize i = 0; i < len; i++) {
+            prefix[i + 1] = type_trie_child(prefix[i], id[i]);
+        }
+        entry->type = (struct OObj_type) {entry_id, (oi32) len, prefix[len], prefix};
+        entry->hash = hash;
+
+        struct type_entry **bucket = &L_types.types[hash & (TYPE_BUCKETS - 1)];
+        entry->next = *bucket;
+        // publishes the fully written entry
+        SDL_AtomicSetPtr((void **) bucket, entry);
+        type = &entry->type;
+    }
+    SDL_AtomicUnlock(&L_types.lock);
+    return type;
+}
+
 void OObj_id_mismatch_log_wtf(oobj obj, const char *id, const char *func)
 {
     if (OObj_check(obj, OObj)) {
@@ -189,24 +513,49 @@ void OObj_name_set(oobj obj, const char *opt_name)
     o_lock_block(obj) {
         self->opt_name = o_str_clone_realloc(obj, self->opt_name, opt_name);
     }
+    if (self->parent) {
+        // invalidates name indices of the parent, which are built under its lock
+        OObj *parent = self->parent;
+        o_lock_block(parent) {
+            parent->children_stamp++;
+        }
+    }
 }
 
 
 #ifdef MIA_OPTION_THREAD
 
+// protected
+// returns the mutex of the object and creates it, if not done yet
+O_EXTERN
+void *OObj__mutex(oobj obj)
+{
+    OObj *self = obj;
+    void *mutex = SDL_AtomicGetPtr(&self->mutex);
+    if (mutex) {
+        return mutex;
+    }
+
+    mutex = SDL_CreateMutex();
+    o_assume(mutex, "SDL_CreateMutex failed");
+    if (!SDL_AtomicCASPtr(&self->mutex, NULL, mutex)) {
+        // another thread was faster
+        SDL_DestroyMutex(mutex);
+    }
+    return SDL_AtomicGetPtr(&self->mutex);
+}
+
 void o_lock(oobj obj)
 {
     OObj_assert(obj, OObj);
-    OObj *self = obj;
-    int ret = SDL_LockMutex(self->mutex);
+    int ret = SDL_LockMutex(OObj__mutex(obj));
     o_assume(ret != -1, "SDL_LockMutex failed");
 }
 
 bool o_lock_try(oobj obj)
 {
     OObj_assert(obj, OObj);
-    OObj *self = obj;
-    int ret = SDL_TryLockMutex(self->mutex);
+    int ret = SDL_TryLockMutex(OObj__mutex(obj));
     o_assume(ret != -1, "SDL_TryLockMutex failed");
     return ret == 0;
 }
@@ -215,6 +564,7 @@ void o_unlock(oobj obj)
 {
     OObj_assert(obj, OObj);
     OObj *self = obj;
+    assert(self->mutex && "o_unlock without o_lock");
     int ret = SDL_UnlockMutex(self->mutex);
     o_assume(ret != -1, "SDL_UnLockMutex failed");
 }
@@ -363,12 +713,14 @@ oobj *OObj_list_id(oobj obj, osize *opt_out_num, const char *id)
     OObj_assert(obj, OObj);
     OObj *self = obj;
 
+    // resolve the type once, so the loop compares integers
+    const struct OObj_type *type = OObj_type_intern(id);
     oobj *list = NULL;
     osize num = 0;
     o_lock_block(self) {
         list = o_new(obj, oobj, self->children_num + 1);
         for (osize i = 0; i < self->children_num; i++) {
-            if (OObj_id_check(self->children[i], id)) {
+            if (OObj_type_check(self->children[i], type)) {
                 list[num++] = self->children[i];
             }
         }
@@ -384,12 +736,111 @@ oobj *OObj_list_id(oobj obj, osize *opt_out_num, const char *id)
 
 
 
+//
+// child iterator
+//
+
+struct OObj_iter OObj_iter_new(oobj obj, const char *id, bool reverse, oi32 r_level)
+{
+    OObj_assert(obj, OObj);
+    struct OObj_iter it = {0};
+    it.type = OObj_type_intern(id);
+    it.reverse = reverse;
+    it.r_level = o_clamp(r_level, 0, OObj_ITER_DEPTH_MAX - 1);
+    it.frames[0].obj = obj;
+    it.depth = 1;
+    return it;
+}
+
+// picks the next child of a frame, or NULL if done
+O_STATIC
+OObj *iter_frame_next(struct OObj_iter *it, oi32 f)
+{
+    OObj *parent = it->frames[f].obj;
+    OObj *child = NULL;
+    o_lock_block(parent) {
+        osize num = parent->children_num;
+        osize idx;
+        if (!it->frames[f].last) {
+            idx = it->reverse ? num - 1 : 0;
+        } else {
+            osize at = it->frames[f].idx;
+            if (parent->children_stamp != it->frames[f].stamp
+                && (at >= num || parent->children[at] != it->frames[f].last)) {
+                // children changed in the loop body, search the last child again
+                at = child_idx(parent, it->frames[f].last);
+                if (at < 0) {
+                    // last child was removed, so the following children moved one back
+                    at = it->reverse ? o_min(it->frames[f].idx, num) : it->frames[f].idx - 1;
+                }
+            }
+            idx = at + (it->reverse ? -1 : 1);
+        }
+        it->frames[f].stamp = parent->children_stamp;
+        if (idx >= 0 && idx < num) {
+            child = parent->children[idx];
+            it->frames[f].idx = idx;
+        }
+        it->frames[f].last = child;
+    }
+    return child;
+}
+
+// pushes it->descend as new frame, if still a child of the top frame
+O_STATIC
+void iter_descend(struct OObj_iter *it)
+{
+    OObj *child = it->descend;
+    it->descend = NULL;
+    oi32 f = it->depth - 1;
+    OObj *parent = it->frames[f].obj;
+    bool alive;
+    o_lock_block(parent) {
+        alive = parent->children_stamp == it->frames[f].stamp || child_idx(parent, child) >= 0;
+    }
+    if (!alive) {
+        return;
+    }
+    it->frames[it->depth].obj = child;
+    it->frames[it->depth].last = NULL;
+    it->depth++;
+}
+
+bool OObj_iter_next(struct OObj_iter *it)
+{
+    if (it->descend) {
+        iter_descend(it);
+    }
+    while (it->depth > 0) {
+        oi32 f = it->depth - 1;
+        OObj *child = iter_frame_next(it, f);
+        if (!child) {
+            it->depth--;
+            continue;
+        }
+        if (f < it->r_level) {
+            it->descend = child;
+        }
+        if (OObj_type_check(child, it->type)) {
+            it->child = child;
+            it->level = f;
+            return true;
+        }
+        if (it->descend) {
+            iter_descend(it);
+        }
+    }
+    it->child = NULL;
+    return false;
+}
+
+
 // recursive find child (if full is true)
 O_STATIC
-OObj *find_child_r(OObj *self, const char *id, const char *opt_name, oi32 r_level)
+OObj *find_child_r(OObj *self, const struct OObj_type *type, const char *opt_name, oi32 r_level)
 {
     for (osize i = 0; i < self->children_num; i++) {
-        if (!OObj_id_check(self->children[i], id)) {
+        if (!OObj_type_check(self->children[i], type)) {
             continue;
         }
         OObj *child = self->children[i];
@@ -402,7 +853,7 @@ OObj *find_child_r(OObj *self, const char *id, const char *opt_name, oi32 r_leve
         return NULL;
     }
     for (osize i = 0; i < self->children_num; i++) {
-        OObj *found = find_child_r(self->children[i], id, opt_name, r_level - 1);
+        OObj *found = find_child_r(self->children[i], type, opt_name, r_level - 1);
         if (found) {
             return found;
         }
@@ -418,16 +869,17 @@ struct oobj_opt OObj_find_id(oobj obj, const char *id, const char *opt_name, oi3
     }
     OObj_assert(obj, OObj);
     OObj *self = obj;
+    const struct OObj_type *type = OObj_type_intern(id);
     OObj *search = NULL;
     o_lock_block(obj) {
-        if (OObj_id_check(self, id)) {
+        if (OObj_type_check(self, type)) {
             if (!opt_name || o_str_equals(self->opt_name, opt_name)) {
                 search = self;
             }
         }
 
         if (!search) {
-            search = find_child_r(self, id, opt_name, o_max(0, r_level));
+            search = find_child_r(self, type, opt_name, o_max(0, r_level));
         }
     }
     return oobj_opt(search);
@@ -436,14 +888,14 @@ struct oobj_opt OObj_find_id(oobj obj, const char *id, const char *opt_name, oi3
 
 // recursive find parent (if full is true)
 O_STATIC
-OObj *find_parent_r(OObj *self, const char *id, const char *opt_name, oi32 r_level)
+OObj *find_parent_r(OObj *self, const struct OObj_type *type, const char *opt_name, oi32 r_level)
 {
     OObj *parent = self->parent;
     if (parent == NULL) {
         return NULL;
     }
     OObj *found = NULL;
-    if (OObj_id_check(parent, id)) {
+    if (OObj_type_check(parent, type)) {
         found = parent;
         if (opt_name && !o_str_equals(parent->opt_name, opt_name)) {
             found = NULL;
@@ -456,7 +908,7 @@ OObj *find_parent_r(OObj *self, const char *id, const char *opt_name, oi32 r_lev
     if (r_level <= 0) {
         return NULL;
     }
-    return find_parent_r(parent, id, opt_name, r_level - 1);
+    return find_parent_r(parent, type, opt_name, r_level - 1);
 }
 
 struct oobj_opt OObj_find_parent_id(oobj obj, const char *id, const char *opt_name, oi32 r_level)
@@ -468,7 +920,7 @@ struct oobj_opt OObj_find_parent_id(oobj obj, const char *id, const char *opt_na
     OObj *self = obj;
     OObj *search = NULL;
     o_lock_block(obj) {
-        search = find_parent_r(self, id, opt_name, o_max(0, r_level));
+        search = find_parent_r(self, OObj_type_intern(id), opt_name, o_max(0, r_level));
     }
     return oobj_opt(search);
 }
@@ -548,8 +1000,10 @@ void *o_realloc_try(oobj obj, void *mem, osize element_size, osize num)
                 mem_rem(owner, old_mem);
                 ret = NULL;
             } else {
-                // realloc
-                owner->mem[idx] = mem;
+                // realloc (on failure, the old mem stays valid and in the list)
+                if (mem) {
+                    mem_replace(owner, idx, mem);
+                }
                 ret = mem;
             }
 
@@ -1,16 +1,25 @@
 #include "o/OPattern.h"
 #include "o/OObj_builder.h"
 #include "o/OArray.h"
+#include <SDL2/SDL_atomic.h>
+#include <string.h>
 
 #define O_LOG_LIB "o"
 #include "o/log.h"
 
 
-#define FIND_ALL_CAPACITY_JUMPS 16
+#define FIND_ALL_CAPACITY_MIN 16
 
 #define GROUPS_CAP_JUMPS 16
 #define CAPTURES_CAP_JUMPS 8
 
+// larger patterns only use the backtracking matcher
+#define DFA_ITEMS_MAX 1024
+#define DFA_STATES_MAX 512
+
+#define DFA_FLAG_MATCH 0x01
+#define DFA_FLAG_ALIVE 0x02
+
 
 // other sets are generated in code, like dot or uppercase versions
 static const char SET_c[] = "\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B\x0C\x0D\x0E\x0F"        \
@@ -431,6 +440,260 @@ void parse(OPattern *self, const char *pattern)
     }
 }
 
+//
+// dfa
+//
+
+// PLUS groups are expanded into SINGLE + MUL
+struct dfa_item {
+    const struct OPattern_group *group;
+    enum OPattern_group_mode mode;
+};
+
+// a dfa state is an ordered (priority) list of items (threads), like in the backtracking order
+struct dfa_state {
+    osize offset;
+    osize num;
+    ou32 hash;
+    bool match;
+};
+
+struct OPattern_dfa {
+    osize states_num;
+    int classes_num;
+
+    // byte -> equivalence class of all groups
+    obyte classes[256];
+
+    // states_num * classes_num transitions, state 0 is dead, 1 is the start
+    ou16 *next;
+
+    // DFA_FLAG_* for each state
+    obyte *flags;
+
+    // bytes that may start a non empty match
+    struct OPattern_group first;
+
+    // the only first byte for memchr, or -1
+    int first_single;
+};
+
+// appends the epsilon closure of item idx to the list
+// returns true if the end of the pattern (match) was reached, so all following threads have a lower priority
+O_STATIC
+bool dfa_closure(const struct dfa_item *items, osize items_num, osize idx,
+                 ou16 *list, osize *num, bool *seen)
+{
+    for (;;) {
+        if (idx >= items_num) {
+            return true;
+        }
+        if (seen[idx]) {
+            // closure was already added by a thread with a higher priority
+            return false;
+        }
+        seen[idx] = true;
+        list[(*num)++] = (ou16) idx;
+        if (items[idx].mode == OPattern_group_MODE_SINGLE) {
+            return false;
+        }
+        // MUL and OPT may also be skipped
+        idx++;
+    }
+}
+
+O_STATIC
+ou32 dfa_list_hash(const ou16 *list, osize num, bool match)
+{
+    ou32 hash = match ? 1 : 0;
+    for (osize i = 0; i < num; i++) {
+        hash = hash * 31 + list[i];
+    }
+    return hash;
+}
+
+// returns the state id, creates the state if not found, or -1 if too many states
+O_STATIC
+int dfa_state_get(oobj states, oobj pool, const ou16 *list, osize num, bool match)
+{
+    ou32 hash = dfa_list_hash(list, num, match);
+    struct dfa_state *state = OArray_data_void(states);
+    const ou16 *pool_data = OArray_data_void(pool);
+    for (osize i = 0; i < OArray_num(states); i++) {
+        if (state[i].hash == hash && state[i].num == num && state[i].match == match
+            && memcmp(&pool_data[state[i].offset], list, sizeof *list * num) == 0) {
+            return (int) i;
+        }
+    }
+    if (OArray_num(states) >= DFA_STATES_MAX) {
+        return -1;
+    }
+    struct dfa_state new_state = {OArray_num(pool), num, hash, match};
+    OArray_append(pool, list, num);
+    OArray_push(states, &new_state);
+    return (int) OArray_num(states) - 1;
+}
+
+// lowers the groups into a DFA (subset construction with ordered subsets)
+// leaves self->dfa NULL if not possible
+O_STATIC
+void dfa_compile(OPattern *self)
+{
+    oobj container = OObj_new(self);
+
+    osize items_num = 0;
+    struct dfa_item *items = o_new(container, *items, self->groups_size * 2 + 1);
+    for (osize g = 0; g < self->groups_size; g++) {
+        const struct OPattern_group *group = &self->groups[g];
+        if (group->mode == OPattern_group_MODE_PLUS) {
+            items[items_num++] = (struct dfa_item) {group, OPattern_group_MODE_SINGLE};
+            items[items_num++] = (struct dfa_item) {group, OPattern_group_MODE_MUL};
+        } else {
+            items[items_num++] = (struct dfa_item) {group, group->mode};
+        }
+    }
+    if (items_num > DFA_ITEMS_MAX) {
+        goto CLEAN_UP;
+    }
+
+    // byte equivalence classes, refined by each item
+    obyte classes[256] = {0};
+    int classes_num = 1;
+    for (osize i = 0; i < items_num; i++) {
+        int remap[512];
+        for (int r = 0; r < classes_num * 2; r++) {
+            remap[r] = -1;
+        }
+        int remap_num = 0;
+        for (int b = 0; b < 256; b++) {
+            int key = classes[b] * 2 + (OPattern_group_check(items[i].group, (obyte) b) ? 1 : 0);
+            if (remap[key] < 0) {
+                remap[key] = remap_num++;
+            }
+            classes[b] = (obyte) remap[key];
+        }
+        classes_num = remap_num;
+    }
+    // a representative byte for each class
+    obyte class_byte[256];
+    for (int b = 255; b >= 0; b--) {
+        class_byte[classes[b]] = (obyte) b;
+    }
+
+    oobj states = OArray_new_dyn(container, NULL, sizeof(struct dfa_state), 0, 64);
+    oobj pool = OArray_new_dyn(container, NULL, sizeof(ou16), 0, 256);
+    oobj next = OArray_new_dyn(container, NULL, sizeof(ou16), 0, 1024);
+    ou16 *list = o_new(container, ou16, items_num + 1);
+    ou16 *current = o_new(container, ou16, items_num + 1);
+    bool *seen = o_new0(container, bool, items_num + 1);
+
+    // dead state 0
+    dfa_state_get(states, pool, list, 0, false);
+
+    // start state 1
+    osize num = 0;
+    bool match = dfa_closure(items, items_num, 0, list, &num, seen);
+    dfa_state_get(states, pool, list, num, match);
+    for (osize i = 0; i < num; i++) {
+        seen[list[i]] = false;
+    }
+
+    for (osize s = 0; s < OArray_num(states); s++) {
+        // copy, the pool may be reallocated
+        struct dfa_state state = *(struct dfa_state *) OArray_at_void(states, s);
+        o_memcpy(current, (ou16 *) OArray_data_void(pool) + state.offset, sizeof *current, state.num);
+
+        for (int c = 0; c < classes_num; c++) {
+            num = 0;
+            match = false;
+            for (osize t = 0; t < state.num && !match; t++) {
+                const struct dfa_item *item = &items[current[t]];
+                if (!OPattern_group_check(item->group, class_byte[c])) {
+                    continue;
+                }
+                osize target = item->mode == OPattern_group_MODE_MUL ? current[t] : current[t] + 1;
+                match = dfa_closure(items, items_num, target, list, &num, seen);
+            }
+            for (osize i = 0; i < num; i++) {
+                seen[list[i]] = false;
+            }
+            int id = dfa_state_get(states, pool, list, num, match);
+            if (id < 0) {
+                goto CLEAN_UP;
+            }
+            ou16 id16 = (ou16) id;
+            OArray_push(next, &id16);
+        }
+    }
+
+    osize states_num = OArray_num(states);
+    struct OPattern_dfa *dfa = o_new0(self, *dfa, 1);
+    dfa->states_num = states_num;
+    dfa->classes_num = classes_num;
+    o_memcpy(dfa->classes, classes, 1, 256);
+    dfa->next = o_new(self, ou16, states_num * classes_num);
+    o_memcpy(dfa->next, OArray_data_void(next), sizeof(ou16), states_num * classes_num);
+    dfa->flags = o_new0(self, obyte, states_num);
+    struct dfa_state *state = OArray_data_void(states);
+    for (osize s = 0; s < states_num; s++) {
+        dfa->flags[s] = (state[s].match ? DFA_FLAG_MATCH : 0) | (state[s].num > 0 ? DFA_FLAG_ALIVE : 0);
+    }
+
+    // first byte set from the threads of the start state
+    const ou16 *start_list = (ou16 *) OArray_data_void(pool) + state[1].offset;
+    for (osize t = 0; t < state[1].num; t++) {
+        OPattern_group_or(&dfa->first, items[start_list[t]].group);
+    }
+    dfa->first_single = -1;
+    int first_cnt = 0;
+    for (int b = 0; b < 256; b++) {
+        if (OPattern_group_check(&dfa->first, (obyte) b)) {
+            dfa->first_single = b;
+            first_cnt++;
+        }
+    }
+    if (first_cnt != 1) {
+        dfa->first_single = -1;
+    }
+
+    // read lock free in dfa_get
+    SDL_AtomicSetPtr((void **) &self->dfa, dfa);
+
+    CLEAN_UP:
+    o_del(container);
+}
+
+// returns the next position >= pos, that may start a match, or data_size
+O_STATIC
+osize dfa_candidate(const struct OPattern_dfa *dfa, const obyte *data, osize data_size, osize pos)
+{
+    if (dfa->first_single >= 0) {
+        const obyte *found = memchr(data + pos, dfa->first_single, (size_t) (data_size - pos));
+        return found ? found - data : data_size;
+    }
+    while (pos < data_size && !OPattern_group_check(&dfa->first, data[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+// returns the length of the match at start, 0 if not found
+O_STATIC
+osize dfa_match_at(const struct OPattern_dfa *dfa, const obyte *data, osize data_size, osize start)
+{
+    osize state = 1;
+    osize end = start;
+    for (osize pos = start; pos < data_size && (dfa->flags[state] & DFA_FLAG_ALIVE); pos++) {
+        state = dfa->next[state * dfa->classes_num + dfa->classes[data[pos]]];
+        if (dfa->flags[state] & DFA_FLAG_MATCH) {
+            // the match of the threads with a higher priority, overrides the previous ones
+            end = pos + 1;
+        }
+    }
+    return end - start;
+}
+
+
 //
 // public
 //
@@ -444,6 +707,7 @@ OPattern *OPattern_init(oobj obj, oobj parent, const char *pattern)
     OObj_id_set(self, OPattern_ID);
 
     parse(self, pattern);
+    self->dfa_enabled = true;
 
     return self;
 }
@@ -452,6 +716,45 @@ OPattern *OPattern_init(oobj obj, oobj parent, const char *pattern)
 // object functions
 //
 
+// returns the DFA to use, compiled on the second find (or NULL)
+O_STATIC
+struct OPattern_dfa *dfa_get(OPattern *self, bool force)
+{
+    struct OPattern_dfa *dfa = SDL_AtomicGetPtr((void **) &self->dfa);
+    if (dfa) {
+        return dfa;
+    }
+
+    // counts with the spinlock, the object lock is only taken to compile
+    SDL_AtomicLock(&self->dfa_lock);
+    self->finds += !force;
+    bool compile = !self->dfa_compiled && (force || self->finds >= 2);
+    SDL_AtomicUnlock(&self->dfa_lock);
+    if (!compile) {
+        return NULL;
+    }
+
+    o_lock_block(self) {
+        // may have been compiled by another thread in the meantime
+        SDL_AtomicLock(&self->dfa_lock);
+        compile = !self->dfa_compiled;
+        SDL_AtomicUnlock(&self->dfa_lock);
+        if (compile) {
+            dfa_compile(self);
+            SDL_AtomicLock(&self->dfa_lock);
+            self->dfa_compiled = true;
+            SDL_AtomicUnlock(&self->dfa_lock);
+        }
+    }
+    return SDL_AtomicGetPtr((void **) &self->dfa);
+}
+
+bool OPattern_dfa_available(oobj obj)
+{
+    OObj_assert(obj, OPattern);
+    return dfa_get(obj, true) != NULL;
+}
+
 O_STATIC
 struct o_str_range find_at(OPattern *self, const void *data, osize data_size,
                            struct o_str_range *captures, osize start_idx)
@@ -507,7 +810,7 @@ struct o_str_range find_at(OPattern *self, const void *data, osize data_size,
             for (osize gi = group_idx; gi < self->groups_size; gi++) {
                 if (self->groups[gi].mode != OPattern_group_MODE_MUL
                     && self->groups[gi].mode != OPattern_group_MODE_OPT
-                    && !(self->groups[gi].mode == OPattern_group_MODE_PLUS && group_cnt > 0)) {
+                    && !(gi == group_idx && self->groups[gi].mode == OPattern_group_MODE_PLUS && group_cnt > 0)) {
                     valid = false;
                     break;
                 }
@@ -662,6 +965,41 @@ struct o_str_range OPattern_find_data(oobj obj, const void *data, osize data_siz
         return range;
     }
 
+    struct OPattern_dfa *dfa = self->dfa_enabled ? dfa_get(self, false) : NULL;
+    if (dfa) {
+        const obyte *data_buf = data;
+        for (osize i = 0; i < data_size; i++) {
+            if (!self->anchored_start) {
+                i = dfa_candidate(dfa, data_buf, data_size, i);
+                if (i >= data_size) {
+                    break;
+                }
+            }
+            osize len = dfa_match_at(dfa, data_buf, data_size, i);
+            if (len > 0) {
+                range = (struct o_str_range) {i, len};
+                break;
+            }
+            if (self->anchored_start) {
+                break;
+            }
+        }
+
+        if (self->anchored_end && (range.start + range.len) != data_size) {
+            range = (struct o_str_range) {0};
+        }
+
+        if (out_opt_captures && self->captures_size > 0) {
+            if (range.len > 0) {
+                // reconstruct the captures with the backtracking matcher
+                find_at(self, data, data_size, out_opt_captures, range.start);
+            } else {
+                o_clear(out_opt_captures, sizeof *out_opt_captures, self->captures_size);
+            }
+        }
+        return range;
+    }
+
     struct o_str_range *captures = o_new0(self, struct o_str_range, self->captures_size);
 
     for (osize i = 0; i < data_size - self->min_groups; i++) {
@@ -671,10 +1009,9 @@ struct o_str_range OPattern_find_data(oobj obj, const void *data, osize data_siz
         }
     }
 
-    if (self->anchored_end) {
-        if ((range.start + range.len) != data_size) {
-            range = (struct o_str_range) {0};
-        }
+    if (range.len == 0 || (self->anchored_end && (range.start + range.len) != data_size)) {
+        // empty matches are not found, return a cleared range
+        range = (struct o_str_range) {0};
     }
 
     if (out_opt_captures) {
@@ -702,14 +1039,14 @@ osize OPattern_find_all_data(oobj obj,
     }
 
     osize cnt = 0;
-    osize capacity = FIND_ALL_CAPACITY_JUMPS;
+    osize capacity = FIND_ALL_CAPACITY_MIN;
     struct o_str_range_list matches = {
             o_new(obj, struct o_str_range, capacity),
             0,
             obj
     };
     struct o_str_range_list_list captures_list = {
-            o_new(obj, struct o_str_range *, capacity),
+            o_new(obj, struct o_str_range_list, capacity),
             0,
             obj
     };
@@ -724,20 +1061,28 @@ osize OPattern_find_all_data(oobj obj,
 
     osize start = 0;
     for (;;) {
-        struct o_str_range next = OPattern_find_data(self, &data_buf[start], data_size - start, NULL);
+        struct o_str_range next = OPattern_find_data(self, &data_buf[start], data_size - start,
+                                                     out_opt_captures_list ? captures.list : NULL);
         next.start += start;
+        if (out_opt_captures_list) {
+            for (osize i = 0; i < captures.len; i++) {
+                if (captures.list[i].len > 0) {
+                    captures.list[i].start += start;
+                }
+            }
+        }
 
         start = (next.start + next.len);
         matches.list[cnt] = next;
         captures_list.list[cnt] = captures;
 
-        // create a capture list for the next find
-        captures.list = o_new0(obj, struct o_str_range, OPattern_captures(obj) + 1);
-
         if (next.len == 0) {
             break;
         }
 
+        // create a capture list for the next find
+        captures.list = o_new0(obj, struct o_str_range, OPattern_captures(obj) + 1);
+
         cnt++;
 
         if (start >= data_size || self->anchored_start) {
@@ -746,9 +1091,9 @@ osize OPattern_find_all_data(oobj obj,
 
         if (cnt >= capacity) {
             // resize lists
-            capacity += FIND_ALL_CAPACITY_JUMPS;
+            capacity *= 2;
             matches.list = o_renew(obj, matches.list, struct o_str_range, capacity);
-            captures_list.list = o_renew(obj, captures_list.list, struct o_str_range *, capacity);
+            captures_list.list = o_renew(obj, captures_list.list, struct o_str_range_list, capacity);
         }
     }
 
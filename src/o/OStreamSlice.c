@@ -0,0 +1,100 @@
+#include "o/OStreamSlice.h"
+#include "o/OObj_builder.h"
+
+OStreamSlice *OStreamSlice_init(oobj obj, oobj parent, oobj base, osize offset, osize size)
+{
+    OStreamSlice *self = obj;
+    o_clear(self, sizeof *self, 1);
+
+    OStream_init(obj, parent,
+                 OStreamSlice__v_valid,
+                 OStreamSlice__v_size,
+                 OStreamSlice__v_seek,
+                 OStreamSlice__v_read_try,
+                 OStreamSlice__v_write,
+                 OStreamSlice__v_close);
+    OObj_id_set(self, OStreamSlice_ID);
+
+    self->base = base;
+    self->offset = o_max(0, offset);
+    self->size = o_max(0, size);
+
+    return self;
+}
+
+
+bool OStreamSlice__v_valid(oobj obj)
+{
+    OObj_assert(obj, OStreamSlice);
+    OStreamSlice *self = obj;
+    return self->base && OStream_valid(self->base);
+}
+
+osize OStreamSlice__v_size(oobj obj)
+{
+    OObj_assert(obj, OStreamSlice);
+    OStreamSlice *self = obj;
+    if (!self->base) {
+        return -1;
+    }
+    return self->size;
+}
+
+osize OStreamSlice__v_seek(oobj obj, osize offset, enum OStream_seek_whence whence)
+{
+    OObj_assert(obj, OStreamSlice);
+    OStreamSlice *self = obj;
+    if (!self->base) {
+        return -1;
+    }
+    osize pos = self->pos;
+    if (whence == OStream_SEEK_SET) {
+        pos = offset;
+    } else if (whence == OStream_SEEK_CUR) {
+        pos += offset;
+    } else if (whence == OStream_SEEK_END) {
+        pos = self->size + offset;
+    }
+    self->pos = o_clamp(pos, 0, self->size);
+    return self->pos;
+}
+
+osize OStreamSlice__v_read_try(oobj obj, void *out_data, osize element_size, osize num)
+{
+    OObj_assert(obj, OStreamSlice);
+    OStreamSlice *self = obj;
+    if (!self->base) {
+        return 0;
+    }
+    osize num_left = (self->size - self->pos) / element_size;
+    osize num_read = o_min(num_left, num);
+    if (num_read <= 0) {
+        return 0;
+    }
+
+    // the base stream may be shared with other slices
+    osize read = 0;
+    o_lock_block(self->base) {
+        if (OStream_seek(self->base, self->offset + self->pos, OStream_SEEK_SET) == self->offset + self->pos) {
+            read = OStream_read_try(self->base, out_data, element_size, num_read);
+        }
+    }
+    self->pos += read * element_size;
+    return read;
+}
+
+osize OStreamSlice__v_write(oobj obj, const void *data, osize element_size, osize num)
+{
+    // read only
+    return 0;
+}
+
+bool OStreamSlice__v_close(oobj obj)
+{
+    OObj_assert(obj, OStreamSlice);
+    OStreamSlice *self = obj;
+    self->base = NULL;
+    self->size = 0;
+    self->pos = 0;
+    return true;
+}
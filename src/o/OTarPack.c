@@ -0,0 +1,557 @@
+#include "o/OTarPack.h"
+#include "o/OObj_builder.h"
+#include "o/OObjRoot.h"
+#include "o/ODelcallback.h"
+#include "o/OMap.h"
+#include "o/OStream.h"
+#include "o/OStreamMem.h"
+#include "o/OStreamSlice.h"
+#include "o/file.h"
+#include "o/str.h"
+#include "o/parallel.h"
+#include <SDL2/SDL_atomic.h>
+#include <string.h>
+
+#ifdef MIA_PLATFORM_UNIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define O_LOG_LIB "o"
+#include "o/log.h"
+
+
+#define PACK_BLOCK 512
+#define PACK_NAME_MAX 4096
+
+
+//
+// backing
+//
+
+struct OTarPack_backing {
+    // the pack and each open mounted stream hold a reference
+    SDL_atomic_t refs;
+
+    // heap root, owns the base stream
+    oobj root;
+
+    oobj stream;
+    const obyte *map;
+    osize map_size;
+};
+
+O_STATIC
+struct OTarPack_backing *pack_backing_new(void)
+{
+    oobj root = OObjRoot_new_heap();
+    struct OTarPack_backing *self = o_new0(root, *self, 1);
+    self->root = root;
+    SDL_AtomicSet(&self->refs, 1);
+    return self;
+}
+
+O_STATIC
+void pack_backing_release(struct OTarPack_backing *self)
+{
+    if (!SDL_AtomicDecRef(&self->refs)) {
+        return;
+    }
+#ifdef MIA_PLATFORM_UNIX
+    if (self->map) {
+        munmap((void *) self->map, (size_t) self->map_size);
+    }
+#endif
+    o_del(self->root);
+}
+
+
+//
+// mounted packs
+//
+
+static struct {
+    SDL_SpinLock lock;
+    oobj packs[OTarPack_MOUNT_MAX];
+    int num;
+} L_mounted;
+
+
+//
+// header scan
+//
+
+O_STATIC
+bool pack_read_at(OTarPack *self, osize offset, void *out_data, osize size)
+{
+    if (self->map) {
+        if (offset < 0 || offset + size > self->map_size) {
+            return false;
+        }
+        o_memcpy(out_data, self->map + offset, 1, size);
+        return true;
+    }
+    bool ok = false;
+    o_lock_block(self->stream) {
+        if (OStream_seek(self->stream, offset, OStream_SEEK_SET) == offset) {
+            ok = OStream_read_try(self->stream, out_data, 1, size) == size;
+        }
+    }
+    return ok;
+}
+
+// parses an octal header field, or the gnu base-256 extension for large sizes
+O_STATIC
+osize pack_parse_number(const obyte *field, int len)
+{
+    osize res = 0;
+    if (field[0] & 0x80) {
+        for (int i = 1; i < len; i++) {
+            res = (res << 8) | field[i];
+        }
+        return res;
+    }
+    int i = 0;
+    while (i < len && field[i] == ' ') {
+        i++;
+    }
+    for (; i < len && field[i] >= '0' && field[i] <= '7'; i++) {
+        res = res * 8 + (field[i] - '0');
+    }
+    return res;
+}
+
+O_STATIC
+bool pack_checksum_valid(const obyte *header)
+{
+    // the checksum is computed with its own field filled with spaces
+    osize sum = 0;
+    for (int i = 0; i < PACK_BLOCK; i++) {
+        sum += (i >= 148 && i < 156) ? ' ' : header[i];
+    }
+    return sum == pack_parse_number(header + 148, 8);
+}
+
+O_STATIC
+bool pack_block_is_zero(const obyte *header)
+{
+    for (int i = 0; i < PACK_BLOCK; i++) {
+        if (header[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+O_STATIC
+const char *pack_name_strip(const char *name)
+{
+    while (name[0] == '.' && name[1] == '/') {
+        name += 2;
+    }
+    return name;
+}
+
+O_STATIC
+void pack_scan(OTarPack *self, osize archive_size)
+{
+    obyte header[PACK_BLOCK];
+    char name[PACK_NAME_MAX];
+    bool long_name = false;
+
+    osize pos = 0;
+    while (pos + PACK_BLOCK <= archive_size) {
+        if (!pack_read_at(self, pos, header, PACK_BLOCK) || pack_block_is_zero(header)) {
+            break;
+        }
+        if (!pack_checksum_valid(header)) {
+            o_log_warn_s("OTarPack", "invalid header checksum at: %i, stopped the scan", (int) pos);
+            break;
+        }
+        osize size = pack_parse_number(header + 124, 12);
+        char type = (char) header[156];
+        osize data = pos + PACK_BLOCK;
+        osize next = data + (size + PACK_BLOCK - 1) / PACK_BLOCK * PACK_BLOCK;
+        if (size < 0 || data + size > archive_size) {
+            o_log_warn_s("OTarPack", "truncated member at: %i, stopped the scan", (int) pos);
+            break;
+        }
+        pos = next;
+
+        if (type == 'L') {
+            // gnu long name for the next header
+            osize len = o_min(size, PACK_NAME_MAX - 1);
+            long_name = pack_read_at(self, data, name, len);
+            name[long_name ? len : 0] = '\0';
+            continue;
+        }
+
+        if (!long_name) {
+            name[0] = '\0';
+            // ustar prefix
+            if (memcmp(header + 257, "ustar", 5) == 0 && header[345]) {
+                o_strf_buf(name, "%.155s/", (const char *) header + 345);
+            }
+            osize len = o_strlen(name);
+            snprintf(name + len, sizeof name - len, "%.100s", (const char *) header);
+        }
+        long_name = false;
+
+        // regular files only
+        if (type != '0' && type != '\0' && type != '7') {
+            continue;
+        }
+        const char *key = pack_name_strip(name);
+        osize key_len = o_strlen(key);
+        if (key_len == 0 || key[key_len - 1] == '/') {
+            continue;
+        }
+
+        struct OTarPack_entry entry = {data, size};
+        OMap_set(self->index, &key, &entry);
+    }
+}
+
+
+//
+// public
+//
+
+OTarPack *OTarPack_init(oobj obj, oobj parent, oobj stream)
+{
+    OTarPack *self = obj;
+    o_clear(self, sizeof *self, 1);
+
+    OObj_init(obj, parent);
+    OObj_id_set(self, OTarPack_ID);
+
+    self->index = OMap_new_string_keys(self, sizeof(struct OTarPack_entry), 64);
+
+    self->backing = pack_backing_new();
+    self->stream = stream;
+    if (stream) {
+        // owned by the backing, so mounted streams can still read from it after the pack is deleted
+        o_move(stream, self->backing->root);
+        self->backing->stream = stream;
+        pack_scan(self, OStream_size(stream));
+    }
+
+    // vfuncs
+    self->super.v_del = OTarPack__v_del;
+    self->super.v_op_num = OTarPack__v_op_num;
+
+    return self;
+}
+
+struct oobj_opt OTarPack_new_file(oobj parent, const char *file)
+{
+#ifdef MIA_PLATFORM_UNIX
+    int fd = open(file, O_RDONLY);
+    if (fd >= 0) {
+        struct stat info;
+        void *map = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            // private copy on write, so OStreamMem writes into a member do not segfault
+            map = mmap(NULL, (size_t) info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if (map != MAP_FAILED) {
+            OTarPack *self = OTarPack_new(parent, NULL);
+            self->file = o_str_clone(self, file);
+            self->map = map;
+            self->map_size = (osize) info.st_size;
+            self->backing->map = self->map;
+            self->backing->map_size = self->map_size;
+            pack_scan(self, self->map_size);
+            return oobj_opt(self);
+        }
+    }
+    // fall back to a stream
+#endif
+    struct oobj_opt stream = o_file_open(parent, file, "rb");
+    if (!stream.o) {
+        o_log_warn_s(__func__, "failed to open the file: %s", file);
+        return oobj_opt(NULL);
+    }
+    OTarPack *self = OTarPack_new(parent, stream.o);
+    self->file = o_str_clone(self, file);
+    return oobj_opt(self);
+}
+
+//
+// virtual implementations:
+//
+
+void OTarPack__v_del(oobj obj)
+{
+    OObj_assert(obj, OTarPack);
+    OTarPack *self = obj;
+
+    // no new mounted streams can find the pack after this
+    OTarPack_unmount(self);
+
+    // open mounted streams may still read, the last one frees the backing
+    pack_backing_release(self->backing);
+
+    OObj__v_del(self);
+}
+
+osize OTarPack__v_op_num(oobj obj)
+{
+    return OTarPack_num(obj);
+}
+
+//
+// object functions:
+//
+
+osize OTarPack_num(oobj obj)
+{
+    OObj_assert(obj, OTarPack);
+    OTarPack *self = obj;
+    return OMap_num(self->index);
+}
+
+const char *OTarPack_name_at(oobj obj, osize idx)
+{
+    OObj_assert(obj, OTarPack);
+    OTarPack *self = obj;
+    return *OMap_key_at(self->index, idx, char *);
+}
+
+bool OTarPack_find(oobj obj, const char *name, struct OTarPack_entry *out_opt_entry)
+{
+    OObj_assert(obj, OTarPack);
+    OTarPack *self = obj;
+    name = pack_name_strip(name);
+    struct OTarPack_entry *entry = OMap_get(self->index, &name, struct OTarPack_entry);
+    if (!entry) {
+        return false;
+    }
+    if (out_opt_entry) {
+        *out_opt_entry = *entry;
+    }
+    return true;
+}
+
+const void *OTarPack_view(oobj obj, const char *name, osize *out_opt_size)
+{
+    OObj_assert(obj, OTarPack);
+    OTarPack *self = obj;
+    struct OTarPack_entry entry;
+    if (!self->map || !OTarPack_find(self, name, &entry)) {
+        return NULL;
+    }
+    if (out_opt_size) {
+        *out_opt_size = entry.size;
+    }
+    return self->map + entry.offset;
+}
+
+struct oobj_opt OTarPack_stream(oobj obj, oobj parent, const char *name)
+{
+    OObj_assert(obj, OTarPack);
+    OTarPack *self = obj;
+    struct OTarPack_entry entry;
+    if (!OTarPack_find(self, name, &entry)) {
+        return oobj_opt(NULL);
+    }
+    if (self->map) {
+        return oobj_opt(OStreamMem_new(parent, (obyte *) self->map + entry.offset, entry.size));
+    }
+    return oobj_opt(OStreamSlice_new(parent, self->stream, entry.offset, entry.size));
+}
+
+osize OTarPack_read(oobj obj, const char *name, void *out_data, osize out_size)
+{
+    OObj_assert(obj, OTarPack);
+    OTarPack *self = obj;
+    struct OTarPack_entry entry;
+    if (!OTarPack_find(self, name, &entry)) {
+        return -1;
+    }
+    osize size = o_min(entry.size, out_size);
+    if (!pack_read_at(self, entry.offset, out_data, size)) {
+        return 0;
+    }
+    return size;
+}
+
+struct pack_read_parallel_context {
+    OTarPack *self;
+    struct OTarPack_read_job *jobs;
+};
+
+O_STATIC
+void pack_read_parallel_fn(osize begin, osize end, void *user)
+{
+    struct pack_read_parallel_context *C = user;
+    OTarPack *self = C->self;
+
+    // without a map, each chunk opens its own file stream, so the chunks do not wait for the shared stream lock
+    oobj root = NULL;
+    oobj stream = NULL;
+    if (!self->map && self->file) {
+        root = OObjRoot_new_heap();
+        stream = o_file_open(root, self->file, "rb").o;
+    }
+
+    for (osize i = begin; i < end; i++) {
+        struct OTarPack_read_job *job = &C->jobs[i];
+        struct OTarPack_entry entry;
+        if (!OTarPack_find(self, job->name, &entry)) {
+            job->out_read = -1;
+            continue;
+        }
+        osize size = o_min(entry.size, job->out_size);
+        if (stream) {
+            job->out_read = 0;
+            if (OStream_seek(stream, entry.offset, OStream_SEEK_SET) == entry.offset) {
+                job->out_read = OStream_read_try(stream, job->out_data, 1, size);
+            }
+        } else {
+            job->out_read = pack_read_at(self, entry.offset, job->out_data, size) ? size : 0;
+        }
+    }
+
+    o_del(root);
+}
+
+osize OTarPack_read_parallel(oobj obj, struct OTarPack_read_job *jobs, osize jobs_num)
+{
+    OObj_assert(obj, OTarPack);
+    OTarPack *self = obj;
+    if (jobs_num <= 0) {
+        return 0;
+    }
+    struct pack_read_parallel_context C = {self, jobs};
+    o_parallel_for(NULL, jobs_num, 1, pack_read_parallel_fn, &C);
+
+    osize done = 0;
+    for (osize i = 0; i < jobs_num; i++) {
+        struct OTarPack_entry entry;
+        if (jobs[i].out_read >= 0 && OTarPack_find(self, jobs[i].name, &entry)
+            && jobs[i].out_read == o_min(entry.size, jobs[i].out_size)) {
+            done++;
+        }
+    }
+    return done;
+}
+
+
+//
+// mount functions:
+//
+
+bool OTarPack_mount(oobj obj, const char *opt_prefix)
+{
+    OObj_assert(obj, OTarPack);
+    OTarPack *self = obj;
+    bool mounted = false;
+    SDL_AtomicLock(&L_mounted.lock);
+    bool known = false;
+    for (int i = 0; i < L_mounted.num; i++) {
+        known |= L_mounted.packs[i] == self;
+    }
+    if (!known && L_mounted.num < OTarPack_MOUNT_MAX) {
+        o_free(self, self->mount_prefix);
+        self->mount_prefix = opt_prefix ? o_str_clone(self, opt_prefix) : NULL;
+        L_mounted.packs[L_mounted.num++] = self;
+        mounted = true;
+    }
+    SDL_AtomicUnlock(&L_mounted.lock);
+    if (!mounted) {
+        o_log_warn_s(__func__, "failed to mount, already mounted or too many packs");
+    }
+    return mounted;
+}
+
+void OTarPack_unmount(oobj obj)
+{
+    OObj_assert(obj, OTarPack);
+    OTarPack *self = obj;
+    SDL_AtomicLock(&L_mounted.lock);
+    for (int i = 0; i < L_mounted.num; i++) {
+        if (L_mounted.packs[i] == self) {
+            // keep the mount order
+            for (int j = i + 1; j < L_mounted.num; j++) {
+                L_mounted.packs[j - 1] = L_mounted.packs[j];
+            }
+            L_mounted.num--;
+            break;
+        }
+    }
+    SDL_AtomicUnlock(&L_mounted.lock);
+}
+
+// call with the mount lock held
+O_STATIC
+OTarPack *mounted_find(const char *file, const char **out_name, struct OTarPack_entry *out_opt_entry)
+{
+    file = pack_name_strip(file);
+    for (int i = L_mounted.num - 1; i >= 0; i--) {
+        OTarPack *pack = L_mounted.packs[i];
+        const char *name = file;
+        if (pack->mount_prefix) {
+            osize prefix_len = o_strlen(pack->mount_prefix);
+            if (strncmp(file, pack->mount_prefix, prefix_len) != 0) {
+                continue;
+            }
+            name += prefix_len;
+        }
+        if (OTarPack_find(pack, name, out_opt_entry)) {
+            *out_name = name;
+            return pack;
+        }
+    }
+    return NULL;
+}
+
+struct oobj_opt OTarPack_mounted(const char *file, const char **out_opt_name)
+{
+    const char *name = NULL;
+    SDL_AtomicLock(&L_mounted.lock);
+    OTarPack *res = mounted_find(file, &name, NULL);
+    SDL_AtomicUnlock(&L_mounted.lock);
+    if (res && out_opt_name) {
+        *out_opt_name = name;
+    }
+    return oobj_opt(res);
+}
+
+O_STATIC
+void mounted_stream_del(oobj obj)
+{
+    pack_backing_release(o_user(obj));
+}
+
+struct oobj_opt OTarPack_mounted_stream(oobj parent, const char *file)
+{
+    const char *name;
+    struct OTarPack_entry entry;
+    struct OTarPack_backing *backing = NULL;
+    SDL_AtomicLock(&L_mounted.lock);
+    OTarPack *pack = mounted_find(file, &name, &entry);
+    if (pack) {
+        // the deletor unmounts under the lock before it releases the backing
+        backing = pack->backing;
+        SDL_AtomicIncRef(&backing->refs);
+    }
+    SDL_AtomicUnlock(&L_mounted.lock);
+    if (!backing) {
+        return oobj_opt(NULL);
+    }
+
+    oobj stream;
+    if (backing->map) {
+        stream = OStreamMem_new(parent, (obyte *) backing->map + entry.offset, entry.size);
+    } else {
+        stream = OStreamSlice_new(parent, backing->stream, entry.offset, entry.size);
+    }
+    // the stream reads from the backing, so it holds it until deleted
+    oobj release = ODelcallback_new(stream, mounted_stream_del);
+    o_user_set(release, backing);
+    return oobj_opt(stream);
+}
@@ -3,68 +3,262 @@
 #include "o/OThreadpool.h"
 #include "o/OObj_builder.h"
 #include "o/OFuture.h"
-#include "o/OQueue.h"
+#include "o/OCondition.h"
 #include "o/OArray.h"
 #include "o/OThread.h"
 #include "o/str.h"
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_timer.h>
 
 #define O_LOG_LIB "o"
 #include "o/log.h"
 
+// max futures in a deque of a thread, further pushes go into the shared queue
+#define DEQUE_SIZE 4096
+
+// failed steal rounds before a thread goes to sleep
+#define STEAL_ROUNDS 8
+
+struct OThreadpool_worker {
+    OThreadpool *pool;
+    ou32 rand;
+
+    // Chase-Lev deque, the owning thread pushes and takes at the bottom, others steal at the top.
+    // indices are only increasing and wrap around as unsigned ints
+    SDL_atomic_t bottom;
+    obyte cache_line_pad_0_[64];
+    SDL_atomic_t top;
+    obyte cache_line_pad_1_[64];
+    void *slots[DEQUE_SIZE];
+};
+
+struct OThreadpool_sched {
+    // futures pushed but not yet taken by a thread
+    SDL_atomic_t pending;
+    // futures currently running
+    SDL_atomic_t running;
+    // threads waiting on cond
+    SDL_atomic_t sleeping;
+    SDL_atomic_t closed;
+
+    // OCondition, waits with the pool lock
+    oobj cond;
+
+    struct OThreadpool_worker workers[];
+};
+
+// the worker of the current thread, if its a pool thread
+static _Thread_local struct OThreadpool_worker *L_worker;
+
+// protected in OFuture.c
+O_EXTERN
+void OFuture__run(oobj obj);
+
+
+//
+// deque
+//
 
 O_STATIC
-void OThreadpool__thread_runnable(oobj thread_obj)
+bool deque_push(struct OThreadpool_worker *w, void *future)
 {
-    OThreadpool *self = o_user(thread_obj);
-    OObj_assert(self, OThreadpool);
+    ou32 b = (ou32) SDL_AtomicGet(&w->bottom);
+    ou32 t = (ou32) SDL_AtomicGet(&w->top);
+    if (b - t >= DEQUE_SIZE) {
+        return false;
+    }
+    SDL_AtomicSetPtr(&w->slots[b % DEQUE_SIZE], future);
+    SDL_AtomicSet(&w->bottom, (int) (b + 1));
+    return true;
+}
 
-    o_log_debug_s(__func__,
-               "pool thread started: " ou64_PRI, o_thread_id());
+O_STATIC
+void *deque_take(struct OThreadpool_worker *w)
+{
+    ou32 b = (ou32) SDL_AtomicGet(&w->bottom) - 1;
+    SDL_AtomicSet(&w->bottom, (int) b);
+    ou32 t = (ou32) SDL_AtomicGet(&w->top);
+    int size = (int) (b - t);
+    if (size < 0) {
+        // empty
+        SDL_AtomicSet(&w->bottom, (int) (b + 1));
+        return NULL;
+    }
+    void *future = SDL_AtomicGetPtr(&w->slots[b % DEQUE_SIZE]);
+    if (size > 0) {
+        return future;
+    }
+    // last one, race against the thieves
+    if (!SDL_AtomicCAS(&w->top, (int) t, (int) (t + 1))) {
+        future = NULL;
+    }
+    SDL_AtomicSet(&w->bottom, (int) (b + 1));
+    return future;
+}
+
+O_STATIC
+void *deque_steal(struct OThreadpool_worker *w)
+{
+    ou32 t = (ou32) SDL_AtomicGet(&w->top);
+    ou32 b = (ou32) SDL_AtomicGet(&w->bottom);
+    if ((int) (b - t) <= 0) {
+        return NULL;
+    }
+    void *future = SDL_AtomicGetPtr(&w->slots[t % DEQUE_SIZE]);
+    if (!SDL_AtomicCAS(&w->top, (int) t, (int) (t + 1))) {
+        // lost against the owner or another thief
+        return NULL;
+    }
+    return future;
+}
 
-    for(;;) {
-        OFuture *future;
-        bool valid = OQueue_pop_front(self->task_queue, &future);
 
-        // returns invalid if queue is closed
-        if(!valid) {
-            o_log_debug_s(__func__,
-                       "pool thread finished: " ou64_PRI, o_thread_id());
+//
+// scheduler
+//
+
+O_STATIC
+void *shared_take(OThreadpool *self)
+{
+    void *future = NULL;
+    o_lock_block(self) {
+        if (OArray_num(self->shared_queue) > 0) {
+            OArray_take_front(self->shared_queue, &future, 1);
         }
+    }
+    return future;
+}
 
-        OObj_assert(future, OFuture);
+O_STATIC
+void *steal_random(OThreadpool *self, struct OThreadpool_worker *w)
+{
+    // xorshift32
+    w->rand ^= w->rand << 13;
+    w->rand ^= w->rand >> 17;
+    w->rand ^= w->rand << 5;
+
+    osize n = self->threads_size;
+    osize start = (osize) (w->rand % (ou32) n);
+    for (osize i = 0; i < n; i++) {
+        struct OThreadpool_worker *victim = &self->sched->workers[(start + i) % n];
+        if (victim == w) {
+            continue;
+        }
+        void *future = deque_steal(victim);
+        if (future) {
+            return future;
+        }
+    }
+    return NULL;
+}
 
+O_STATIC
+void *find_work(OThreadpool *self, struct OThreadpool_worker *w)
+{
+    void *future = deque_take(w);
+    if (!future && SDL_AtomicGet(&self->sched->pending) > 0) {
+        future = shared_take(self);
+        if (!future) {
+            future = steal_random(self, w);
+        }
+    }
+    return future;
+}
 
-        o_lock_block(self) {
-            self->running_futures[self->running_futures_size] = future;
-            self->running_futures_size++;
-            assert(self->running_futures_size<=self->threads_size);
+// returns false if the pool is closed and all futures are done
+O_STATIC
+bool sleep_for_work(OThreadpool *self)
+{
+    struct OThreadpool_sched *sched = self->sched;
+    bool work = true;
+    o_lock_block(self) {
+        SDL_AtomicIncRef(&sched->sleeping);
+        // pushes increase pending before checking for sleeping threads, so no wakeup gets lost
+        while (SDL_AtomicGet(&sched->pending) <= 0 && !SDL_AtomicGet(&sched->closed)) {
+            OCondition_wait(sched->cond, self);
         }
+        SDL_AtomicAdd(&sched->sleeping, -1);
+        work = SDL_AtomicGet(&sched->pending) > 0;
+    }
+    return work;
+}
 
-        //
-        // run future
-        //
+O_STATIC
+void OThreadpool__thread_runnable(oobj thread_obj)
+{
+    struct OThreadpool_worker *w = o_user(thread_obj);
+    OThreadpool *self = w->pool;
+    OObj_assert(self, OThreadpool);
+    struct OThreadpool_sched *sched = self->sched;
+
+    L_worker = w;
+
+    o_log_debug_s(__func__,
+               "pool thread started: " ou64_PRI, o_thread_id());
+
+    int failed = 0;
+    for (;;) {
+        OFuture *future = find_work(self, w);
+        if (!future) {
+            if (SDL_AtomicGet(&sched->pending) > 0 && ++failed < STEAL_ROUNDS) {
+                // lost a race, or a push is in flight
+                SDL_Delay(0);
+                continue;
+            }
+            failed = 0;
+            if (!sleep_for_work(self)) {
+                break;
+            }
+            continue;
+        }
+        failed = 0;
+        SDL_AtomicAdd(&sched->pending, -1);
+
+        OObj_assert(future, OFuture);
+        SDL_AtomicIncRef(&sched->running);
+        OFuture__run(future);
+        SDL_AtomicAdd(&sched->running, -1);
+    }
 
-        // protected in OFuture.c
-        O_EXTERN
-        void OFuture__thread_runnable(oobj obj);
+    L_worker = NULL;
+    o_log_debug_s(__func__,
+               "pool thread finished: " ou64_PRI, o_thread_id());
+}
 
-        // the fn OFuture__thread_runnable expects obj's o_user to be set to the future.
-        // So we create a placeholder to hold it
-        oobj user = OObj_new(thread_obj);
-        o_user_set(user, future);
 
-        OFuture__thread_runnable(user);
-        o_del(user);
+//
+// protected
+// used by OFuture.c
+//
 
+O_EXTERN
+void OThreadpool__push(oobj obj, oobj future)
+{
+    OObj_assert(obj, OThreadpool);
+    OThreadpool *self = obj;
+    struct OThreadpool_sched *sched = self->sched;
+    assert(!SDL_AtomicGet(&sched->closed) && "OThreadpool already deleted");
 
+    struct OThreadpool_worker *w = L_worker;
+    if (!w || w->pool != self || !deque_push(w, future)) {
         o_lock_block(self) {
-            self->running_futures_size--;
-            assert(self->running_futures_size>=0);
+            OArray_push(self->shared_queue, &future);
         }
+    }
 
+    SDL_AtomicIncRef(&sched->pending);
+    if (SDL_AtomicGet(&sched->sleeping) > 0) {
+        o_lock_block(self) {
+            OCondition_signal(sched->cond);
+        }
     }
 }
 
+
+//
+// public
+//
+
 OThreadpool *OThreadpool_init(oobj obj, oobj parent, osize threads)
 {
     assert(threads >= 1);
@@ -78,15 +272,22 @@ OThreadpool *OThreadpool_init(oobj obj, oobj parent, osize threads)
     self->threads_size = threads;
     self->threads = o_new0(self, oobj, threads);
 
-    self->running_futures_size = 0;
-    self->running_futures = o_new0(self, oobj, threads);
+    self->shared_queue = OArray_new_dyn(self, NULL, sizeof(oobj), 0, threads * 4);
 
-    self->task_queue = OQueue_new(self, OArray_new_dyn(self, NULL, sizeof(oobj), 0, threads*4));
+    self->sched = o_alloc(self, 1, sizeof(struct OThreadpool_sched) + threads * sizeof(struct OThreadpool_worker));
+    o_clear(self->sched, sizeof(struct OThreadpool_sched) + threads * sizeof(struct OThreadpool_worker), 1);
+    self->sched->cond = OOCondition_new(self);
 
-    for(osize i=0; i<threads; i++) {
+    for (osize i = 0; i < threads; i++) {
+        struct OThreadpool_worker *w = &self->sched->workers[i];
+        w->pool = self;
+        w->rand = (ou32) i * 2654435769u + 1;
+    }
+
+    for (osize i = 0; i < threads; i++) {
         char name[64];
         o_strf_buf(name, "OThreadpool_thread#%i/%i", (int) i, (int) threads);
-        self->threads[i] = OThread_new_run(self, OThreadpool__thread_runnable, name, self);
+        self->threads[i] = OThread_new_run(self, OThreadpool__thread_runnable, name, &self->sched->workers[i]);
     }
 
     // set virtual deletor
@@ -100,11 +301,14 @@ void OThreadpool__v_del(oobj obj)
     OObj_assert(obj, OThreadpool);
     OThreadpool *self = obj;
 
-    // so that the threads stop...
-    OQueue_signal_close(self->task_queue);
+    // so that the threads stop, after all pending futures are done
+    o_lock_block(self) {
+        SDL_AtomicSet(&self->sched->closed, 1);
+        OCondition_broadcast(self->sched->cond);
+    }
 
-    // we need to call OThread_wait, so the threads are stopping work before the Queue gets deleted
-    for(osize i=0; i<self->threads_size; i++) {
+    // we need to call OThread_wait, so the threads are stopping work before the deques get deleted
+    for (osize i = 0; i < self->threads_size; i++) {
         OThread_wait(self->threads[i]);
     }
     OObj__v_del(obj);
@@ -114,11 +318,7 @@ osize OThreadpool_running_futures(oobj obj)
 {
     OObj_assert(obj, OThreadpool);
     OThreadpool *self = obj;
-    osize running;
-    o_lock_block(self) {
-        running = self->running_futures_size;
-    }
-    return running;
+    return SDL_AtomicGet(&self->sched->running);
 }
 
 
@@ -126,7 +326,13 @@ osize OThreadpool_queuing(oobj obj)
 {
     OObj_assert(obj, OThreadpool);
     OThreadpool *self = obj;
-    return OQueue_num(self->task_queue);
+    return o_max(0, SDL_AtomicGet(&self->sched->pending));
+}
+
+bool OThreadpool_in_pool(oobj obj)
+{
+    OObj_assert(obj, OThreadpool);
+    return L_worker && L_worker->pool == obj;
 }
 
 
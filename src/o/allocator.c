@@ -2,10 +2,27 @@
 #include "o/common.h"
 #include <SDL2/SDL_stdinc.h>
 #include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_thread.h>
 
 #define O_LOG_LIB "o"
 #include "o/log.h"
 
+// see o_allocator_thread_calls
+static _Thread_local osize L_thread_calls;
+
+// protected
+O_EXTERN
+void o_allocator__thread_calls_inc(void)
+{
+    L_thread_calls++;
+}
+
+osize o_allocator_thread_calls(void)
+{
+    return L_thread_calls;
+}
+
 O_STATIC
 void *heap_realloc_try(struct o_allocator_i iface, void *mem, osize element_size, osize num)
 {
@@ -56,7 +73,7 @@ O_STATIC
 void pool_stack_push(struct pool *p, void *mem)
 {
     osize stack_size = (osize) p->pools_num * (osize) p->blocks_in_pool;
-    if(p->stack_num+1 >= stack_size) {
+    if(p->stack_num >= stack_size) {
         o_log_wtf_s(__func__, "free failed, already all free or another double free bug!");
         return;
     }
@@ -238,7 +255,11 @@ void o_allocator_pool_del(struct o_allocator_i *self)
     SDL_DestroyMutex(p->mutex);
 #endif
 
+    for(int i=0; i<p->pools_num; i++) {
+        SDL_free(p->pools[i]);
+    }
     SDL_free(p->pools);
+    SDL_free(p->stack);
     SDL_free(p);
     o_clear(self, sizeof *self, 1);
 }
@@ -305,6 +326,558 @@ bool o_allocator_pool_pointer_pooled(struct o_allocator_i self, const void *mem)
     return false;
 }
 
+//
+// Slab
+//
+
+#define slab_ID 558874
+
+// each slab is a 64 KiB aligned region, starting with a header
+#define SLAB_SHIFT 16
+#define SLAB_SIZE ((osize) 1 << SLAB_SHIFT)
+#define SLAB_HEADER_SIZE 64
+
+// slabs are allocated in chunks to reduce the alignment waste
+#define SLAB_CHUNK_SLABS 16
+
+// smallest size class is 16 bytes (2^4), the largest 8 KiB (2^13)
+#define SLAB_CLASS_MIN_SHIFT 4
+#define SLAB_CLASS_MAX_SHIFT 13
+#define SLAB_CLASSES_MAX (SLAB_CLASS_MAX_SHIFT - SLAB_CLASS_MIN_SHIFT + 1)
+
+// number of blocks exchanged between a thread cache and the shared state
+#define SLAB_BATCH 32
+
+
+struct slab_block {
+    struct slab_block *next;
+};
+
+// located at the start of each slab
+struct slab_header {
+    int id;
+    int class_idx;
+    struct slab *owner;
+};
+_Static_assert(sizeof(struct slab_header) <= SLAB_HEADER_SIZE, "slab header too big");
+
+struct slab_cache {
+    // NULL if the allocator was deleted
+    struct slab *slab;
+    struct slab_cache *prev, *next;
+    struct {
+        struct slab_block *free;
+        int num;
+    } classes[SLAB_CLASSES_MAX];
+};
+
+struct slab {
+    int id;
+
+    int classes_num;
+
+    // shared state, locked by mutex
+    struct {
+        struct slab_block *free;
+        osize free_num;
+        osize blocks_num;
+    } classes[SLAB_CLASSES_MAX];
+
+    // raw allocated chunks
+    void **chunks;
+    int chunks_num;
+
+    // next unused aligned slab in the last chunk
+    obyte *chunk_slab_next;
+    int chunk_slabs_left;
+
+    int slabs_num;
+
+    // list of all thread caches
+    struct slab_cache *caches;
+
+#ifdef MIA_OPTION_THREAD
+    SDL_TLSID tls;
+#else
+    struct slab_cache *cache;
+#endif
+
+    void *mutex;
+};
+
+#define slab_assert(allocator) assert(((struct slab *) (allocator).impl)->id == slab_ID)
+
+
+//
+// slab map
+// a global two level bitmap that marks each 64 KiB region, which holds a slab.
+// So a pointer can be checked in O(1) without reading foreign memory.
+// Uses the address bits [16, 48), tagged pointers (like on android) have their top bits masked out.
+//
+
+#define SLAB_MAP_LEAF_BITS 20
+#define SLAB_MAP_ROOT_BITS 12
+
+static SDL_atomic_t *slab_map_L[1 << SLAB_MAP_ROOT_BITS];
+
+O_STATIC
+void slab_map_pos(const void *mem, osize *out_root, osize *out_leaf)
+{
+    ou64 region = ((ou64) (uintptr_t) mem & (((ou64) 1 << 48) - 1)) >> SLAB_SHIFT;
+    *out_root = (osize) (region >> SLAB_MAP_LEAF_BITS);
+    *out_leaf = (osize) (region & (((ou64) 1 << SLAB_MAP_LEAF_BITS) - 1));
+}
+
+O_STATIC
+bool slab_map_get(const void *mem)
+{
+    osize root, leaf;
+    slab_map_pos(mem, &root, &leaf);
+    SDL_atomic_t *bits = SDL_AtomicGetPtr((void **) &slab_map_L[root]);
+    if (!bits) {
+        return false;
+    }
+    return ((ou32) SDL_AtomicGet(&bits[leaf / 32]) >> (leaf % 32)) & 1;
+}
+
+// called with the slab mutex locked, the bits of different slabs may be set concurrently
+O_STATIC
+void slab_map_set(const void *mem, bool set)
+{
+    osize root, leaf;
+    slab_map_pos(mem, &root, &leaf);
+    SDL_atomic_t *bits = SDL_AtomicGetPtr((void **) &slab_map_L[root]);
+    if (!bits) {
+        bits = SDL_calloc(sizeof *bits, ((osize) 1 << SLAB_MAP_LEAF_BITS) / 32);
+        o_assume(bits, "slab map allocation failed");
+        if (!SDL_AtomicCASPtr((void **) &slab_map_L[root], NULL, bits)) {
+            // another allocator was faster
+            SDL_free(bits);
+            bits = SDL_AtomicGetPtr((void **) &slab_map_L[root]);
+        }
+    }
+    ou32 mask = (ou32) 1 << (leaf % 32);
+    int old_bits, new_bits;
+    do {
+        old_bits = SDL_AtomicGet(&bits[leaf / 32]);
+        new_bits = (int) (set ? (ou32) old_bits | mask : (ou32) old_bits & ~mask);
+    } while (!SDL_AtomicCAS(&bits[leaf / 32], old_bits, new_bits));
+}
+
+O_STATIC
+struct slab_header *slab_header_of(const void *mem)
+{
+    if (!mem || !slab_map_get(mem)) {
+        return NULL;
+    }
+    return (struct slab_header *) ((uintptr_t) mem & ~((uintptr_t) SLAB_SIZE - 1));
+}
+
+O_STATIC
+osize slab_class_size(int class_idx)
+{
+    return (osize) 1 << (class_idx + SLAB_CLASS_MIN_SHIFT);
+}
+
+O_STATIC
+int slab_class_of(osize n)
+{
+    int class_idx = 0;
+    while (slab_class_size(class_idx) < n) {
+        class_idx++;
+    }
+    return class_idx;
+}
+
+O_STATIC
+void slab_lock(struct slab *s)
+{
+#ifdef MIA_OPTION_THREAD
+    int ret = SDL_LockMutex(s->mutex);
+    o_assume(ret != -1, "SDL_LockMutex failed");
+#endif
+}
+
+O_STATIC
+void slab_unlock(struct slab *s)
+{
+#ifdef MIA_OPTION_THREAD
+    int ret = SDL_UnlockMutex(s->mutex);
+    o_assume(ret != -1, "SDL_UnLockMutex failed");
+#endif
+}
+
+// slab mutex must be locked
+// carves a new slab into blocks for the shared free list of the given class
+O_STATIC
+void slab_grow(struct slab *s, int class_idx)
+{
+    if (s->chunk_slabs_left <= 0) {
+        // one slab extra, to align the chunk
+        osize chunk_size = SLAB_SIZE * (SLAB_CHUNK_SLABS + 1);
+        obyte *chunk = SDL_malloc(chunk_size);
+        o_assume(chunk, "slab chunk allocation failed?");
+
+        s->chunks = SDL_realloc(s->chunks, sizeof *s->chunks * (s->chunks_num + 1));
+        o_assume(s->chunks, "slab chunk list allocation failed?");
+        s->chunks[s->chunks_num++] = chunk;
+
+        uintptr_t aligned = ((uintptr_t) chunk + SLAB_SIZE - 1) & ~((uintptr_t) SLAB_SIZE - 1);
+        s->chunk_slab_next = (obyte *) aligned;
+        s->chunk_slabs_left = SLAB_CHUNK_SLABS;
+        o_log_trace_s("o_allocator_slab", "allocating a new chunk! (chunks now: %i)", s->chunks_num);
+    }
+
+    obyte *slab = s->chunk_slab_next;
+    s->chunk_slab_next += SLAB_SIZE;
+    s->chunk_slabs_left--;
+    s->slabs_num++;
+
+    struct slab_header *header = (struct slab_header *) slab;
+    header->id = slab_ID;
+    header->class_idx = class_idx;
+    header->owner = s;
+    slab_map_set(slab, true);
+
+    osize size = slab_class_size(class_idx);
+    osize blocks = (SLAB_SIZE - SLAB_HEADER_SIZE) / size;
+    if (size >= SLAB_HEADER_SIZE) {
+        // keep the blocks aligned to their size, so bigger blocks loose the header space
+        blocks = (SLAB_SIZE - size) / size;
+    }
+    obyte *first = slab + o_max(size, SLAB_HEADER_SIZE);
+    for (osize i = blocks - 1; i >= 0; i--) {
+        struct slab_block *block = (struct slab_block *) (first + i * size);
+        block->next = s->classes[class_idx].free;
+        s->classes[class_idx].free = block;
+    }
+    s->classes[class_idx].free_num += blocks;
+    s->classes[class_idx].blocks_num += blocks;
+}
+
+// moves up to SLAB_BATCH blocks from the shared state into the cache
+O_STATIC
+void slab_cache_refill(struct slab_cache *c, int class_idx)
+{
+    struct slab *s = c->slab;
+    slab_lock(s);
+    if (!s->classes[class_idx].free) {
+        slab_grow(s, class_idx);
+    }
+    for (int i = 0; i < SLAB_BATCH && s->classes[class_idx].free; i++) {
+        struct slab_block *block = s->classes[class_idx].free;
+        s->classes[class_idx].free = block->next;
+        s->classes[class_idx].free_num--;
+
+        block->next = c->classes[class_idx].free;
+        c->classes[class_idx].free = block;
+        c->classes[class_idx].num++;
+    }
+    slab_unlock(s);
+}
+
+// moves up to max blocks from the cache back into the shared state
+O_STATIC
+void slab_cache_flush(struct slab_cache *c, int class_idx, int max)
+{
+    struct slab *s = c->slab;
+    slab_lock(s);
+    for (int i = 0; i < max && c->classes[class_idx].free; i++) {
+        struct slab_block *block = c->classes[class_idx].free;
+        c->classes[class_idx].free = block->next;
+        c->classes[class_idx].num--;
+
+        block->next = s->classes[class_idx].free;
+        s->classes[class_idx].free = block;
+        s->classes[class_idx].free_num++;
+    }
+    slab_unlock(s);
+}
+
+// fast path for the thread local cache of the last used slab allocator
+static _Thread_local struct slab_cache *L_slab_cache_last;
+
+// registered as thread local storage destructor, called on thread exit
+O_STATIC
+void slab_cache_del(void *data)
+{
+    struct slab_cache *c = data;
+    struct slab *s = c->slab;
+    if (s) {
+        for (int i = 0; i < s->classes_num; i++) {
+            slab_cache_flush(c, i, c->classes[i].num);
+        }
+        slab_lock(s);
+        if (c->prev) {
+            c->prev->next = c->next;
+        } else {
+            s->caches = c->next;
+        }
+        if (c->next) {
+            c->next->prev = c->prev;
+        }
+        slab_unlock(s);
+    }
+    if (L_slab_cache_last == c) {
+        L_slab_cache_last = NULL;
+    }
+    SDL_free(c);
+}
+
+O_STATIC
+struct slab_cache *slab_cache(struct slab *s)
+{
+    struct slab_cache *c = L_slab_cache_last;
+    if (c && c->slab == s) {
+        return c;
+    }
+#ifdef MIA_OPTION_THREAD
+    c = SDL_TLSGet(s->tls);
+#else
+    c = s->cache;
+#endif
+    if (c) {
+        L_slab_cache_last = c;
+        return c;
+    }
+
+    c = SDL_calloc(sizeof *c, 1);
+    o_assume(c, "slab cache allocation failed");
+    c->slab = s;
+
+    slab_lock(s);
+    c->next = s->caches;
+    if (c->next) {
+        c->next->prev = c;
+    }
+    s->caches = c;
+    slab_unlock(s);
+
+#ifdef MIA_OPTION_THREAD
+    SDL_TLSSet(s->tls, c, slab_cache_del);
+#else
+    s->cache = c;
+#endif
+    L_slab_cache_last = c;
+    return c;
+}
+
+O_STATIC
+void *slab_block_alloc(struct slab *s, int class_idx)
+{
+    struct slab_cache *c = slab_cache(s);
+    if (!c->classes[class_idx].free) {
+        slab_cache_refill(c, class_idx);
+    }
+    struct slab_block *block = c->classes[class_idx].free;
+    c->classes[class_idx].free = block->next;
+    c->classes[class_idx].num--;
+    return block;
+}
+
+O_STATIC
+void slab_block_free(struct slab *s, struct slab_header *header, void *mem)
+{
+    struct slab_cache *c = slab_cache(s);
+    int class_idx = header->class_idx;
+    struct slab_block *block = mem;
+    block->next = c->classes[class_idx].free;
+    c->classes[class_idx].free = block;
+    if (++c->classes[class_idx].num >= 2 * SLAB_BATCH) {
+        slab_cache_flush(c, class_idx, SLAB_BATCH);
+    }
+}
+
+O_STATIC
+void *slab_realloc_try(struct o_allocator_i iface, void *mem, osize element_size, osize num)
+{
+    slab_assert(iface);
+    struct slab *s = iface.impl;
+
+    osize n = element_size * num;
+    n = o_max(0, n);
+    if (!mem && n == 0) {
+        // noop
+        return NULL;
+    }
+
+    struct slab_header *header = slab_header_of(mem);
+    assert((!header || (header->id == slab_ID && header->owner == s)) && "pointer of another slab allocator?");
+
+    if (n == 0) {
+        // free
+        if (header) {
+            slab_block_free(s, header, mem);
+        } else {
+            SDL_free(mem);
+        }
+        return NULL;
+    }
+
+    osize max_size = slab_class_size(s->classes_num - 1);
+
+    if (header) {
+        osize old_size = slab_class_size(header->class_idx);
+        if (n <= old_size) {
+            // realloc, the old block can fit the values
+            return mem;
+        }
+        // grow into a new block (or the heap), o_memcpy, free from the slab
+        void *new_mem;
+        if (n <= max_size) {
+            new_mem = slab_block_alloc(s, slab_class_of(n));
+        } else {
+            new_mem = SDL_malloc(n);
+            if (!new_mem) {
+                o_log_debug_s(__func__, "failed to allocate %i bytes", n);
+                return NULL;
+            }
+        }
+        o_memcpy(new_mem, mem, 1, old_size);
+        slab_block_free(s, header, mem);
+        return new_mem;
+    }
+
+    if (!mem && n <= max_size) {
+        // alloc
+        return slab_block_alloc(s, slab_class_of(n));
+    }
+
+    // (re)alloc using heap
+    mem = SDL_realloc(mem, n);
+    if (!mem) {
+        o_log_debug_s(__func__, "failed to allocate %i bytes", n);
+    }
+    return mem;
+}
+
+struct o_allocator_i o_allocator_slab_new(int max_block_size)
+{
+    if (max_block_size <= 0) {
+        max_block_size = 1024;
+    }
+    max_block_size = o_clamp(max_block_size, 1 << SLAB_CLASS_MIN_SHIFT, 1 << SLAB_CLASS_MAX_SHIFT);
+
+    struct slab *s = SDL_calloc(sizeof *s, 1);
+    o_assume(s, "failed to create slab struct");
+    s->id = slab_ID;
+    s->classes_num = slab_class_of(max_block_size) + 1;
+
+#ifdef MIA_OPTION_THREAD
+    s->tls = SDL_TLSCreate();
+    o_assume(s->tls, "SDL_TLSCreate failed");
+    s->mutex = SDL_CreateMutex();
+    o_assume(s->mutex, "SDL_CreateMutex failed");
+#endif
+
+    o_log_trace_s("o_allocator_slab", "created with %i size classes, up to %i bytes",
+                  s->classes_num, (int) slab_class_size(s->classes_num - 1));
+
+    return (struct o_allocator_i) {s, slab_realloc_try, "slab"};
+}
+
+void o_allocator_slab_del(struct o_allocator_i *self)
+{
+    if (!self || !self->impl) {
+        return;
+    }
+    slab_assert(*self);
+    struct slab *s = self->impl;
+
+    // the cache of this thread is freed directly, the others on their thread exit
+#ifdef MIA_OPTION_THREAD
+    struct slab_cache *own = SDL_TLSGet(s->tls);
+    SDL_TLSSet(s->tls, NULL, NULL);
+#else
+    struct slab_cache *own = s->cache;
+#endif
+    for (struct slab_cache *c = s->caches; c; c = c->next) {
+        c->slab = NULL;
+    }
+    if (L_slab_cache_last == own) {
+        L_slab_cache_last = NULL;
+    }
+    SDL_free(own);
+
+    for (int i = 0; i < s->chunks_num; i++) {
+        uintptr_t aligned = ((uintptr_t) s->chunks[i] + SLAB_SIZE - 1) & ~((uintptr_t) SLAB_SIZE - 1);
+        for (int j = 0; j < SLAB_CHUNK_SLABS; j++) {
+            slab_map_set((obyte *) aligned + j * SLAB_SIZE, false);
+        }
+        SDL_free(s->chunks[i]);
+    }
+
+#ifdef MIA_OPTION_THREAD
+    // kill the mutex
+    SDL_DestroyMutex(s->mutex);
+#endif
+
+    SDL_free(s->chunks);
+    SDL_free(s);
+    o_clear(self, sizeof *self, 1);
+}
+
+int o_allocator_slab_block_size_max(struct o_allocator_i self)
+{
+    struct slab *s = self.impl;
+    if (!s || s->id != slab_ID) {
+        return 0;
+    }
+    return (int) slab_class_size(s->classes_num - 1);
+}
+
+int o_allocator_slab_slabs_num(struct o_allocator_i self)
+{
+    struct slab *s = self.impl;
+    if (!s || s->id != slab_ID) {
+        return 0;
+    }
+    return s->slabs_num;
+}
+
+int o_allocator_slab_blocks_num(struct o_allocator_i self)
+{
+    struct slab *s = self.impl;
+    if (!s || s->id != slab_ID) {
+        return 0;
+    }
+    osize num = 0;
+    slab_lock(s);
+    for (int i = 0; i < s->classes_num; i++) {
+        num += s->classes[i].blocks_num;
+    }
+    slab_unlock(s);
+    return (int) num;
+}
+
+int o_allocator_slab_blocks_available(struct o_allocator_i self)
+{
+    struct slab *s = self.impl;
+    if (!s || s->id != slab_ID) {
+        return 0;
+    }
+    osize num = 0;
+    slab_lock(s);
+    for (int i = 0; i < s->classes_num; i++) {
+        num += s->classes[i].free_num;
+        for (struct slab_cache *c = s->caches; c; c = c->next) {
+            num += c->classes[i].num;
+        }
+    }
+    slab_unlock(s);
+    return (int) num;
+}
+
+bool o_allocator_slab_pointer_slabbed(struct o_allocator_i self, const void *mem)
+{
+    struct slab *s = self.impl;
+    if (!s || s->id != slab_ID) {
+        return false;
+    }
+    struct slab_header *header = slab_header_of(mem);
+    return header && header->owner == s;
+}
+
 //
 // Arena
 //
@@ -1,6 +1,7 @@
 #include "o/file.h"
 #include "o/str.h"
 #include "o/OStreamSdl.h"
+#include "o/OTarPack.h"
 #include "o/OObjRoot.h"  // for internal work
 #include <SDL2/SDL_rwops.h>
 #include <SDL2/SDL_system.h>
@@ -24,11 +25,17 @@
 
 
 struct oobj_opt o_file_open(oobj parent, const char *file, const char *mode) {
-    SDL_RWops *rwops = SDL_RWFromFile(file, mode);
-    if (!rwops) {
-        return oobj_opt(NULL);
+    oobj stream = NULL;
+    if (mode[0] == 'r' && o_str_find_char(mode, '+') == -1) {
+        stream = OTarPack_mounted_stream(parent, file).o;
+    }
+    if (!stream) {
+        SDL_RWops *rwops = SDL_RWFromFile(file, mode);
+        if (!rwops) {
+            return oobj_opt(NULL);
+        }
+        stream = OStreamSdl_new(parent, rwops);
     }
-    OStreamSdl *stream = OStreamSdl_new(parent, rwops);
 
     char buf[64];
     o_strf_buf(buf, "Stream:%s", file);
@@ -1,6 +1,9 @@
 #include "o/img.h"
 #include "o/OObj.h"
 #include "o/OObjRoot.h"
+#include "o/OTarPack.h"
+#include "o/OStreamMem.h"
+#include "o/str.h"
 #include <SDL2/SDL_image.h>
 
 #define O_LOG_LIB "o"
@@ -36,10 +39,45 @@ struct o_img o_img_new0(oobj obj, int cols, int rows)
     return self;
 }
 
+// loads from a mounted OTarPack, if available, else from the file system
+O_STATIC
+SDL_Surface *img_load_surface(const char *file)
+{
+    oobj root = OObjRoot_new_heap();
+    struct oobj_opt stream = OTarPack_mounted_stream(root, file);
+    if (!stream.o) {
+        o_del(root);
+        return IMG_Load(file);
+    }
+
+    // memory mapped packs are decoded without a copy
+    const void *data = NULL;
+    osize size = 0;
+    if (OObj_check(stream.o, OStreamMem)) {
+        OStreamMem *mem = stream.o;
+        data = mem->memory;
+        size = mem->memory_size;
+    } else {
+        size = OStream_size(stream.o);
+        void *buf = o_alloc(root, 1, size);
+        if (buf && OStream_read(stream.o, buf, 1, size) == size) {
+            data = buf;
+        }
+    }
+    SDL_Surface *img = NULL;
+    if (data) {
+        // the file extension is used as type hint, like IMG_Load does
+        osize dot = o_str_find_back_char(file, '.');
+        img = IMG_LoadTyped_RW(SDL_RWFromConstMem(data, (int) size), 1, dot >= 0 ? file + dot + 1 : NULL);
+    }
+    o_del(root);
+    return img;
+}
+
 struct o_img o_img_new_file(oobj obj, const char *file)
 {
     struct o_img self = {0};
-    SDL_Surface *img = IMG_Load(file);
+    SDL_Surface *img = img_load_surface(file);
     if(!img || img->w <= 0 || img->h <= 0) {
         o_log_warn_s(__func__, "failed to load the image: %s", file);
         return self;
@@ -18,6 +18,7 @@
 #include "OFuture.c"
 #include "OJoin.c"
 #include "OJson.c"
+#include "OJsonDoc.c"
 #include "OMap.c"
 #include "OObj.c"
 #include "OPattern.c"
@@ -29,11 +30,14 @@
 #include "OStreamBuffered.c"
 #include "OStreamMem.c"
 #include "OStreamSdl.c"
+#include "OStreamSlice.c"
 #include "OStreamSocket.c"
+#include "OTarPack.c"
 #include "OTask.c"
 #include "OThread.c"
 #include "OThreadpool.c"
 #include "OWeakjoin.c"
+#include "parallel.c"
 #include "socket.c"
 #include "str.c"
 #include "tar.c"
@@ -0,0 +1,233 @@
+#include "o/parallel.h"
+#include "o/OObj.h"
+
+// elements per tile, if the tile rows are chosen
+#define TILE_ELEMENTS 16384
+
+#ifdef MIA_OPTION_THREAD
+
+#include "o/OObjRoot.h"
+#include "o/OThreadpool.h"
+#include "o/OFuture.h"
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_cpuinfo.h>
+
+// chunks per thread, if the grain size is chosen
+#define CHUNKS_PER_THREAD 4
+
+struct job {
+    osize num;
+    osize grain;
+    SDL_atomic_t next_chunk;
+
+    o_parallel_fn fn;
+    void *user;
+
+    // reduce only
+    o_parallel_reduce_fn reduce_fn;
+    o_parallel_join_fn join_fn;
+    void *inout_result;
+    osize result_size;
+    // partial results, one per thread
+    obyte *partials;
+    SDL_atomic_t next_partial;
+};
+
+static void *L_pool;
+
+
+O_STATIC
+void job_work(struct job *job)
+{
+    void *partial = NULL;
+    if (job->reduce_fn) {
+        int p = SDL_AtomicAdd(&job->next_partial, 1);
+        partial = job->partials + p * job->result_size;
+    }
+    for (;;) {
+        osize begin = (osize) SDL_AtomicAdd(&job->next_chunk, 1) * job->grain;
+        if (begin >= job->num) {
+            break;
+        }
+        osize end = o_min(job->num, begin + job->grain);
+        if (job->reduce_fn) {
+            job->reduce_fn(begin, end, partial, job->user);
+        } else {
+            job->fn(begin, end, job->user);
+        }
+    }
+}
+
+O_STATIC
+void job_future(oobj future)
+{
+    job_work(o_user(future));
+}
+
+// returns false if the job should be run inline
+O_STATIC
+bool job_run(oobj opt_pool, struct job *job)
+{
+    if (job->grain > 0 && job->num <= job->grain) {
+        // a single chunk, without touching the pool
+        return false;
+    }
+    oobj pool = opt_pool ? opt_pool : o_parallel_pool();
+    if (!pool || OThreadpool_in_pool(pool)) {
+        return false;
+    }
+
+    int threads = (int) OThreadpool_threads(pool);
+    if (job->grain <= 0) {
+        job->grain = o_max(1, job->num / ((threads + 1) * CHUNKS_PER_THREAD));
+    }
+    osize chunks = (job->num + job->grain - 1) / job->grain;
+    if (chunks <= 1) {
+        return false;
+    }
+    int helpers = (int) o_min(threads, chunks - 1);
+
+    // futures and partials are allocated in a temporary root, because the job may run in any thread
+    oobj container = OObjRoot_new_heap();
+    if (job->reduce_fn) {
+        job->partials = o_alloc(container, helpers + 1, job->result_size);
+        for (int i = 0; i < helpers + 1; i++) {
+            o_memcpy(job->partials + i * job->result_size, job->inout_result, 1, job->result_size);
+        }
+    }
+
+    oobj *futures = o_new(container, oobj, helpers);
+    for (int i = 0; i < helpers; i++) {
+        futures[i] = OFuture_new_run(container, job_future, pool, job);
+    }
+    job_work(job);
+    for (int i = 0; i < helpers; i++) {
+        OFuture_wait(futures[i]);
+    }
+
+    if (job->reduce_fn) {
+        // a partial of a helper that found no chunk left is still the initial value
+        for (int i = 0; i < helpers + 1; i++) {
+            job->join_fn(job->inout_result, job->partials + i * job->result_size, job->user);
+        }
+    }
+    o_del(container);
+    return true;
+}
+
+//
+// public
+//
+
+oobj o_parallel_pool(void)
+{
+    void *pool = SDL_AtomicGetPtr(&L_pool);
+    if (pool) {
+        return pool;
+    }
+    int threads = SDL_GetCPUCount() - 1;
+    if (threads <= 0) {
+        return NULL;
+    }
+    // the pool lives as long as the program, so it gets an own root
+    oobj root = OObjRoot_new_heap();
+    pool = OThreadpool_new(root, threads);
+    if (!SDL_AtomicCASPtr(&L_pool, NULL, pool)) {
+        // other thread was faster
+        o_del(root);
+        pool = SDL_AtomicGetPtr(&L_pool);
+    }
+    return pool;
+}
+
+#else // MIA_OPTION_THREAD
+
+oobj o_parallel_pool(void)
+{
+    return NULL;
+}
+
+#endif // MIA_OPTION_THREAD
+
+
+void o_parallel_for(oobj opt_pool, osize num, osize grain, o_parallel_fn fn, void *user)
+{
+    if (num <= 0) {
+        return;
+    }
+#ifdef MIA_OPTION_THREAD
+    struct job job = {
+            .num = num,
+            .grain = grain,
+            .fn = fn,
+            .user = user
+    };
+    if (job_run(opt_pool, &job)) {
+        return;
+    }
+#endif
+    fn(0, num, user);
+}
+
+void o_parallel_reduce(oobj opt_pool, osize num, osize grain, void *inout_result, osize result_size,
+                       o_parallel_reduce_fn fn, o_parallel_join_fn join, void *user)
+{
+    if (num <= 0) {
+        return;
+    }
+#ifdef MIA_OPTION_THREAD
+    struct job job = {
+            .num = num,
+            .grain = grain,
+            .user = user,
+            .reduce_fn = fn,
+            .join_fn = join,
+            .inout_result = inout_result,
+            .result_size = result_size
+    };
+    if (job_run(opt_pool, &job)) {
+        return;
+    }
+#endif
+    // inline, the result is the only partial
+    fn(0, num, inout_result, user);
+}
+
+
+struct tiles {
+    int cols, rows;
+    int tile_cols, tile_rows;
+    int tiles_x;
+    o_parallel_tile_fn fn;
+    void *user;
+};
+
+O_STATIC
+void tiles_run(osize begin, osize end, void *user)
+{
+    struct tiles *t = user;
+    for (osize i = begin; i < end; i++) {
+        int col = (int) (i % t->tiles_x) * t->tile_cols;
+        int row = (int) (i / t->tiles_x) * t->tile_rows;
+        t->fn(col, o_min(t->cols, col + t->tile_cols), row, o_min(t->rows, row + t->tile_rows), t->user);
+    }
+}
+
+void o_parallel_for_2d(oobj opt_pool, int cols, int rows, int tile_cols, int tile_rows,
+                       o_parallel_tile_fn fn, void *user)
+{
+    if (cols <= 0 || rows <= 0) {
+        return;
+    }
+    struct tiles t = {
+            .cols = cols,
+            .rows = rows,
+            .tile_cols = tile_cols > 0 ? o_min(tile_cols, cols) : cols,
+            .fn = fn,
+            .user = user
+    };
+    t.tile_rows = tile_rows > 0 ? tile_rows : o_max(1, TILE_ELEMENTS / t.tile_cols);
+    t.tiles_x = (cols + t.tile_cols - 1) / t.tile_cols;
+    int tiles_y = (rows + t.tile_rows - 1) / t.tile_rows;
+    o_parallel_for(opt_pool, (osize) t.tiles_x * tiles_y, 1, tiles_run, &t);
+}
@@ -1,10 +1,14 @@
 #include "r/RBuffer.h"
 #include "o/OObj_builder.h"
 #include "r/gl.h"
+#include "r/state.h"
 
 #define O_LOG_LIB "r"
 #include "o/log.h"
 
+// smallest storage in elements, to avoid many small reallocations
+#define MIN_CAPACITY 16
+
 
 //
 // public
@@ -21,9 +25,7 @@ RBuffer *RBuffer_init(oobj obj, oobj parent, osize element_size)
     self->element_size = element_size;
     
     glGenVertexArrays(1, &self->gl_vao);
-    glBindVertexArray(self->gl_vao);
     glGenBuffers(1, &self->gl_vbo);
-    glBindVertexArray(0);
     r_error_check("create");
 
     // deletor
@@ -39,6 +41,7 @@ void RBuffer__v_del(oobj obj)
     OObj_assert(obj, RBuffer);
     RBuffer *self = obj;
 
+    r_state_buffer_deleted(self->gl_vao, self->gl_vbo);
     // safe to pass 0
     glDeleteVertexArrays(1, &self->gl_vao);
     glDeleteBuffers(1, &self->gl_vbo);
@@ -56,51 +59,164 @@ void RBuffer_update(oobj obj, const void *data, osize num)
         return;
     }
     
-    glBindVertexArray(self->gl_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, self->gl_vbo);
-    
-    glBufferData(GL_ARRAY_BUFFER, self->element_size * num, data, GL_STREAM_DRAW);
+    // the array buffer binding is not part of the vao
+    r_state_array_buffer(self->gl_vbo);
+
+    if(num > self->capacity) {
+        self->capacity = o_max(MIN_CAPACITY, o_max(num, self->capacity * 2));
+    }
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    // orphan the old storage, so we do not have to wait for pending draws on it
+    glBufferData(GL_ARRAY_BUFFER, self->element_size * self->capacity, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, self->element_size * num, data);
+    r_stats_frame()->buffer_uploaded_bytes += self->element_size * num;
+    r_stats_frame()->buffer_full_uploads++;
     
     r_error_check("update");
 }
 
+void RBuffer_update_range(oobj obj, const void *data, osize num, osize begin, osize n)
+{
+    OObj_assert(obj, RBuffer);
+    RBuffer *self = obj;
+
+    // the storage (and its old content) is too small, or was never allocated
+    if(num > self->capacity) {
+        RBuffer_update(self, data, num);
+        return;
+    }
+
+    self->num = num;
+    begin = o_clamp(begin, 0, num);
+    n = o_clamp(n, 0, num - begin);
+    if(n <= 0) {
+        return;
+    }
+
+    r_state_array_buffer(self->gl_vbo);
+
+    const obyte *bytes = data;
+    glBufferSubData(GL_ARRAY_BUFFER, self->element_size * begin, self->element_size * n,
+                    bytes + self->element_size * begin);
+    r_stats_frame()->buffer_uploaded_bytes += self->element_size * n;
+
+    r_error_check("update range");
+}
+
+void RBuffer_dirty_mark(struct RBuffer_dirty *dirty, osize idx, osize n)
+{
+    if (n <= 0) {
+        return;
+    }
+    if (!dirty->tracking) {
+        // unmarked changes before may still be pending
+        dirty->tracking = true;
+        dirty->all = true;
+    }
+
+    // absorbs all touching spans into the new one and inserts it sorted
+    struct RBuffer_span span = {idx, idx + n};
+    struct RBuffer_span spans[RBuffer_DIRTY_SPANS_MAX + 1];
+    int num = 0;
+    bool inserted = false;
+    for (int i = 0; i < dirty->spans_num; i++) {
+        struct RBuffer_span s = dirty->spans[i];
+        if (s.end < span.begin) {
+            spans[num++] = s;
+        } else if (s.begin > span.end) {
+            if (!inserted) {
+                spans[num++] = span;
+                inserted = true;
+            }
+            spans[num++] = s;
+        } else {
+            span.begin = o_min(span.begin, s.begin);
+            span.end = o_max(span.end, s.end);
+        }
+    }
+    if (!inserted) {
+        spans[num++] = span;
+    }
+
+    if (num > RBuffer_DIRTY_SPANS_MAX) {
+        // merges the closest neighbours, uploading their gap is the cheapest
+        int merge = 0;
+        for (int i = 1; i < num - 1; i++) {
+            if (spans[i + 1].begin - spans[i].end < spans[merge + 1].begin - spans[merge].end) {
+                merge = i;
+            }
+        }
+        spans[merge].end = spans[merge + 1].end;
+        for (int i = merge + 1; i < num - 1; i++) {
+            spans[i] = spans[i + 1];
+        }
+        num--;
+    }
+
+    o_memcpy(dirty->spans, spans, sizeof *spans, num);
+    dirty->spans_num = num;
+}
+
+void RBuffer_update_dirty(oobj obj, struct RBuffer_dirty *dirty, const void *data, osize num)
+{
+    OObj_assert(obj, RBuffer);
+    RBuffer *self = obj;
+
+    osize dirty_num = 0;
+    for (int i = 0; i < dirty->spans_num; i++) {
+        dirty_num += dirty->spans[i].end - dirty->spans[i].begin;
+    }
+
+    // if most elements changed, a single orphaning upload beats waiting on pending draws for sub uploads
+    if (!dirty->tracking || dirty->all || num != self->num || dirty_num * 2 > num) {
+        RBuffer_update(self, data, num);
+    } else {
+        for (int i = 0; i < dirty->spans_num; i++) {
+            struct RBuffer_span s = dirty->spans[i];
+            RBuffer_update_range(self, data, num, s.begin, s.end - s.begin);
+        }
+    }
+
+    dirty->all = false;
+    dirty->spans_num = 0;
+}
+
 void RBuffer_use(oobj obj)
 {
     if (!obj) {
-        glBindVertexArray(0);
+        r_state_vao(0);
         return;
     }
     OObj_assert(obj, RBuffer);
     RBuffer *self = obj;
 
-    glBindVertexArray(self->gl_vao);
+    r_state_vao(self->gl_vao);
 }
 
-void RBuffer_location_vec4(oobj obj, int location, osize offset)
+void RBuffer_location(oobj obj, int location, int size, ou32 gl_type, bool normalized, osize offset)
 {
     OObj_assert(obj, RBuffer);
     RBuffer *self = obj;
     
-    glBindVertexArray(self->gl_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, self->gl_vbo);
+    r_state_vao(self->gl_vao);
+    r_state_array_buffer(self->gl_vbo);
 
     glEnableVertexAttribArray(location);
     
-    glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE,
+    glVertexAttribPointer(location, size, gl_type, normalized ? GL_TRUE : GL_FALSE,
                           self->element_size, (void *) offset);
     
     glVertexAttribDivisor(location, 1);
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-    
     r_error_check("location");
 }
 
 
+void RBuffer_location_vec4(oobj obj, int location, osize offset)
+{
+    RBuffer_location(obj, location, 4, GL_FLOAT, false, offset);
+}
+
 void RBuffer_location_mat4(oobj obj, int location, osize offset)
 {
     for(int c=0; c<4; c++) {
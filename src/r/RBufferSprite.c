@@ -0,0 +1,29 @@
+#include "r/RBufferSprite.h"
+#include "r/sprite.h"
+#include "r/gl.h"
+
+//
+// public
+//
+
+RBufferSprite *RBufferSprite_init(oobj obj, oobj parent)
+{
+    RBufferSprite *self = obj;
+
+    RBuffer_init(self, parent, sizeof (struct r_sprite));
+
+    const int in_pos = 0;
+    const int in_size_angle = 1;
+    const int in_uv_pos = 2;
+    const int in_uv_size = 3;
+    const int in_color = 4;
+
+    // size, angle and reserved are read as a single half vec4
+    RBuffer_location(self, in_pos, 2, GL_FLOAT, false, offsetof(struct r_sprite, pos));
+    RBuffer_location(self, in_size_angle, 4, GL_HALF_FLOAT, false, offsetof(struct r_sprite, size));
+    RBuffer_location(self, in_uv_pos, 2, GL_FLOAT, false, offsetof(struct r_sprite, uv_pos));
+    RBuffer_location(self, in_uv_size, 2, GL_HALF_FLOAT, false, offsetof(struct r_sprite, uv_size));
+    RBuffer_location(self, in_color, 4, GL_UNSIGNED_BYTE, true, offsetof(struct r_sprite, color));
+
+    return self;
+}
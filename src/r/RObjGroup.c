@@ -1,10 +1,137 @@
 #include "r/RObjGroup.h"
 #include "o/OObj_builder.h"
+#include "r/RObjQuad.h"
+#include "r/RObjText.h"
+#include "r/RBufferQuad.h"
+#include "r/RShaderQuad.h"
+#include "m/flt.h"
 
 #define O_LOG_LIB "r"
 #include "o/log.h"
 
 
+O_STATIC
+bool pose_is_translation(const mat4 *p)
+{
+    for (int c = 0; c < 3; c++) {
+        for (int r = 0; r < 4; r++) {
+            if (p->v[c * 4 + r] != (c == r ? 1.0f : 0.0f)) {
+                return false;
+            }
+        }
+    }
+    return p->m32 == 0 && p->m33 == 1;
+}
+
+// plain RObjQuad's with a single RShaderQuad
+O_STATIC
+bool quads_batchable(oobj obj)
+{
+    // no sub classes, they may render differently
+    if (OObj_type(obj) != OObj_type_literal(RObjQuad_ID)) {
+        return false;
+    }
+    RObjQuad *quads = obj;
+    // overridden virtual functions must still be called
+    if (quads->super.v_update != RObjQuad__v_update || quads->super.v_render != RObjQuad__v_render) {
+        return false;
+    }
+    return o_num(quads->shader_pipeline) == 1
+           && OObj_type(RObjQuad_shader(quads, 0)) == OObj_type_literal(RShaderQuad_ID);
+}
+
+// returns the RObjQuad of child, if it can be merged into a batch, else NULL
+O_STATIC
+RObjQuad *batch_quads_of(oobj child, const struct r_proj *proj, vec2 *out_offset)
+{
+    *out_offset = vec2_(0);
+
+    if (OObj_check(child, RObjText)) {
+        RObjText *text = child;
+        if (text->super.v_render != RObjText__v_render || !pose_is_translation(&text->pose)) {
+            return NULL;
+        }
+        // same pixel rounding as RObjText__v_render
+        out_offset->x = m_round(text->pose.m30 * proj->scale) / proj->scale;
+        out_offset->y = m_round(text->pose.m31 * proj->scale) / proj->scale;
+        child = text->quads;
+    }
+
+    return quads_batchable(child) ? child : NULL;
+}
+
+O_STATIC
+bool batch_compatible(RObjGroup *self, RShaderQuad *shader, oobj tex)
+{
+    RShaderQuad *batch = self->batch_shader;
+    return batch->super.program == shader->super.program
+           && batch->super.blend == shader->super.blend
+           && self->batch_tex == tex
+           && memcmp(&batch->stuv, &shader->stuv, sizeof batch->stuv) == 0;
+}
+
+O_STATIC
+void batch_flush(RObjGroup *self, oobj tex, const struct r_proj *proj)
+{
+    if (!self->batch_shader) {
+        return;
+    }
+    // borrows the shader of the first merged child, its tex is restored afterwards
+    RShaderQuad *shader = self->batch_shader;
+    oobj shader_tex = shader->tex;
+    shader->tex = self->batch_tex;
+
+    RBuffer_update(self->batch_buffer, OArray_data_void(self->batch_quads), OArray_num(self->batch_quads));
+    RShader_render_ex(shader, self->batch_buffer, tex, 0, proj);
+    shader->tex = shader_tex;
+
+    OArray_clear(self->batch_quads);
+    self->batch_shader = NULL;
+    self->batch_tex = NULL;
+}
+
+O_STATIC
+void batch_add(RObjGroup *self, RObjQuad *quads, vec2 offset)
+{
+    int num = (int) o_min(OArray_num(quads->quads), quads->num_rendered);
+    if (num <= 0) {
+        return;
+    }
+    struct r_quad *dst = OArray_append(self->batch_quads, OArray_data_void(quads->quads), num);
+    if (offset.x != 0 || offset.y != 0) {
+        for (int i = 0; i < num; i++) {
+            dst[i].pose.m30 += offset.x;
+            dst[i].pose.m31 += offset.y;
+        }
+    }
+}
+
+O_STATIC
+void render_batched(RObjGroup *self, oobj tex, const struct r_proj *proj)
+{
+    o_foreach_child(self, RObj, it) {
+        vec2 offset;
+        RObjQuad *quads = batch_quads_of(it.child, proj, &offset);
+        if (!quads) {
+            batch_flush(self, tex, proj);
+            RObj_render_ex(it.child, tex, proj, false);
+            continue;
+        }
+
+        RShaderQuad *shader = RObjQuad_shader(quads, 0);
+        if (self->batch_shader && !batch_compatible(self, shader, quads->tex)) {
+            batch_flush(self, tex, proj);
+        }
+        if (!self->batch_shader) {
+            self->batch_shader = shader;
+            self->batch_tex = quads->tex;
+        }
+        batch_add(self, quads, offset);
+    }
+    batch_flush(self, tex, proj);
+}
+
+
 //
 // public
 //
@@ -29,26 +156,42 @@ RObjGroup *RObjGroup_init(oobj obj, oobj parent)
 
 void RObjGroup__v_update(oobj obj)
 {
-    RObj **list = RObjGroup_list(obj, NULL);
-
-    RObj **it = list;
-    while (*it) {
-        RObj *child = *it++;
-        RObj_update(child);
+    OObj_assert(obj, RObjGroup);
+    RObjGroup *self = obj;
+    o_foreach_child(obj, RObj, it) {
+        // merged quads are copied in the render call, no need to upload them
+        if (self->batch && quads_batchable(it.child)) {
+            continue;
+        }
+        RObj_update(it.child);
     }
-
-    o_free(obj, list);
 }
 
 void RObjGroup__v_render(oobj obj, oobj tex, const struct r_proj *proj)
 {
-    RObj **list = RObjGroup_list(obj, NULL);
-
-    RObj **it = list;
-    while (*it) {
-        RObj *child = *it++;
-        RObj_render_ex(child, tex, proj, false);
+    OObj_assert(obj, RObjGroup);
+    RObjGroup *self = obj;
+    if (self->batch) {
+        render_batched(self, tex, proj);
+        return;
     }
+    o_foreach_child(obj, RObj, it) {
+        RObj_render_ex(it.child, tex, proj, false);
+    }
+}
+
 
-    o_free(obj, list);
+//
+// object functions:
+//
+
+void RObjGroup_batch_set(oobj obj, bool batch)
+{
+    OObj_assert(obj, RObjGroup);
+    RObjGroup *self = obj;
+    self->batch = batch;
+    if (batch && !self->batch_buffer) {
+        self->batch_buffer = RBufferQuad_new(self);
+        self->batch_quads = OArray_new_dyn(self, NULL, sizeof(struct r_quad), 0, 64);
+    }
 }
@@ -94,7 +94,10 @@ void RObjQuad__v_update(oobj obj)
     OObj_assert(obj, RObjQuad);
     RObjQuad* self = obj;
 
-    RBuffer_update(self->buffer, OArray_data_void(self->quads), OArray_num(self->quads));
+    const void *data = OArray_data_void(self->quads);
+    osize num = OArray_num(self->quads);
+
+    RBuffer_update_dirty(self->buffer, &self->dirty, data, num);
 }
 
 void RObjQuad__v_render(oobj obj, oobj tex, const struct r_proj* proj)
@@ -0,0 +1,85 @@
+#include "r/RObjSprite.h"
+#include "o/OObj_builder.h"
+#include "o/OArray.h"
+#include "r/RBufferSprite.h"
+
+#define O_LOG_LIB "r"
+#include "o/log.h"
+
+
+//
+// public
+//
+
+
+RObjSprite* RObjSprite_init(oobj obj, oobj parent, int num, oobj tex, bool move_tex)
+{
+    RObjSprite* self = obj;
+    o_clear(self, sizeof *self, 1);
+
+    RObj_init(obj, parent, RObjSprite__v_update, RObjSprite__v_render);
+    OObj_id_set(self, RObjSprite_ID);
+
+    num = o_max(0, num);
+    self->num_rendered = oi32_MAX;
+
+    self->sprites = OArray_new(self, NULL, sizeof(struct r_sprite), num);
+
+    for (int i = 0; i < num; i++) {
+        *RObjSprite_at(self, i) = r_sprite_new(m_2(RTex_size(tex)));
+    }
+
+    self->tex = tex;
+    if (tex && move_tex) {
+        o_move(tex, self);
+    }
+
+    self->buffer = RBufferSprite_new(self);
+    self->shader = RShaderSprite_new(self, tex, false);
+
+    // vfuncs
+    self->super.super.v_op_num = RObjSprite__v_op_num;
+    self->super.super.v_op_at = RObjSprite__v_op_at;
+
+    // update default values to gpu
+    RObj_update(self);
+
+    return self;
+}
+
+//
+// virtual implementations:
+//
+
+osize RObjSprite__v_op_num(oobj obj)
+{
+    return RObjSprite_num(obj);
+}
+
+void* RObjSprite__v_op_at(oobj obj, osize idx)
+{
+    return RObjSprite_at(obj, (int)idx);
+}
+
+void RObjSprite__v_update(oobj obj)
+{
+    OObj_assert(obj, RObjSprite);
+    RObjSprite* self = obj;
+
+    const void *data = OArray_data_void(self->sprites);
+    osize num = OArray_num(self->sprites);
+
+    RBuffer_update_dirty(self->buffer, &self->dirty, data, num);
+}
+
+void RObjSprite__v_render(oobj obj, oobj tex, const struct r_proj* proj)
+{
+    OObj_assert(obj, RObjSprite);
+    RObjSprite* self = obj;
+
+    // update tex reference
+    self->shader->tex = self->tex;
+
+    int num_render = o_min(OArray_num(self->sprites), self->num_rendered);
+    RShader_render_ex(self->shader, self->buffer, tex, num_render, proj);
+}
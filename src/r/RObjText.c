@@ -67,7 +67,7 @@ RObjText *RObjText_init(oobj obj, oobj parent, int num, oobj tex, bool move_tex,
 
     self->text_mode = RObjText_MODE_DEFAULT;
     
-    self->quads = RObjQuad_new_color(parent, num, tex, move_tex);
+    self->quads = RObjQuad_new_color(self, num, tex, move_tex);
     
     for(int i=0; i<num; i++) {
         struct r_quad *q = RObjQuad_at(self->quads, i);
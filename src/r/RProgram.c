@@ -4,10 +4,14 @@
 #include "o/file.h"
 #include "o/str.h"
 #include "r/gl.h"
+#include "r/state.h"
 
 #define O_LOG_LIB "r"
 #include "o/log.h"
 
+// last given RProgram generation
+static ou32 L_generation;
+
 
 O_STATIC
 GLuint shader_stage_new(char **shader_codes, GLint shader_type, const char *source_tag_of_code)
@@ -196,6 +200,9 @@ RProgram *RProgram_init(oobj obj, oobj parent, char **shader_codes, int num_draw
     self->num_draw_buffers = num_draw_buffers;
     self->uniforms = OMap_new_string_keys(self, sizeof (oi32), 64);
 
+    // skips 0 on overflow, which marks unused cache entries
+    self->generation = ++L_generation ? L_generation : ++L_generation;
+
     // deletor
     self->super.v_del = RProgram__v_del;
 
@@ -229,6 +236,7 @@ void RProgram__v_del(oobj obj)
     OObj_assert(obj, RProgram);
     RProgram *self = obj;
 
+    r_state_program_deleted(self->gl_program);
     // safe to pass 0
     glDeleteProgram(self->gl_program);
 
@@ -238,13 +246,13 @@ void RProgram__v_del(oobj obj)
 ou32 RProgram_use(oobj obj)
 {
     if (!obj) {
-        glUseProgram(0);
+        r_state_program(0);
         return 0;
     }
     OObj_assert(obj, RProgram);
     RProgram *self = obj;
 
-    glUseProgram(self->gl_program);
+    r_state_program(self->gl_program);
 
     return self->gl_program;
 }
@@ -278,86 +286,136 @@ oi32 RProgram_uniform(oobj obj, const char *name)
 
 void RProgram_uniform_tex(oobj obj, const char *name, int pos, ou32 tex)
 {
-
-    O_EXTERN
-    ou32 RTex__bound_gl(void);
-    ou32 bound = RTex__bound_gl();
-    assert((bound==0 || bound != tex) && "tex already bound as framebuffer!");
-
-    oi32 uniform = RProgram_uniform(obj, name);
-    glActiveTexture(GL_TEXTURE0 + pos);
-    glUniform1i(uniform, pos);
-    glBindTexture(GL_TEXTURE_2D, tex);
+    RProgram_handle_tex(RProgram_uniform(obj, name), pos, tex);
 }
 
 void RProgram_uniform_tex_off(oobj program, int pos)
 {
-    glActiveTexture(GL_TEXTURE0 + pos);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    // noop, the binding stays in the state cache, see r/state.h
 }
 
 void RProgram_uniform_mat4(oobj obj, const char *name, const mat4 *data, int num)
 {
-    oi32 uniform = RProgram_uniform(obj, name);
-    glUniformMatrix4fv(uniform, num, GL_FALSE, (void *) data);
+    RProgram_handle_mat4(RProgram_uniform(obj, name), data, num);
 }
 
 void RProgram_uniform_mat3(oobj obj, const char *name, const mat3 *data, int num)
 {
-    oi32 uniform = RProgram_uniform(obj, name);
-    glUniformMatrix3fv(uniform, num, GL_FALSE, (void *) data);
+    RProgram_handle_mat3(RProgram_uniform(obj, name), data, num);
 }
 
 void RProgram_uniform_mat2(oobj obj, const char *name, const mat2 *data, int num)
 {
-    oi32 uniform = RProgram_uniform(obj, name);
-    glUniformMatrix2fv(uniform, num, GL_FALSE, (void *) data);
+    RProgram_handle_mat2(RProgram_uniform(obj, name), data, num);
 }
 
 void RProgram_uniform_vec4(oobj obj, const char *name, const vec4 *data, int num)
 {
-    oi32 uniform = RProgram_uniform(obj, name);
-    glUniform4fv(uniform, num, (void *) data);
+    RProgram_handle_vec4(RProgram_uniform(obj, name), data, num);
 }
 
 void RProgram_uniform_vec3(oobj obj, const char *name, const vec3 *data, int num)
 {
-    oi32 uniform = RProgram_uniform(obj, name);
-    glUniform3fv(uniform, num, (void *) data);
+    RProgram_handle_vec3(RProgram_uniform(obj, name), data, num);
 }
 
 void RProgram_uniform_vec2(oobj obj, const char *name, const vec2 *data, int num)
 {
-    oi32 uniform = RProgram_uniform(obj, name);
-    glUniform2fv(uniform, num, (void *) data);
+    RProgram_handle_vec2(RProgram_uniform(obj, name), data, num);
 }
 
 void RProgram_uniform_float(oobj obj, const char *name, const float *data, int num)
 {
-    oi32 uniform = RProgram_uniform(obj, name);
-    glUniform1fv(uniform, num, (void *) data);
+    RProgram_handle_float(RProgram_uniform(obj, name), data, num);
 }
 
 void RProgram_uniform_ivec4(oobj obj, const char *name, const ivec4 *data, int num)
 {
-    oi32 uniform = RProgram_uniform(obj, name);
-    glUniform4iv(uniform, num, (void *) data);
+    RProgram_handle_ivec4(RProgram_uniform(obj, name), data, num);
 }
 
 void RProgram_uniform_ivec3(oobj obj, const char *name, const ivec3 *data, int num)
 {
-    oi32 uniform = RProgram_uniform(obj, name);
-    glUniform3iv(uniform, num, (void *) data);
+    RProgram_handle_ivec3(RProgram_uniform(obj, name), data, num);
 }
 
 void RProgram_uniform_ivec2(oobj obj, const char *name, const ivec2 *data, int num)
 {
-    oi32 uniform = RProgram_uniform(obj, name);
-    glUniform2iv(uniform, num, (void *) data);
+    RProgram_handle_ivec2(RProgram_uniform(obj, name), data, num);
 }
 
 void RProgram_uniform_int(oobj obj, const char *name, const int *data, int num)
 {
-    oi32 uniform = RProgram_uniform(obj, name);
-    glUniform1iv(uniform, num, (void *) data);
+    RProgram_handle_int(RProgram_uniform(obj, name), data, num);
+}
+
+
+//
+// uniform handle wrapper
+//
+
+void RProgram_handle_tex(oi32 handle, int pos, ou32 tex)
+{
+    O_EXTERN
+    ou32 RTex__bound_gl(void);
+    ou32 bound = RTex__bound_gl();
+    assert((bound==0 || bound != tex) && "tex already bound as framebuffer!");
+
+    r_state_tex(pos, tex);
+    glUniform1i(handle, pos);
+}
+
+void RProgram_handle_mat4(oi32 handle, const mat4 *data, int num)
+{
+    glUniformMatrix4fv(handle, num, GL_FALSE, (void *) data);
+}
+
+void RProgram_handle_mat3(oi32 handle, const mat3 *data, int num)
+{
+    glUniformMatrix3fv(handle, num, GL_FALSE, (void *) data);
+}
+
+void RProgram_handle_mat2(oi32 handle, const mat2 *data, int num)
+{
+    glUniformMatrix2fv(handle, num, GL_FALSE, (void *) data);
+}
+
+void RProgram_handle_vec4(oi32 handle, const vec4 *data, int num)
+{
+    glUniform4fv(handle, num, (void *) data);
+}
+
+void RProgram_handle_vec3(oi32 handle, const vec3 *data, int num)
+{
+    glUniform3fv(handle, num, (void *) data);
+}
+
+void RProgram_handle_vec2(oi32 handle, const vec2 *data, int num)
+{
+    glUniform2fv(handle, num, (void *) data);
+}
+
+void RProgram_handle_float(oi32 handle, const float *data, int num)
+{
+    glUniform1fv(handle, num, (void *) data);
+}
+
+void RProgram_handle_ivec4(oi32 handle, const ivec4 *data, int num)
+{
+    glUniform4iv(handle, num, (void *) data);
+}
+
+void RProgram_handle_ivec3(oi32 handle, const ivec3 *data, int num)
+{
+    glUniform3iv(handle, num, (void *) data);
+}
+
+void RProgram_handle_ivec2(oi32 handle, const ivec2 *data, int num)
+{
+    glUniform2iv(handle, num, (void *) data);
+}
+
+void RProgram_handle_int(oi32 handle, const int *data, int num)
+{
+    glUniform1iv(handle, num, (void *) data);
 }
@@ -4,22 +4,30 @@
 #include "r/RBuffer.h"
 #include "r/RTex.h"
 #include "r/gl.h"
+#include "r/state.h"
 
 
+// last used state, to count the state changes
+static struct {
+    oobj program;
+    oobj buffer;
+    oobj tex;
+    bool blend;
+} L_last;
+
 O_STATIC
-void blend(bool on)
+void count_state(oobj program, oobj buffer, oobj tex, bool blend_on)
 {
-    if(!on) {
-        glDisable(GL_BLEND);
-        r_error_check("blend off");
-        return;
-    }
-
-    glEnable(GL_BLEND);
-    // adds alpha, can't get more transparency:
-    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
-
-    r_error_check("blend");
+    struct r_stats *stats = r_stats_frame();
+    stats->draw_calls++;
+    stats->state_changes += (program != L_last.program)
+                            + (buffer != L_last.buffer)
+                            + (tex != L_last.tex)
+                            + (blend_on != L_last.blend);
+    L_last.program = program;
+    L_last.buffer = buffer;
+    L_last.tex = tex;
+    L_last.blend = blend_on;
 }
 
 
@@ -62,13 +70,58 @@ void RShader_render_ex(oobj obj, oobj buffer, oobj tex, int opt_num_rendered, co
     RBuffer_use(buffer);
     RTex_use(tex, RProgram_num_draw_buffers(self->program));
 
-    blend(self->blend);
+    r_state_blend(self->blend);
+    count_state(self->program, buffer, tex, self->blend);
     opt_proj = o_or(opt_proj, RTex_proj(tex));
     
     self->v_render(self, self->program, o_min(opt_num_rendered, RBuffer_num(buffer)), opt_proj);
-    
-    RBuffer_use(NULL);
-    RProgram_use(NULL);
+
+    // program and buffer stay bound, see r/state.h
+}
+
+
+const struct RShader_handles *RShader_handles_get(struct RShader_handles_cache *cache, oobj program,
+                                                  const char *const *opt_extra_names)
+{
+    ou32 generation = RProgram_generation(program);
+    for (int i = 0; i < RShader_HANDLES_CACHE_SIZE; i++) {
+        if (generation && cache->entries[i].generation == generation) {
+            return &cache->entries[i];
+        }
+    }
+
+    struct RShader_handles *handles = &cache->entries[cache->next];
+    cache->next = (cache->next + 1) % RShader_HANDLES_CACHE_SIZE;
+    r_stats_frame()->shader_handles_resolved++;
+
+    handles->generation = generation;
+    handles->viewport_scale_double = RProgram_uniform(program, "u_c_viewport_scale_double");
+    handles->viewport_size_half = RProgram_uniform(program, "u_c_viewport_size_half");
+    handles->viewport_even_offset = RProgram_uniform(program, "u_c_viewport_even_offset");
+    handles->vp = RProgram_uniform(program, "u_vp");
+    handles->tex_scale = RProgram_uniform(program, "u_tex_scale");
+    handles->tex = RProgram_uniform(program, "u_tex");
+    osize extra_num = o_list_num(opt_extra_names);
+    assert(extra_num <= RShader_HANDLES_EXTRA_MAX && "too many extra uniform names");
+    for (int i = 0; i < RShader_HANDLES_EXTRA_MAX; i++) {
+        handles->extra[i] = i < extra_num ? RProgram_uniform(program, opt_extra_names[i]) : -1;
+    }
+    return handles;
+}
+
+void RShader_handles_set_common(const struct RShader_handles *handles, const struct r_proj *proj, oobj tex)
+{
+    float camera_viewport_scale_double = proj->scale * 2;
+    RProgram_handle_float(handles->viewport_scale_double, &camera_viewport_scale_double, 1);
+    RProgram_handle_vec2(handles->viewport_size_half, &proj->vpsh, 1);
+    RProgram_handle_vec2(handles->viewport_even_offset, &proj->viewport_even_offset, 1);
+
+    RProgram_handle_mat4(handles->vp, &proj->cam, 1);
+
+    vec2 tex_scale = RTex_get_tex_scale(tex);
+    RProgram_handle_vec2(handles->tex_scale, &tex_scale, 1);
+
+    RProgram_handle_tex(handles->tex, 0, RTex_tex(tex));
 }
 
 
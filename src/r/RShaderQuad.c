@@ -40,30 +40,18 @@ void RShaderQuad__v_render(oobj obj, oobj program, int num, const struct r_proj
     OObj_assert(obj, RShaderQuad);
     RShaderQuad *self = obj;
 
-    // common uniforms
-    float camera_viewport_scale_double = proj->scale * 2;
-    RProgram_uniform_float(program, "u_c_viewport_scale_double", &camera_viewport_scale_double, 1);
-    RProgram_uniform_vec2(program, "u_c_viewport_size_half", &proj->vpsh, 1);
-    RProgram_uniform_vec2(program, "u_c_viewport_even_offset", &proj->viewport_even_offset, 1);
+    static const char *const stuv_names[] = {"u_s", "u_t", "u_u", "u_v", NULL};
+    const struct RShader_handles *handles = RShader_handles_get(&self->handles, program, stuv_names);
 
+    // common and basic uniforms
+    RShader_handles_set_common(handles, proj, self->tex);
 
     // stuv
-    RProgram_uniform_vec4(program, "u_s", &self->stuv.col[0], 1);
-    RProgram_uniform_vec4(program, "u_t", &self->stuv.col[1], 1);
-    RProgram_uniform_vec4(program, "u_u", &self->stuv.col[2], 1);
-    RProgram_uniform_vec4(program, "u_v", &self->stuv.col[3], 1);
-
-    // basic uniforms:
-    RProgram_uniform_mat4(program, "u_vp", &proj->cam, 1);
-
-    vec2 tex_scale = RTex_get_tex_scale(self->tex);
-    RProgram_uniform_vec2(program, "u_tex_scale", &tex_scale, 1);
-
-    RProgram_uniform_tex(program, "u_tex", 0, RTex_tex(self->tex));
+    for (int i = 0; i < 4; i++) {
+        RProgram_handle_vec4(handles->extra[i], &self->stuv.col[i], 1);
+    }
 
     // draw call
     glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, num);
-
-    RProgram_uniform_tex_off(program, 0);
 }
 
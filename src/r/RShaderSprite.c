@@ -0,0 +1,45 @@
+#include "r/RShaderSprite.h"
+#include "o/OObj_builder.h"
+#include "r/RProgram.h"
+#include "r/program.h"
+#include "r/gl.h"
+
+
+RShaderSprite *RShaderSprite_init(oobj obj, oobj parent, oobj tex, bool move_tex)
+{
+    RShaderSprite *self = obj;
+    o_clear(self, sizeof *self, 1);
+
+    RShader_init(obj, parent, r_program_Sprite(), RShaderSprite__v_render);
+    OObj_id_set(self, RShaderSprite_ID);
+
+    self->tex = tex;
+    if (tex && move_tex) {
+        o_move(tex, self);
+    }
+
+    self->color = vec4_(1);
+
+    return self;
+}
+
+//
+// virtual implementations:
+//
+
+void RShaderSprite__v_render(oobj obj, oobj program, int num, const struct r_proj *proj)
+{
+    OObj_assert(obj, RShaderSprite);
+    RShaderSprite *self = obj;
+
+    static const char *const color_names[] = {"u_color", NULL};
+    const struct RShader_handles *handles = RShader_handles_get(&self->handles, program, color_names);
+
+    // common and basic uniforms
+    RShader_handles_set_common(handles, proj, self->tex);
+
+    RProgram_handle_vec4(handles->extra[0], &self->color, 1);
+
+    // draw call
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, num);
+}
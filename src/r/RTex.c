@@ -17,6 +17,8 @@
 #include "r/RShaderQuadMerge.h"
 #include "r/RObj.h"
 #include "r/tex.h"
+#include "r/state.h"
+#include "r/texpool.h"
 
 #define O_LOG_LIB "r"
 #include "o/log.h"
@@ -101,6 +103,7 @@ void update_fbo(RTex *self, int requested_num_draw_buffers) {
         self->fbo = o_new0(self, struct RTex_fbo, 1);
         self->fbo->proj = r_proj_new(RTex_size_int(self), vec2_(-1), true);
         glGenFramebuffers(1, &self->fbo->gl_fbo);
+        r_stats_frame()->gl_allocations++;
     }
 
     ou32 attachment1 = 0;
@@ -109,11 +112,11 @@ void update_fbo(RTex *self, int requested_num_draw_buffers) {
         attachment1 = attached_tex->gl_tex;
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, self->fbo->gl_fbo);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, self->gl_tex, 0);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, attachment1, 0);
+    r_state_draw_framebuffer(self->fbo->gl_fbo);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, self->gl_tex, 0);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, attachment1, 0);
 
-    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    GLenum status = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
     switch (status) {
         case GL_FRAMEBUFFER_COMPLETE:
             break;
@@ -179,6 +182,38 @@ ou32 RTex__bound_gl(void) {
     return RTex_tex(RTex_L.bound_tex);
 }
 
+// protected, used by RTexLoader.c
+// swaps the gpu storage (gl tex, size, format) of both textures, keeping their wrap and filter modes
+O_EXTERN
+void RTex__swap_storage(oobj obj, oobj other) {
+    OObj_assert(obj, RTex);
+    OObj_assert(other, RTex);
+    RTex *a = obj;
+    RTex *b = other;
+
+    // the fbos are bound to the old gl textures
+    RTex_use_done(a);
+    RTex_use_done(b);
+
+    ou32 gl_tex = a->gl_tex;
+    ivec2 size = a->size;
+    ivec4 viewport = a->viewport;
+    enum r_format format = a->format;
+    a->gl_tex = b->gl_tex;
+    a->size = b->size;
+    a->viewport = b->viewport;
+    a->format = b->format;
+    b->gl_tex = gl_tex;
+    b->size = size;
+    b->viewport = viewport;
+    b->format = format;
+
+    RTex_wrap_set(a, a->wrap_mode);
+    RTex_filter_set(a, a->filter_mode);
+    RTex_wrap_set(b, b->wrap_mode);
+    RTex_filter_set(b, b->filter_mode);
+}
+
 //
 // public
 //
@@ -213,7 +248,8 @@ RTex *RTex_init_ex(oobj obj, oobj parent, const void *opt_buffer, int cols, int
     r_error_check("tex allocation start...");
 
     glGenTextures(1, &self->gl_tex);
-    glBindTexture(GL_TEXTURE_2D, self->gl_tex);
+    r_stats_frame()->gl_allocations++;
+    r_state_tex(0, self->gl_tex);
 
     // default may be that new rows are not byte aligned, so 1 for byte aligned if format is R_FORMAT_R_8
     glPixelStorei(GL_UNPACK_ALIGNMENT, self->format == R_FORMAT_R_8 ? 1 : 4);
@@ -223,8 +259,6 @@ RTex *RTex_init_ex(oobj obj, oobj parent, const void *opt_buffer, int cols, int
                  0, format_channels(format), format_size(format), opt_buffer);
     r_error_check("tex allocation");
 
-    glBindTexture(GL_TEXTURE_2D, 0);
-
     RTex_wrap_set(self, RTex_wrap_CLAMP);
     RTex_filter_set(self, RTex_filter_NEAREST);
 
@@ -315,6 +349,63 @@ RTex *RTex_new_kernel_gauss(oobj parent, int cols, int rows, vec2 sigma, float n
     return self;
 }
 
+void RTex_kernel_gauss_weights(float *out_weights, int n, float sigma) {
+    n = o_max(n, 1);
+    sigma = sigma > 0 ? sigma : ((n - 1) * 0.5 - 1) * 0.3 + 0.8;
+    float scale = -0.5 / (sigma * sigma);
+    int center = n / 2;
+    for (int i = 0; i < n; i++) {
+        float x = i - center;
+        out_weights[i] = m_exp(scale * x * x);
+    }
+    float sum = vecn_sum(out_weights, n);
+    vecn_scale(out_weights, out_weights, 1.0f / sum, n);
+}
+
+RTex *RTex_new_kernel_sep(oobj parent, const float *weights, int n, bool vertical) {
+    n = o_max(n, 1);
+    int taps = (n + 1) / 2;
+    vec4 *buffer = o_new0(parent, vec4, taps);
+
+    // merges weights i and i+1 into a tap between both pixels, sampled linear
+    for (int t = 0; t < taps; t++) {
+        int i = t * 2;
+        float offset = (float) (i - n / 2);
+        float w_a = weights[i];
+        float w_b = i + 1 < n ? weights[i + 1] : 0.0f;
+        float w = w_a + w_b;
+        buffer[t].r = w;
+        buffer[t].g = w > 0.0f ? offset + w_b / w : offset;
+    }
+
+    int cols = vertical ? 1 : taps;
+    int rows = vertical ? taps : 1;
+    RTex *self = RTex_new_ex(parent, buffer, cols, rows,
+                             R_FORMAT_RGBA_32F, R_FORMAT_RGBA_32F);
+    o_free(parent, buffer);
+    return self;
+}
+
+RTex *RTex_new_kernel_sep_box(oobj parent, int n, bool vertical) {
+    n = o_max(n, 1);
+    float *weights = o_new(parent, float, n);
+    for (int i = 0; i < n; i++) {
+        weights[i] = 1.0f / (float) n;
+    }
+    RTex *self = RTex_new_kernel_sep(parent, weights, n, vertical);
+    o_free(parent, weights);
+    return self;
+}
+
+RTex *RTex_new_kernel_sep_gauss(oobj parent, int n, float sigma, bool vertical) {
+    n = o_max(n, 1);
+    float *weights = o_new(parent, float, n);
+    RTex_kernel_gauss_weights(weights, n, sigma);
+    RTex *self = RTex_new_kernel_sep(parent, weights, n, vertical);
+    o_free(parent, weights);
+    return self;
+}
+
 //
 // virtual implementations:
 //
@@ -325,6 +416,7 @@ void RTex__v_del(oobj obj) {
 
     // deletes fbo, if available
     RTex_use_done(self);
+    r_state_tex_deleted(self->gl_tex);
     // safe for 0
     glDeleteTextures(1, &self->gl_tex);
 
@@ -379,7 +471,7 @@ void RTex_wrap_set(oobj obj, enum RTex_wrap_modes mode) {
     OObj_assert(obj, RTex);
     RTex *self = obj;
     self->wrap_mode = mode;
-    glBindTexture(GL_TEXTURE_2D, self->gl_tex);
+    r_state_tex(0, self->gl_tex);
     if (self->wrap_mode == RTex_wrap_CLAMP) {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -387,14 +479,13 @@ void RTex_wrap_set(oobj obj, enum RTex_wrap_modes mode) {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void RTex_filter_set(oobj obj, enum RTex_filter_modes mode) {
     OObj_assert(obj, RTex);
     RTex *self = obj;
     self->filter_mode = mode;
-    glBindTexture(GL_TEXTURE_2D, self->gl_tex);
+    r_state_tex(0, self->gl_tex);
     if (self->filter_mode == RTex_filter_LINEAR) {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -402,7 +493,6 @@ void RTex_filter_set(oobj obj, enum RTex_filter_modes mode) {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 oobj RTex_camera(oobj obj) {
@@ -426,7 +516,7 @@ void RTex_use(oobj obj, int requested_draw_buffers) {
         if (!RTex_L.bound_valid || RTex_L.bound_tex != NULL) {
             RTex_L.bound_valid = true;
             RTex_L.bound_tex = NULL;
-            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, RTex_L.back_fbo);
+            r_state_draw_framebuffer(RTex_L.back_fbo);
             
             // gl deprecated using plain GL_BACK, but gles does not support GL_BACK_LEFT
 #ifdef MIA_OPTION_GLES
@@ -435,7 +525,7 @@ void RTex_use(oobj obj, int requested_draw_buffers) {
             GLenum back_buffer = GL_BACK_LEFT;
 #endif
             glDrawBuffers(1, (GLenum[]){back_buffer});
-            glViewport(m_4(RTex_L.back_viewport));
+            r_state_viewport(RTex_L.back_viewport);
             r_error_check("use back");
         }
         return;
@@ -448,8 +538,8 @@ void RTex_use(oobj obj, int requested_draw_buffers) {
         RTex_L.bound_valid = true;
         RTex_L.bound_tex = obj;
         update_fbo(self, requested_draw_buffers); // Ensure the framebuffer is created
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, self->fbo->gl_fbo);
-        glViewport(m_4(self->viewport));
+        r_state_draw_framebuffer(self->fbo->gl_fbo);
+        r_state_viewport(self->viewport);
         r_error_check("use tex");
     }
 }
@@ -461,6 +551,11 @@ void RTex_use_done(oobj obj) {
     if (!self->fbo) {
         return;
     }
+    if (RTex_L.bound_tex == self) {
+        // gl falls back to the default framebuffer
+        RTex_L.bound_valid = false;
+    }
+    r_state_framebuffer_deleted(self->fbo->gl_fbo);
     glDeleteFramebuffers(1, &self->fbo->gl_fbo);
     o_free(self, self->fbo);
     self->fbo = NULL;
@@ -471,29 +566,41 @@ void RTex_get_ex(oobj obj, void *out_buffer, enum r_format format) {
     RTex *self = obj;
     update_fbo(self, 1); // Ensure the framebuffer is created
 
-    glBindTexture(GL_TEXTURE_2D, self->gl_tex);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, self->fbo->gl_fbo);
+    r_state_read_framebuffer(self->fbo->gl_fbo);
     // default may be that new rows are not byte aligned, so 1 for byte aligned if format is R_FORMAT_R_8
     glPixelStorei(GL_PACK_ALIGNMENT, self->format == R_FORMAT_R_8 ? 1 : 4);
     glReadBuffer(GL_COLOR_ATTACHMENT0);
     glReadPixels(0, 0, self->size.x, self->size.y,
                  format_channels(format), format_size(format),
                  out_buffer);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
-    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void RTex_set_ex(oobj obj, const void *buffer, enum r_format format) {
     OObj_assert(obj, RTex);
     RTex *self = obj;
-    glBindTexture(GL_TEXTURE_2D, self->gl_tex);
+    r_state_tex(0, self->gl_tex);
     // default may be that new rows are not byte aligned, so 1 for byte aligned if format is R_FORMAT_R_8
     glPixelStorei(GL_UNPACK_ALIGNMENT, self->format == R_FORMAT_R_8 ? 1 : 4);
     glTexSubImage2D(GL_TEXTURE_2D, 0,
                     0, 0, self->size.x, self->size.y,
                     format_channels(format), format_size(format),
                     buffer);
-    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void RTex_set_rows_ex(oobj obj, const void *buffer, int row, int rows, enum r_format format) {
+    OObj_assert(obj, RTex);
+    RTex *self = obj;
+    assert(row >= 0 && rows >= 0 && row + rows <= self->size.y);
+    if (rows <= 0) {
+        return;
+    }
+    r_state_tex(0, self->gl_tex);
+    // default may be that new rows are not byte aligned, so 1 for byte aligned if format is R_FORMAT_R_8
+    glPixelStorei(GL_UNPACK_ALIGNMENT, self->format == R_FORMAT_R_8 ? 1 : 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0,
+                    0, row, self->size.x, rows,
+                    format_channels(format), format_size(format),
+                    buffer);
 }
 
 bool RTex_write_file(oobj obj, const char *file) {
@@ -610,7 +717,7 @@ void RTex_blit_back_ex(oobj obj, ivec4 viewport_obj, ivec4 viewport_back, enum R
         viewport_back = RTex_L.back_viewport;
     }
 
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, RTex_L.back_fbo);
+    r_state_read_framebuffer(RTex_L.back_fbo);
 
     glBlitFramebuffer(viewport_back.x, viewport_back.y,
                       viewport_back.x + viewport_back.v2, viewport_back.y + viewport_back.v3,
@@ -656,7 +763,7 @@ RTex *RTex_border(oobj obj, ivec4 lrbt, vec4 color, enum r_format format) {
     size.x += lrbt.v0 + lrbt.v1;
     size.y += lrbt.v2 + lrbt.v3;
 
-    RTex *res = RTex_new_ex(obj, NULL, m_2(size), format, format);
+    RTex *res = r_texpool_new(obj, ivec2_cast_float(size.v), format);
     RTex_clear_full(res, color);
     RTex_blit(res, obj, 0, 0);
     return res;
@@ -754,16 +861,94 @@ void RTex_conv_into(oobj obj, oobj kernel, ivec2 offset, oobj into) {
     RTex_quads(into, RTex_L.s_quad_kernel, &q, 1);
 }
 
+// renders a linear sampled quad of tex into the full obj
+O_STATIC
+void blit_linear(RTex *obj, RTex *tex) {
+    enum RTex_filter_modes filter = tex->filter_mode;
+    RTex_filter_set(tex, RTex_filter_LINEAR);
+    RTex_blit_ex(obj, tex, r_quad_new(m_2(RTex_size(obj))).pose, r_quad_new(m_2(RTex_size(tex))).uv);
+    RTex_filter_set(tex, filter);
+}
+
+// a single pass of a separable convolution, kernel from RTex_new_kernel_sep
+O_STATIC
+void sep_pass(RTex *obj, oobj kernel, oobj into) {
+    struct r_quad q = r_quad_new(m_2(RTex_size(obj)));
+
+    // the taps merge two texels with a linear fetch
+    enum RTex_filter_modes filter = obj->filter_mode;
+    RTex_filter_set(obj, RTex_filter_LINEAR);
+
+    RShaderQuad_tex_set(RTex_L.s_quad_kernel, obj, false);
+    RShader_blend_set(RTex_L.s_quad_kernel, false);
+    RShaderQuadKernel_kernel_set(RTex_L.s_quad_kernel, kernel, false);
+    RShaderQuadKernel_offset_set(RTex_L.s_quad_kernel, ivec2_(0));
+    RShaderQuadKernel_color_set(RTex_L.s_quad_kernel, R_WHITE);
+    RShader_program_set(RTex_L.s_quad_kernel, r_program_QuadKernel_sep());
+    RTex_quads(into, RTex_L.s_quad_kernel, &q, 1);
+
+    RTex_filter_set(obj, filter);
+}
+
+// into may be NULL for the back buffer
+O_STATIC
+enum r_format target_format(oobj into) {
+    return into ? RTex_format(into) : R_FORMAT_RGBA_8;
+}
+
+O_STATIC
+void sep_into(oobj obj, oobj kernel_h, oobj kernel_v, oobj into) {
+    OObj_assert(obj, RTex);
+    RTex *tmp = r_texpool_acquire(RTex_size_int(obj), target_format(into));
+    sep_pass(obj, kernel_h, tmp);
+    sep_pass(tmp, kernel_v, into);
+    r_texpool_release(tmp);
+}
+
 void RTex_blur_into(oobj obj, ivec2 size, oobj into) {
-    oobj kernel = RTex_new_kernel(obj, m_2(size), 1.0f, false, 1.0f);
-    RTex_conv_into(obj, kernel, ivec2_(0), into);
-    o_del(kernel);
+    sep_into(obj,
+             r_tex_kernel_sep_box_cached(size.x, false),
+             r_tex_kernel_sep_box_cached(size.y, true),
+             into);
+}
+
+void RTex_blur_large_into(oobj obj, ivec2 size, oobj into) {
+    OObj_assert(obj, RTex);
+    RTex *level = obj;
+    RTex *levels[32];
+    int num_levels = 0;
+
+    // downsample, each pixel is a linear fetch between 2x2 pixels of the level above
+    while ((size.x > R_BLUR_LARGE_KERNEL || size.y > R_BLUR_LARGE_KERNEL)
+           && level->size.x >= 2 && level->size.y >= 2 && num_levels < 32) {
+        RTex *next = r_texpool_acquire(ivec2_(level->size.x / 2, level->size.y / 2), target_format(into));
+        blit_linear(next, level);
+        levels[num_levels++] = next;
+        level = next;
+        size.x = o_max(1, size.x / 2);
+        size.y = o_max(1, size.y / 2);
+    }
+
+    if (num_levels == 0) {
+        RTex_blur_into(obj, size, into);
+        return;
+    }
+
+    RTex *blurred = r_texpool_acquire(level->size, target_format(into));
+    RTex_blur_into(level, size, blurred);
+    blit_linear(into, blurred);
+
+    r_texpool_release(blurred);
+    for (int i = 0; i < num_levels; i++) {
+        r_texpool_release(levels[i]);
+    }
 }
 
 void RTex_gauss_into(oobj obj, ivec2 size, vec2 sigma, oobj into) {
-    oobj kernel = RTex_new_kernel_gauss(obj, m_2(size), sigma, 1.0f);
-    RTex_conv_into(obj, kernel, ivec2_(0), into);
-    o_del(kernel);
+    sep_into(obj,
+             r_tex_kernel_sep_gauss_cached(size.x, sigma.x, false),
+             r_tex_kernel_sep_gauss_cached(size.y, sigma.y, true),
+             into);
 }
 
 void RTex_dilate_into(oobj obj, oobj kernel, ivec2 offset, vec4 mask, vec4 color, oobj into) {
@@ -798,9 +983,8 @@ void RTex_contour_into(oobj obj, oobj kernel, ivec2 offset, vec4 mask, vec4 colo
 }
 
 void RTex_outline_into(oobj obj, ivec2 size, ivec2 offset, vec4 mask, vec4 color, oobj into) {
-    oobj kernel = RTex_new_kernel(obj, m_2(size), 1.0f, true, -1);
+    oobj kernel = r_tex_kernel_cached(size, 1.0f, true, -1);
     RTex_contour_into(obj, kernel, offset, mask, color, into);
-    o_del(kernel);
 }
 
 RTex *RTex_collage(const oobj *srcs, int n, int cols, ivec2 margin, vec4 bg_color, enum r_format format) {
@@ -818,7 +1002,7 @@ RTex *RTex_collage(const oobj *srcs, int n, int cols, ivec2 margin, vec4 bg_colo
 
     ivec2 full_size = ivec2_scale_v(grid_size, ivec2_(cols, rows));
 
-    RTex *res = RTex_new_ex(srcs[0], NULL, m_2(full_size), format, format);
+    RTex *res = r_texpool_new(srcs[0], full_size, format);
     RTex_clear_full(res, bg_color);
 
     for (int i = 0; i < n; i++) {
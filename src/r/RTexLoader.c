@@ -0,0 +1,296 @@
+#include "r/RTexLoader.h"
+#include "o/OObj_builder.h"
+#include "o/OFuture.h"
+#include "o/OPtr.h"
+#include "o/parallel.h"
+#include "o/str.h"
+#include "o/timer.h"
+#include "r/RTex.h"
+
+#define O_LOG_LIB "r"
+#include "o/log.h"
+
+
+// protected in RTex.c
+O_EXTERN
+void RTex__swap_storage(oobj obj, oobj other);
+
+
+struct RTexLoader_job {
+    // container for all job resources
+    oobj o;
+
+    // OPtr to the target (RTex or custom with img_fn)
+    oobj target_ptr;
+    RTexLoader__img_fn opt_img_fn;
+
+    char *file;
+
+    // only used by the decoding thread, until decoded
+    oobj decode_o;
+    struct o_img img;
+    oobj future;
+    bool decoded;
+
+    // RTex in the full size, swapped into the target once uploaded
+    oobj staging;
+    int rows_uploaded;
+};
+
+
+static struct {
+    RTexLoader *default_loader;
+} RTexLoader_L;
+
+
+O_STATIC
+void decode(struct RTexLoader_job *job)
+{
+    job->img = o_img_new_file(job->decode_o, job->file);
+}
+
+#ifdef MIA_OPTION_THREAD
+O_STATIC
+void decode_future(oobj future)
+{
+    decode(o_user(future));
+}
+#endif
+
+O_STATIC
+void job_del(RTexLoader *self, osize idx)
+{
+    struct RTexLoader_job *job = *OArray_at(self->jobs, idx, struct RTexLoader_job *);
+#ifdef MIA_OPTION_THREAD
+    if (job->future) {
+        OFuture_wait(job->future);
+    }
+#endif
+    OArray_pop_at(self->jobs, idx, NULL);
+    // job is allocated on job->o
+    o_del(job->o);
+    self->batch_done++;
+}
+
+// returns true if the decoded image is available
+O_STATIC
+bool job_decoded(struct RTexLoader_job *job, bool *inout_allow_sync_decode)
+{
+    if (job->decoded) {
+        return true;
+    }
+#ifdef MIA_OPTION_THREAD
+    if (!OFuture_finished(job->future)) {
+        return false;
+    }
+#else
+    if (!*inout_allow_sync_decode) {
+        return false;
+    }
+    *inout_allow_sync_decode = false;
+    decode(job);
+#endif
+    job->decoded = true;
+    return true;
+}
+
+O_STATIC
+void add_job(RTexLoader *self, oobj target, const char *file, RTexLoader__img_fn opt_img_fn)
+{
+    if (OArray_num(self->jobs) == 0) {
+        self->batch_jobs = self->batch_done = 0;
+    }
+    self->batch_jobs++;
+
+    oobj o = OObj_new(self);
+    struct RTexLoader_job *job = o_new0(o, *job, 1);
+    job->o = o;
+    job->target_ptr = OPtr_new(o, target);
+    job->opt_img_fn = opt_img_fn;
+    job->file = o_str_clone(o, file);
+    job->decode_o = OObj_new(o);
+    OArray_push(self->jobs, &job);
+
+#ifdef MIA_OPTION_THREAD
+    job->future = OFuture_new_run(o, decode_future, self->opt_threadpool, job);
+#endif
+}
+
+
+//
+// public
+//
+
+RTexLoader *RTexLoader_init(oobj obj, oobj parent, oobj opt_threadpool)
+{
+    RTexLoader *self = obj;
+    o_clear(self, sizeof *self, 1);
+
+    OObj_init(self, parent);
+    OObj_id_set(self, RTexLoader_ID);
+
+    self->opt_threadpool = opt_threadpool;
+    self->budget_bytes = RTexLoader_BUDGET_BYTES_DEFAULT;
+    self->budget_ms = RTexLoader_BUDGET_MS_DEFAULT;
+    self->jobs = OArray_new_dyn(self, NULL, sizeof(struct RTexLoader_job *), 0, 8);
+
+    // vfuncs
+    self->super.v_del = RTexLoader__v_del;
+
+    return self;
+}
+
+RTexLoader *RTexLoader_default(void)
+{
+    if (!RTexLoader_L.default_loader) {
+        RTexLoader_L.default_loader = RTexLoader_new(r_root(), o_parallel_pool());
+        OObj_name_set(RTexLoader_L.default_loader, "RTexLoader_default");
+    }
+    return RTexLoader_L.default_loader;
+}
+
+// protected, used by r_frame_begin
+O_EXTERN
+void RTexLoader__update_default(void)
+{
+    if (RTexLoader_L.default_loader) {
+        RTexLoader_update(RTexLoader_L.default_loader);
+    }
+}
+
+//
+// virtual implementations:
+//
+
+void RTexLoader__v_del(oobj obj)
+{
+    OObj_assert(obj, RTexLoader);
+    RTexLoader *self = obj;
+
+    while (OArray_num(self->jobs) > 0) {
+        job_del(self, OArray_num(self->jobs) - 1);
+    }
+    if (RTexLoader_L.default_loader == self) {
+        RTexLoader_L.default_loader = NULL;
+    }
+
+    OObj__v_del(self);
+}
+
+
+//
+// object functions:
+//
+
+void RTexLoader_load(oobj obj, oobj tex, const char *file)
+{
+    OObj_assert(obj, RTexLoader);
+    OObj_assert(tex, RTex);
+    add_job(obj, tex, file, NULL);
+}
+
+void RTexLoader_load_img(oobj obj, oobj target, const char *file, RTexLoader__img_fn fn)
+{
+    OObj_assert(obj, RTexLoader);
+    assert(fn);
+    add_job(obj, target, file, fn);
+}
+
+void RTexLoader_update(oobj obj)
+{
+    OObj_assert(obj, RTexLoader);
+    RTexLoader *self = obj;
+
+    ou64 start = o_timer();
+    osize bytes = 0;
+    bool allow_sync_decode = true;
+
+    osize idx = 0;
+    while (idx < OArray_num(self->jobs)) {
+        if ((self->budget_bytes > 0 && bytes >= self->budget_bytes)
+            || (self->budget_ms > 0 && o_timer_elapsed_millis(start) >= self->budget_ms)) {
+            break;
+        }
+
+        struct RTexLoader_job *job = *OArray_at(self->jobs, idx, struct RTexLoader_job *);
+        oobj target = OPtr_get(job->target_ptr).o;
+        if (!target) {
+            // cancelled
+            job_del(self, idx);
+            continue;
+        }
+        if (!job_decoded(job, &allow_sync_decode)) {
+            idx++;
+            continue;
+        }
+
+        if (!job->img.rgba_data) {
+            o_log_warn_s("RTexLoader", "failed to load image file: %s", job->file);
+            job_del(self, idx);
+            continue;
+        }
+
+        if (job->opt_img_fn) {
+            job->opt_img_fn(target, &job->img);
+            job_del(self, idx);
+            continue;
+        }
+
+        // staged upload, row by row
+        if (!job->staging) {
+            job->staging = RTex_new(job->o, NULL, job->img.cols, job->img.rows);
+        }
+        osize row_bytes = (osize) job->img.cols * 4;
+        int rows = job->img.rows - job->rows_uploaded;
+        if (self->budget_bytes > 0) {
+            rows = (int) o_clamp((self->budget_bytes - bytes) / row_bytes, 1, rows);
+        }
+        RTex_set_rows_ex(job->staging, job->img.rgba_data + job->rows_uploaded * row_bytes,
+                         job->rows_uploaded, rows, R_FORMAT_RGBA_8);
+        job->rows_uploaded += rows;
+        bytes += rows * row_bytes;
+        r_stats_frame()->tex_uploaded_bytes += rows * row_bytes;
+
+        if (job->rows_uploaded >= job->img.rows) {
+            RTex__swap_storage(target, job->staging);
+            job_del(self, idx);
+            continue;
+        }
+        // budget reached, continue in the next frame
+        break;
+    }
+}
+
+float RTexLoader_progress(oobj obj)
+{
+    OObj_assert(obj, RTexLoader);
+    RTexLoader *self = obj;
+    if (self->batch_jobs <= 0) {
+        return 1.0f;
+    }
+    // decoding is the first half of a job, uploading the second one
+    float progress = (float) self->batch_done;
+    for (osize i = 0; i < OArray_num(self->jobs); i++) {
+        struct RTexLoader_job *job = *OArray_at(self->jobs, i, struct RTexLoader_job *);
+        if (job->decoded) {
+            progress += 0.5f;
+            if (job->img.rows > 0) {
+                progress += 0.5f * (float) job->rows_uploaded / (float) job->img.rows;
+            }
+        }
+    }
+    return o_clamp(progress / (float) self->batch_jobs, 0.0f, 1.0f);
+}
+
+
+//
+// RTex and co functions
+//
+
+RTex *RTex_new_file_async(oobj parent, const char *file)
+{
+    bvec4 transparent = {0};
+    RTex *self = RTex_new(parent, &transparent, 1, 1);
+    RTexLoader_load(RTexLoader_default(), self, file);
+    return self;
+}
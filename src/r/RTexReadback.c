@@ -0,0 +1,283 @@
+#include "r/RTexReadback.h"
+#include "o/OObj_builder.h"
+#include "o/OFuture.h"
+#include "o/img.h"
+#include "o/str.h"
+#include "r/RTex.h"
+#include "r/gl.h"
+
+#define O_LOG_LIB "r"
+#include "o/log.h"
+
+// glClientWaitSync timeout for a blocking wait, in ns
+#define WAIT_TIMEOUT_NS 1000000000
+
+
+static struct {
+    // intrusive list of the pending readbacks, polled in r_frame_begin
+    RTexReadback *pending;
+} RTexReadback_L;
+
+
+O_STATIC
+void pending_add(RTexReadback *self)
+{
+    self->prev = NULL;
+    self->next = RTexReadback_L.pending;
+    if (RTexReadback_L.pending) {
+        RTexReadback_L.pending->prev = self;
+    }
+    RTexReadback_L.pending = self;
+}
+
+O_STATIC
+void pending_remove(RTexReadback *self)
+{
+    RTexReadback *prev = self->prev;
+    RTexReadback *next = self->next;
+    if (prev) {
+        prev->next = next;
+    } else if (RTexReadback_L.pending == self) {
+        RTexReadback_L.pending = next;
+    }
+    if (next) {
+        next->prev = prev;
+    }
+    self->prev = self->next = NULL;
+}
+
+O_STATIC
+void delete_gl(RTexReadback *self)
+{
+    if (self->gl_sync) {
+        glDeleteSync(self->gl_sync);
+        self->gl_sync = NULL;
+    }
+    // safe to pass 0
+    glDeleteBuffers(1, &self->gl_pbo);
+    self->gl_pbo = 0;
+}
+
+O_STATIC
+void map_data(RTexReadback *self)
+{
+    osize size = RTexReadback_data_size(self);
+    self->data = o_alloc0(self, 1, o_max(1, size));
+    if (self->gl_pbo && size > 0) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, self->gl_pbo);
+#ifdef MIA_PLATFORM_EMSCRIPTEN
+        // webgl2 does not support mapping buffers
+        glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, size, self->data);
+#else
+        void *mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+        if (mapped) {
+            memcpy(self->data, mapped, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        } else {
+            o_log_error_s("RTexReadback", "failed to map the pixel buffer");
+        }
+#endif
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        r_error_check("RTexReadback map");
+    }
+    delete_gl(self);
+}
+
+O_STATIC
+void encode(RTexReadback *self)
+{
+    struct o_img img = {self->data, self->size.x, self->size.y, NULL};
+    // only read by the render thread after the encoding has finished
+    self->saved = o_img_write_file(img, self->opt_file);
+}
+
+#ifdef MIA_OPTION_THREAD
+O_STATIC
+void encode_future(oobj future)
+{
+    encode(o_user(future));
+}
+#endif
+
+O_STATIC
+void start_encoding(RTexReadback *self)
+{
+    self->state = RTexReadback_ENCODING;
+#ifdef MIA_OPTION_THREAD
+    self->future = OFuture_new_run(self, encode_future, self->opt_threadpool, self);
+#else
+    encode(self);
+#endif
+}
+
+O_STATIC
+void finish(RTexReadback *self)
+{
+    pending_remove(self);
+    self->state = RTexReadback_FINISHED;
+    // may delete self
+    if (self->opt_callback) {
+        self->opt_callback(self);
+    }
+}
+
+//
+// public
+//
+
+RTexReadback *RTexReadback_init(oobj obj, oobj parent, oobj tex, enum r_format format, OObj__event_fn opt_callback)
+{
+    OObj_assert(tex, RTex);
+    RTexReadback *self = obj;
+    o_clear(self, sizeof *self, 1);
+
+    OObj_init(self, parent);
+    OObj_id_set(self, RTexReadback_ID);
+
+    self->state = RTexReadback_PENDING;
+    self->size = RTex_size_int(tex);
+    self->format = format;
+    self->opt_callback = opt_callback;
+
+    osize size = RTexReadback_data_size(self);
+    if (size > 0) {
+        glGenBuffers(1, &self->gl_pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, self->gl_pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+
+        // with a bound pack buffer, the out_buffer is an offset into that buffer
+        RTex_get_ex(tex, NULL, format);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        self->gl_sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        // flush, so the fence is guaranteed to signal while polling with a zero timeout
+        glFlush();
+        r_error_check("RTexReadback");
+    }
+
+    pending_add(self);
+
+    // vfuncs
+    self->super.v_del = RTexReadback__v_del;
+
+    return self;
+}
+
+//
+// virtual implementations:
+//
+
+void RTexReadback__v_del(oobj obj)
+{
+    OObj_assert(obj, RTexReadback);
+    RTexReadback *self = obj;
+
+    pending_remove(self);
+#ifdef MIA_OPTION_THREAD
+    if (self->future) {
+        // the encoding works on self->data
+        OFuture_wait(self->future);
+    }
+#endif
+    delete_gl(self);
+
+    OObj__v_del(self);
+}
+
+//
+// object functions:
+//
+
+bool RTexReadback_poll(oobj obj)
+{
+    OObj_assert(obj, RTexReadback);
+    RTexReadback *self = obj;
+
+    if (self->state == RTexReadback_PENDING) {
+        if (self->gl_sync) {
+            GLenum res = glClientWaitSync(self->gl_sync, 0, 0);
+            if (res == GL_TIMEOUT_EXPIRED) {
+                return false;
+            }
+            if (res == GL_WAIT_FAILED) {
+                // mapping the buffer synchronizes anyway
+                o_log_warn_s("RTexReadback", "fence sync failed");
+            }
+        }
+        map_data(self);
+        if (self->opt_file) {
+            start_encoding(self);
+        }
+    }
+
+    if (self->state == RTexReadback_ENCODING) {
+#ifdef MIA_OPTION_THREAD
+        if (!OFuture_finished(self->future)) {
+            return false;
+        }
+#endif
+        finish(self);
+        return true;
+    }
+
+    if (self->state == RTexReadback_PENDING) {
+        finish(self);
+    }
+    return true;
+}
+
+void RTexReadback_wait(oobj obj)
+{
+    OObj_assert(obj, RTexReadback);
+    RTexReadback *self = obj;
+
+    if (self->state == RTexReadback_PENDING && self->gl_sync) {
+        GLenum res;
+        do {
+            res = glClientWaitSync(self->gl_sync, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT_NS);
+        } while (res == GL_TIMEOUT_EXPIRED);
+    }
+
+    if (RTexReadback_poll(self)) {
+        // callback may have deleted self
+        return;
+    }
+#ifdef MIA_OPTION_THREAD
+    assert(self->state == RTexReadback_ENCODING);
+    OFuture_wait(self->future);
+    RTexReadback_poll(self);
+#endif
+}
+
+void RTexReadback_poll_all(void)
+{
+    RTexReadback *it = RTexReadback_L.pending;
+    while (it) {
+        RTexReadback *next = it->next;
+        if (RTexReadback_poll(it)) {
+            // the callback may have deleted or created other readbacks, so restart
+            it = RTexReadback_L.pending;
+            continue;
+        }
+        it = next;
+    }
+}
+
+
+//
+// RTex functions
+//
+
+oobj RTex_get_async(oobj obj, oobj parent, enum r_format format, OObj__event_fn opt_callback)
+{
+    return RTexReadback_new(parent, obj, format, opt_callback);
+}
+
+oobj RTex_write_file_async(oobj obj, oobj parent, const char *file, oobj opt_threadpool, OObj__event_fn opt_callback)
+{
+    RTexReadback *self = RTexReadback_new(parent, obj, R_FORMAT_RGBA_8, opt_callback);
+    // the readback is first polled later on, so its safe to set the encoding here
+    self->opt_file = o_str_clone(self, file);
+    self->opt_threadpool = opt_threadpool;
+    return self;
+}
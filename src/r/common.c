@@ -1,6 +1,8 @@
 #include "r/common.h"
 #include "r/proj.h"
 #include "r/gl.h"
+#include "r/state.h"
+#include "r/RTexReadback.h"
 #include "o/OObjRoot.h"
 #include "o/ODelcallback.h"
 #include "m/vec/ivec2.h"
@@ -15,6 +17,8 @@ static struct {
     ivec2 back_size;
     struct r_proj back_proj;
     ivec2 max_tex_size;
+    struct r_stats stats_frame;
+    struct r_stats stats_last;
 } common_L;
 
 
@@ -100,10 +104,47 @@ void r_frame_begin(int back_cols, int back_rows)
 {
     common_L.back_size = ivec2_(back_cols, back_rows);
 
+    common_L.stats_last = common_L.stats_frame;
+    o_clear(&common_L.stats_frame, sizeof common_L.stats_frame, 1);
+
+    // the gl state may have been changed outside between the frames
+    r_state_invalidate();
+
+    // recycles the render targets of the last frame
+    void r_texpool__frame_begin(void);
+    r_texpool__frame_begin();
+
     glDisable(GL_DEPTH_TEST);
     glDisable(GL_SCISSOR_TEST);
     
     r_error_check("frame begin");
+
+    // callbacks of finished readbacks
+    RTexReadback_poll_all();
+
+    // staged uploads of the background loader
+    void RTexLoader__update_default(void);
+    RTexLoader__update_default();
+}
+
+struct r_stats *r_stats_frame(void)
+{
+    return &common_L.stats_frame;
+}
+
+struct r_stats r_stats_last(void)
+{
+    return common_L.stats_last;
+}
+
+void r_stats_log(struct r_stats stats)
+{
+    o_log_info_s("r_stats", "draw calls: %i, state changes: %i, gl calls: %i issued, %i skipped, "
+                            "handles resolved: %i, buffer uploads: %.1f KiB, tex uploads: %.1f KiB, "
+                            "gl allocations: %i",
+                 stats.draw_calls, stats.state_changes, stats.gl_calls, stats.gl_calls_skipped,
+                 stats.shader_handles_resolved, stats.buffer_uploaded_bytes / 1024.0,
+                 stats.tex_uploaded_bytes / 1024.0, stats.gl_allocations);
 }
 
 bool r_error_check_call(const char *file, int line, const char *tag) {
@@ -46,6 +46,8 @@ r_program_DECL(QuadDab, 2)
 r_program_DECL(QuadKernel_contour, 1)
 r_program_DECL(QuadKernel_conv, 1)
 r_program_DECL(QuadKernel_contour_inv, 1)
+r_program_DECL(QuadKernel_sep, 1)
 r_program_DECL(QuadMerge, 1)
 r_program_DECL(Rect, 1)
 r_program_DECL(Rect_color, 1)
+r_program_DECL(Sprite, 1)
@@ -7,12 +7,14 @@
 #include "RBuffer.c"
 #include "RBufferQuad.c"
 #include "RBufferRect.c"
+#include "RBufferSprite.c"
 #include "RCam.c"
 #include "rect.c"
 #include "RObj.c"
 #include "RObjGroup.c"
 #include "RObjQuad.c"
 #include "RObjRect.c"
+#include "RObjSprite.c"
 #include "RObjText.c"
 #include "RProgram.c"
 #include "RShader.c"
@@ -22,8 +24,14 @@
 #include "RShaderQuadKernel.c"
 #include "RShaderQuadMerge.c"
 #include "RShaderRect.c"
+#include "RShaderSprite.c"
 #include "RTex.c"
+#include "RTexLoader.c"
+#include "RTexReadback.c"
+#include "sprite.c"
+#include "state.c"
 #include "tex.c"
+#include "texpool.c"
 
 
 
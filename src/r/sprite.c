@@ -0,0 +1,151 @@
+#include "r/sprite.h"
+#include "m/flt.h"
+#include "m/byte.h"
+
+
+ou16 r_sprite_half_pack(float f)
+{
+    union {
+        float f;
+        ou32 u;
+    } v = {f};
+    ou16 sign = (ou16) ((v.u >> 16) & 0x8000);
+    ou32 exp_bits = (v.u >> 23) & 0xff;
+    ou32 mant = v.u & 0x7fffff;
+
+    // inf or nan
+    if (exp_bits == 0xff) {
+        return sign | 0x7c00 | (mant ? 0x200 : 0);
+    }
+
+    oi32 exp = (oi32) exp_bits - 127 + 15;
+
+    // overflow -> inf
+    if (exp >= 31) {
+        return sign | 0x7c00;
+    }
+
+    // subnormal or zero
+    if (exp <= 0) {
+        if (exp < -10) {
+            return sign;
+        }
+        mant |= 0x800000;
+        int shift = 14 - exp;
+        ou32 half = mant >> shift;
+        ou32 rem = mant & ((1u << shift) - 1);
+        ou32 mid = 1u << (shift - 1);
+        if (rem > mid || (rem == mid && (half & 1))) {
+            half++;
+        }
+        return sign | (ou16) half;
+    }
+
+    ou32 half = ((ou32) exp << 10) | (mant >> 13);
+    ou32 rem = mant & 0x1fff;
+    // a carry into the exponent is fine, rounds up to the next exponent or inf
+    if (rem > 0x1000 || (rem == 0x1000 && (half & 1))) {
+        half++;
+    }
+    return sign | (ou16) half;
+}
+
+float r_sprite_half_unpack(ou16 h)
+{
+    ou32 sign = (ou32) (h & 0x8000) << 16;
+    ou32 exp = (h >> 10) & 0x1f;
+    ou32 mant = h & 0x3ff;
+    union {
+        ou32 u;
+        float f;
+    } v;
+
+    if (exp == 0) {
+        if (mant == 0) {
+            v.u = sign;
+        } else {
+            // subnormal, normalize it
+            exp = 127 - 15 + 1;
+            while (!(mant & 0x400)) {
+                mant <<= 1;
+                exp--;
+            }
+            mant &= 0x3ff;
+            v.u = sign | (exp << 23) | (mant << 13);
+        }
+    } else if (exp == 31) {
+        v.u = sign | 0x7f800000 | (mant << 13);
+    } else {
+        v.u = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+    }
+    return v.f;
+}
+
+struct r_sprite r_sprite_new(int tex_cols, int tex_rows)
+{
+    // minimum 1 to create a valid size
+    tex_cols = m_max(1, tex_cols);
+    tex_rows = m_max(1, tex_rows);
+
+    struct r_sprite s;
+    o_clear(&s, sizeof s, 1);
+    // centered at (0, 0) with a size equal to the tex size, the uv maps the whole tex
+    r_sprite_size_set(&s, (float) tex_cols, (float) tex_rows);
+    r_sprite_uv_size_set(&s, (float) tex_cols, (float) tex_rows);
+    s.color = bvec4_(255);
+    return s;
+}
+
+struct r_quad r_sprite_to_quad(struct r_sprite sprite)
+{
+    float w = r_sprite_half_unpack(sprite.size[0]);
+    float h = r_sprite_half_unpack(sprite.size[1]);
+    float angle = r_sprite_half_unpack(sprite.angle);
+    float c = m_cos(angle);
+    float s = m_sin(angle);
+
+    struct r_quad q;
+    // mat4 has column major order, see u/pose.h
+    q.pose = mat4_new(
+            c * w / 2, s * w / 2, 0, 0,
+            -s * h / 2, c * h / 2, 0, 0,
+            0, 0, 1, 0,
+            sprite.pos.x, sprite.pos.y, 0, 1
+    );
+    q.uv = mat4_new(
+            r_sprite_half_unpack(sprite.uv_size[0]) / 2, 0, 0, 0,
+            0, r_sprite_half_unpack(sprite.uv_size[1]) / 2, 0, 0,
+            0, 0, 1, 0,
+            sprite.uv_pos.x, sprite.uv_pos.y, 0, 1
+    );
+    for (int i = 0; i < 4; i++) {
+        q.s.v[i] = (float) sprite.color.v[i] / 255.0f;
+    }
+    q.t = vec4_(0);
+    q.u = vec4_(0);
+    q.v = vec4_(0);
+    return q;
+}
+
+struct r_sprite r_sprite_from_quad(const struct r_quad *quad)
+{
+    const mat4 *p = &quad->pose;
+    float w = 2 * m_sqrt(p->m00 * p->m00 + p->m01 * p->m01);
+    float h = 2 * m_sqrt(p->m10 * p->m10 + p->m11 * p->m11);
+    // a mirrored pose is kept as negative height
+    if (p->m00 * p->m11 - p->m01 * p->m10 < 0) {
+        h = -h;
+    }
+
+    struct r_sprite s;
+    o_clear(&s, sizeof s, 1);
+    s.pos = vec2_(p->m30, p->m31);
+    r_sprite_size_set(&s, w, h);
+    r_sprite_angle_set(&s, m_atan2(p->m01, p->m00));
+    s.uv_pos = vec2_(quad->uv.m30, quad->uv.m31);
+    r_sprite_uv_size_set(&s, quad->uv.m00 * 2, quad->uv.m11 * 2);
+    for (int i = 0; i < 4; i++) {
+        s.color.v[i] = (obyte) m_clamp(quad->s.v[i] * 255.0f + 0.5f, 0, 255);
+    }
+    return s;
+}
@@ -0,0 +1,197 @@
+#include "r/state.h"
+#include "r/gl.h"
+#include "m/vec/ivec4.h"
+
+#define O_LOG_LIB "r"
+#include "o/log.h"
+
+
+// cached values are only valid, if the matching valid flag is set
+static struct {
+    ou32 program;
+    ou32 vao;
+    ou32 array_buffer;
+    int active_unit;
+    ou32 tex[R_STATE_TEX_UNITS];
+    bool blend;
+    ou32 draw_fbo;
+    ou32 read_fbo;
+    ivec4 viewport;
+
+    struct {
+        bool program, vao, array_buffer, active_unit, blend, draw_fbo, read_fbo, viewport;
+        bool tex[R_STATE_TEX_UNITS];
+    } valid;
+} state_L;
+
+
+O_STATIC
+void count(bool issued)
+{
+    struct r_stats *stats = r_stats_frame();
+    if (issued) {
+        stats->gl_calls++;
+    } else {
+        stats->gl_calls_skipped++;
+    }
+}
+
+//
+// public
+//
+
+void r_state_invalidate(void)
+{
+    o_clear(&state_L.valid, sizeof state_L.valid, 1);
+}
+
+void r_state_program(ou32 gl_program)
+{
+    if (state_L.valid.program && state_L.program == gl_program) {
+        count(false);
+        return;
+    }
+    state_L.valid.program = true;
+    state_L.program = gl_program;
+    glUseProgram(gl_program);
+    count(true);
+}
+
+void r_state_vao(ou32 gl_vao)
+{
+    if (state_L.valid.vao && state_L.vao == gl_vao) {
+        count(false);
+        return;
+    }
+    state_L.valid.vao = true;
+    state_L.vao = gl_vao;
+    glBindVertexArray(gl_vao);
+    count(true);
+}
+
+void r_state_array_buffer(ou32 gl_vbo)
+{
+    if (state_L.valid.array_buffer && state_L.array_buffer == gl_vbo) {
+        count(false);
+        return;
+    }
+    state_L.valid.array_buffer = true;
+    state_L.array_buffer = gl_vbo;
+    glBindBuffer(GL_ARRAY_BUFFER, gl_vbo);
+    count(true);
+}
+
+void r_state_tex(int unit, ou32 gl_tex)
+{
+    assert(unit >= 0 && unit < R_STATE_TEX_UNITS);
+    if (state_L.valid.tex[unit] && state_L.tex[unit] == gl_tex) {
+        count(false);
+        return;
+    }
+    if (!state_L.valid.active_unit || state_L.active_unit != unit) {
+        state_L.valid.active_unit = true;
+        state_L.active_unit = unit;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        count(true);
+    }
+    state_L.valid.tex[unit] = true;
+    state_L.tex[unit] = gl_tex;
+    glBindTexture(GL_TEXTURE_2D, gl_tex);
+    count(true);
+    r_stats_frame()->state_changes++;
+}
+
+void r_state_blend(bool on)
+{
+    if (state_L.valid.blend && state_L.blend == on) {
+        count(false);
+        return;
+    }
+    state_L.valid.blend = true;
+    state_L.blend = on;
+    if (!on) {
+        glDisable(GL_BLEND);
+        count(true);
+        r_error_check("blend off");
+        return;
+    }
+    glEnable(GL_BLEND);
+    // adds alpha, can't get more transparency:
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
+    count(true);
+    count(true);
+    r_error_check("blend");
+}
+
+void r_state_draw_framebuffer(ou32 gl_fbo)
+{
+    if (state_L.valid.draw_fbo && state_L.draw_fbo == gl_fbo) {
+        count(false);
+        return;
+    }
+    state_L.valid.draw_fbo = true;
+    state_L.draw_fbo = gl_fbo;
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gl_fbo);
+    count(true);
+}
+
+void r_state_read_framebuffer(ou32 gl_fbo)
+{
+    if (state_L.valid.read_fbo && state_L.read_fbo == gl_fbo) {
+        count(false);
+        return;
+    }
+    state_L.valid.read_fbo = true;
+    state_L.read_fbo = gl_fbo;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, gl_fbo);
+    count(true);
+}
+
+void r_state_viewport(ivec4 viewport)
+{
+    if (state_L.valid.viewport && ivec4_equals_v(state_L.viewport, viewport)) {
+        count(false);
+        return;
+    }
+    state_L.valid.viewport = true;
+    state_L.viewport = viewport;
+    glViewport(viewport.x, viewport.y, viewport.v2, viewport.v3);
+    count(true);
+}
+
+
+void r_state_program_deleted(ou32 gl_program)
+{
+    if (state_L.program == gl_program) {
+        state_L.valid.program = false;
+    }
+}
+
+void r_state_buffer_deleted(ou32 gl_vao, ou32 gl_vbo)
+{
+    if (state_L.vao == gl_vao) {
+        state_L.valid.vao = false;
+    }
+    if (state_L.array_buffer == gl_vbo) {
+        state_L.valid.array_buffer = false;
+    }
+}
+
+void r_state_tex_deleted(ou32 gl_tex)
+{
+    for (int i = 0; i < R_STATE_TEX_UNITS; i++) {
+        if (state_L.tex[i] == gl_tex) {
+            state_L.valid.tex[i] = false;
+        }
+    }
+}
+
+void r_state_framebuffer_deleted(ou32 gl_fbo)
+{
+    if (state_L.draw_fbo == gl_fbo) {
+        state_L.valid.draw_fbo = false;
+    }
+    if (state_L.read_fbo == gl_fbo) {
+        state_L.valid.read_fbo = false;
+    }
+}
@@ -2,8 +2,34 @@
 #include "r/RTex.h"
 #include "o/ODelcallback.h"
 
+enum kernel_kind {
+    KERNEL_BOX,
+    KERNEL_GAUSS,
+    KERNEL_SEP_BOX,
+    KERNEL_SEP_GAUSS
+};
+
+struct kernel_key {
+    enum kernel_kind kind;
+    ivec2 size;
+    float set;
+    bool plus;
+    vec2 sigma;
+    float normalize;
+};
+
+struct kernel_entry {
+    struct kernel_key key;
+    RTex *tex;
+    oobj guard;
+    ou64 last_use;
+};
+
 static struct {
     oobj o;
+
+    struct kernel_entry kernels[R_TEX_KERNEL_CACHE_SIZE];
+    ou64 kernel_uses;
 } tex_L;
 
 O_STATIC
@@ -108,6 +134,102 @@ oobj r_tex_kernel_gauss9(bool normalized)
     return lazy;
 }
 
+O_STATIC
+bool kernel_key_equals(struct kernel_key a, struct kernel_key b)
+{
+    return a.kind == b.kind
+           && a.size.x == b.size.x && a.size.y == b.size.y
+           && a.set == b.set
+           && a.plus == b.plus
+           && a.sigma.x == b.sigma.x && a.sigma.y == b.sigma.y
+           && a.normalize == b.normalize;
+}
+
+O_STATIC
+oobj kernel_cached(struct kernel_key key)
+{
+    tex_L.kernel_uses++;
+
+    // search, or take an empty or the least recently used entry
+    struct kernel_entry *lru = &tex_L.kernels[0];
+    for (int i = 0; i < R_TEX_KERNEL_CACHE_SIZE; i++) {
+        struct kernel_entry *e = &tex_L.kernels[i];
+        if (e->tex && kernel_key_equals(e->key, key)) {
+            e->last_use = tex_L.kernel_uses;
+            return e->tex;
+        }
+        if (lru->tex && (!e->tex || e->last_use < lru->last_use)) {
+            lru = e;
+        }
+    }
+
+    if (lru->tex) {
+        o_del(lru->guard);
+        o_del(lru->tex);
+    }
+    lru->key = key;
+    lru->last_use = tex_L.kernel_uses;
+    // separable kernels are n x 1 or 1 x n
+    int n = o_max(key.size.x, key.size.y);
+    bool vertical = key.size.y > 1;
+    switch (key.kind) {
+        case KERNEL_GAUSS:
+            lru->tex = RTex_new_kernel_gauss(tex_L_o(), m_2(key.size), key.sigma, key.normalize);
+            break;
+        case KERNEL_SEP_BOX:
+            lru->tex = RTex_new_kernel_sep_box(tex_L_o(), n, vertical);
+            break;
+        case KERNEL_SEP_GAUSS:
+            lru->tex = RTex_new_kernel_sep_gauss(tex_L_o(), n, key.sigma.x, vertical);
+            break;
+        default:
+            lru->tex = RTex_new_kernel(tex_L_o(), m_2(key.size), key.set, key.plus, key.normalize);
+            break;
+    }
+    lru->guard = ODelcallback_new_assert(lru->tex, "r_tex_kernel_cached", "deleted!");
+    return lru->tex;
+}
+
+oobj r_tex_kernel_cached(ivec2 size, float set, bool plus, float normalize)
+{
+    struct kernel_key key = {0};
+    key.kind = KERNEL_BOX;
+    key.size = size;
+    key.set = set;
+    key.plus = plus;
+    key.normalize = normalize;
+    return kernel_cached(key);
+}
+
+oobj r_tex_kernel_gauss_cached(ivec2 size, vec2 sigma, float normalize)
+{
+    struct kernel_key key = {0};
+    key.kind = KERNEL_GAUSS;
+    key.size = size;
+    key.sigma = sigma;
+    key.normalize = normalize;
+    return kernel_cached(key);
+}
+
+oobj r_tex_kernel_sep_box_cached(int n, bool vertical)
+{
+    n = o_max(n, 1);
+    struct kernel_key key = {0};
+    key.kind = KERNEL_SEP_BOX;
+    key.size = vertical ? ivec2_(1, n) : ivec2_(n, 1);
+    return kernel_cached(key);
+}
+
+oobj r_tex_kernel_sep_gauss_cached(int n, float sigma, bool vertical)
+{
+    n = o_max(n, 1);
+    struct kernel_key key = {0};
+    key.kind = KERNEL_SEP_GAUSS;
+    key.size = vertical ? ivec2_(1, n) : ivec2_(n, 1);
+    key.sigma.x = sigma;
+    return kernel_cached(key);
+}
+
 //
 // files
 //
@@ -0,0 +1,163 @@
+#include "r/texpool.h"
+#include "r/RTex.h"
+#include "o/OArray.h"
+#include "o/ODelcallback.h"
+
+#define O_LOG_LIB "r"
+#include "o/log.h"
+
+
+struct entry {
+    RTex *tex;
+    // asserts that no one else deletes the tex
+    oobj guard;
+    bool in_use;
+    int last_frame;
+};
+
+static struct {
+    oobj o;
+    // OArray of struct entry
+    OArray *entries;
+    int frame;
+    int transient;
+} texpool_L;
+
+
+O_STATIC
+OArray *entries(void)
+{
+    if (!texpool_L.o) {
+        texpool_L.o = OObj_new(r_root());
+        OObj_name_set(texpool_L.o, "r_texpool");
+        texpool_L.entries = OArray_new_dyn(texpool_L.o, NULL, sizeof(struct entry), 0, 16);
+    }
+    return texpool_L.entries;
+}
+
+O_STATIC
+void entry_del(osize idx)
+{
+    struct entry *e = OArray_at(texpool_L.entries, idx, struct entry);
+    o_del(e->guard);
+    o_del(e->tex);
+    OArray_pop_at(texpool_L.entries, idx, NULL);
+}
+
+
+// protected, used by r_frame_begin
+O_EXTERN
+void r_texpool__frame_begin(void)
+{
+    if (!texpool_L.o) {
+        return;
+    }
+    texpool_L.frame++;
+    osize idx = 0;
+    while (idx < OArray_num(texpool_L.entries)) {
+        struct entry *e = OArray_at(texpool_L.entries, idx, struct entry);
+        e->in_use = false;
+        if (texpool_L.frame - e->last_frame > R_TEXPOOL_KEEP_FRAMES) {
+            entry_del(idx);
+            continue;
+        }
+        idx++;
+    }
+}
+
+//
+// public
+//
+
+oobj r_texpool_acquire(ivec2 size, enum r_format format)
+{
+    OArray *list = entries();
+    for (osize i = 0; i < OArray_num(list); i++) {
+        struct entry *e = OArray_at(list, i, struct entry);
+        if (!e->in_use && e->tex->format == format
+            && e->tex->size.x == size.x && e->tex->size.y == size.y) {
+            e->in_use = true;
+            e->last_frame = texpool_L.frame;
+            RTex_viewport_set_full(e->tex);
+            return e->tex;
+        }
+    }
+
+    struct entry e = {0};
+    e.tex = RTex_new_ex(texpool_L.o, NULL, m_2(size), format, format);
+    e.guard = ODelcallback_new_assert(e.tex, "r_texpool", "deleted!");
+    e.in_use = true;
+    e.last_frame = texpool_L.frame;
+    OArray_push(list, &e);
+    return e.tex;
+}
+
+void r_texpool_release(oobj tex)
+{
+    if (!tex || !texpool_L.o) {
+        return;
+    }
+    for (osize i = 0; i < OArray_num(texpool_L.entries); i++) {
+        struct entry *e = OArray_at(texpool_L.entries, i, struct entry);
+        if (e->tex == tex) {
+            e->in_use = false;
+            return;
+        }
+    }
+    o_log_warn_s(__func__, "tex is not owned by the pool");
+}
+
+bool r_texpool_owns(oobj tex)
+{
+    if (!tex || !texpool_L.o) {
+        return false;
+    }
+    for (osize i = 0; i < OArray_num(texpool_L.entries); i++) {
+        if (OArray_at(texpool_L.entries, i, struct entry)->tex == tex) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void r_texpool_transient_begin(void)
+{
+    texpool_L.transient++;
+}
+
+void r_texpool_transient_end(void)
+{
+    assert(texpool_L.transient > 0 && "transient_end without a begin");
+    texpool_L.transient--;
+}
+
+oobj r_texpool_new(oobj parent, ivec2 size, enum r_format format)
+{
+    if (texpool_L.transient > 0) {
+        return r_texpool_acquire(size, format);
+    }
+    return RTex_new_ex(parent, NULL, m_2(size), format, format);
+}
+
+void r_texpool_clear(void)
+{
+    if (!texpool_L.o) {
+        return;
+    }
+    osize idx = 0;
+    while (idx < OArray_num(texpool_L.entries)) {
+        if (!OArray_at(texpool_L.entries, idx, struct entry)->in_use) {
+            entry_del(idx);
+            continue;
+        }
+        idx++;
+    }
+}
+
+int r_texpool_num(void)
+{
+    if (!texpool_L.o) {
+        return 0;
+    }
+    return (int) OArray_num(texpool_L.entries);
+}
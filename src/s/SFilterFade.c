@@ -1,6 +1,6 @@
 #include "s/SFilterFade.h"
 #include "o/OObj_builder.h"
-#include "m/vec/vecn.h"
+#include "s/mix.h"
 #include "s/STrack.h"
 
 
@@ -26,14 +26,18 @@ void SFilterFade__v_apply(oobj obj, oobj track, float *data, int channels, osize
 {
     OObj_assert(obj, SFilterFade);
     SFilterFade *self = obj;
-    for(osize i=0; i<len; i++) {
-        float *i_data = &data[i * channels];
-        osize i_time = time_ticks + i;
-        float t = (float) (i_time - self->time_a) / (float) (self->time_b - self->time_a);
-        t = m_clamp(t, 0.0f, 1.0f);
-        float amp = m_mix(self->amp_a, self->amp_b, t);
-        vecn_scale(i_data, i_data, amp, channels);
+
+    // amp_a before time_a, a linear ramp until time_b and amp_b afterwards
+    osize ramp_begin = o_clamp(self->time_a - time_ticks, 0, len);
+    osize ramp_end = o_clamp(self->time_b - time_ticks, 0, len);
+
+    s_mix_gain(data, self->amp_a, ramp_begin * channels);
+    if(ramp_end > ramp_begin) {
+        float step = (self->amp_b - self->amp_a) / (float) (self->time_b - self->time_a);
+        float amp = self->amp_a + step * (float) (time_ticks + ramp_begin - self->time_a);
+        s_mix_gain_ramp(data + ramp_begin * channels, amp, step, channels, ramp_end - ramp_begin);
     }
+    s_mix_gain(data + ramp_end * channels, self->amp_b, (len - ramp_end) * channels);
 }
 
 //
@@ -0,0 +1,343 @@
+#include "s/SResampler.h"
+#include "o/OObj_builder.h"
+#include "m/sca/dbl.h"
+#include "simd.h"
+
+#define O_LOG_LIB "s"
+#include "o/log.h"
+
+
+// kaiser window shape, ~80 dB stopband
+#define KAISER_BETA 8.0
+
+// cutoff relative to the lower nyquist frequency, the transition band lies below it
+#define SINC_CUTOFF 0.92
+
+
+// n is a multiple of 4
+O_STATIC
+float dot4(const float *restrict a, const float *restrict b, int n)
+{
+#if defined(SIMD_SSE)
+    __m128 acc = _mm_setzero_ps();
+    for (int i = 0; i < n; i += 4) {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    __m128 shuf = _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(acc, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+#elif defined(SIMD_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (int i = 0; i < n; i += 4) {
+        acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    float32x2_t sums = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(sums, sums), 0);
+#else
+    // 4 lanes, so that the compiler may vectorize without reassociating
+    float acc[4] = {0};
+    for (int i = 0; i < n; i += 4) {
+        for (int l = 0; l < 4; l++) {
+            acc[l] += a[i + l] * b[i + l];
+        }
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+}
+
+O_STATIC
+double bessel_i0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// windowed sinc, x in src ticks
+O_STATIC
+double kernel(double x, double cutoff, double half)
+{
+    if (md_abs(x) >= half) {
+        return 0.0;
+    }
+    double s = x == 0.0 ? 1.0 : md_sin(md_PI * cutoff * x) / (md_PI * cutoff * x);
+    double r = x / half;
+    return cutoff * s * bessel_i0(KAISER_BETA * md_sqrt(1.0 - r * r)) / bessel_i0(KAISER_BETA);
+}
+
+O_STATIC
+void table_create(SResampler *self)
+{
+    if (self->table) {
+        o_free(self, self->table);
+        o_free(self, self->coef);
+        self->table = self->coef = NULL;
+    }
+
+    if (self->dst_spec.freq == self->src_spec.freq) {
+        // just channel mixing
+        self->taps = 1;
+        self->lead = 0;
+        return;
+    }
+    if (self->quality == SResampler_LINEAR) {
+        self->taps = 2;
+        self->lead = 0;
+        return;
+    }
+
+    // lowpass below the lower nyquist frequency, which widens the filter for downsampling
+    double cutoff = SINC_CUTOFF * o_min(1.0, (double) self->dst_spec.freq / self->src_spec.freq);
+    double half = SResampler_SINC_ZEROS / cutoff;
+    int half_ticks = (int) md_ceil(half);
+    self->lead = half_ticks - 1;
+    self->taps = o_align_size(2 * half_ticks, 4);
+
+    self->table = o_new(self, float, (SResampler_SINC_PHASES + 1) * self->taps);
+    self->coef = o_new(self, float, self->taps);
+    for (int ph = 0; ph <= SResampler_SINC_PHASES; ph++) {
+        float *row = self->table + ph * self->taps;
+        double f = (double) ph / SResampler_SINC_PHASES;
+        double sum = 0;
+        for (int k = 0; k < self->taps; k++) {
+            double c = kernel(k - self->lead - f, cutoff, half);
+            row[k] = (float) c;
+            sum += c;
+        }
+        // unity gain for each phase
+        for (int k = 0; k < self->taps; k++) {
+            row[k] = (float) (row[k] / sum);
+        }
+    }
+}
+
+O_STATIC
+void work_ensure(SResampler *self, osize src_len)
+{
+    if (self->work && src_len <= self->work_ticks) {
+        return;
+    }
+    int channels = self->dst_spec.channels;
+    osize old_stride = self->taps + self->work_ticks;
+    osize stride = self->taps + src_len;
+    float *work = o_new0(self, float, stride * channels);
+    if (self->work) {
+        // keep the history
+        for (int c = 0; c < channels; c++) {
+            o_memcpy(work + c * stride, self->work + c * old_stride, sizeof(float), self->taps);
+        }
+        o_free(self, self->work);
+    }
+    self->work = work;
+    self->work_ticks = src_len;
+}
+
+// appends the src ticks after the history, mixed into the dst channels (planar)
+O_STATIC
+void work_append(SResampler *self, const float *restrict src, osize src_len)
+{
+    int dst_ch = self->dst_spec.channels;
+    int src_ch = self->src_spec.channels;
+    osize stride = self->taps + self->work_ticks;
+
+    for (int c = 0; c < dst_ch; c++) {
+        float *restrict dst = self->work + c * stride + self->taps;
+        if (src_ch == dst_ch || src_ch == 1 || src_ch < dst_ch) {
+            int k = c % src_ch;
+            for (osize j = 0; j < src_len; j++) {
+                dst[j] = src[j * src_ch + k];
+            }
+            continue;
+        }
+        // downmix, the average of all channels k with k%dst_ch==c
+        int num = 0;
+        for (int k = c; k < src_ch; k += dst_ch) {
+            num++;
+        }
+        float amp = 1.0f / (float) num;
+        for (osize j = 0; j < src_len; j++) {
+            float sum = 0;
+            for (int k = c; k < src_ch; k += dst_ch) {
+                sum += src[j * src_ch + k];
+            }
+            dst[j] = sum * amp;
+        }
+    }
+}
+
+// src position of a dst tick, as integer tick and fraction
+O_STATIC
+osize src_pos(SResampler *self, osize dst_time, float *opt_out_fract)
+{
+    osize num = dst_time * self->src_spec.freq;
+    if (opt_out_fract) {
+        *opt_out_fract = (float) (num % self->dst_spec.freq) / (float) self->dst_spec.freq;
+    }
+    return num / self->dst_spec.freq;
+}
+
+
+//
+// public
+//
+
+SResampler *SResampler_init(oobj obj, oobj parent, struct s_audio_spec dst_spec, struct s_audio_spec src_spec,
+                            enum SResampler_quality quality)
+{
+    SResampler *self = obj;
+    o_clear(self, sizeof *self, 1);
+
+    OObj_init(obj, parent);
+    OObj_id_set(self, SResampler_ID);
+
+    self->dst_spec = dst_spec;
+    self->src_spec = src_spec;
+    self->quality = quality;
+    table_create(self);
+    SResampler_reset(self);
+
+    return self;
+}
+
+
+//
+// object functions
+//
+
+void SResampler_setup(oobj obj, struct s_audio_spec dst_spec, struct s_audio_spec src_spec,
+                      enum SResampler_quality quality)
+{
+    OObj_assert(obj, SResampler);
+    SResampler *self = obj;
+    if (s_audio_spec_equals(self->dst_spec, dst_spec) && s_audio_spec_equals(self->src_spec, src_spec)
+        && self->quality == quality) {
+        return;
+    }
+    self->dst_spec = dst_spec;
+    self->src_spec = src_spec;
+    self->quality = quality;
+    table_create(self);
+
+    // layout changed
+    if (self->work) {
+        o_free(self, self->work);
+        self->work = NULL;
+        self->work_ticks = 0;
+    }
+    SResampler_reset(self);
+}
+
+void SResampler_reset(oobj obj)
+{
+    OObj_assert(obj, SResampler);
+    SResampler *self = obj;
+    self->dst_next = -1;
+    self->src_next = 0;
+    if (self->work) {
+        o_clear(self->work, sizeof(float), (self->taps + self->work_ticks) * self->dst_spec.channels);
+    }
+}
+
+void SResampler_reserve(oobj obj, osize dst_len)
+{
+    OObj_assert(obj, SResampler);
+    SResampler *self = obj;
+    work_ensure(self, SResampler_src_ticks_max(self, dst_len));
+}
+
+osize SResampler_src_ticks_max(oobj obj, osize dst_len)
+{
+    OObj_assert(obj, SResampler);
+    SResampler *self = obj;
+    return dst_len * self->src_spec.freq / self->dst_spec.freq + self->taps + 1;
+}
+
+osize SResampler_src_ticks(oobj obj, osize dst_len, osize dst_time, osize *out_src_time)
+{
+    OObj_assert(obj, SResampler);
+    SResampler *self = obj;
+    assert(dst_time >= 0);
+
+    osize first = src_pos(self, dst_time, NULL);
+    osize last = src_pos(self, dst_time + o_max(dst_len, 1) - 1, NULL);
+    osize start = self->src_next;
+    if (dst_time != self->dst_next) {
+        // not consecutive, restart at the first tick of the filter
+        start = o_max(0, first - self->lead);
+    }
+    *out_src_time = start;
+    return o_max(0, last - self->lead + self->taps - start);
+}
+
+void SResampler_run(oobj obj, float *out_dst, osize dst_len, osize dst_time, const float *src, osize src_len)
+{
+    OObj_assert(obj, SResampler);
+    SResampler *self = obj;
+    if (dst_len <= 0) {
+        return;
+    }
+
+    osize src_time;
+    osize needed = SResampler_src_ticks(self, dst_len, dst_time, &src_time);
+    assert(needed == src_len && "src span must match SResampler_src_ticks");
+    (void) needed;
+
+    if (dst_time != self->dst_next) {
+        SResampler_reset(self);
+    }
+
+    work_ensure(self, src_len);
+    work_append(self, src, src_len);
+
+    int channels = self->dst_spec.channels;
+    int taps = self->taps;
+    osize stride = taps + self->work_ticks;
+    // src tick of work[0]
+    osize base = src_time - taps;
+
+    for (osize u = 0; u < dst_len; u++) {
+        float f;
+        osize i = src_pos(self, dst_time + u, &f);
+        osize o = i - self->lead - base;
+        assert(o >= 0 && o + taps <= taps + src_len);
+        const float *w = self->work + o;
+        float *out = out_dst + u * channels;
+
+        if (taps == 1) {
+            for (int c = 0; c < channels; c++) {
+                out[c] = w[c * stride];
+            }
+        } else if (!self->table) {
+            for (int c = 0; c < channels; c++) {
+                const float *wc = w + c * stride;
+                out[c] = wc[0] + (wc[1] - wc[0]) * f;
+            }
+        } else {
+            float phase = f * SResampler_SINC_PHASES;
+            int ph = (int) phase;
+            float t = phase - (float) ph;
+            const float *restrict row_a = self->table + ph * taps;
+            const float *restrict row_b = row_a + taps;
+            float *restrict coef = self->coef;
+            for (int k = 0; k < taps; k++) {
+                coef[k] = row_a[k] + (row_b[k] - row_a[k]) * t;
+            }
+            for (int c = 0; c < channels; c++) {
+                out[c] = dot4(w + c * stride, coef, taps);
+            }
+        }
+    }
+
+    // keep the last taps ticks as history for the next consecutive span
+    for (int c = 0; c < channels; c++) {
+        float *wc = self->work + c * stride;
+        o_memmove(wc, wc + src_len, sizeof(float), taps);
+    }
+    self->src_next = src_time + src_len;
+    self->dst_next = dst_time + dst_len;
+}
@@ -2,8 +2,9 @@
 #include "o/OObj_builder.h"
 #include "o/OArray.h"
 #include "o/OJoin.h"
-#include "o/OWeakjoin.h"
+#include <SDL2/SDL_atomic.h>
 
+#include "s/mix.h"
 #include "s/wav.h"
 #include "s/SFilter.h"
 
@@ -11,12 +12,313 @@
 #include "o/log.h"
 
 
-// protected
+// ring buffer size for commands and collected objects, a power of two
+#define QUEUE_SIZE 64
+
+// preallocated number of played tracks, a full drained queue fits in
+#define PLAYED_CAPACITY QUEUE_SIZE
+
+enum cmd_type {
+    CMD_PLAY,
+    CMD_REMOVE,
+    CMD_AMP,
+    CMD_PRIORITY,
+    CMD_RESET
+};
+
+struct cmd {
+    enum cmd_type type;
+    // CMD_PLAY, start_ticks is relative to the time_ticks of the draining retr
+    struct STrack__played played;
+    // CMD_REMOVE, CMD_AMP, CMD_PRIORITY
+    osize handle;
+    float amp;
+    int priority;
+};
+
+struct STrack__queue {
+    // producers -> retr'ieving thread
+    struct cmd cmds[QUEUE_SIZE];
+    SDL_atomic_t cmds_read, cmds_write;
+
+    // retr'ieving thread -> STrack_collect, holds and SFilter's to delete
+    struct collect {
+        oobj del;
+        // handle of the played hold, 0 for an SFilter
+        osize handle;
+    } collect[QUEUE_SIZE];
+    SDL_atomic_t collect_read, collect_write;
+
+    // serializes the producers, never locked by the retr'ieving thread
+    oobj producer;
+
+    // OArray of osize handles that are played, producer side
+    oobj live;
+
+    // parent of the holds
+    oobj holds;
+
+    // last given handle
+    osize played_idx;
+
+    // number of holds on this track of all STrack's that are playing it
+    SDL_atomic_t held;
+
+    // spec_key of the playing spec that STrack_play_ex already reserved for, 0 if none
+    SDL_atomic_t reserved;
+};
+
+
+//
+// lock free single producer single consumer ring buffers
+//
+
+O_STATIC
+bool cmd_push(struct STrack__queue *q, const struct cmd *cmd)
+{
+    int w = SDL_AtomicGet(&q->cmds_write);
+    if (w - SDL_AtomicGet(&q->cmds_read) >= QUEUE_SIZE) {
+        return false;
+    }
+    q->cmds[w % QUEUE_SIZE] = *cmd;
+    // publish after the slot is written (SDL_AtomicSet is a full barrier)
+    SDL_AtomicSet(&q->cmds_write, w + 1);
+    return true;
+}
+
+O_STATIC
+bool cmd_pop(struct STrack__queue *q, struct cmd *out_cmd)
+{
+    int r = SDL_AtomicGet(&q->cmds_read);
+    if (r == SDL_AtomicGet(&q->cmds_write)) {
+        return false;
+    }
+    *out_cmd = q->cmds[r % QUEUE_SIZE];
+    SDL_AtomicSet(&q->cmds_read, r + 1);
+    return true;
+}
+
+O_STATIC
+bool collect_push(struct STrack__queue *q, oobj del, osize handle)
+{
+    int w = SDL_AtomicGet(&q->collect_write);
+    if (w - SDL_AtomicGet(&q->collect_read) >= QUEUE_SIZE) {
+        return false;
+    }
+    q->collect[w % QUEUE_SIZE] = (struct collect) {del, handle};
+    SDL_AtomicSet(&q->collect_write, w + 1);
+    return true;
+}
+
+O_STATIC
+bool collect_pop(struct STrack__queue *q, struct collect *out_collect)
+{
+    int r = SDL_AtomicGet(&q->collect_read);
+    if (r == SDL_AtomicGet(&q->collect_write)) {
+        return false;
+    }
+    *out_collect = q->collect[r % QUEUE_SIZE];
+    SDL_AtomicSet(&q->collect_read, r + 1);
+    return true;
+}
+
+
+//
+// retr'ieving thread
+//
+
+// -1 on failure
+O_STATIC
+osize played_idx_from_handle(STrack *self, osize handle)
+{
+    for (osize i = 0; i < o_num(self->played); i++) {
+        struct STrack__played *p = o_at(self->played, i);
+        if (p->handle_idx == handle) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// applies the queued commands, self is locked
+O_STATIC
+void drain(STrack *self, bool grow)
+{
+    struct cmd cmd;
+    for (;;) {
+        if (!grow && OArray_reserve(self->played) <= 0) {
+            // without growing the preallocated array, the remaining commands wait for the next retr
+            break;
+        }
+        if (!cmd_pop(self->queue, &cmd)) {
+            break;
+        }
+        if (cmd.type == CMD_PLAY) {
+            cmd.played.start_ticks += self->time_ticks;
+            OArray_push(self->played, &cmd.played);
+            continue;
+        }
+        if (cmd.type == CMD_RESET) {
+            for (osize i = 0; i < o_num(self->played); i++) {
+                struct STrack__played *p = o_at(self->played, i);
+                p->done = true;
+            }
+            continue;
+        }
+        osize idx = played_idx_from_handle(self, cmd.handle);
+        if (idx < 0) {
+            continue;
+        }
+        struct STrack__played *p = o_at(self->played, idx);
+        if (cmd.type == CMD_REMOVE) {
+            p->done = true;
+        } else if (cmd.type == CMD_PRIORITY) {
+            p->priority = cmd.priority;
+        } else {
+            p->amp = cmd.amp;
+        }
+    }
+}
+
+// protected, applies the queued commands without allocation, self is locked
+O_EXTERN
+void STrack__drain(oobj obj)
+{
+    OObj_assert(obj, STrack);
+    drain(obj, false);
+}
+
+// protected, passes the done played tracks back to STrack_collect, self is locked
 O_EXTERN
-void STrack__played_del(struct STrack__played *self)
+void STrack__played_pass_back(oobj obj)
 {
-    o_del(self->weak);
-    o_del(self->opt_parent);
+    OObj_assert(obj, STrack);
+    STrack *self = obj;
+    // back to front, so the indices are not invalidated
+    for (osize i = o_num(self->played) - 1; i >= 0; i--) {
+        struct STrack__played *p = o_at(self->played, i);
+        if (!p->done) {
+            continue;
+        }
+        if (!collect_push(self->queue, p->hold, p->handle_idx)) {
+            // full, try again on the next retr
+            continue;
+        }
+        OArray_pop_at(self->played, i, NULL);
+    }
+}
+
+// true if only the holds of playing STrack's are left as parents, so the user deleted the track
+// lock free, the hold is joined before held is increased and held is decreased before the hold is removed,
+//     so a playing track is never seen as released
+O_STATIC
+bool track_released(oobj track)
+{
+    STrack *t = track;
+    return OJoin_num_parents_atomic(t) <= SDL_AtomicGet(&t->queue->held);
+}
+
+// returns the preallocated scratch, or a temporary allocation if too small, see scratch_end
+O_STATIC
+void *scratch_begin(STrack *self, struct STrack__scratch *scratch, osize bytes)
+{
+    if (!scratch->in_use && bytes <= scratch->size) {
+        scratch->in_use = true;
+        return scratch->data;
+    }
+    return o_alloc(self, 1, bytes);
+}
+
+O_STATIC
+void scratch_end(STrack *self, struct STrack__scratch *scratch, void *mem)
+{
+    if (mem == scratch->data) {
+        scratch->in_use = false;
+        return;
+    }
+    o_free(self, mem);
+}
+
+O_STATIC
+void scratch_reserve(STrack *self, struct STrack__scratch *scratch, osize bytes)
+{
+    if (bytes <= scratch->size) {
+        return;
+    }
+    assert(!scratch->in_use);
+    scratch->data = o_realloc(self, scratch->data, 1, bytes);
+    scratch->size = bytes;
+}
+
+// creates or reconfigures the resampler, which only allocates if something changed
+O_STATIC
+SResampler *resampler_setup(STrack *self, struct s_audio_spec wanted)
+{
+    if (!self->resampler) {
+        self->resampler = SResampler_new(self, wanted, self->spec, self->resample_quality);
+    } else {
+        SResampler_setup(self->resampler, wanted, self->spec, self->resample_quality);
+    }
+    return self->resampler;
+}
+
+// ticks of an audio callback block in the given spec, with some room for rounding
+O_STATIC
+osize block_ticks(struct s_audio_spec spec)
+{
+    return s_resample_dst_ticks(spec, s_audio_spec_default(), s_audio_block_ticks()) + 16;
+}
+
+// spec as single atomic int, 0 if not representable
+O_STATIC
+int spec_key(struct s_audio_spec spec)
+{
+    if (spec.freq <= 0 || spec.freq >= (1 << 22) || spec.channels <= 0 || spec.channels >= 256) {
+        return 0;
+    }
+    return spec.freq << 8 | spec.channels;
+}
+
+
+//
+// producer side
+//
+
+// deletes a hold and decreases the held counter of its track, without locking the track
+O_STATIC
+void hold__v_del(oobj obj)
+{
+    STrack *track = o_user(obj);
+    // before OObj__v_del removes the hold as parent, see track_released
+    SDL_AtomicAdd(&track->queue->held, -1);
+    OObj__v_del(obj);
+}
+
+// producer is locked
+O_STATIC
+void queue_cmd(STrack *self, const struct cmd *cmd)
+{
+    while (!cmd_push(self->queue, cmd)) {
+        // full, the retr'ieving thread does not run (paused or not played), so drain it here
+        o_lock(self);
+        drain(self, true);
+        STrack__played_pass_back(self);
+        o_unlock(self);
+        STrack_collect(self);
+    }
+}
+
+// -1 if not available, producer is locked
+O_STATIC
+osize live_idx(STrack *self, osize handle)
+{
+    oobj live = self->queue->live;
+    for (osize i = 0; i < o_num(live); i++) {
+        if (*OArray_at(live, i, osize) == handle) {
+            return i;
+        }
+    }
+    return -1;
 }
 
 
@@ -35,10 +337,14 @@ STrack* STrack_new_super(osize object_size, oobj parent, const struct s_audio_sp
     }
 
     self->endable = true;
+    self->resample_quality = SResampler_QUALITY_DEFAULT;
+
+    self->played = OArray_new_dyn(self, NULL, sizeof(struct STrack__played), 0, PLAYED_CAPACITY);
 
-    // allocates the played array, inits time, and sets active to true
-    STrack_reset(self);
-    self->played_idx = 0;
+    self->queue = o_new0(self, struct STrack__queue, 1);
+    self->queue->producer = OObj_new(self);
+    self->queue->live = OArray_new_dyn(self->queue->producer, NULL, sizeof(osize), 0, PLAYED_CAPACITY);
+    self->queue->holds = OObj_new(self);
 
     self->filter = OArray_new_dyn(self, NULL, sizeof(oobj), 0, 4);
 
@@ -46,6 +352,10 @@ STrack* STrack_new_super(osize object_size, oobj parent, const struct s_audio_sp
     self->v_retr = STrack__v_retr;
     self->v_duration = STrack__v_duration;
 
+    // an audio callback block in its own spec, STrack_play_ex reserves for the playing spec
+    STrack_reserve(self, block_ticks(self->spec), &self->spec);
+    SDL_AtomicSet(&self->queue->reserved, spec_key(self->spec));
+
     return self;
 }
 
@@ -66,67 +376,78 @@ bool STrack__v_retr(oobj obj, float *out_data, osize len, osize time_ticks)
         self->time_ticks = time_ticks;
     }
 
-    oobj container = OObj_new(obj);
+    STrack__drain(self);
 
     // init silence (floats bitmap is in fact 0 for 0.0f), so using o_clea for performance
     o_clear(out_data, 1, s_audio_spec_buffer_size(self->spec, len));
 
-    // keep track of played to remove
-    bool *p_del = o_new0(container, bool, o_num(self->played));
-
-    float *mix_buf = o_new(container, float, s_audio_spec_buffer_size(self->spec, len));
+    float *mix_buf = scratch_begin(self, &self->scratch_mix, s_audio_spec_buffer_size(self->spec, len));
 
     for(osize i=0; i<o_num(self->played); i++) {
         struct STrack__played *p = o_at(self->played, i);
-
-        // needs to be released, if valid!
-        struct oobj_opt track = OWeakjoin_acquire(p->weak);
-        if(!track.o) {
-            p_del[i] = true;
+        if(p->done) {
             continue;
         }
 
-        bool retr = true;
+        // the hold keeps the track alive, so no weak reference needs to be resolved
+        if(!p->keep && track_released(p->track)) {
+            p->done = true;
+            continue;
+        }
 
         // span before track begins?
         if(time_ticks + len <= p->start_ticks) {
-            retr = false;
+            p->done = p->stopping;
+            continue;
         }
 
-        if(retr) {
+        osize track_time = time_ticks - p->start_ticks;
 
-            osize track_time = time_ticks - p->start_ticks;
-            osize track_len = len;
-            float *out_track_data = out_data;
-            if(track_time < 0) {
-                // tracks are not able to retr data before their start tick, so shifting to start
-                track_len += track_time;
-                out_track_data -= track_time*self->spec.channels;
-                track_time = 0;
-            }
-
-            // retrieve track data in this spec
-            bool ended = STrack_retr(track.o, mix_buf, track_len, track_time, &self->spec);
-            if(ended && STrack_endable(track.o)) {
-                p_del[i] = true;
+        // virtual or stopping and already faded out (or not started yet), so nothing to retr
+        if((p->virtualized || p->stopping) && (p->amp_mixed == 0.0f || track_time <= 0)) {
+            // fades in when mixed again, its time advances anyway
+            p->amp_mixed = 0.0f;
+            if(STrack_endable(p->track) && s_audio_spec_time_as_seconds(self->spec, track_time + len)
+                                           >= STrack_duration(p->track)) {
+                p->done = true;
             }
+            p->done |= p->stopping;
+            continue;
+        }
 
-            // mix into our output
-            s_mix_into(out_track_data, mix_buf, p->amp, self->spec.channels, track_len);
+        osize track_len = len;
+        float *out_track_data = out_data;
+        if(track_time < 0) {
+            // tracks are not able to retr data before their start tick, so shifting to start
+            track_len += track_time;
+            out_track_data -= track_time*self->spec.channels;
+            track_time = 0;
         }
 
-        OWeakjoin_release(p->weak);
-    }
+        // retrieve track data in this spec
+        bool ended = STrack_retr(p->track, mix_buf, track_len, track_time, &self->spec);
+        if(ended && STrack_endable(p->track)) {
+            p->done = true;
+        }
 
-    // pop from back to front so the idx remains valid
-    for(osize i=o_num(self->played)-1; i>=0; i--) {
-        if(p_del[i]) {
-            struct STrack__played *p = o_at(self->played, i);
-            STrack__played_del(p);
-            OArray_pop_at(self->played, i, NULL);
+        // mix into our output, ramps to a changed (or stopping) amp within this block
+        float amp = p->stopping || p->virtualized ? 0.0f : p->amp;
+        if(amp != p->amp_mixed && track_len > 0) {
+            float step = (amp - p->amp_mixed) / (float) track_len;
+            s_mix_add_ramp(out_track_data, mix_buf, p->amp_mixed + step, step, self->spec.channels, track_len);
+        } else {
+            s_mix_add(out_track_data, mix_buf, amp, s_audio_spec_array_size(self->spec, track_len));
+        }
+        p->amp_mixed = amp;
+        if(p->stopping) {
+            p->done = true;
         }
     }
 
+    scratch_end(self, &self->scratch_mix, mix_buf);
+
+    STrack__played_pass_back(self);
+
     o_unlock(self);
     return o_num(self->played)==0;
 }
@@ -154,17 +475,15 @@ void track_apply_filters(STrack *self, float *data, osize len, osize time_ticks)
         f->v_apply(f, self, data, self->spec.channels, len, time_ticks);
     }
 
-    // remove and del backwards
+    // remove backwards, deleted by STrack_collect
     for(osize i=o_num(self->filter)-1; i>=0; i--)
     {
         oobj *filter = o_at(self->filter, i);
         OObj_assert(*filter, SFilter);
         SFilter *f = *filter;
-        osize end_time = f->end_time;
-        if(time_ticks > end_time) {
+        if(time_ticks > f->end_time && collect_push(self->queue, f, 0)) {
             OArray_pop_at(self->filter, i, NULL);
         }
-        o_del(f);
     }
 
 }
@@ -185,16 +504,20 @@ bool STrack_retr(oobj obj, float *out_data, osize len, osize time_ticks, const s
         return ended;
     }
     // resample needed!
-    osize track_len = s_resample_dst_ticks(self->spec, wanted, len);
-    osize track_time_ticks = s_resample_dst_ticks(self->spec, wanted, time_ticks);
-    float *tmp = o_new(obj, float, s_audio_spec_array_size(self->spec, track_len));
-    // retrieve data from this track
-    bool ended = self->v_retr(obj, tmp, track_len, track_time_ticks);
-    track_apply_filters(self, tmp, track_len, track_time_ticks);
+    SResampler *resampler = resampler_setup(self, wanted);
+    osize track_time_ticks;
+    osize track_len = SResampler_src_ticks(resampler, len, time_ticks, &track_time_ticks);
+    float *tmp = scratch_begin(self, &self->scratch_resample, s_audio_spec_buffer_size(self->spec, track_len));
+    // retrieve data from this track, the resampler may already hold all needed ticks
+    bool ended = false;
+    if(track_len > 0) {
+        ended = self->v_retr(obj, tmp, track_len, track_time_ticks);
+        track_apply_filters(self, tmp, track_len, track_time_ticks);
+    }
     // resample into the output
-    s_resample(wanted, self->spec, out_data, tmp, track_len);
+    SResampler_run(resampler, out_data, len, time_ticks, tmp, track_len);
     // done...
-    o_free(obj, tmp);
+    scratch_end(self, &self->scratch_resample, tmp);
 
     o_unlock(self);
     return ended;
@@ -223,77 +546,107 @@ oobj STrack_retr_span_ex(oobj obj, osize len, osize time_ticks, const struct s_a
     return array;
 }
 
-void STrack_reset(oobj obj)
+void STrack_reserve(oobj obj, osize len, const struct s_audio_spec *opt_spec)
 {
     OObj_assert(obj, STrack);
     STrack *self = obj;
     o_lock(self);
 
-    // struct player stuff is allocated on the player array
-    // so all OWeakjoin's are deleted as well
-    o_del(self->played);
-    self->played = OArray_new_dyn(self, NULL, sizeof(struct STrack__played), 0, 32);
+    struct s_audio_spec wanted = opt_spec? *opt_spec : s_audio_spec_default();
+    osize track_len = s_resample_dst_ticks(self->spec, wanted, len);
+    scratch_reserve(self, &self->scratch_mix, s_audio_spec_buffer_size(self->spec, o_max(len, track_len)));
+    if(!s_audio_spec_equals(self->spec, wanted)) {
+        SResampler *resampler = resampler_setup(self, wanted);
+        SResampler_reserve(resampler, len);
+        scratch_reserve(self, &self->scratch_resample,
+                        s_audio_spec_buffer_size(self->spec, SResampler_src_ticks_max(resampler, len)));
+    }
 
     o_unlock(self);
 }
 
-osize STrack_play_ex(oobj obj, oobj track, osize time_ticks, float amp, bool parent_join)
+void STrack_reset(oobj obj)
 {
     OObj_assert(obj, STrack);
     STrack *self = obj;
-    o_lock(self);
-
-    struct STrack__played p = {0};
-    p.handle_idx = ++self->played_idx;
-    p.weak = OWeakjoin_new(self->played, track);
-    if(parent_join) {
-        p.opt_parent = OObj_new(self->played);
-        OJoin_add(track, p.opt_parent);
-    }
-    p.start_ticks = self->time_ticks + time_ticks;
-    p.amp = amp;
+    o_lock(self->queue->producer);
 
-    OArray_push(self->played, &p);
+    queue_cmd(self, &(struct cmd) {.type = CMD_RESET});
+    OArray_clear(self->queue->live);
 
-    o_unlock(self);
-    return p.handle_idx;
+    o_unlock(self->queue->producer);
 }
 
-// -1 on failure
-O_STATIC
-osize get_played_array_idx_handle(oobj obj, osize handle)
+void STrack_collect(oobj obj)
 {
     OObj_assert(obj, STrack);
     STrack *self = obj;
-    for(osize i=0; i<o_num(self->played); i++) {
-        struct STrack__played *p = o_at(self->played, i);
-        if(p->handle_idx == handle) {
-            return i;
+    o_lock(self->queue->producer);
+
+    struct collect collect;
+    while(collect_pop(self->queue, &collect)) {
+        osize idx = collect.handle > 0 ? live_idx(self, collect.handle) : -1;
+        if(idx >= 0) {
+            OArray_pop_at(self->queue->live, idx, NULL);
         }
+        // may delete the played track, if the hold was its last parent
+        o_del(collect.del);
     }
-    return -1;
+
+    o_unlock(self->queue->producer);
 }
 
-O_STATIC
-struct STrack__played *get_played_from_handle(oobj obj, osize handle)
+osize STrack_play_ex(oobj obj, oobj track, osize time_ticks, float amp, bool keep, int priority)
 {
     OObj_assert(obj, STrack);
+    OObj_assert(track, STrack);
     STrack *self = obj;
-    for(osize i=0; i<o_num(self->played); i++) {
-        struct STrack__played *p = o_at(self->played, i);
-        if(p->handle_idx == handle) {
-            return p;
-        }
+    STrack *t = track;
+
+    // the reserve locks the track, which a retr of it also does, so only for a new playing spec.
+    // plays of an already reserved track (like a shared sfx) never wait for the retr'ieving thread
+    int key = spec_key(self->spec);
+    if (!key || SDL_AtomicGet(&t->queue->reserved) != key) {
+        STrack_reserve(t, block_ticks(self->spec), &self->spec);
+        SDL_AtomicSet(&t->queue->reserved, key);
     }
-    return NULL;
-}
 
+    o_lock(self->queue->producer);
+    STrack_collect(self);
+
+    struct cmd cmd = {.type = CMD_PLAY};
+    struct STrack__played *p = &cmd.played;
+    p->handle_idx = ++self->queue->played_idx;
+    p->track = t;
+    p->keep = keep;
+    p->start_ticks = time_ticks;
+    p->amp = amp;
+    p->amp_mixed = amp;
+    p->priority = priority;
+
+    // the hold is created and deleted outside of the retr'ieving thread
+    p->hold = OObj_new(self->queue->holds);
+    o_user_set(p->hold, t);
+    ((OObj *) p->hold)->v_del = hold__v_del;
+    OJoin_add(t, p->hold);
+    // after the hold is joined, see track_released
+    SDL_AtomicIncRef(&t->queue->held);
+
+    OArray_push(self->queue->live, &p->handle_idx);
+    queue_cmd(self, &cmd);
+
+    o_unlock(self->queue->producer);
+    return p->handle_idx;
+}
 
 bool STrack_played_available(oobj obj, osize handle)
 {
-    o_lock(obj);
-    bool available = get_played_from_handle(obj, handle) != NULL;
-    o_unlock(obj);
+    OObj_assert(obj, STrack);
+    STrack *self = obj;
+    o_lock(self->queue->producer);
+    STrack_collect(self);
+    bool available = live_idx(self, handle) >= 0;
+    o_unlock(self->queue->producer);
     return available;
 }
 
@@ -301,31 +654,49 @@ bool STrack_played_remove(oobj obj, osize handle)
 {
     OObj_assert(obj, STrack);
     STrack *self = obj;
-    o_lock(self);
+    o_lock(self->queue->producer);
+    STrack_collect(self);
 
-    osize idx = get_played_array_idx_handle(obj, handle);
-    if(idx < 0) {
-
-        o_unlock(self);
-        return false;
+    osize idx = live_idx(self, handle);
+    if(idx >= 0) {
+        OArray_pop_at(self->queue->live, idx, NULL);
+        queue_cmd(self, &(struct cmd) {.type = CMD_REMOVE, .handle = handle});
     }
-    struct STrack__played *p = o_at(self->played, idx);
-    STrack__played_del(p);
-    OArray_pop_at(self->played, idx, NULL);
 
-    o_unlock(self);
-    return true;
+    o_unlock(self->queue->producer);
+    return idx >= 0;
 }
 
 bool STrack_played_amp_set(oobj obj, osize handle, float amp)
 {
-    o_lock(obj);
-    struct STrack__played *p = get_played_from_handle(obj, handle);
-    if(p) {
-        p->amp = amp;
+    OObj_assert(obj, STrack);
+    STrack *self = obj;
+    o_lock(self->queue->producer);
+    STrack_collect(self);
+
+    osize idx = live_idx(self, handle);
+    if(idx >= 0) {
+        queue_cmd(self, &(struct cmd) {.type = CMD_AMP, .handle = handle, .amp = amp});
     }
-    o_unlock(obj);
-    return p!=NULL;
+
+    o_unlock(self->queue->producer);
+    return idx >= 0;
+}
+
+bool STrack_played_priority_set(oobj obj, osize handle, int priority)
+{
+    OObj_assert(obj, STrack);
+    STrack *self = obj;
+    o_lock(self->queue->producer);
+    STrack_collect(self);
+
+    osize idx = live_idx(self, handle);
+    if(idx >= 0) {
+        queue_cmd(self, &(struct cmd) {.type = CMD_PRIORITY, .handle = handle, .priority = priority});
+    }
+
+    o_unlock(self->queue->producer);
+    return idx >= 0;
 }
 
 
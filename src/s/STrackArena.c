@@ -1,6 +1,8 @@
 #include "s/STrackArena.h"
 #include "o/OObj_builder.h"
 #include "o/OArray.h"
+#include "o/timer.h"
+#include "m/sca/flt.h"
 
 
 #define O_LOG_LIB "s"
@@ -16,6 +18,10 @@ STrackArena *STrackArena_new_super(osize object_size, oobj parent, int limit, co
     super->endable = false;
     super->time_ticks_auto = true;
     self->limit = limit;
+    self->real_limit = limit;
+    self->virtual_amp = STrackArena_VIRTUAL_AMP_DEFAULT;
+    self->load_target = 0;
+    self->stats.real_budget = limit;
 
     // vfuncs
     super->v_retr = STrackArena__v_retr;
@@ -23,6 +29,64 @@ STrackArena *STrackArena_new_super(osize object_size, oobj parent, int limit, co
     return self;
 }
 
+// true if a should be mixed before b
+O_STATIC
+bool ranked_before(const struct STrack__played *a, const struct STrack__played *b)
+{
+    if(a->priority != b->priority) {
+        return a->priority > b->priority;
+    }
+    if(o_abs(a->amp) != o_abs(b->amp)) {
+        return o_abs(a->amp) > o_abs(b->amp);
+    }
+    return a->handle_idx > b->handle_idx;
+}
+
+// insertion sort, the order of the last retr is mostly kept, so nearly linear and allocation free
+O_STATIC
+void rank(oobj played)
+{
+    osize num = o_num(played);
+    if(num < 2) {
+        return;
+    }
+    struct STrack__played *data = o_at(played, 0);
+    for(osize i=1; i<num; i++) {
+        struct STrack__played p = data[i];
+        osize j = i;
+        for(; j>0 && ranked_before(&p, &data[j-1]); j--) {
+            data[j] = data[j-1];
+        }
+        data[j] = p;
+    }
+}
+
+// smoothed time of the retr relative to the block time
+O_STATIC
+void load_update(STrackArena *self, double retr_s, osize len)
+{
+    double block_s = s_audio_spec_time_as_seconds(STrack_spec(self), len);
+    if(block_s > 0) {
+        self->stats.load = m_mix(self->stats.load, (float) (retr_s / block_s), 0.1f);
+    }
+}
+
+// adapts the real budget to the load, one track per retr
+O_STATIC
+void budget_update(STrackArena *self)
+{
+    int budget = self->stats.real_budget;
+    if(self->load_target <= 0) {
+        budget = self->real_limit;
+    } else if(self->stats.load > self->load_target) {
+        budget--;
+    } else if(self->stats.load < self->load_target * 0.75f) {
+        budget++;
+    }
+    // at least one real track, so the load is measured with mixing
+    self->stats.real_budget = o_clamp(budget, 1, o_max(1, self->real_limit));
+}
+
 //
 // virtual implementations:
 //
@@ -34,23 +98,50 @@ bool STrackArena__v_retr(oobj obj, float *out_data, osize len, osize time_ticks)
     STrackArena *self = obj;
     o_lock(self);
 
-    assert(self->limit>=0);
+    assert(self->limit>=0 && self->real_limit>=0);
 
     // protected
     O_EXTERN
-    void STrack__played_del(struct STrack__played *self);
+    void STrack__drain(oobj obj);
+
+    // apply the queued commands first, to limit the new played tracks as well
+    if(super->time_ticks_auto) {
+        super->time_ticks = time_ticks;
+    }
+    STrack__drain(self);
+
+    ou64 start = o_timer();
+    budget_update(self);
 
-    // keep in limit and remove oldest (at front) until limit is reached
-    while(o_num(super->played) > self->limit) {
-        struct STrack__played *p = o_at(super->played, 0);
-        o_log_trace_s("STrackArena", "popping: %"osize_PRI, p->handle_idx);
-        STrack__played_del(p);
-        OArray_pop_front(super->played, NULL);
+    // the best ranked tracks are mixed, the following are virtual, the ones over limit are stolen
+    // STrack__v_retr fades out the virtual and stolen tracks within this block
+    // and passes the stolen back to be deleted outside of the audio thread
+    rank(super->played);
+    int active = 0;
+    int real = 0;
+    for(osize i=0; i<o_num(super->played); i++) {
+        struct STrack__played *p = o_at(super->played, i);
+        if(p->done || p->stopping) {
+            continue;
+        }
+        if(active >= self->limit) {
+            o_log_trace_s("STrackArena", "stopping: %"osize_PRI, p->handle_idx);
+            p->stopping = true;
+            self->stats.stolen++;
+            continue;
+        }
+        active++;
+        p->virtualized = real >= self->stats.real_budget || o_abs(p->amp) <= self->virtual_amp;
+        real += !p->virtualized;
     }
+    self->stats.real_voices = real;
+    self->stats.virtual_voices = active - real;
 
     // call super to mix played on this track tracks
     bool ended = STrack__v_retr(self, out_data, len, time_ticks);
 
+    load_update(self, o_timer_elapsed_s(start), len);
+
     o_unlock(self);
     return ended;
 }
@@ -59,3 +150,21 @@ bool STrackArena__v_retr(oobj obj, float *out_data, osize len, osize time_ticks)
 // object functions
 //
 
+osize STrackArena_play(oobj obj, oobj track, double time_seconds, float amp, int priority)
+{
+    OObj_assert(obj, STrackArena);
+    assert(time_seconds >= 0);
+    // in the same command, so a retr never ranks the new track at the default priority
+    return STrack_play_ex(obj, track, (osize) (time_seconds * STrack_spec(obj).freq), amp, false, priority);
+}
+
+struct STrackArena_stats STrackArena_stats(oobj obj)
+{
+    OObj_assert(obj, STrackArena);
+    STrackArena *self = obj;
+    o_lock(self);
+    struct STrackArena_stats stats = self->stats;
+    o_unlock(self);
+    return stats;
+}
+
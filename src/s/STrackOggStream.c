@@ -0,0 +1,589 @@
+#include "s/STrackOggStream.h"
+#include "o/OObj_builder.h"
+#include "o/OArray.h"
+#include "o/file.h"
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_thread.h>
+
+#define STB_VORBIS_HEADER_ONLY
+#include "ext_stb_vorbis.c"
+
+#define O_LOG_LIB "s"
+#include "o/log.h"
+
+
+// a retr slightly before the read position (rounded times of the caller) is served from there instead of seeking
+#define RESAMPLE_SLACK_TICKS 4
+
+// the worker also wakes up periodically, so a missed wake up costs at most this delay
+#define WORKER_PERIOD_MS 20
+
+
+struct STrackOggStream__ring {
+    // stream positions in ticks, the ring index is position % ring_ticks
+    // read is written by the retr, or by the decoder while a seek is pending
+    SDL_atomic_t read;
+    // written by the decoder
+    SDL_atomic_t write;
+    // stream position at which the decoder reached the end, or -1
+    SDL_atomic_t end;
+
+    // seek requests are set by the (locked) retr or STrackOggStream_seek,
+    //      the decoder clears seek, once the ring buffer is refilled at seek_ticks
+    SDL_atomic_t seek;
+    SDL_atomic_t seek_ticks;
+
+    SDL_atomic_t underruns;
+
+    // list of all streams, for the worker
+    STrackOggStream *prev, *next;
+};
+
+#ifdef MIA_OPTION_THREAD
+// the dedicated decoding thread, see worker_run
+struct worker {
+    SDL_Thread *thread;
+    SDL_atomic_t stop;
+};
+#endif
+
+static struct {
+    // guards first and the list links
+    SDL_SpinLock lock;
+    STrackOggStream *first;
+
+#ifdef MIA_OPTION_THREAD
+    // held by the worker while decoding.
+    // Taken by list changes, seeks and STrackOggStream_wait to exclude the worker
+    SDL_mutex *decoding;
+
+    // posted to wake up the worker
+    SDL_sem *wake;
+
+    // set by a post and reset by the worker, so that the audio thread posts only once
+    SDL_atomic_t wake_pending;
+
+    // running while streams exist, guarded by decoding
+    struct worker *worker;
+#endif
+} STrackOggStream_L;
+
+
+// wakes up the worker, lock and allocation free, so the audio thread may call it
+O_STATIC
+void worker_wake(void)
+{
+#ifdef MIA_OPTION_THREAD
+    SDL_sem *wake = SDL_AtomicGetPtr((void **) &STrackOggStream_L.wake);
+    if (wake && SDL_AtomicCAS(&STrackOggStream_L.wake_pending, 0, 1)) {
+        SDL_SemPost(wake);
+    }
+#endif
+}
+
+#ifdef MIA_OPTION_THREAD
+// forward declaration, the decoding loop of the worker thread
+O_STATIC
+int worker_run(void *data);
+
+// creates the semaphore and the mutex once, lock free, so that nothing is allocated under the spinlock
+O_STATIC
+void sync_init(void)
+{
+    if (SDL_AtomicGetPtr((void **) &STrackOggStream_L.decoding)) {
+        return;
+    }
+    SDL_sem *wake = SDL_CreateSemaphore(0);
+    SDL_mutex *decoding = SDL_CreateMutex();
+    o_assume(wake && decoding, "failed to create the STrackOggStream sync objects");
+    if (!SDL_AtomicCASPtr((void **) &STrackOggStream_L.wake, NULL, wake)) {
+        SDL_DestroySemaphore(wake);
+    }
+    if (!SDL_AtomicCASPtr((void **) &STrackOggStream_L.decoding, NULL, decoding)) {
+        SDL_DestroyMutex(decoding);
+    }
+}
+#endif
+
+O_STATIC
+void list_add(STrackOggStream *self)
+{
+#ifdef MIA_OPTION_THREAD
+    sync_init();
+    SDL_LockMutex(STrackOggStream_L.decoding);
+#endif
+
+    SDL_AtomicLock(&STrackOggStream_L.lock);
+    self->ring->next = STrackOggStream_L.first;
+    if (STrackOggStream_L.first) {
+        STrackOggStream_L.first->ring->prev = self;
+    }
+    STrackOggStream_L.first = self;
+    SDL_AtomicUnlock(&STrackOggStream_L.lock);
+
+#ifdef MIA_OPTION_THREAD
+    if (!STrackOggStream_L.worker) {
+        struct worker *worker = SDL_calloc(1, sizeof *worker);
+        o_assume(worker, "failed to allocate the STrackOggStream worker");
+        worker->thread = SDL_CreateThread(worker_run, "STrackOggStream", worker);
+        o_assume(worker->thread, "failed to create the STrackOggStream worker");
+        STrackOggStream_L.worker = worker;
+    }
+    SDL_UnlockMutex(STrackOggStream_L.decoding);
+#endif
+}
+
+O_STATIC
+void list_remove(STrackOggStream *self)
+{
+#ifdef MIA_OPTION_THREAD
+    // waits for a running decode of the worker
+    SDL_LockMutex(STrackOggStream_L.decoding);
+#endif
+
+    SDL_AtomicLock(&STrackOggStream_L.lock);
+    struct STrackOggStream__ring *ring = self->ring;
+    if (ring->prev) {
+        ring->prev->ring->next = ring->next;
+    } else if (STrackOggStream_L.first == self) {
+        STrackOggStream_L.first = ring->next;
+    }
+    if (ring->next) {
+        ring->next->ring->prev = ring->prev;
+    }
+    ring->prev = ring->next = NULL;
+    SDL_AtomicUnlock(&STrackOggStream_L.lock);
+
+#ifdef MIA_OPTION_THREAD
+    // the last stream stops the worker, the next stream starts a new one (first only changes under decoding)
+    struct worker *stopped = NULL;
+    if (!STrackOggStream_L.first && STrackOggStream_L.worker) {
+        stopped = STrackOggStream_L.worker;
+        STrackOggStream_L.worker = NULL;
+        SDL_AtomicSet(&stopped->stop, 1);
+    }
+    SDL_UnlockMutex(STrackOggStream_L.decoding);
+
+    if (stopped) {
+        SDL_SemPost(STrackOggStream_L.wake);
+        SDL_WaitThread(stopped->thread, NULL);
+        SDL_free(stopped);
+    }
+#endif
+}
+
+
+// decodes into the free space of the ring buffer
+O_STATIC
+void fill(STrackOggStream *self)
+{
+    struct STrackOggStream__ring *ring = self->ring;
+    int channels = self->super.spec.channels;
+    int capacity = (int) self->ring_ticks;
+
+    while (SDL_AtomicGet(&ring->end) < 0) {
+        // the retr may only advance read in the meantime, so free can only grow
+        int read = SDL_AtomicGet(&ring->read);
+        int write = SDL_AtomicGet(&ring->write);
+        int free = capacity - (write - read);
+        if (free <= 0) {
+            break;
+        }
+        int idx = write % capacity;
+        int num = o_min(free, capacity - idx);
+        int got = stb_vorbis_get_samples_float_interleaved(self->vorbis, channels,
+                                                           self->ring_data + idx * channels, num * channels);
+        if (got <= 0) {
+            SDL_AtomicSet(&ring->end, write);
+            break;
+        }
+        SDL_AtomicSet(&ring->write, write + got);
+    }
+}
+
+// decodes, handles a pending seek and fills the ring buffer
+O_STATIC
+void decode(STrackOggStream *self)
+{
+    struct STrackOggStream__ring *ring = self->ring;
+    if (!SDL_AtomicGet(&ring->seek)) {
+        fill(self);
+        return;
+    }
+
+    // the retr does not touch the positions while a seek is pending
+    int target = SDL_AtomicGet(&ring->seek_ticks);
+    bool ok = target < self->length && stb_vorbis_seek(self->vorbis, (unsigned int) target);
+    SDL_AtomicSet(&ring->end, ok ? -1 : target);
+    SDL_AtomicSet(&ring->write, target);
+    SDL_AtomicSet(&ring->read, target);
+
+    // refill before clearing the request, so that the retr finds its time in the ring buffer
+    fill(self);
+    SDL_AtomicSet(&ring->seek, 0);
+}
+
+O_STATIC
+bool needs_decode(STrackOggStream *self)
+{
+    struct STrackOggStream__ring *ring = self->ring;
+    if (SDL_AtomicGet(&ring->seek)) {
+        return true;
+    }
+    if (SDL_AtomicGet(&ring->end) >= 0) {
+        return false;
+    }
+    return SDL_AtomicGet(&ring->write) - SDL_AtomicGet(&ring->read) < self->ring_ticks;
+}
+
+#ifdef MIA_OPTION_THREAD
+O_STATIC
+int worker_run(void *data)
+{
+    struct worker *worker = data;
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+    while (!SDL_AtomicGet(&worker->stop)) {
+        SDL_SemWaitTimeout(STrackOggStream_L.wake, WORKER_PERIOD_MS);
+        SDL_AtomicSet(&STrackOggStream_L.wake_pending, 0);
+
+        SDL_LockMutex(STrackOggStream_L.decoding);
+        SDL_AtomicLock(&STrackOggStream_L.lock);
+        STrackOggStream *it = STrackOggStream_L.first;
+        SDL_AtomicUnlock(&STrackOggStream_L.lock);
+
+        // streams are only removed while holding decoding, new ones are added in front
+        for (; it; it = it->ring->next) {
+            if (!it->blocking && needs_decode(it)) {
+                decode(it);
+            }
+        }
+        SDL_UnlockMutex(STrackOggStream_L.decoding);
+    }
+    return 0;
+}
+#endif
+
+// track must be locked, or the worker excluded
+O_STATIC
+void request_seek(STrackOggStream *self, osize time_ticks)
+{
+    struct STrackOggStream__ring *ring = self->ring;
+    SDL_AtomicSet(&ring->seek_ticks, (int) o_clamp(time_ticks, 0, self->length));
+    SDL_AtomicSet(&ring->seek, 1);
+    worker_wake();
+}
+
+// track must be locked
+// mix's the ring buffer data into out_data, requests a seek if time_ticks is not in the ring buffer
+// returns the number of mixed ticks
+O_STATIC
+osize ring_mix(STrackOggStream *self, float *out_data, osize len, osize time_ticks)
+{
+    struct STrackOggStream__ring *ring = self->ring;
+    if (len <= 0 || SDL_AtomicGet(&ring->seek)) {
+        return 0;
+    }
+
+    osize read = SDL_AtomicGet(&ring->read);
+    osize write = SDL_AtomicGet(&ring->write);
+    osize end = SDL_AtomicGet(&ring->end);
+
+    if (time_ticks < read && read - time_ticks <= RESAMPLE_SLACK_TICKS) {
+        time_ticks = read;
+    }
+    if (time_ticks < read || time_ticks > write) {
+        if (end < 0 || time_ticks < end) {
+            request_seek(self, time_ticks);
+        }
+        return 0;
+    }
+
+    int channels = self->super.spec.channels;
+    osize num = o_min(len, write - time_ticks);
+    osize done = 0;
+    while (done < num) {
+        osize idx = (time_ticks + done) % self->ring_ticks;
+        osize seg = o_min(num - done, self->ring_ticks - idx);
+        s_mix_into(out_data + done * channels, self->ring_data + idx * channels, 1.0f, channels, seg);
+        done += seg;
+    }
+
+    // frees the read data for the decoder
+    SDL_AtomicSet(&ring->read, (int) (time_ticks + num));
+
+    // below the low water mark, refills without waiting for the main thread
+    if (end < 0 && write - (time_ticks + num) < self->ring_ticks / 2) {
+        worker_wake();
+    }
+    return num;
+}
+
+O_STATIC
+bool ring_ended(STrackOggStream *self, osize time_ticks)
+{
+    if (time_ticks >= self->length) {
+        return true;
+    }
+    struct STrackOggStream__ring *ring = self->ring;
+    osize end = SDL_AtomicGet(&ring->end);
+    return !SDL_AtomicGet(&ring->seek) && end >= 0 && time_ticks >= end;
+}
+
+
+//
+// public
+//
+
+struct oobj_opt STrackOggStream_new_super(osize object_size, oobj parent, const void *data, osize data_size,
+                                          osize ring_ticks)
+{
+    assert(object_size >= (osize) sizeof(STrackOggStream));
+
+    // header only, to get the spec
+    int error;
+    stb_vorbis *vorbis = stb_vorbis_open_memory(data, (int) data_size, &error, NULL);
+    if (!vorbis) {
+        o_log_error_s(__func__, "Failed to open ogg data: %i", error);
+        return oobj_opt(NULL);
+    }
+    stb_vorbis_info info = stb_vorbis_get_info(vorbis);
+    osize length = stb_vorbis_stream_length_in_samples(vorbis);
+    stb_vorbis_close(vorbis);
+
+    // positions are stored as SDL_atomic_t
+    if (length <= 0 || length >= oi32_MAX) {
+        o_log_error_s(__func__, "Invalid ogg stream length: %" osize_PRI, length);
+        return oobj_opt(NULL);
+    }
+
+    struct s_audio_spec spec = {(int) info.sample_rate, info.channels};
+    STrack *super = STrack_new_super(object_size, parent, &spec);
+    STrackOggStream *self = (STrackOggStream *) super;
+    OObj_id_set(self, STrackOggStream_ID);
+
+    // the decoder works on the own copy
+    self->data = OArray_new(self, data, 1, data_size);
+    self->vorbis = stb_vorbis_open_memory(o_at(self->data, 0), (int) data_size, &error, NULL);
+    assert(self->vorbis);
+    self->length = length;
+
+    if (ring_ticks <= 0) {
+        ring_ticks = (osize) spec.freq * STrackOggStream_RING_MS_DEFAULT / 1000;
+    }
+    self->ring_ticks = ring_ticks;
+    self->ring_data = o_new0(self, float, s_audio_spec_array_size(spec, ring_ticks));
+
+    self->ring = o_new0(self, struct STrackOggStream__ring, 1);
+    SDL_AtomicSet(&self->ring->end, -1);
+
+    // vfuncs
+    ((OObj *) self)->v_del = STrackOggStream__v_del;
+    super->v_retr = STrackOggStream__v_retr;
+    super->v_duration = STrackOggStream__v_duration;
+
+    // ready to play
+    fill(self);
+
+    list_add(self);
+
+    return oobj_opt(self);
+}
+
+struct oobj_opt STrackOggStream_new_file(oobj parent, const char *file)
+{
+    oobj container = OObj_new(parent);
+    struct oobj_opt self = oobj_opt(NULL);
+
+    struct oobj_opt memory = o_file_read(container, file, false, 1);
+    if (!memory.o) {
+        o_log_error_s(__func__, "Failed to load file to memory %s", file);
+    } else {
+        self = STrackOggStream_new(parent, o_at(memory.o, 0), o_num(memory.o));
+    }
+
+    o_del(container);
+    return self;
+}
+
+
+// protected, used by s_update
+O_EXTERN
+void STrackOggStream__update_all(void)
+{
+#ifdef MIA_OPTION_THREAD
+    // the worker refills on its own, this just lowers the latency
+    worker_wake();
+#else
+    // locked, so that no stream gets deleted while updating
+    SDL_AtomicLock(&STrackOggStream_L.lock);
+    for (STrackOggStream *it = STrackOggStream_L.first; it; it = it->ring->next) {
+        STrackOggStream_update(it);
+    }
+    SDL_AtomicUnlock(&STrackOggStream_L.lock);
+#endif
+}
+
+
+//
+// virtual implementations:
+//
+
+void STrackOggStream__v_del(oobj obj)
+{
+    OObj_assert(obj, STrackOggStream);
+    STrackOggStream *self = obj;
+
+    if (OJoin_num_parents(self) > 0) {
+        // not deleted yet, see OJoin__v_del
+        return;
+    }
+
+    // waits for a running decode
+    list_remove(self);
+    stb_vorbis_close(self->vorbis);
+    self->vorbis = NULL;
+
+    OJoin__v_del(self);
+}
+
+bool STrackOggStream__v_retr(oobj obj, float *out_data, osize len, osize time_ticks)
+{
+    OObj_assert(obj, STrackOggStream);
+    STrackOggStream *self = obj;
+    o_lock(self);
+
+    // call super to mix played on this track tracks
+    STrack__v_retr(self, out_data, len, time_ticks);
+
+    int channels = self->super.spec.channels;
+    osize done = 0;
+    for (;;) {
+        done += ring_mix(self, out_data + done * channels, len - done, time_ticks + done);
+        if (done >= len || ring_ended(self, time_ticks + done) || !self->blocking) {
+            break;
+        }
+        // blocking, the decoding thread skips this stream
+        decode(self);
+    }
+
+    bool ended = ring_ended(self, time_ticks + len);
+    if (done < len) {
+        osize missing = o_min(len, self->length - time_ticks) - done;
+        if (missing > 0) {
+            SDL_AtomicAdd(&self->ring->underruns, (int) missing);
+        }
+    }
+
+    o_unlock(self);
+    return ended;
+}
+
+osize STrackOggStream__v_duration(oobj obj)
+{
+    OObj_assert(obj, STrackOggStream);
+    STrackOggStream *self = obj;
+    return self->length;
+}
+
+
+//
+// object functions
+//
+
+void STrackOggStream_blocking_set(oobj obj, bool set)
+{
+    OObj_assert(obj, STrackOggStream);
+    STrackOggStream *self = obj;
+#ifdef MIA_OPTION_THREAD
+    // the worker skips blocking streams
+    SDL_LockMutex(STrackOggStream_L.decoding);
+#endif
+    o_lock(self);
+    self->blocking = set;
+    o_unlock(self);
+#ifdef MIA_OPTION_THREAD
+    SDL_UnlockMutex(STrackOggStream_L.decoding);
+#endif
+}
+
+osize STrackOggStream_underruns(oobj obj)
+{
+    OObj_assert(obj, STrackOggStream);
+    STrackOggStream *self = obj;
+    return SDL_AtomicGet(&self->ring->underruns);
+}
+
+osize STrackOggStream_buffered(oobj obj)
+{
+    OObj_assert(obj, STrackOggStream);
+    STrackOggStream *self = obj;
+    struct STrackOggStream__ring *ring = self->ring;
+    if (SDL_AtomicGet(&ring->seek)) {
+        return 0;
+    }
+    return SDL_AtomicGet(&ring->write) - SDL_AtomicGet(&ring->read);
+}
+
+osize STrackOggStream_memory(oobj obj)
+{
+    OObj_assert(obj, STrackOggStream);
+    STrackOggStream *self = obj;
+    stb_vorbis_info info = stb_vorbis_get_info(self->vorbis);
+    return o_num(self->data)
+           + s_audio_spec_buffer_size(self->super.spec, self->ring_ticks)
+           + (osize) info.setup_memory_required + (osize) info.temp_memory_required;
+}
+
+void STrackOggStream_seek(oobj obj, osize time_ticks, bool wait)
+{
+    OObj_assert(obj, STrackOggStream);
+    STrackOggStream *self = obj;
+
+    // a running decode may have read the last seek request already
+#ifdef MIA_OPTION_THREAD
+    SDL_LockMutex(STrackOggStream_L.decoding);
+#endif
+    o_lock(self);
+    request_seek(self, time_ticks);
+    o_unlock(self);
+#ifdef MIA_OPTION_THREAD
+    SDL_UnlockMutex(STrackOggStream_L.decoding);
+#endif
+
+    STrackOggStream_update(self);
+    if (wait) {
+        STrackOggStream_wait(self);
+    }
+}
+
+void STrackOggStream_update(oobj obj)
+{
+    OObj_assert(obj, STrackOggStream);
+    STrackOggStream *self = obj;
+
+    if (self->blocking || !needs_decode(self)) {
+        return;
+    }
+
+#ifdef MIA_OPTION_THREAD
+    worker_wake();
+#else
+    decode(self);
+#endif
+}
+
+void STrackOggStream_wait(oobj obj)
+{
+    OObj_assert(obj, STrackOggStream);
+#ifdef MIA_OPTION_THREAD
+    STrackOggStream *self = obj;
+    // excludes the worker and does its pending work for this stream here
+    SDL_LockMutex(STrackOggStream_L.decoding);
+    if (!self->blocking && needs_decode(self)) {
+        decode(self);
+    }
+    SDL_UnlockMutex(STrackOggStream_L.decoding);
+#endif
+}
@@ -3,14 +3,23 @@
 #include "o/ODelcallback.h"
 #include "o/OArray.h"
 #include "o/OWeakjoin.h"
+#include "o/parallel.h"
+#include "o/timer.h"
+#include "s/mix.h"
+#include "s/SResampler.h"
 #include "s/STrack.h"
 #include "s/STrackArray.h"
 #include <SDL2/SDL_audio.h>
+#include <SDL2/SDL_atomic.h>
+#include <stdlib.h>
 
 #define O_LOG_LIB "s"
 
 #include "o/log.h"
 
+// samples per chunk for o_parallel_for, so audio callback sized buffers are mixed inline
+#define MIX_PARALLEL_GRAIN 65536
+
 static struct {
     bool init;
     oobj root;
@@ -29,6 +38,16 @@ static struct {
     oobj track;
     osize track_time;
 
+    // instrumented mode, written by the audio thread, read approximately by s_audio_stats
+    SDL_atomic_t instrument;
+    struct {
+        float durations_ms[S_AUDIO_STATS_WINDOW];
+        osize callbacks;
+        osize overruns;
+        osize allocations;
+        double max_ms;
+    } stats;
+
 } common_L;
 
 
@@ -178,6 +197,78 @@ oobj s_audio_track(void)
     return common_L.track;
 }
 
+int s_audio_block_ticks(void)
+{
+    if (common_L.spec.samples > 0) {
+        return common_L.spec.samples;
+    }
+    return s_audio_spec_ex_default().samples;
+}
+
+void s_update(void)
+{
+    if (common_L.track) {
+        STrack_collect(common_L.track);
+    }
+
+    // protected in STrackOggStream.c
+    O_EXTERN
+    void STrackOggStream__update_all(void);
+    STrackOggStream__update_all();
+}
+
+void s_audio_instrument_set(bool set)
+{
+    if (set && !SDL_AtomicGet(&common_L.instrument)) {
+        o_clear(&common_L.stats, sizeof common_L.stats, 1);
+    }
+    SDL_AtomicSet(&common_L.instrument, set);
+}
+
+bool s_audio_instrument(void)
+{
+    return SDL_AtomicGet(&common_L.instrument) != 0;
+}
+
+O_STATIC
+int stats_cmp(const void *a, const void *b)
+{
+    float fa = *(const float *) a;
+    float fb = *(const float *) b;
+    return (fa > fb) - (fa < fb);
+}
+
+struct s_audio_stats s_audio_stats(void)
+{
+    struct s_audio_stats res = {0};
+    res.callbacks = common_L.stats.callbacks;
+    res.overruns = common_L.stats.overruns;
+    res.allocations = common_L.stats.allocations;
+    res.max_ms = common_L.stats.max_ms;
+    res.budget_ms = 1000.0 * s_audio_block_ticks() / common_L.spec.spec.freq;
+
+    int num = (int) o_min(res.callbacks, S_AUDIO_STATS_WINDOW);
+    if (num <= 0) {
+        return res;
+    }
+    float sorted[S_AUDIO_STATS_WINDOW];
+    o_memcpy(sorted, common_L.stats.durations_ms, sizeof(float), num);
+    qsort(sorted, num, sizeof(float), stats_cmp);
+    res.p50_ms = sorted[(num - 1) * 50 / 100];
+    res.p95_ms = sorted[(num - 1) * 95 / 100];
+    res.p99_ms = sorted[(num - 1) * 99 / 100];
+    return res;
+}
+
+void s_audio_stats_log(struct s_audio_stats stats)
+{
+    o_log_s("s_audio_stats",
+            "callbacks: %"osize_PRI", p50: %.3f ms, p95: %.3f ms, p99: %.3f ms, max: %.3f ms, "
+            "budget: %.3f ms, overruns: %"osize_PRI", allocations: %"osize_PRI,
+            stats.callbacks, stats.p50_ms, stats.p95_ms, stats.p99_ms, stats.max_ms,
+            stats.budget_ms, stats.overruns, stats.allocations);
+}
+
 
 void s_mic_device_open(void)
 {
@@ -280,15 +371,23 @@ osize s_play_keep(oobj track, double time_seconds, float amp)
     return STrack_play_keep(common_L.track, track, time_seconds, amp);
 }
 
+struct mix_into {
+    float *in_out_data;
+    const float *mix_data;
+    float mix_amp;
+};
+
+O_STATIC
+void mix_into_run(osize begin, osize end, void *user)
+{
+    struct mix_into *m = user;
+    s_mix_add(m->in_out_data + begin, m->mix_data + begin, m->mix_amp, end - begin);
+}
+
 void s_mix_into(float *restrict in_out_data, const float *restrict mix_data, float mix_amp, int channels, osize len)
 {
-    for (osize i = 0; i < channels * len; i++) {
-        float a = in_out_data[i];
-        float b = mix_data[i];
-        float mixed = a + b * mix_amp;
-        mixed = o_clamp(mixed, -1.0f, +1.0f);
-        in_out_data[i] = mixed;
-    }
+    struct mix_into m = {in_out_data, mix_data, mix_amp};
+    o_parallel_for(NULL, channels * len, MIX_PARALLEL_GRAIN, mix_into_run, &m);
 }
 
 void s_resample(struct s_audio_spec dst_spec, struct s_audio_spec src_spec,
@@ -300,37 +399,23 @@ void s_resample(struct s_audio_spec dst_spec, struct s_audio_spec src_spec,
         return;
     }
 
-    // Check if conversion is needed
-    SDL_AudioCVT cvt;
-    int build_res;
-    build_res = SDL_BuildAudioCVT(&cvt, AUDIO_F32, src_spec.channels, src_spec.freq,
-                                  AUDIO_F32, dst_spec.channels, dst_spec.freq);
-
-    if (build_res < 0) {
-        o_log_error_s(__func__, "Failed to build audio CVT: %s", SDL_GetError());
+    osize dst_len = s_resample_dst_ticks(dst_spec, src_spec, src_len);
+    if (dst_len <= 0) {
         return;
     }
 
-    // Allocate buffer for conversion
-    cvt.len = src_len * src_spec.channels * (osize) sizeof(float);
-    cvt.buf = o_alloc(common_L.root, 1, cvt.len * cvt.len_mult);
-
-    // Copy the source audio data into the conversion buffer
-    o_memcpy(cvt.buf, src, 1, cvt.len);
+    oobj container = OObj_new(common_L.root);
+    SResampler *resampler = SResampler_new(container, dst_spec, src_spec, SResampler_QUALITY_DEFAULT);
+    osize src_time;
+    osize len = SResampler_src_ticks(resampler, dst_len, 0, &src_time);
 
-    // Perform the audio conversion
-    if (SDL_ConvertAudio(&cvt) < 0) {
-        o_log_error_s(__func__, "Failed to convert audio: %s", SDL_GetError());
-        goto CLEAN_UP;
-    }
+    // the filter reaches a few ticks over the end, padded with silence
+    float *padded = o_new0(container, float, s_audio_spec_array_size(src_spec, len));
+    o_memcpy(padded, src + s_audio_spec_array_size(src_spec, src_time), sizeof(float),
+             s_audio_spec_array_size(src_spec, o_clamp(src_len - src_time, 0, len)));
+    SResampler_run(resampler, out_dst, dst_len, 0, padded, len);
 
-    // Calculate destination length and copy the converted audio data to the destination buffer
-    osize dst_len = s_resample_dst_ticks(dst_spec, src_spec, src_len);
-    o_memcpy(out_dst, cvt.buf, sizeof(float), dst_len * dst_spec.channels);
-
-    CLEAN_UP:
-    // Free the conversion buffer
-    o_free(common_L.root, cvt.buf);
+    o_del(container);
 }
 
 
@@ -339,8 +424,28 @@ void audio_callback(void *userdata, Uint8 *stream, int stream_bytes)
 {
     float *data = (float *) stream;
     osize len = (osize) stream_bytes / (osize) (common_L.spec.spec.channels * sizeof(float));
+
+    if (!SDL_AtomicGet(&common_L.instrument)) {
+        STrack_retr(common_L.track, data, len, common_L.track_time, NULL);
+        s_mix_limit(data, len * common_L.spec.spec.channels);
+        common_L.track_time += len;
+        return;
+    }
+
+    osize allocations = o_allocator_thread_calls();
+    ou64 start = o_timer();
     STrack_retr(common_L.track, data, len, common_L.track_time, NULL);
+    s_mix_limit(data, len * common_L.spec.spec.channels);
+    double ms = o_timer_elapsed_s(start) * 1000.0;
     common_L.track_time += len;
+
+    common_L.stats.durations_ms[common_L.stats.callbacks % S_AUDIO_STATS_WINDOW] = (float) ms;
+    common_L.stats.callbacks++;
+    common_L.stats.allocations += o_allocator_thread_calls() - allocations;
+    common_L.stats.max_ms = o_max(common_L.stats.max_ms, ms);
+    if (ms > 1000.0 * (double) len / common_L.spec.spec.freq) {
+        common_L.stats.overruns++;
+    }
 }
 
 
@@ -360,29 +465,20 @@ void mic_callback(void *userdata, Uint8 *stream, int stream_bytes)
 
     o_lock(common_L.mic_tracks);
 
-    osize mt_num = o_num(common_L.mic_tracks);
-    bool *mt_del = o_new0(common_L.mic_tracks, bool, mt_num);
-    for (osize i = 0; i < mt_num; i++) {
+    // back to front, so popping does not invalidate the indices
+    for (osize i = o_num(common_L.mic_tracks) - 1; i >= 0; i--) {
         oobj *weak = o_at(common_L.mic_tracks, i);
         struct oobj_opt track = OWeakjoin_acquire(*weak);
         if (track.o) {
             mic_callback_track_push(track.o, data, len);
+            OWeakjoin_release(*weak);
         } else {
-            mt_del[i] = true;
-        }
-        OWeakjoin_release(*weak);
-    }
-
-    // back to front, so the indices are not invalidated
-    for (osize i = mt_num - 1; i >= 0; i--) {
-        if (mt_del[i]) {
-            oobj weak;
-            OArray_pop_at(common_L.mic_tracks, i, &weak);
-            o_del(weak);
+            OWeakjoin_release(*weak);
+            oobj dead;
+            OArray_pop_at(common_L.mic_tracks, i, &dead);
+            o_del(dead);
         }
     }
-    o_free(common_L.mic_tracks, mt_del);
-
 
     o_unlock(common_L.mic_tracks);
 }
@@ -0,0 +1,165 @@
+#include "s/mix.h"
+#include "simd.h"
+
+
+// lane gains of the first 4 floats and their increment per 4 floats.
+// only possible if the 4 lanes hold whole ticks (mono, stereo, quad)
+O_STATIC
+bool ramp_lanes(float gain, float step, int channels, float *out_lanes, float *out_inc)
+{
+    if (channels <= 0 || 4 % channels != 0) {
+        return false;
+    }
+    for (int l = 0; l < 4; l++) {
+        out_lanes[l] = gain + step * (float) (l / channels);
+    }
+    *out_inc = step * (float) (4 / channels);
+    return true;
+}
+
+void s_mix_add(float *restrict bus, const float *restrict src, float gain, osize num)
+{
+    osize i = 0;
+#if defined(SIMD_SSE)
+    __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= num; i += 4) {
+        __m128 b = _mm_loadu_ps(bus + i);
+        _mm_storeu_ps(bus + i, _mm_add_ps(b, _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+    }
+#elif defined(SIMD_NEON)
+    float32x4_t g = vdupq_n_f32(gain);
+    for (; i + 4 <= num; i += 4) {
+        vst1q_f32(bus + i, vmlaq_f32(vld1q_f32(bus + i), vld1q_f32(src + i), g));
+    }
+#endif
+    for (; i < num; i++) {
+        bus[i] += src[i] * gain;
+    }
+}
+
+void s_mix_add_ramp(float *restrict bus, const float *restrict src, float gain, float step, int channels, osize len)
+{
+    osize num = len * channels;
+    osize i = 0;
+#if defined(SIMD_SSE) || defined(SIMD_NEON)
+    float lanes[4], inc;
+    if (ramp_lanes(gain, step, channels, lanes, &inc)) {
+#if defined(SIMD_SSE)
+        __m128 g = _mm_loadu_ps(lanes);
+        __m128 d = _mm_set1_ps(inc);
+        for (; i + 4 <= num; i += 4) {
+            __m128 b = _mm_loadu_ps(bus + i);
+            _mm_storeu_ps(bus + i, _mm_add_ps(b, _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+            g = _mm_add_ps(g, d);
+        }
+#else
+        float32x4_t g = vld1q_f32(lanes);
+        float32x4_t d = vdupq_n_f32(inc);
+        for (; i + 4 <= num; i += 4) {
+            vst1q_f32(bus + i, vmlaq_f32(vld1q_f32(bus + i), vld1q_f32(src + i), g));
+            g = vaddq_f32(g, d);
+        }
+#endif
+    }
+#endif
+    for (; i < num; i++) {
+        bus[i] += src[i] * (gain + step * (float) (i / channels));
+    }
+}
+
+void s_mix_gain(float *data, float gain, osize num)
+{
+    if (gain == 1.0f) {
+        return;
+    }
+    osize i = 0;
+#if defined(SIMD_SSE)
+    __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= num; i += 4) {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), g));
+    }
+#elif defined(SIMD_NEON)
+    float32x4_t g = vdupq_n_f32(gain);
+    for (; i + 4 <= num; i += 4) {
+        vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), g));
+    }
+#endif
+    for (; i < num; i++) {
+        data[i] *= gain;
+    }
+}
+
+void s_mix_gain_ramp(float *data, float gain, float step, int channels, osize len)
+{
+    osize num = len * channels;
+    osize i = 0;
+#if defined(SIMD_SSE) || defined(SIMD_NEON)
+    float lanes[4], inc;
+    if (ramp_lanes(gain, step, channels, lanes, &inc)) {
+#if defined(SIMD_SSE)
+        __m128 g = _mm_loadu_ps(lanes);
+        __m128 d = _mm_set1_ps(inc);
+        for (; i + 4 <= num; i += 4) {
+            _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), g));
+            g = _mm_add_ps(g, d);
+        }
+#else
+        float32x4_t g = vld1q_f32(lanes);
+        float32x4_t d = vdupq_n_f32(inc);
+        for (; i + 4 <= num; i += 4) {
+            vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), g));
+            g = vaddq_f32(g, d);
+        }
+#endif
+    }
+#endif
+    for (; i < num; i++) {
+        data[i] *= gain + step * (float) (i / channels);
+    }
+}
+
+void s_mix_limit(float *data, osize num)
+{
+    // |y| = min(|x|, knee) + range * over / (range + over), with over = max(|x| - knee, 0)
+    // continuous in value and slope at the knee, approaches 1.0 for loud input
+    const float knee = S_MIX_LIMIT_KNEE;
+    const float range = 1.0f - S_MIX_LIMIT_KNEE;
+    osize i = 0;
+#if defined(SIMD_SSE)
+    __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 k = _mm_set1_ps(knee);
+    __m128 r = _mm_set1_ps(range);
+    __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= num; i += 4) {
+        __m128 x = _mm_loadu_ps(data + i);
+        __m128 a = _mm_andnot_ps(sign, x);
+        __m128 over = _mm_max_ps(_mm_sub_ps(a, k), zero);
+        __m128 y = _mm_add_ps(_mm_min_ps(a, k), _mm_div_ps(_mm_mul_ps(r, over), _mm_add_ps(r, over)));
+        _mm_storeu_ps(data + i, _mm_or_ps(y, _mm_and_ps(sign, x)));
+    }
+#elif defined(SIMD_NEON)
+    float32x4_t k = vdupq_n_f32(knee);
+    float32x4_t r = vdupq_n_f32(range);
+    float32x4_t zero = vdupq_n_f32(0.0f);
+    for (; i + 4 <= num; i += 4) {
+        float32x4_t x = vld1q_f32(data + i);
+        float32x4_t a = vabsq_f32(x);
+        float32x4_t over = vmaxq_f32(vsubq_f32(a, k), zero);
+        float32x4_t den = vaddq_f32(r, over);
+        // reciprocal estimate with two newton steps, vdivq_f32 is aarch64 only
+        float32x4_t inv = vrecpeq_f32(den);
+        inv = vmulq_f32(vrecpsq_f32(den, inv), inv);
+        inv = vmulq_f32(vrecpsq_f32(den, inv), inv);
+        float32x4_t y = vaddq_f32(vminq_f32(a, k), vmulq_f32(vmulq_f32(r, over), inv));
+        uint32x4_t neg = vcltq_f32(x, zero);
+        vst1q_f32(data + i, vbslq_f32(neg, vnegq_f32(y), y));
+    }
+#endif
+    for (; i < num; i++) {
+        float x = data[i];
+        float a = x < 0.0f ? -x : x;
+        float over = o_max(a - knee, 0.0f);
+        float y = o_min(a, knee) + range * over / (range + over);
+        data[i] = x < 0.0f ? -y : y;
+    }
+}
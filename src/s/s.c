@@ -2,12 +2,15 @@
 
 #include "common.c"
 #include "ext_stb_vorbis.c"
+#include "mix.c"
 #include "ogg.c"
 #include "SFilter.c"
 #include "SFilterFade.c"
+#include "SResampler.c"
 #include "STrack.c"
 #include "STrackArena.c"
 #include "STrackArray.c"
+#include "STrackOggStream.c"
 #include "wav.c"
 
 #endif
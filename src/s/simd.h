@@ -0,0 +1,14 @@
+#ifndef S_SIMD_H
+#define S_SIMD_H
+
+// private header of the "s" library, selects the SIMD instruction set for the dsp kernels
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SIMD_SSE
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SIMD_NEON
+#endif
+
+#endif //S_SIMD_H
@@ -7,12 +7,252 @@
 #include "u/color.h"
 #include "u/atlas.h"
 #include "u/pose.h"
+#include "o/parallel.h"
+#include "r/RTexLoader.h"
 
 #define O_LOG_LIB "u"
 
 #include "o/log.h"
 
 
+// pixels per chunk for o_parallel_*, smaller images are processed inline
+#define PARALLEL_GRAIN 16384
+
+struct pixel_op {
+    UImg *self;
+    UImg *other;
+    vec4 add, scale;
+    obyte value[R_FORMAT_MAX_SIZE];
+    ivec2 offset;
+};
+
+O_STATIC
+void clear_run(osize begin, osize end, void *user)
+{
+    struct pixel_op *op = user;
+    for (osize i = begin; i < end; i++) {
+        r_format_pixel_copy(UImg_at_idx(op->self, i), op->value, op->self->format);
+    }
+}
+
+O_STATIC
+void min_run(osize begin, osize end, void *inout_partial, void *user)
+{
+    struct pixel_op *op = user;
+    vec4 *value = inout_partial;
+    for (osize i = begin; i < end; i++) {
+        vec4 c = r_format_value_as_vec4(UImg_at_idx(op->self, i), op->self->format);
+        *value = vec4_min_v(*value, c);
+    }
+}
+
+O_STATIC
+void min_join(void *inout_result, const void *partial, void *user)
+{
+    vec4 *value = inout_result;
+    *value = vec4_min_v(*value, *(const vec4 *) partial);
+}
+
+O_STATIC
+void max_run(osize begin, osize end, void *inout_partial, void *user)
+{
+    struct pixel_op *op = user;
+    vec4 *value = inout_partial;
+    for (osize i = begin; i < end; i++) {
+        vec4 c = r_format_value_as_vec4(UImg_at_idx(op->self, i), op->self->format);
+        *value = vec4_max_v(*value, c);
+    }
+}
+
+O_STATIC
+void max_join(void *inout_result, const void *partial, void *user)
+{
+    vec4 *value = inout_result;
+    *value = vec4_max_v(*value, *(const vec4 *) partial);
+}
+
+O_STATIC
+void add_scaled_run(osize begin, osize end, void *user)
+{
+    struct pixel_op *op = user;
+    for (osize i = begin; i < end; i++) {
+        void *data = UImg_at_idx(op->self, i);
+        vec4 c = r_format_value_as_vec4(data, op->self->format);
+        c = vec4_add_v(c, op->add);
+        c = vec4_scale_v(c, op->scale);
+        c = vec4_clamp(c, 0, 1);
+        r_format_value_from_vec4(data, op->self->format, c);
+    }
+}
+
+O_STATIC
+void blit_lb_run(osize begin, osize end, void *user)
+{
+    struct pixel_op *op = user;
+    UImg *self = op->self;
+    UImg *blit = op->other;
+    for (int r = (int) begin; r < (int) end; r++) {
+        int dst_r = r + op->offset.v1;
+        if (dst_r < 0 || dst_r >= self->size.y) {
+            continue;
+        }
+        for (int c = 0; c < blit->size.x; c++) {
+            int dst_c = c + op->offset.v0;
+            if (dst_c < 0 || dst_c >= self->size.x) {
+                continue;
+            }
+
+            r_format_pixel_copy(UImg_at(self, dst_c, dst_r), UImg_at(blit, c, r), self->format);
+        }
+    }
+}
+
+O_STATIC
+void cast_run(osize begin, osize end, void *user)
+{
+    struct pixel_op *op = user;
+    UImg *res = op->self;
+    UImg *src = op->other;
+    for (osize i = begin; i < end; i++) {
+        r_format_value_cast(UImg_at_idx(res, i), res->format, UImg_at_idx(src, i), src->format);
+    }
+}
+
+// city block distance, separable into row passes and column passes
+O_STATIC
+void distance_rows_run(osize begin, osize end, void *user)
+{
+    struct pixel_op *op = user;
+    UImg *res = op->self;
+    int cols = res->size.x;
+    for (int r = (int) begin; r < (int) end; r++) {
+        obyte *row = UImg_at(res, 0, r);
+        // left -> right, outside is 0
+        int prev = 0;
+        for (int c = 0; c < cols; c++) {
+            prev = o_min(row[c], prev + 1);
+            row[c] = (obyte) prev;
+        }
+        // right -> left
+        prev = 0;
+        for (int c = cols - 1; c >= 0; c--) {
+            prev = o_min(row[c], prev + 1);
+            row[c] = (obyte) prev;
+        }
+    }
+}
+
+O_STATIC
+void distance_cols_run(osize begin, osize end, void *user)
+{
+    struct pixel_op *op = user;
+    UImg *res = op->self;
+    int cols = res->size.x;
+    int rows = res->size.y;
+    obyte *data = UImg_data(res);
+    // column bands, so each row access stays in a cache line
+    for (int r = 0; r < rows; r++) {
+        obyte *row = data + (osize) r * cols;
+        const obyte *down = r == 0 ? NULL : row - cols;
+        for (int c = (int) begin; c < (int) end; c++) {
+            int value = (down ? down[c] : 0) + 1;
+            row[c] = (obyte) o_min(row[c], value);
+        }
+    }
+    for (int r = rows - 1; r >= 0; r--) {
+        obyte *row = data + (osize) r * cols;
+        const obyte *up = r == rows - 1 ? NULL : row + cols;
+        for (int c = (int) begin; c < (int) end; c++) {
+            int value = (up ? up[c] : 0) + 1;
+            row[c] = (obyte) o_min(row[c], value);
+        }
+    }
+}
+
+struct blur_op {
+    const vec4 *src;
+    vec4 *dst;
+    ivec2 size;
+    bool vertical;
+    int n;
+    // NULL for a box blur
+    const float *opt_weights;
+};
+
+// filters a single row or column of the vec4 buffer, clamped to the edge
+O_STATIC
+void blur_line(const struct blur_op *op, int line)
+{
+    int len = op->vertical ? op->size.y : op->size.x;
+    osize stride = op->vertical ? op->size.x : 1;
+    osize start = op->vertical ? line : (osize) line * op->size.x;
+    const vec4 *src = op->src + start;
+    vec4 *dst = op->dst + start;
+    int half = op->n / 2;
+
+    if (op->opt_weights) {
+        for (int p = 0; p < len; p++) {
+            vec4 sum = vec4_(0);
+            for (int i = 0; i < op->n; i++) {
+                int k = o_clamp(p - half + i, 0, len - 1);
+                sum = vec4_add_scaled(sum, src[k * stride], op->opt_weights[i]);
+            }
+            dst[p * stride] = sum;
+        }
+        return;
+    }
+
+    // running sum: add the entering, remove the leaving pixel
+    vec4 sum = vec4_(0);
+    for (int i = 0; i < op->n; i++) {
+        sum = vec4_add_v(sum, src[o_clamp(i - half, 0, len - 1) * stride]);
+    }
+    float scale = 1.0f / (float) op->n;
+    for (int p = 0; p < len; p++) {
+        dst[p * stride] = vec4_scale(sum, scale);
+        int enter = o_clamp(p - half + op->n, 0, len - 1);
+        int leave = o_clamp(p - half, 0, len - 1);
+        sum = vec4_add_v(sum, vec4_sub_v(src[enter * stride], src[leave * stride]));
+    }
+}
+
+O_STATIC
+void blur_lines_run(osize begin, osize end, void *user)
+{
+    const struct blur_op *op = user;
+    for (osize line = begin; line < end; line++) {
+        blur_line(op, (int) line);
+    }
+}
+
+// separable, into a vec4 buffer to avoid rounding between the passes
+O_STATIC
+UImg *blur_sep(UImg *self, ivec2 n, const float *opt_weights_h, const float *opt_weights_v)
+{
+    osize num = UImg_num(self);
+    if (num <= 0) {
+        return UImg_new(self, NULL, m_2(self->size), self->format);
+    }
+    vec4 *a = o_new(self, vec4, num);
+    vec4 *b = o_new(self, vec4, num);
+    for (osize i = 0; i < num; i++) {
+        a[i] = r_format_value_as_vec4(UImg_at_idx(self, i), self->format);
+    }
+
+    struct blur_op op = {a, b, self->size, false, n.x, opt_weights_h};
+    o_parallel_for(NULL, self->size.y, o_max(1, PARALLEL_GRAIN / self->size.x), blur_lines_run, &op);
+    op = (struct blur_op) {b, a, self->size, true, n.y, opt_weights_v};
+    o_parallel_for(NULL, self->size.x, o_max(1, PARALLEL_GRAIN / self->size.y), blur_lines_run, &op);
+
+    UImg *res = UImg_new(self, NULL, m_2(self->size), self->format);
+    for (osize i = 0; i < num; i++) {
+        r_format_value_from_vec4(UImg_at_idx(res, i), res->format, a[i]);
+    }
+    o_free(self, a);
+    o_free(self, b);
+    return res;
+}
+
 
 //
 // public
@@ -71,6 +311,24 @@ struct oobj_opt UImg_new_file(oobj parent, const char* file)
     return oobj_opt(self);
 }
 
+O_STATIC
+void file_async_loaded(oobj target, struct o_img *img)
+{
+    UImg *self = target;
+    // img is allocated on the loader, which may use another allocator
+    o_free(self, self->data);
+    self->size = ivec2_(img->cols, img->rows);
+    self->data = o_new(self, obyte, o_img_data_size(*img));
+    memcpy(self->data, img->rgba_data, o_img_data_size(*img));
+}
+
+UImg *UImg_new_file_async(oobj parent, const char *file)
+{
+    UImg *self = UImg_new(parent, NULL, 0, 0, R_FORMAT_RGBA_8);
+    RTexLoader_load_img(RTexLoader_default(), self, file, file_async_loaded);
+    return self;
+}
+
 struct oobj_opt UImg_new_tex(oobj parent, oobj tex, enum r_format format)
 {
     ivec2 size = RTex_size_int(tex);
@@ -134,24 +392,18 @@ void UImg_clear(oobj obj, vec4 clear_color)
 {
     OObj_assert(obj, UImg);
     UImg *self = obj;
-    obyte clear_data[R_FORMAT_MAX_SIZE];
-    r_format_value_from_vec4(clear_data, self->format, clear_color);
-
-    for (osize i = 0; i < UImg_num(self); i++) {
-        r_format_pixel_copy(UImg_at_idx(self, i), clear_data, self->format);
-    }
+    struct pixel_op op = {.self = self};
+    r_format_value_from_vec4(op.value, self->format, clear_color);
+    o_parallel_for(NULL, UImg_num(self), PARALLEL_GRAIN, clear_run, &op);
 }
 
 vec4 UImg_min(oobj obj)
 {
     OObj_assert(obj, UImg);
     UImg *self = obj;
+    struct pixel_op op = {.self = self};
     vec4 value = vec4_(m_MAX);
-    for (osize i = 0; i < UImg_num(self); i++) {
-        void *data = UImg_at_idx(self, i);
-        vec4 c = r_format_value_as_vec4(data, self->format);
-        value = vec4_min_v(value, c);
-    }
+    o_parallel_reduce(NULL, UImg_num(self), PARALLEL_GRAIN, &value, sizeof value, min_run, min_join, &op);
     return value;
 }
 
@@ -160,53 +412,28 @@ vec4 UImg_max(oobj obj)
 {
     OObj_assert(obj, UImg);
     UImg *self = obj;
+    struct pixel_op op = {.self = self};
     vec4 value = vec4_(m_MIN);
-    for (osize i = 0; i < UImg_num(self); i++) {
-        void *data = UImg_at_idx(self, i);
-        vec4 c = r_format_value_as_vec4(data, self->format);
-        value = vec4_max_v(value, c);
-    }
+    o_parallel_reduce(NULL, UImg_num(self), PARALLEL_GRAIN, &value, sizeof value, max_run, max_join, &op);
     return value;
 }
 
 void UImg_add(oobj obj, vec4 add)
 {
-    OObj_assert(obj, UImg);
-    UImg *self = obj;
-    for (osize i = 0; i < UImg_num(self); i++) {
-        void *data = UImg_at_idx(self, i);
-        vec4 c = r_format_value_as_vec4(data, self->format);
-        c = vec4_add_v(c, add);
-        c = vec4_clamp(c, 0, 1);
-        r_format_value_from_vec4(data, self->format, c);
-    }
+    UImg_add_scaled(obj, add, vec4_(1));
 }
 
 void UImg_scale(oobj obj, vec4 scale)
 {
-    OObj_assert(obj, UImg);
-    UImg *self = obj;
-    for (osize i = 0; i < UImg_num(self); i++) {
-        void *data = UImg_at_idx(self, i);
-        vec4 c = r_format_value_as_vec4(data, self->format);
-        c = vec4_scale_v(c, scale);
-        c = vec4_clamp(c, 0, 1);
-        r_format_value_from_vec4(data, self->format, c);
-    }
+    UImg_add_scaled(obj, vec4_(0), scale);
 }
 
 void UImg_add_scaled(oobj obj, vec4 add, vec4 scale)
 {
     OObj_assert(obj, UImg);
     UImg *self = obj;
-    for (osize i = 0; i < UImg_num(self); i++) {
-        void *data = UImg_at_idx(self, i);
-        vec4 c = r_format_value_as_vec4(data, self->format);
-        c = vec4_add_v(c, add);
-        c = vec4_scale_v(c, scale);
-        c = vec4_clamp(c, 0, 1);
-        r_format_value_from_vec4(data, self->format, c);
-    }
+    struct pixel_op op = {.self = self, .add = add, .scale = scale};
+    o_parallel_for(NULL, UImg_num(self), PARALLEL_GRAIN, add_scaled_run, &op);
 }
 
 void UImg_normalize(oobj obj)
@@ -227,26 +454,18 @@ void UImg_blit_lb(oobj obj, oobj img, ivec2 offset_lb)
     UImg *blit = img;
     UImg *tmp = NULL;
 
+    if (UImg_num(blit) <= 0 || UImg_num(self) <= 0) {
+        return;
+    }
+
     if (blit->format != self->format) {
         tmp = UImg_cast(blit, self->format);
         o_move(tmp, obj);
         blit = tmp;
     }
 
-    for (int r = 0; r < blit->size.y; r++) {
-        int dst_r = r + offset_lb.v1;
-        if (dst_r < 0 || dst_r >= self->size.y) {
-            continue;
-        }
-        for (int c = 0; c < blit->size.x; c++) {
-            int dst_c = c + offset_lb.v0;
-            if (dst_c < 0 || dst_c >= self->size.x) {
-                continue;
-            }
-
-            r_format_pixel_copy(UImg_at(self, dst_c, dst_r), UImg_at(blit, c, r), self->format);
-        }
-    }
+    struct pixel_op op = {.self = self, .other = blit, .offset = offset_lb};
+    o_parallel_for(NULL, blit->size.y, o_max(1, PARALLEL_GRAIN / blit->size.x), blit_lb_run, &op);
 
     o_del(tmp);
 }
@@ -270,9 +489,8 @@ UImg *UImg_cast(oobj obj, enum r_format format)
         return UImg_clone(obj);
     }
     UImg *res = UImg_new(obj, NULL, m_2(self->size), format);
-    for (osize i = 0; i < UImg_num(self); i++) {
-        r_format_value_cast(UImg_at_idx(res, i), res->format, UImg_at_idx(self, i), self->format);
-    }
+    struct pixel_op op = {.self = res, .other = self};
+    o_parallel_for(NULL, UImg_num(self), PARALLEL_GRAIN, cast_run, &op);
     return res;
 }
 
@@ -460,31 +678,19 @@ UImg *UImg_collage(const oobj *srcs, int n,
 UImg *UImg_distance_transform(oobj obj, bool full)
 {
     UImg *res = UImg_cast(obj, R_FORMAT_R_8);
+    if (UImg_num(res) <= 0) {
+        return res;
+    }
 
     if (!full) {
-        // first pass, left bottom -> right top
-        for (int r = 0; r < res->size.y; r++) {
-            for (int c = 0; c < res->size.x; c++) {
-                obyte down = r == 0 ? 0 : *(obyte *) UImg_at(res, c, r - 1);
-                obyte left = c == 0 ? 0 : *(obyte *) UImg_at(res, c - 1, r);
-                obyte *set = (obyte *) UImg_at(res, c, r);
-                obyte value = o_min(down, left) + 1;
-                *set = o_min(*set, value);
-            }
-        }
-
-        // second pass, right top -> left bottom
-        for (int r = res->size.y - 1; r >= 0; r--) {
-            for (int c = res->size.x - 1; c >= 0; c--) {
-                obyte up = r == res->size.y - 1 ? 0 : *(obyte *) UImg_at(res, c, r + 1);
-                obyte right = c == res->size.x - 1 ? 0 : *(obyte *) UImg_at(res, c + 1, r);
-                obyte *set = (obyte *) UImg_at(res, c, r);
-                obyte value = o_min(up, right) + 1;
-                *set = o_min(*set, value);
-            }
-        }
+        // city block distance is separable, so rows and column bands run in parallel
+        // saturates at 255 (the former two pass chamfer wrapped around to 0)
+        struct pixel_op op = {.self = res};
+        o_parallel_for(NULL, res->size.y, o_max(1, PARALLEL_GRAIN / res->size.x), distance_rows_run, &op);
+        o_parallel_for(NULL, res->size.x, o_max(64, PARALLEL_GRAIN / res->size.y), distance_cols_run, &op);
     } else {
         // full:
+        // chessboard distance is not separable, so stays sequential
 
         // first pass, left bottom -> right top
         for (int r = 0; r < res->size.y; r++) {
@@ -518,3 +724,27 @@ UImg *UImg_distance_transform(oobj obj, bool full)
 }
 
 
+UImg *UImg_blur(oobj obj, ivec2 size)
+{
+    OObj_assert(obj, UImg);
+    UImg *self = obj;
+    assert(size.x > 0 && size.y > 0);
+    return blur_sep(self, size, NULL, NULL);
+}
+
+UImg *UImg_gauss(oobj obj, ivec2 size, vec2 sigma)
+{
+    OObj_assert(obj, UImg);
+    UImg *self = obj;
+    assert(size.x > 0 && size.y > 0);
+    float *weights_h = o_new(self, float, size.x);
+    float *weights_v = o_new(self, float, size.y);
+    RTex_kernel_gauss_weights(weights_h, size.x, sigma.x);
+    RTex_kernel_gauss_weights(weights_v, size.y, sigma.y);
+    UImg *res = blur_sep(self, size, weights_h, weights_v);
+    o_free(self, weights_h);
+    o_free(self, weights_v);
+    return res;
+}
+
+
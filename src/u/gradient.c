@@ -1,70 +1,73 @@
 #include "u/gradient.h"
+#include "o/parallel.h"
 #include "m/vec/bvec4.h"
 #include "m/types/flt.h"
 #include "m/utils/color.h"
 
-void u_gradient_hue(bvec4 *rgba_data, int size)
+// pixels per chunk for o_parallel_for, usual gradient sizes are filled inline
+#define GRADIENT_PARALLEL_GRAIN 4096
+
+struct gradient {
+    bvec4 *rgba_data;
+    int size;
+    // base color, with channel set to the gradient position
+    vec4 base;
+    int channel;
+    bool hsv;
+};
+
+O_STATIC
+void gradient_run(osize begin, osize end, void *user)
 {
-    for(int i=0; i<size; i++) {
-        float hue = (float) i / (float) size;
-        vec4 hsva = {{hue, 1, 1, 1}};
-        vec4 rgba = vec4_hsv2rgb(hsva);
-        rgba_data[i] = bvec4_cast_float_1(rgba.v);
+    struct gradient *g = user;
+    for(osize i=begin; i<end; i++) {
+        vec4 color = g->base;
+        color.v[g->channel] = (float) i / (float) g->size;
+        if(g->hsv) {
+            color = vec4_hsv2rgb(color);
+        }
+        g->rgba_data[i] = bvec4_cast_float_1(color.v);
     }
 }
 
+O_STATIC
+void gradient_fill(bvec4 *rgba_data, int size, vec4 base, int channel, bool hsv)
+{
+    struct gradient g = {rgba_data, size, base, channel, hsv};
+    o_parallel_for(NULL, size, GRADIENT_PARALLEL_GRAIN, gradient_run, &g);
+}
+
+void u_gradient_hue(bvec4 *rgba_data, int size)
+{
+    gradient_fill(rgba_data, size, vec4_(0, 1, 1, 1), 0, true);
+}
+
 void u_gradient_sat(bvec4 *rgba_data, int size, float hue)
 {
-    for(int i=0; i<size; i++) {
-        float sat = (float) i / (float) size;
-        vec4 hsva = {{hue, sat, 1, 1}};
-        vec4 rgba = vec4_hsv2rgb(hsva);
-        rgba_data[i] = bvec4_cast_float_1(rgba.v);
-    }
+    gradient_fill(rgba_data, size, vec4_(hue, 0, 1, 1), 1, true);
 }
 
 void u_gradient_val(bvec4 *rgba_data, int size, float hue, float sat)
 {
-    for(int i=0; i<size; i++) {
-        float val = (float) i / (float) size;
-        vec4 hsva = {{hue, sat, val, 1}};
-        vec4 rgba = vec4_hsv2rgb(hsva);
-        rgba_data[i] = bvec4_cast_float_1(rgba.v);
-    }
+    gradient_fill(rgba_data, size, vec4_(hue, sat, 0, 1), 2, true);
 }
 
 void u_gradient_red(bvec4 *rgba_data, int size, float green, float blue)
 {
-    for(int i=0; i<size; i++) {
-        float red = (float) i / (float) size;
-        vec4 rgba = vec4_(red, green, blue, 1);
-        rgba_data[i] = bvec4_cast_float_1(rgba.v);
-    }
+    gradient_fill(rgba_data, size, vec4_(0, green, blue, 1), 0, false);
 }
 
 void u_gradient_green(bvec4 *rgba_data, int size, float red, float blue)
 {
-    for(int i=0; i<size; i++) {
-        float green = (float) i / (float) size;
-        vec4 rgba = vec4_(red, green, blue, 1);
-        rgba_data[i] = bvec4_cast_float_1(rgba.v);
-    }
+    gradient_fill(rgba_data, size, vec4_(red, 0, blue, 1), 1, false);
 }
 
 void u_gradient_blue(bvec4 *rgba_data, int size, float red, float green)
 {
-    for(int i=0; i<size; i++) {
-        float blue = (float) i / (float) size;
-        vec4 rgba = vec4_(red, green, blue, 1);
-        rgba_data[i] = bvec4_cast_float_1(rgba.v);
-    }
+    gradient_fill(rgba_data, size, vec4_(red, green, 0, 1), 2, false);
 }
 
 void u_gradient_alpha(bvec4 *rgba_data, int size, float red, float green, float blue)
 {
-    for(int i=0; i<size; i++) {
-        float alpha = (float) i / (float) size;
-        vec4 rgba = vec4_(red, green, blue, alpha);
-        rgba_data[i] = bvec4_cast_float_1(rgba.v);
-    }
+    gradient_fill(rgba_data, size, vec4_(red, green, blue, 0), 3, false);
 }
@@ -1,8 +1,10 @@
 #include "u/splash.h"
 #include "o/OArray.h"
 #include "o/str.h"
+#include "r/RObjQuad.h"
 #include "r/RObjText.h"
 #include "r/RTex.h"
+#include "r/RTexLoader.h"
 #include "a/app.h"
 #include "a/ADefer.h"
 #include "a/AView.h"
@@ -14,6 +16,11 @@
 
 #define SPLASH_INJECT "u_splash_context"
 
+// size of the loading progress bar in units
+#define MIA_BAR_WIDTH 96.0f
+#define MIA_BAR_HEIGHT 2.0f
+#define MIA_BAR_Y -24.0f
+
 struct splash_context {
     oobj splash_scene;
 
@@ -111,6 +118,7 @@ struct mia_splash_context {
     float min_time;
     float fade_time;
     oobj ro;
+    oobj bar_ro;
 };
 
 O_STATIC
@@ -125,6 +133,8 @@ void mia_splash_setup(oobj view)
 
     // w and h == 2 -> default
     RObjText_pose_set(C->ro, u_pose_new(-size.x, 0, 4, 4));
+
+    C->bar_ro = RObjQuad_new_color(view, 1, NULL, false);
 }
 
 O_STATIC
@@ -140,8 +150,13 @@ void mia_splash_render(oobj view, oobj tex, float dt)
     struct mia_splash_context *C = o_user(view);
     vec4 bg_color = C->bg_color;
     vec4 text_color = C->text_color;
+    bool loading = !RTexLoader_idle(RTexLoader_default());
     if(C->time<C->min_time) {
         C->time+=dt;
+        if(loading) {
+            // keep showing (without fading) until the background loader has finished
+            C->time = o_min(C->time, C->min_time - C->fade_time);
+        }
         if(C->time>=C->min_time) {
             a_app_scene_exit(a_app_scene_index());
         }
@@ -157,6 +172,14 @@ void mia_splash_render(oobj view, oobj tex, float dt)
     RTex_clear_full(tex, bg_color);
     RObjText_color_set(C->ro, text_color);
     RTex_ro(tex, C->ro);
+
+    if(loading) {
+        float w = MIA_BAR_WIDTH * RTexLoader_progress(RTexLoader_default());
+        struct r_quad *q = RObjQuad_at(C->bar_ro, 0);
+        q->pose = u_pose_new((w - MIA_BAR_WIDTH) / 2.0f, MIA_BAR_Y, w, MIA_BAR_HEIGHT);
+        q->s = text_color;
+        RTex_ro(tex, C->bar_ro);
+    }
 }
 
 
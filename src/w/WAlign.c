@@ -60,11 +60,10 @@ vec2 WAlign__v_update(oobj obj, vec2 lt, vec2 min_size, oobj theme, a_pointer__f
     
     vec2 res_size = vec2_(0);
 
-    osize list_len;
-    WObj **list = WObj_list_direct(self, &list_len);
-    for(osize i=list_len-1; i>=0; i--) {
-        const char *option_h = WObj_option(list[i], WAlign_KEY_H);
-        const char *option_v = WObj_option(list[i], WAlign_KEY_V);
+    o_foreach_child_reverse(self, WObj, it) {
+        WObj *child = it.child;
+        const char *option_h = WObj_option(child, WAlign_KEY_H);
+        const char *option_v = WObj_option(child, WAlign_KEY_V);
         
         enum WAlign_mode mode_h = self->align_h;
         enum WAlign_mode mode_v = self->align_v;
@@ -78,7 +77,7 @@ vec2 WAlign__v_update(oobj obj, vec2 lt, vec2 min_size, oobj theme, a_pointer__f
             }
         }
         
-        vec2 prev_size = WObj_gen_padding_size(list[i]);
+        vec2 prev_size = WObj_gen_padding_size(child);
         
         vec2 room = vec2_sub_v(min_size, prev_size);
         room = vec2_max(room, 0);
@@ -118,7 +117,7 @@ vec2 WAlign__v_update(oobj obj, vec2 lt, vec2 min_size, oobj theme, a_pointer__f
             break;
         }
 
-        vec2 child_size = WObj_update(list[i], child_lt, child_min_size, theme, pointer_fn);
+        vec2 child_size = WObj_update(child, child_lt, child_min_size, theme, pointer_fn);
 
         vec2 used_size = vec2_(child_size.x + child_lt.x - lt.x,
                                child_size.y - child_lt.y + lt.y);
@@ -126,7 +125,5 @@ vec2 WAlign__v_update(oobj obj, vec2 lt, vec2 min_size, oobj theme, a_pointer__f
         res_size = vec2_max_v(res_size, used_size);
     }
     
-    o_free(self, list);
-    
     return res_size;
 }
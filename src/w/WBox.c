@@ -65,8 +65,7 @@ vec2 WBox__v_update(oobj obj, vec2 lt, vec2 min_size, oobj theme, a_pointer__fn
     WObj *super = obj;
     WBox *self = obj;
 
-    osize list_num;
-    WObj **list = WObj_list_direct(self, &list_num);
+    osize list_num = 0;
 
     float weight_sum = 0;
     float weight_room = self->layout == WBox_LAYOUT_H_WEIGHTS ? min_size.x : min_size.y;
@@ -74,16 +73,19 @@ vec2 WBox__v_update(oobj obj, vec2 lt, vec2 min_size, oobj theme, a_pointer__fn
     vec2 size = vec2_(0);
     vec2 offset = vec2_(0);
 
-    // prepare weights
-    if (self->layout == WBox_LAYOUT_H_WEIGHTS || self->layout == WBox_LAYOUT_V_WEIGHTS) {
-        for (osize i = 0; i < list_num; i++) {
-            float w = WBox_child_weight(list[i]);
-            if (w > 0) {
-                weight_sum += w;
-            } else {
-                vec2 used_size = WObj_gen_used_size(list[i]);
-                weight_room -= self->layout == WBox_LAYOUT_H_WEIGHTS ? used_size.x : used_size.y;
-            }
+    // count and prepare weights
+    bool weights = self->layout == WBox_LAYOUT_H_WEIGHTS || self->layout == WBox_LAYOUT_V_WEIGHTS;
+    o_foreach_child(self, WObj, it) {
+        list_num++;
+        if (!weights) {
+            continue;
+        }
+        float w = WBox_child_weight(it.child);
+        if (w > 0) {
+            weight_sum += w;
+        } else {
+            vec2 used_size = WObj_gen_used_size(it.child);
+            weight_room -= self->layout == WBox_LAYOUT_H_WEIGHTS ? used_size.x : used_size.y;
         }
     }
 
@@ -95,7 +97,8 @@ vec2 WBox__v_update(oobj obj, vec2 lt, vec2 min_size, oobj theme, a_pointer__fn
 
     vec2 line_size = vec2_(0);
 
-    for (osize i = 0; i < list_num; i++) {
+    o_foreach_child(self, WObj, it) {
+        WObj *child = it.child;
 
         vec2 child_min_size = vec2_(0);
         if(self->layout == WBox_LAYOUT_H) {
@@ -105,7 +108,7 @@ vec2 WBox__v_update(oobj obj, vec2 lt, vec2 min_size, oobj theme, a_pointer__fn
             child_min_size.x = min_size.x;
         }
         if (self->layout == WBox_LAYOUT_H_V) {
-            float right = offset.x + WObj_gen_padding_size(list[i]).x;
+            float right = offset.x + WObj_gen_padding_size(child).x;
             if (right > min_size.x) {
                 offset.x = 0;
                 offset.y += line_size.y + self->spacing.y;
@@ -113,7 +116,7 @@ vec2 WBox__v_update(oobj obj, vec2 lt, vec2 min_size, oobj theme, a_pointer__fn
             }
         }
         if (self->layout == WBox_LAYOUT_V_H) {
-            float bottom = offset.y + WObj_gen_padding_size(list[i]).y;
+            float bottom = offset.y + WObj_gen_padding_size(child).y;
             if (bottom > min_size.y) {
                 offset.y = 0;
                 offset.x += line_size.x + self->spacing.x;
@@ -121,14 +124,14 @@ vec2 WBox__v_update(oobj obj, vec2 lt, vec2 min_size, oobj theme, a_pointer__fn
             }
         }
         if(self->layout == WBox_LAYOUT_H_WEIGHTS) {
-            float w = WBox_child_weight(list[i]);
+            float w = WBox_child_weight(child);
             if (w > 0 && weight_room > 0) {
                 child_min_size.x = m_floor(weight_room * w / weight_sum);
             }
             child_min_size.y = min_size.y;
         }
         if(self->layout == WBox_LAYOUT_V_WEIGHTS) {
-            float w = WBox_child_weight(list[i]);
+            float w = WBox_child_weight(child);
             if (w > 0 && weight_room > 0) {
                 child_min_size.y = m_floor(weight_room * w / weight_sum);
             }
@@ -138,7 +141,7 @@ vec2 WBox__v_update(oobj obj, vec2 lt, vec2 min_size, oobj theme, a_pointer__fn
         vec2 child_lt = vec2_(lt.x + offset.x, lt.y - offset.y);
         // round to next pixel, so a fraction'ed size does not ruin all of our other objects
         child_lt = vec2_round(child_lt);
-        vec2 child_size = WObj_update(list[i], child_lt, child_min_size, theme, pointer_fn);
+        vec2 child_size = WObj_update(child, child_lt, child_min_size, theme, pointer_fn);
 
         vec2 s = vec2_add_v(child_size, offset);
         size = vec2_max_v(size, s);
@@ -153,7 +156,5 @@ vec2 WBox__v_update(oobj obj, vec2 lt, vec2 min_size, oobj theme, a_pointer__fn
         }
     }
 
-    o_free(self, list);
-
     return size;
 }
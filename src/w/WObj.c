@@ -325,13 +325,10 @@ void WObj__ignore_alloc_rects_set(oobj obj, bool set)
     OObj_assert(obj, WObj);
     WObj *self = obj;
     self->ignore_rects_alloc = set;
-    osize list_num;
-    WObj **list = WObj_list_direct(self, &list_num);
     // no need for backwards, but to keep it consistent...
-    for(osize i=list_num-1; i>=0; i--) {
-        WObj__ignore_alloc_rects_set(list[i], set);
+    o_foreach_child_reverse(self, WObj, it) {
+        WObj__ignore_alloc_rects_set(it.child, set);
     }
-    o_free(self, list);
 }
 
 
@@ -350,11 +347,12 @@ vec2 WObj__update_children_stacked(oobj obj, vec2 lt, vec2 min_size, oobj theme,
     OObj_assert(obj, WObj);
     WObj *self = obj;
 
-    osize list_num;
-    WObj **list = WObj_list_direct(self, &list_num);
-    vec2 child_size = WObj__update_list_stacked(list, list_num, lt, min_size, theme, pointer_fn);
-    o_free(self, list);
-
+    // same as WObj__update_list_stacked, but without allocating the list
+    vec2 child_size = vec2_(0);
+    o_foreach_child_reverse(self, WObj, it) {
+        vec2 s = WObj_update(it.child, lt, min_size, theme, pointer_fn);
+        child_size = vec2_max_v(child_size, s);
+    }
     return child_size;
 }
 
@@ -0,0 +1,43 @@
+#include "o/OObjRoot.h"
+#include "o/log.h"
+#include "o/timer.h"
+
+
+O_STATIC
+void bench_module(const char *module, int (*fn)(oobj obj))
+{
+    o_log_base(O_LOG_INFO, "o", NULL, 0, module, "benchmarking...");
+    oobj root = OObjRoot_new_heap();
+    ou64 start = o_timer();
+    int res = fn(root);
+    if(res) {
+        o_exit(module);
+    }
+    o_del(root);
+    o_log_base(O_LOG_INFO, "o", NULL, 0, module, "finished in %.3f s", o_timer_elapsed_s(start));
+}
+
+#define BENCH(module) do {                          \
+int module ## __bench(oobj root);                   \
+bench_module(#module "_bench", module ## __bench);  \
+} while(0)
+
+
+
+void o__bench_main(void)
+{
+    BENCH(o_allocator);
+    BENCH(OObj);
+    BENCH(OMap);
+    BENCH(OJson);
+    BENCH(OJsonDoc);
+    BENCH(OThreadpool);
+    BENCH(o_parallel);
+    BENCH(OPattern);
+    BENCH(OTarPack);
+    BENCH(RObjSprite);
+    BENCH(RTex_blur);
+    BENCH(s_mix);
+    BENCH(SResampler);
+    BENCH(STrackOggStream);
+}
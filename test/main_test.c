@@ -27,8 +27,24 @@ test_module(#module "_test", module ## __test);     \
 
 void o__test_main(void)
 {
+    TEST(o_allocator);
+    TEST(OObj);
     TEST(OArray);
+    TEST(OMap);
+    TEST(OJson);
+    TEST(OJsonDoc);
+    TEST(OThreadpool);
     TEST(o_str);
+    TEST(o_parallel);
     TEST(OPattern);
+    TEST(OTarPack);
     TEST(RTex);
+    TEST(RBuffer);
+    TEST(RObjGroup);
+    TEST(RShader);
+    TEST(r_sprite);
+    TEST(s_mix);
+    TEST(SResampler);
+    TEST(STrack);
+    TEST(UImg);
 }
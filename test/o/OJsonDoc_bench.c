@@ -0,0 +1,67 @@
+#include "o/OJsonDoc.h"
+#include "o/timer.h"
+#include "o/log.h"
+
+#define ENTITIES 20000
+#define RUNS 5
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "o", NULL, 0, "OJsonDoc_bench", __VA_ARGS__)
+
+// save file like document
+O_STATIC
+char *create_text(oobj obj, osize *out_len)
+{
+    osize size = ENTITIES * 256 + 64;
+    char *text = o_new(obj, char, size);
+    char *it = text;
+    it += sprintf(it, "{\"version\": 3, \"entities\": [\n");
+    for (int i = 0; i < ENTITIES; i++) {
+        it += sprintf(it, "  {\"name\": \"entity_%i\", \"pos\": [%.3f, %.3f, %i], \"hp\": %.1f, "
+                          "\"alive\": %s, \"tags\": [\"unit\", \"team_%i\"], \"meta\": null}%s\n",
+                      i, i * 0.125, i * -2.5, i % 16, 100.0 - (i % 100),
+                      i % 3 ? "true" : "false", i % 4, i < ENTITIES - 1 ? "," : "");
+    }
+    it += sprintf(it, "]}\n");
+    *out_len = it - text;
+    return text;
+}
+
+int OJsonDoc__bench(oobj obj)
+{
+    osize len;
+    char *text = create_text(obj, &len);
+    double mb = (double) len / (1024.0 * 1024.0);
+
+    ou64 start = o_timer();
+    oobj json = OJson_new_read_string(obj, NULL, text).o;
+    double ojson_s = o_timer_elapsed_s(start);
+    o_assume(json, "failed to parse");
+    o_del(json);
+
+    double doc_s = 0;
+    double convert_s = 0;
+    osize arena_size = 0;
+    for (int r = 0; r < RUNS; r++) {
+        start = o_timer();
+        oobj doc = OJsonDoc_new_read_buffer(obj, text, len).o;
+        doc_s += o_timer_elapsed_s(start);
+        o_assume(doc, "failed to parse");
+        arena_size = OJsonDoc_arena_size(doc);
+
+        start = o_timer();
+        json = OJsonDoc_node_to_json(OJsonDoc_root(doc), obj, NULL);
+        convert_s += o_timer_elapsed_s(start);
+        o_del(json);
+        o_del(doc);
+    }
+    doc_s /= RUNS;
+    convert_s /= RUNS;
+
+    bench_log("%.2f MB, OJson_new_read_string: %.1f MB/s", mb, mb / ojson_s);
+    bench_log("OJsonDoc_new_read_buffer: %.1f MB/s (arenas: %.2f MB)", mb / doc_s,
+              (double) arena_size / (1024.0 * 1024.0));
+    bench_log("OJsonDoc_new_read_buffer + OJsonDoc_node_to_json: %.1f MB/s", mb / (doc_s + convert_s));
+
+    o_free(obj, text);
+    return 0;
+}
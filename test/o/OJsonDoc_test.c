@@ -0,0 +1,137 @@
+#include "o/OJsonDoc.h"
+#include "o/str.h"
+
+#define test(expr) o_assume(expr, "test failed")
+
+O_STATIC
+void test_read(oobj obj)
+{
+    const char *text = "{\n"
+                       "  \"name\": \"mia\",\n"
+                       "  \"version\": 3,\n"
+                       "  \"scale\": -1.25e-2,\n"
+                       "  \"big\": 12345678901234567890,\n"
+                       "  \"active\": true,\n"
+                       "  \"none\": null,\n"
+                       "  \"empty\": {},\n"
+                       "  \"list\": [1, [], \"two\", {\"three\": false}]\n"
+                       "}";
+    oobj doc = OJsonDoc_new_read_string(obj, text).o;
+    test(doc);
+
+    const struct OJsonDoc_node *root = OJsonDoc_root(doc);
+    test(root->type == OJson_TYPE_OBJECT);
+    test(o_num(doc) == 8);
+    test(o_str_equals(OJsonDoc_node_string(OJsonDoc_node_get(root, "name")), "mia"));
+    test(*OJsonDoc_node_number(OJsonDoc_node_get(root, "version")) == 3);
+    test(*OJsonDoc_node_number(OJsonDoc_node_get(root, "scale")) == -1.25e-2);
+    test(*OJsonDoc_node_number(OJsonDoc_node_get(root, "big")) == 12345678901234567890.0);
+    test(*OJsonDoc_node_boolean(OJsonDoc_node_get(root, "active")) == true);
+    test(OJsonDoc_node_get(root, "none")->type == OJson_TYPE_NULL);
+    test(OJsonDoc_node_num(OJsonDoc_node_get(root, "empty")) == 0);
+    test(OJsonDoc_node_get(root, "missing") == NULL);
+    test(OJsonDoc_node_number(OJsonDoc_node_get(root, "name")) == NULL);
+
+    const struct OJsonDoc_node *list = OJsonDoc_node_get(root, "list");
+    test(OJsonDoc_node_num(list) == 4);
+    test(*OJsonDoc_node_number(OJsonDoc_node_at(list, 0)) == 1);
+    test(OJsonDoc_node_at(list, 1)->type == OJson_TYPE_ARRAY);
+    test(o_str_equals(OJsonDoc_node_string(OJsonDoc_node_at(list, 2)), "two"));
+    test(*OJsonDoc_node_boolean(OJsonDoc_node_get(OJsonDoc_node_at(list, 3), "three")) == false);
+    test(OJsonDoc_node_at(list, 4) == NULL);
+
+    o_del(doc);
+}
+
+O_STATIC
+void test_escapes(oobj obj)
+{
+    oobj doc = OJsonDoc_new_read_string(obj,
+            "[\"a\\\"b\\\\c\\n\", \"\\u00e4\\u20ac\\ud83d\\ude00\", \"\\x41\\'\"]").o;
+    test(doc);
+    const struct OJsonDoc_node *root = OJsonDoc_root(doc);
+    test(o_str_equals(OJsonDoc_node_string(OJsonDoc_node_at(root, 0)), "a\"b\\c\n"));
+    test(o_str_equals(OJsonDoc_node_string(OJsonDoc_node_at(root, 1)), "\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80"));
+    test(o_str_equals(OJsonDoc_node_string(OJsonDoc_node_at(root, 2)), "A\'"));
+
+    // round trip with OJson_dump, which uses o_str_escape
+    OJson *json = OJsonDoc_node_to_json(root, doc, NULL);
+    char *dump = OJson_dump(json, NULL);
+    oobj doc2 = OJsonDoc_new_read_string(doc, dump).o;
+    test(doc2);
+    test(o_str_equals(OJsonDoc_node_string(OJsonDoc_node_at(OJsonDoc_root(doc2), 0)), "a\"b\\c\n"));
+    o_del(doc);
+}
+
+O_STATIC
+void test_invalid(oobj obj)
+{
+    const char *invalid[] = {
+            "", "{", "[1,]x", "{\"a\" 1}", "[1 2]", "\"open", "tru", "[1e]", "{} {}", "-"
+    };
+    for (int i = 0; i < (int) (sizeof invalid / sizeof *invalid); i++) {
+        test(OJsonDoc_new_read_string(obj, invalid[i]).o == NULL);
+    }
+
+    // depth limit
+    char deep[OJsonDoc_DEPTH_MAX * 2 + 8];
+    int len = 0;
+    for (int i = 0; i <= OJsonDoc_DEPTH_MAX; i++) {
+        deep[len++] = '[';
+    }
+    deep[len] = '\0';
+    test(OJsonDoc_new_read_buffer(obj, deep, len).o == NULL);
+}
+
+O_STATIC
+void test_to_json(oobj obj)
+{
+    const char *text = "{\"a\": [1, 2.5, \"x\"], \"b\": {\"c\": null, \"d\": true}}";
+    oobj doc = OJsonDoc_new_read_string(obj, text).o;
+    OJson *json = OJsonDoc_node_to_json(OJsonDoc_root(doc), obj, "root");
+    OJson *ref = OJson_new_read_string(obj, "root", text).o;
+    char *json_dump = OJson_dump(json, NULL);
+    char *ref_dump = OJson_dump(ref, NULL);
+    test(o_str_equals(json_dump, ref_dump));
+
+    // the OJson tree is independent of the document
+    o_del(doc);
+    test(o_str_equals(OJson_dump(json, NULL), ref_dump));
+    o_del(json);
+    o_del(ref);
+}
+
+O_STATIC
+void test_large(oobj obj)
+{
+    // forces multiple arenas, the first one is sized for the text
+    oobj container = OObj_new(obj);
+    osize n = 20000;
+    char *text = o_new(container, char, n * 4 + 8);
+    char *it = text;
+    *it++ = '[';
+    for (osize i = 0; i < n; i++) {
+        it += sprintf(it, "[%i]", (int) (i % 10));
+        *it++ = i < n - 1 ? ',' : ']';
+    }
+    *it = '\0';
+    oobj doc = OJsonDoc_new_read_string(container, text).o;
+    test(doc);
+    const struct OJsonDoc_node *root = OJsonDoc_root(doc);
+    test(OJsonDoc_node_num(root) == n);
+    for (osize i = 0; i < n; i++) {
+        test(*OJsonDoc_node_number(OJsonDoc_node_at(OJsonDoc_node_at(root, i), 0)) == (double) (i % 10));
+    }
+    o_del(container);
+}
+
+
+int OJsonDoc__test(oobj root)
+{
+    test_read(root);
+    test_escapes(root);
+    test_invalid(root);
+    test_to_json(root);
+    test_large(root);
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include "o/OJson.h"
+#include "o/timer.h"
+#include "o/log.h"
+
+#define KEYS 500
+#define RUNS 20
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "o", NULL, 0, "OJson_bench", __VA_ARGS__)
+
+int OJson__bench(oobj obj)
+{
+    // config like object, read field by field
+    OJson *root = OJson_new_object(obj, NULL);
+    char names[KEYS][16];
+    for (int i = 0; i < KEYS; i++) {
+        snprintf(names[i], sizeof names[i], "key_%i", i);
+        OJson_new_number(root, names[i], i);
+    }
+
+    double sum = 0;
+    ou64 start = o_timer();
+    for (int r = 0; r < RUNS; r++) {
+        for (int i = 0; i < KEYS; i++) {
+            sum += *OJson_number(OJson_get(root, names[i]).o);
+        }
+    }
+    double get_s = o_timer_elapsed_s(start);
+
+    OJson *scenes = OJson_new_array(root, "scenes");
+    for (int i = 0; i < KEYS; i++) {
+        OJson *scene = OJson_new_object(scenes, NULL);
+        OJson_new_string(scene, "name", names[i]);
+    }
+    start = o_timer();
+    for (int r = 0; r < RUNS; r++) {
+        for (int i = 0; i < KEYS; i++) {
+            sum += OJson_get_path(root, "scenes.123.name").o != NULL;
+        }
+    }
+    double path_s = o_timer_elapsed_s(start);
+
+    bench_log("%i keys: OJson_get: %.0f/s, OJson_get_path: %.0f/s (%.0f)",
+              KEYS, KEYS * RUNS / get_s, KEYS * RUNS / path_s, sum);
+    o_del(root);
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "o/OJson.h"
+#include "o/str.h"
+#include "o/parallel.h"
+#include "o/OThreadpool.h"
+
+#define test(expr) o_assume(expr, "test failed")
+
+O_STATIC
+void test_get(oobj obj)
+{
+    OJson *root = OJson_new_object(obj, NULL);
+    char name[32];
+    for (int i = 0; i < 300; i++) {
+        snprintf(name, sizeof name, "key_%i", i);
+        OJson_new_number(root, name, i);
+    }
+    test(OJson_num(root) == 300);
+    for (int i = 0; i < 300; i++) {
+        snprintf(name, sizeof name, "key_%i", i);
+        OJson *child = OJson_get(root, name).o;
+        test(child && *OJson_number(child) == i);
+        test(OJson_at(root, i).o == child);
+    }
+    test(OJson_get(root, "missing").o == NULL);
+    test(OJson_at(root, 300).o == NULL);
+
+    // lookups on a read only tree do not allocate
+    osize mem_num = OObj_mem_num(root);
+    OJson_get(root, "key_42");
+    OJson_at(root, 7);
+    test(OObj_mem_num(root) == mem_num);
+
+    // duplicates, the last one wins
+    OJson *dup = OJson_new_string(root, "key_5", "dup");
+    test(OJson_get(root, "key_5").o == dup);
+
+    // invalidated by delete, rename and move
+    o_del(dup);
+    test(*OJson_number(OJson_get(root, "key_5").o) == 5);
+    OJson *child = OJson_get(root, "key_6").o;
+    OObj_name_set(child, "renamed");
+    test(OJson_get(root, "key_6").o == NULL);
+    test(OJson_get(root, "renamed").o == child);
+    OJson *other = OJson_new_object(obj, NULL);
+    o_move(child, other);
+    test(OJson_get(root, "renamed").o == NULL);
+    test(OJson_get(other, "renamed").o == child);
+    test(OJson_num(root) == 299);
+
+    // not an object
+    OJson *array = OJson_new_array(root, "array");
+    OJson_new_number(array, "x", 1);
+    test(OJson_get(array, "x").o == NULL);
+    test(OJson_num(OJson_get(root, "key_1").o) == 0);
+
+    o_del(other);
+    o_del(root);
+}
+
+O_STATIC
+void test_get_path(oobj obj)
+{
+    const char *text = "{\"scenes\": [{\"name\": \"a\"}, {\"name\": \"b\", \"items\": [1, 2, 3]}], \"10\": true}";
+    OJson *root = OJson_new_read_string(obj, NULL, text).o;
+    test(root);
+
+    test(OJson_get_path(root, "").o == root);
+    test(o_str_equals(OJson_string(OJson_get_path(root, "scenes.0.name").o), "a"));
+    test(o_str_equals(OJson_string(OJson_get_path(root, "scenes.1.name").o), "b"));
+    test(*OJson_number(OJson_get_path(root, "scenes.1.items.2").o) == 3);
+    test(*OJson_boolean(OJson_get_path(root, "10").o) == true);
+
+    test(OJson_get_path(root, "scenes.2.name").o == NULL);
+    test(OJson_get_path(root, "scenes.x").o == NULL);
+    test(OJson_get_path(root, "scenes.").o == NULL);
+    test(OJson_get_path(root, "scenes.0.name.more").o == NULL);
+    test(OJson_get_path(root, "missing.0").o == NULL);
+
+    o_del(root);
+}
+
+O_STATIC
+void lookup_run(osize begin, osize end, void *user)
+{
+    oobj root = user;
+    char name[32];
+    for (osize i = begin; i < end; i++) {
+        int key = (int) (i % 100);
+        snprintf(name, sizeof name, "key_%i", key);
+        OJson *child = OJson_get(root, name).o;
+        test(child && *OJson_number(child) == key);
+        test(OJson_num(root) == 100);
+    }
+}
+
+// readers of several threads share the lazily built index
+O_STATIC
+void test_threads(oobj obj)
+{
+    OJson *root = OJson_new_object(obj, NULL);
+    oobj pool = NULL;
+#ifdef MIA_OPTION_THREAD
+    pool = OThreadpool_new(obj, 4);
+#endif
+    char name[32];
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < 100; i++) {
+            snprintf(name, sizeof name, "key_%i", i);
+            OObj_del(OJson_get(root, name).o);
+            OJson_new_number(root, name, i);
+        }
+        // the children changed, so the first readers rebuild the index
+        o_parallel_for(pool, 4000, 100, lookup_run, root);
+    }
+    o_del(pool);
+    o_del(root);
+}
+
+
+int OJson__test(oobj root)
+{
+    test_get(root);
+    test_get_path(root);
+    test_threads(root);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "o/OMap.h"
+#include "o/str.h"
+#include "o/timer.h"
+#include "o/log.h"
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "o", NULL, 0, "OMap_bench", __VA_ARGS__)
+
+O_STATIC
+void bench_num(oobj obj, int num, int approx_num)
+{
+    oobj map = OMap_new_string_keys(obj, sizeof(int), approx_num);
+    char **keys = o_new(obj, char *, num);
+    for (int i = 0; i < num; i++) {
+        keys[i] = o_strf(obj, "uniform_name_%i", i);
+    }
+
+    ou64 start = o_timer();
+    for (int i = 0; i < num; i++) {
+        OMap_set(map, &keys[i], &i);
+    }
+    double set_s = o_timer_elapsed_s(start);
+
+    int rounds = 1000000 / num;
+    if (rounds < 1) {
+        rounds = 1;
+    }
+    ou32 sum = 0;
+    start = o_timer();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < num; i++) {
+            sum += (ou32) *OMap_get(map, &keys[i], int);
+        }
+    }
+    double get_s = o_timer_elapsed_s(start);
+
+    start = o_timer();
+    for (int i = 0; i < num; i++) {
+        OMap_remove(map, &keys[i]);
+    }
+    double remove_s = o_timer_elapsed_s(start);
+
+    bench_log("%i string keys (approx_num %i): set: %.0f/s, get: %.0f/s, remove: %.0f/s (%i)",
+              num, approx_num, num / set_s, (double) rounds * num / get_s, num / remove_s, sum != 0);
+
+    for (int i = 0; i < num; i++) {
+        o_free(obj, keys[i]);
+    }
+    o_free(obj, keys);
+    o_del(map);
+}
+
+int OMap__bench(oobj root)
+{
+    bench_num(root, 64, 64);
+    bench_num(root, 1000, 64);
+    bench_num(root, 100000, 64);
+    return 0;
+}
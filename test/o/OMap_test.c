@@ -0,0 +1,117 @@
+#include "o/OMap.h"
+#include "o/str.h"
+
+#define test(expr) o_assume(expr, "test failed")
+
+O_STATIC
+ou32 size_hash(const void *key)
+{
+    // weak hash on purpose, to stress the probing
+    return (ou32) (*(const osize *) key % 7);
+}
+
+O_STATIC
+bool size_equals(const void *key_a, const void *key_b)
+{
+    return *(const osize *) key_a == *(const osize *) key_b;
+}
+
+O_STATIC
+void *size_clone(oobj obj, const void *key)
+{
+    // the clone is stored as pointer in the pair
+    return (void *) *(const osize *) key;
+}
+
+O_STATIC
+void test_string_keys(oobj obj)
+{
+    oobj map = OMap_new_string_keys(obj, sizeof(int), 4);
+    char buf[32];
+    for (int i = 0; i < 1000; i++) {
+        o_strf_buf(buf, "key_%i", i);
+        char *key = buf;
+        test(OMap_set(map, &key, &i) == i);
+    }
+    test(OMap_num(map) == 1000);
+
+    for (int i = 0; i < 1000; i++) {
+        o_strf_buf(buf, "key_%i", i);
+        char *key = buf;
+        int *val = OMap_get(map, &key, int);
+        test(val && *val == i);
+        test(OMap_get_idx(map, &key) == i);
+    }
+    char *missing = "missing";
+    test(!OMap_get(map, &missing, int));
+    test(!OMap_remove(map, &missing));
+
+    // overwrite
+    char *key_5 = "key_5";
+    int val = -5;
+    test(OMap_set(map, &key_5, &val) == 5);
+    test(*OMap_get(map, &key_5, int) == -5);
+    test(OMap_num(map) == 1000);
+
+    // swap remove, the last pair moves into the removed idx
+    test(OMap_remove(map, &key_5));
+    test(OMap_num(map) == 999);
+    test(!OMap_get(map, &key_5, int));
+    char *key_999 = "key_999";
+    test(OMap_get_idx(map, &key_999) == 5);
+    test(o_str_equals(*OMap_key_at(map, 5, char *), "key_999"));
+    test(*OMap_value_at(map, 5, int) == 999);
+
+    // remove with a key that points into the map itself
+    while (OMap_num(map) > 0) {
+        const char **key = OMap_key_at(map, 0, char *);
+        test(OMap_remove(map, key));
+    }
+    test(OMap_num(map) == 0);
+    for (int i = 0; i < 1000; i++) {
+        o_strf_buf(buf, "key_%i", i);
+        char *key = buf;
+        test(!OMap_get(map, &key, int));
+    }
+    o_del(map);
+}
+
+O_STATIC
+void test_collisions(oobj obj)
+{
+    oobj map = OMap_new(obj, sizeof(osize), sizeof(int), 0, size_hash, size_equals, size_clone);
+    for (osize i = 0; i < 500; i++) {
+        int v = (int) i * 10;
+        OMap_set(map, &i, &v);
+    }
+    test(OMap_num(map) == 500);
+
+    // remove every third key in a shuffled order
+    for (osize i = 0; i < 500; i++) {
+        osize key = (i * 7) % 500;
+        if (key % 3 == 0) {
+            test(OMap_remove(map, &key));
+            test(!OMap_remove(map, &key));
+        }
+    }
+    for (osize i = 0; i < 500; i++) {
+        int *v = OMap_get(map, &i, int);
+        test(i % 3 == 0 ? !v : (v && *v == (int) i * 10));
+    }
+
+    // all pairs reachable by index
+    for (osize i = 0; i < OMap_num(map); i++) {
+        const osize *key = OMap_key_at(map, i, osize);
+        test(OMap_get_idx(map, key) == i);
+        test(*OMap_value_at(map, i, int) == (int) *key * 10);
+    }
+    o_del(map);
+}
+
+
+int OMap__test(oobj root)
+{
+    test_string_keys(root);
+    test_collisions(root);
+    return 0;
+}
@@ -0,0 +1,220 @@
+#include "o/OObjRoot.h"
+#include "o/timer.h"
+#include "o/log.h"
+#include "o/OArray.h"
+#include "o/OStream.h"
+#include <string.h>
+
+#define NUM 100000
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "o", NULL, 0, "OObj_bench", __VA_ARGS__)
+
+O_STATIC
+void bench_create_del(oobj obj, bool locked)
+{
+    oobj *objs = o_new(obj, oobj, NUM);
+
+    ou64 start = o_timer();
+    for(int i=0; i<NUM; i++) {
+        objs[i] = OObj_new(obj);
+        if(locked) {
+            o_lock(objs[i]);
+            o_unlock(objs[i]);
+        }
+    }
+    double create_s = o_timer_elapsed_s(start);
+
+    start = o_timer();
+    for(int i=NUM-1; i>=0; i--) {
+        o_del(objs[i]);
+    }
+    double del_s = o_timer_elapsed_s(start);
+
+    bench_log("%s: create: %.0f objs/s, del: %.0f objs/s",
+              locked? "locked" : "unlocked",
+              NUM / create_s, NUM / del_s);
+    o_free(obj, objs);
+}
+
+O_STATIC
+void bench_bytes(void)
+{
+    // pool allocator to count the used blocks, with the power of two size class of an OObj,
+    //     larger allocations would not be counted
+    int block_size = 64;
+    while(block_size < (int) sizeof(OObj)) {
+        block_size *= 2;
+    }
+    oobj root = OObjRoot_new_pool_ex(block_size, NUM, 2);
+    struct o_allocator_i a = OObj_allocator(root);
+    oobj container = OObj_new(root);
+    int used_start = o_allocator_pool_blocks_used(a);
+    for(int i=0; i<NUM; i++) {
+        OObj_new(container);
+    }
+    int used = o_allocator_pool_blocks_used(a) - used_start;
+    o_assume(used >= NUM, "OObj_new bypassed the pool");
+    bench_log("sizeof(OObj): %i, pooled bytes per OObj_new: %.1f",
+              (int) sizeof(OObj), (double) used * o_allocator_pool_block_size(a) / NUM);
+    o_del(root);
+    o_allocator_pool_del(&a);
+}
+
+O_STATIC
+void bench_mem_many(oobj obj)
+{
+    enum { MANY = 20000 };
+    oobj a = OObj_new(obj);
+    oobj b = OObj_new(obj);
+    void **mem = o_new(obj, void *, MANY);
+
+    // free in allocation order, so the entries are at the front of the list
+    for(int i=0; i<MANY; i++) {
+        mem[i] = o_alloc(a, 1, 16);
+    }
+    ou64 start = o_timer();
+    for(int i=0; i<MANY; i++) {
+        o_free(a, mem[i]);
+    }
+    double free_s = o_timer_elapsed_s(start);
+
+    for(int i=0; i<MANY; i++) {
+        mem[i] = o_alloc(a, 1, 16);
+    }
+    start = o_timer();
+    for(int i=0; i<MANY; i++) {
+        o_mem_move(a, b, mem[i]);
+    }
+    double move_s = o_timer_elapsed_s(start);
+
+    // free through the parent, which searches the hierarchy
+    start = o_timer();
+    for(int i=0; i<MANY; i++) {
+        o_free(obj, mem[i]);
+    }
+    double free_parent_s = o_timer_elapsed_s(start);
+
+    bench_log("%i allocations: o_free: %.0f/s, o_mem_move: %.0f/s, o_free via parent: %.0f/s",
+              MANY, MANY / free_s, MANY / move_s, MANY / free_parent_s);
+
+    o_free(obj, mem);
+    o_del(a);
+    o_del(b);
+}
+
+O_STATIC
+void bench_type_check(oobj obj)
+{
+    enum { CHECKS = 2000000 };
+    oobj arr = OArray_new(obj, NULL, 1, 1);
+    volatile int matches = 0;
+
+    // the old string prefix compare as reference
+    ou64 start = o_timer();
+    for (int i = 0; i < CHECKS; i++) {
+        const char *id = i % 2 ? OArray_ID : OObj_ID "OStream";
+        matches += strncmp(((OObj *) arr)->id, id, strlen(id)) == 0;
+    }
+    double strncmp_s = o_timer_elapsed_s(start);
+
+    start = o_timer();
+    for (int i = 0; i < CHECKS; i++) {
+        matches += i % 2 ? OObj_check(arr, OArray) : OObj_check(arr, OStream);
+    }
+    double check_s = o_timer_elapsed_s(start);
+
+    const struct OObj_type *type = OObj_type_literal(OArray_ID);
+    start = o_timer();
+    for (int i = 0; i < CHECKS; i++) {
+        matches += OObj_type_check(arr, type);
+    }
+    double type_s = o_timer_elapsed_s(start);
+
+    bench_log("type checks: strncmp: %.0f M/s, OObj_check: %.0f M/s, OObj_type_check: %.0f M/s",
+              CHECKS / strncmp_s / 1e6, CHECKS / check_s / 1e6, CHECKS / type_s / 1e6);
+    o_del(arr);
+}
+
+// counts the allocator calls
+static int L_alloc_calls;
+
+O_STATIC
+void *counting_realloc_try(struct o_allocator_i iface, void *restrict mem, osize element_size, osize num)
+{
+    L_alloc_calls++;
+    struct o_allocator_i *heap = iface.impl;
+    return heap->realloc_try(*heap, mem, element_size, num);
+}
+
+// sums a traversal like a widget update: a tree of groups, each with some leaves
+O_STATIC
+int traverse_list_r(oobj obj)
+{
+    int sum = 1;
+    oobj *list = OObj_list(obj, NULL, OObj);
+    for (oobj *it = list; *it; it++) {
+        sum += traverse_list_r(*it);
+    }
+    o_free(obj, list);
+    return sum;
+}
+
+O_STATIC
+int traverse_iter_r(oobj obj)
+{
+    int sum = 1;
+    o_foreach_child(obj, OObj, it) {
+        sum += traverse_iter_r(it.child);
+    }
+    return sum;
+}
+
+O_STATIC
+void bench_iter(void)
+{
+    enum { GROUPS = 100, LEAVES = 20, FRAMES = 200 };
+    struct o_allocator_i heap = o_allocator_heap_new();
+    oobj root = OObjRoot_new((struct o_allocator_i) {&heap, counting_realloc_try, "counting"});
+    oobj tree = OObj_new(root);
+    for (int g = 0; g < GROUPS; g++) {
+        oobj group = OObj_new(tree);
+        for (int l = 0; l < LEAVES; l++) {
+            OObj_new(group);
+        }
+    }
+    volatile int sum = 0;
+
+    int calls = L_alloc_calls;
+    ou64 start = o_timer();
+    for (int f = 0; f < FRAMES; f++) {
+        sum += traverse_list_r(tree);
+    }
+    double list_s = o_timer_elapsed_s(start);
+    int list_calls = L_alloc_calls - calls;
+
+    calls = L_alloc_calls;
+    start = o_timer();
+    for (int f = 0; f < FRAMES; f++) {
+        sum += traverse_iter_r(tree);
+    }
+    double iter_s = o_timer_elapsed_s(start);
+    int iter_calls = L_alloc_calls - calls;
+
+    bench_log("traverse %i objects: OObj_list: %.3f ms/frame, %i allocator calls/frame, "
+              "o_foreach_child: %.3f ms/frame, %i allocator calls/frame",
+              1 + GROUPS * (1 + LEAVES),
+              list_s * 1000.0 / FRAMES, list_calls / FRAMES,
+              iter_s * 1000.0 / FRAMES, iter_calls / FRAMES);
+    o_del(root);
+}
+
+int OObj__bench(oobj obj)
+{
+    bench_create_del(obj, false);
+    bench_create_del(obj, true);
+    bench_bytes();
+    bench_mem_many(obj);
+    bench_type_check(obj);
+    bench_iter();
+    return 0;
+}
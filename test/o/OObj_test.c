@@ -0,0 +1,251 @@
+#include "o/OObj.h"
+#include "o/OObj_builder.h"
+#include "o/OObjRoot.h"
+#include "o/OArray.h"
+#include "o/str.h"
+
+#define test(expr) o_assume(expr, "test failed")
+
+O_STATIC
+void test_inline(oobj obj)
+{
+    oobj a = OObj_new(obj);
+    for(int i=0; i<OObj_CHILDREN_INLINE*4; i++) {
+        OObj_new(a);
+    }
+    test(OObj_children_num(a) == OObj_CHILDREN_INLINE*4);
+
+    oobj *list = OObj_list(a, NULL, OObj);
+    test(o_list_num(list) == OObj_CHILDREN_INLINE*4);
+    o_free(a, list);
+
+    o_lock_block(a) {
+        test(o_lock_try(a));
+        o_unlock(a);
+    }
+    o_del(a);
+}
+
+O_STATIC
+void test_mem_index(oobj obj)
+{
+    // enough allocations to create the mem index
+    enum { NUM = OObj_MEM_INDEX_THRESHOLD * 8 };
+    oobj a = OObj_new(obj);
+    oobj b = OObj_new(obj);
+    int *mem[NUM];
+    for(int i=0; i<NUM; i++) {
+        mem[i] = o_new(a, int, 1);
+        *mem[i] = i;
+    }
+    osize a_num = OObj_mem_num(a);
+
+    // free every third, move every third into b, realloc the rest
+    for(int i=0; i<NUM; i++) {
+        switch(i%3) {
+            case 0:
+                o_free(a, mem[i]);
+                mem[i] = NULL;
+                a_num--;
+                break;
+            case 1:
+                o_mem_move(a, b, mem[i]);
+                a_num--;
+                break;
+            default:
+                mem[i] = o_renew(a, mem[i], int, 64);
+                break;
+        }
+    }
+    test(OObj_mem_num(a) == a_num);
+
+    for(int i=0; i<NUM; i++) {
+        if(!mem[i]) {
+            continue;
+        }
+        test(*mem[i] == i);
+        oobj owner = OObj_mem_search_parent(obj, mem[i], 1).o;
+        test(owner == (i%3 == 1 ? b : a));
+        // free from the parent, searches in the hierarchy
+        o_free(obj, mem[i]);
+    }
+    o_del(a);
+    o_del(b);
+}
+
+O_STATIC
+void test_types(oobj obj)
+{
+    // the child id is seen before its base ids
+    oobj baz = OObj_new(obj);
+    OObj_id_set(baz, OObj_ID "TFoo" "Bar" "Baz");
+    oobj foo = OObj_new(obj);
+    OObj_id_set(foo, OObj_ID "TFoo");
+
+    test(OObj_id_check(baz, OObj_ID "TFoo" "Bar"));
+    test(OObj_id_check(baz, OObj_ID "TFoo"));
+    test(OObj_id_check(baz, OObj_ID));
+    test(OObj_id_check(foo, OObj_ID "TFoo"));
+    test(!OObj_id_check(foo, OObj_ID "TFoo" "Bar"));
+    test(!OObj_id_check(baz, OObj_ID "TFoo" "Bax"));
+    test(!OObj_id_check(baz, OObj_ID "TFoo" "Bar" "Baz" "Qux"));
+
+    // prefix semantic, like the old string compare
+    test(OObj_id_check(baz, OObj_ID "TFo"));
+    test(OObj_id_check(baz, ""));
+    test(!OObj_id_check(NULL, OObj_ID));
+
+    // garbage is rejected
+    char garbage[sizeof(OObj)] = "not an object";
+    test(!OObj_id_check(garbage, OObj_ID));
+
+    // ids are interned and printable
+    test(OObj_id(baz) == OObj_type(baz)->id);
+    test(o_str_equals(OObj_id(baz), "OObjTFooBarBaz"));
+    test(OObj_type_intern("OObjTFooBarBaz") == OObj_type(baz));
+    test(OObj_type_intern(OObj_id(foo)) == OObj_type(foo));
+    test(OObj_type_literal(OObj_ID "TFoo") == OObj_type(foo));
+
+    // temporary buffers must be interned by content
+    char buf[OObj_ID_BUFFER_SIZE];
+    o_strf_buf(buf, "%s%s", OObj_ID, "TFoo");
+    test(OObj_type_check(baz, OObj_type_intern(buf)));
+    o_strf_buf(buf, "%s%s", OObj_ID, "TBar");
+    test(!OObj_type_check(baz, OObj_type_intern(buf)));
+
+    // a reused buffer is interned by its current content
+    o_strf_buf(buf, "%s%s", OObj_ID, "TFoo");
+    test(OObj_id_check(baz, buf));
+    o_strf_buf(buf, "%s%s", OObj_ID, "TBar");
+    test(!OObj_id_check(baz, buf));
+    o_strf_buf(buf, "%s%s", OObj_ID, "TFoo");
+    test(OObj_id_check(baz, buf));
+
+    // lists and finds by type
+    oobj arr = OArray_new(obj, NULL, 1, 4);
+    OObj_new(arr);
+    test(OObj_find(obj, OArray, NULL, 0).o == arr);
+    test(OObj_find(obj, OObj, NULL, 0).o == obj);
+    osize num;
+    oobj *list = OObj_list_id(obj, &num, OObj_ID "TFoo");
+    test(num == 2 && list[0] == baz && list[1] == foo);
+    o_free(obj, list);
+
+    // finds and lists with a reused buffer
+    o_strf_buf(buf, "%s%s", OObj_ID, "TFoo");
+    test(OObj_find_id(obj, buf, NULL, 0).o == baz);
+    o_strf_buf(buf, "%s%s", OObj_ID, "TBar");
+    test(!OObj_find_id(obj, buf, NULL, 0).o);
+    list = OObj_list_id(obj, &num, buf);
+    test(num == 0);
+    if (list) {
+        o_free(obj, list);
+    }
+
+    o_del(arr);
+    o_del(baz);
+    o_del(foo);
+}
+
+// counts the allocator calls, to check that iterations do not allocate
+static int L_alloc_calls;
+
+O_STATIC
+void *counting_realloc_try(struct o_allocator_i iface, void *restrict mem, osize element_size, osize num)
+{
+    L_alloc_calls++;
+    struct o_allocator_i *heap = iface.impl;
+    return heap->realloc_try(*heap, mem, element_size, num);
+}
+
+O_STATIC
+void test_iter(void)
+{
+    struct o_allocator_i heap = o_allocator_heap_new();
+    oobj root = OObjRoot_new((struct o_allocator_i) {&heap, counting_realloc_try, "counting"});
+
+    // a: [arr0, obj1, arr2, obj3, arr4, obj5], arr2: [obj, arr, arr]
+    oobj a = OObj_new(root);
+    oobj children[6];
+    for (int i = 0; i < 6; i++) {
+        children[i] = i % 2 ? (oobj) OObj_new(a) : (oobj) OArray_new(a, NULL, 1, 1);
+    }
+    OObj_new(children[2]);
+    oobj grand = OArray_new(children[2], NULL, 1, 1);
+    OArray_new(grand, NULL, 1, 1);
+
+    // lock once, so the lazy mutexes are created before counting
+    o_lock_block(a) {}
+    o_lock_block(children[2]) {}
+    o_lock_block(grand) {}
+    int calls = L_alloc_calls;
+
+    int n = 0;
+    o_foreach_child(a, OArray, it) {
+        test(it.child == children[n * 2] && it.level == 0);
+        n++;
+    }
+    test(n == 3);
+
+    n = 0;
+    o_foreach_child_reverse(a, OObj, it) {
+        test(it.child == children[5 - n]);
+        n++;
+    }
+    test(n == 6);
+
+    // depth first, parents before their children
+    oobj expected[] = {children[0], children[2], grand, ((OObj *) grand)->children[0], children[4]};
+    n = 0;
+    o_foreach_child_r(a, OArray, 5, it) {
+        test(n < 5 && it.child == expected[n]);
+        test(it.level == (n == 2 ? 1 : n == 3 ? 2 : 0));
+        n++;
+    }
+    test(n == 5);
+
+    // level limit
+    n = 0;
+    o_foreach_child_r(a, OArray, 1, it) {
+        n++;
+    }
+    test(n == 4);
+
+    o_foreach_child(a, OObj, it) {
+        break;
+    }
+    test(L_alloc_calls == calls);
+
+    // deleting while iterating, forward and reverse
+    n = 0;
+    o_foreach_child(a, OArray, it) {
+        o_del(it.child);
+        n++;
+    }
+    test(n == 3 && OObj_children_num(a) == 3);
+    for (int i = 0; i < 3; i++) {
+        OArray_new(a, NULL, 1, 1);
+    }
+    n = 0;
+    o_foreach_child_reverse(a, OObj, it) {
+        if (n == 1) {
+            // removes a child that was not visited yet
+            oobj first = ((OObj *) a)->children[0];
+            o_del(first);
+        }
+        o_del(it.child);
+        n++;
+    }
+    test(n == 5 && OObj_children_num(a) == 0);
+
+    o_del(root);
+}
+
+int OObj__test(oobj obj)
+{
+    test_inline(obj);
+    test_mem_index(obj);
+    test_types(obj);
+    test_iter();
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "o/OPattern.h"
+#include "o/timer.h"
+#include "o/log.h"
+
+#define LINES 20000
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "o", NULL, 0, "OPattern_bench", __VA_ARGS__)
+
+// log file like text
+O_STATIC
+char *create_text(oobj obj, osize *out_len)
+{
+    char *text = o_new(obj, char, LINES * 96 + 1);
+    char *it = text;
+    for (int i = 0; i < LINES; i++) {
+        it += sprintf(it, "12:%02i:%02i %s [module_%i] user=player%i took %i.%03i ms\n",
+                      i / 60 % 60, i % 60, i % 97 == 0 ? "ERROR" : "INFO ", i % 7, i % 13, i % 50, i % 1000);
+    }
+    *out_len = it - text;
+    return text;
+}
+
+O_STATIC
+void bench_pattern(oobj obj, const char *text, osize len, const char *pattern_str, bool captures)
+{
+    OPattern *pattern = OPattern_new(obj, pattern_str);
+    double mb = (double) len / (1024.0 * 1024.0);
+    double mb_s[2];
+    osize found[2];
+    for (int run = 0; run < 2; run++) {
+        OPattern_dfa_enabled_set(pattern, run == 0);
+        struct o_str_range_list_list captures_list;
+        ou64 start = o_timer();
+        found[run] = OPattern_find_all_data(pattern, NULL, captures ? &captures_list : NULL, text, len);
+        mb_s[run] = mb / o_timer_elapsed_s(start);
+        if (captures) {
+            o_str_range_list_list_free(&captures_list);
+        }
+    }
+    o_assume(found[0] == found[1], "dfa differs");
+    bench_log("find_all \"%s\"%s: %i matches, dfa: %.1f MB/s, backtracking: %.1f MB/s",
+              pattern_str, captures ? " with captures" : "", (int) found[0], mb_s[0], mb_s[1]);
+    o_del(pattern);
+}
+
+int OPattern__bench(oobj obj)
+{
+    osize len;
+    char *text = create_text(obj, &len);
+
+    bench_pattern(obj, text, len, "ERROR", false);
+    bench_pattern(obj, text, len, "%d+%.%d+ ms", false);
+    bench_pattern(obj, text, len, "user=(%w+)", true);
+
+    OPattern *pattern = OPattern_new(obj, "module_%d");
+    ou64 start = o_timer();
+    osize replaced;
+    char *res = OPattern_replace(pattern, text, "module", &replaced);
+    bench_log("replace \"module_%%d\": %i replaced, %.1f MB/s",
+              (int) replaced, (double) len / (1024.0 * 1024.0) / o_timer_elapsed_s(start));
+    o_free(pattern, res);
+    o_del(pattern);
+
+    o_free(obj, text);
+    return 0;
+}
@@ -18,6 +18,130 @@ void test_match(oobj pattern, const char *str, struct o_str_range res,
 }
 
 
+// small deterministic random generator for the differential tests
+O_STATIC
+ou32 rand_next(ou32 *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+O_STATIC
+void create_random_pattern(char *pattern, ou32 *rnd)
+{
+    static const char *atoms[] = {"a", "b", "x", ".", "%d", "%a", "[ab]", "[^a]", "%.", "[a-c]"};
+    static const char *mods[] = {"", "", "+", "*", "-", "?"};
+    char *it = pattern;
+    *it = '\0';
+    if (rand_next(rnd) % 5 == 0) {
+        *it++ = '^';
+    }
+    int atoms_num = 1 + (int) (rand_next(rnd) % 5);
+    int open = 0;
+    for (int a = 0; a < atoms_num; a++) {
+        if (rand_next(rnd) % 4 == 0) {
+            *it++ = '(';
+            open++;
+        }
+        it += sprintf(it, "%s%s", atoms[rand_next(rnd) % 10], mods[rand_next(rnd) % 6]);
+        if (open > 0 && rand_next(rnd) % 3 == 0) {
+            *it++ = ')';
+            open--;
+        }
+    }
+    while (open-- > 0) {
+        *it++ = ')';
+    }
+    if (rand_next(rnd) % 5 == 0) {
+        *it++ = '$';
+    }
+    *it = '\0';
+}
+
+// one shot patterns do not pay for the DFA
+O_STATIC
+void test_dfa_lazy(oobj obj)
+{
+    OPattern *p = OPattern_new(obj, "%d+");
+    test(p->dfa == NULL);
+    struct o_str_range r = OPattern_find(p, "ab 123", NULL);
+    test(r.start == 3 && r.len == 3);
+    test(p->dfa == NULL);
+    r = OPattern_find(p, "1", NULL);
+    test(r.start == 0 && r.len == 1);
+    test(p->dfa != NULL);
+    o_del(p);
+}
+
+// compares the DFA with the backtracking matcher
+O_STATIC
+void test_differential(oobj obj)
+{
+    static const char alphabet[] = "abxc1.";
+    ou32 rnd = 1234;
+    char pattern[128];
+    char str[32];
+    struct o_str_range caps_dfa[16];
+    struct o_str_range caps_bt[16];
+    for (int p = 0; p < 400; p++) {
+        create_random_pattern(pattern, &rnd);
+        OPattern *dfa = OPattern_new(obj, pattern);
+        OPattern *bt = OPattern_new(obj, pattern);
+        OPattern_dfa_enabled_set(bt, false);
+        test(OPattern_dfa_available(dfa));
+
+        for (int s = 0; s < 40; s++) {
+            int len = (int) (rand_next(&rnd) % 20);
+            for (int i = 0; i < len; i++) {
+                str[i] = alphabet[rand_next(&rnd) % (sizeof alphabet - 1)];
+            }
+            str[len] = '\0';
+
+            struct o_str_range r_dfa = OPattern_find(dfa, str, caps_dfa);
+            struct o_str_range r_bt = OPattern_find(bt, str, caps_bt);
+            test(r_dfa.start == r_bt.start && r_dfa.len == r_bt.len);
+            for (osize c = 0; c < OPattern_captures(dfa); c++) {
+                test(caps_dfa[c].start == caps_bt[c].start && caps_dfa[c].len == caps_bt[c].len);
+            }
+
+            struct o_str_range_list m_dfa, m_bt;
+            osize n_dfa = OPattern_find_all(dfa, &m_dfa, NULL, str);
+            osize n_bt = OPattern_find_all(bt, &m_bt, NULL, str);
+            test(n_dfa == n_bt);
+            for (osize i = 0; i < n_dfa; i++) {
+                test(m_dfa.list[i].start == m_bt.list[i].start && m_dfa.list[i].len == m_bt.list[i].len);
+            }
+            o_str_range_list_free(&m_dfa);
+            o_str_range_list_free(&m_bt);
+        }
+        o_del(dfa);
+        o_del(bt);
+    }
+}
+
+O_STATIC
+void test_find_all_captures(oobj obj)
+{
+    OPattern *pattern = OPattern_new(obj, "(%a+)=(%d+)");
+    struct o_str_range_list matches;
+    struct o_str_range_list_list captures;
+    osize n = OPattern_find_all(pattern, &matches, &captures, "a=1, bb=22;ccc=333");
+    test(n == 3);
+    test(matches.list[1].start == 5 && matches.list[1].len == 5);
+    test(captures.list[1].list[0].start == 5 && captures.list[1].list[0].len == 2);
+    test(captures.list[1].list[1].start == 8 && captures.list[1].list[1].len == 2);
+    test(captures.list[2].list[1].start == 15 && captures.list[2].list[1].len == 3);
+    o_str_range_list_free(&matches);
+    o_str_range_list_list_free(&captures);
+
+    // multiple PLUS groups at the end of the data must all be matched
+    pattern = OPattern_new(obj, "a+b+");
+    test(OPattern_find(pattern, "xaa", NULL).len == 0);
+    OPattern_dfa_enabled_set(pattern, false);
+    test(OPattern_find(pattern, "xaa", NULL).len == 0);
+}
+
+
 int OPattern__test(oobj obj)
 {
     OPattern *pattern = OPattern_new(obj, ".*");
@@ -119,6 +243,9 @@ int OPattern__test(oobj obj)
                (struct o_str_range) {0, 1},
                (struct o_str_range[3]) {{0, 1}, {0, 0}, {0, 0}}, 3);
 
+    test_dfa_lazy(obj);
+    test_differential(obj);
+    test_find_all_captures(obj);
 
     return 0;
 }
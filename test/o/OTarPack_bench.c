@@ -0,0 +1,85 @@
+#include "o/OTarPack.h"
+#include "o/tar.h"
+#include "o/str.h"
+#include "o/timer.h"
+#include "o/log.h"
+#include <stdio.h>
+
+#define FILES 500
+#define FILE_SIZE (16 * 1024)
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "o", NULL, 0, "OTarPack_bench", __VA_ARGS__)
+
+int OTarPack__bench(oobj obj)
+{
+    const char *file = "OTarPack_bench.tar";
+
+    // asset pack like archive
+    struct o_tar_file *files = o_new0(obj, struct o_tar_file, FILES + 1);
+    char *data = o_new(obj, char, FILE_SIZE);
+    for (int i = 0; i < FILE_SIZE; i++) {
+        data[i] = (char) ('a' + i % 26);
+    }
+    for (int i = 0; i < FILES; i++) {
+        snprintf(files[i].name, sizeof files[i].name, "res/tex/asset_%i.png", i);
+        files[i].data = data;
+        files[i].data_size = FILE_SIZE;
+    }
+    if (!o_tar_write_file(file, files, FILES)) {
+        bench_log("failed to write the archive");
+        return 1;
+    }
+    const char *name = "res/tex/asset_250.png";
+    char *buf = o_new(obj, char, FILE_SIZE * FILES);
+
+    // old way: read in all files to get one
+    ou64 start = o_timer();
+    struct o_tar_file *read_files;
+    osize read_num = o_tar_read_file(obj, &read_files, file);
+    for (osize i = 0; i < read_num; i++) {
+        if (o_str_equals(read_files[i].name, name)) {
+            o_memcpy(buf, read_files[i].data, 1, read_files[i].data_size);
+            break;
+        }
+    }
+    double tar_s = o_timer_elapsed_s(start);
+    for (osize i = 0; i < read_num; i++) {
+        o_free(obj, read_files[i].data);
+    }
+    o_free(obj, read_files);
+
+    // index the headers and read a single member
+    start = o_timer();
+    oobj pack = OTarPack_new_file(obj, file).o;
+    OTarPack_read(pack, name, buf, FILE_SIZE);
+    double pack_s = o_timer_elapsed_s(start);
+
+    bench_log("%i files of %i bytes, load one: o_tar_read_file: %.3f ms, OTarPack_new_file + read: %.3f ms",
+              FILES, FILE_SIZE, tar_s * 1000.0, pack_s * 1000.0);
+
+    // read all members
+    struct OTarPack_read_job *jobs = o_new(obj, struct OTarPack_read_job, FILES);
+    for (int i = 0; i < FILES; i++) {
+        jobs[i] = (struct OTarPack_read_job) {files[i].name, buf + FILE_SIZE * i, FILE_SIZE, 0};
+    }
+    start = o_timer();
+    for (int i = 0; i < FILES; i++) {
+        OTarPack_read(pack, jobs[i].name, jobs[i].out_data, jobs[i].out_size);
+    }
+    double read_s = o_timer_elapsed_s(start);
+    start = o_timer();
+    OTarPack_read_parallel(pack, jobs, FILES);
+    double parallel_s = o_timer_elapsed_s(start);
+
+    double mb = (double) FILES * FILE_SIZE / (1024.0 * 1024.0);
+    bench_log("read all members: OTarPack_read: %.1f MB/s, OTarPack_read_parallel: %.1f MB/s",
+              mb / read_s, mb / parallel_s);
+
+    o_del(pack);
+    remove(file);
+    o_free(obj, jobs);
+    o_free(obj, buf);
+    o_free(obj, data);
+    o_free(obj, files);
+    return 0;
+}
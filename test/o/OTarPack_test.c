@@ -0,0 +1,230 @@
+#include "o/OTarPack.h"
+#include "o/OArray.h"
+#include "o/OStream.h"
+#include "o/OStreamArray.h"
+#include "o/OJson.h"
+#include "o/file.h"
+#include "o/tar.h"
+#include "o/str.h"
+#include <string.h>
+#include <stdio.h>
+
+#define test(expr) o_assume(expr, "test failed")
+
+#define FILES 40
+
+O_STATIC
+void file_content(char *out, osize out_size, int i)
+{
+    // different sizes, some across block boundaries
+    osize len = 0;
+    for (int j = 0; j <= i * 37 && len < out_size - 16; j++) {
+        len += snprintf(out + len, out_size - len, "%i,", i + j);
+    }
+}
+
+// writes a tar archive into an OStreamArray
+O_STATIC
+oobj create_archive(oobj obj)
+{
+    struct o_tar_file *files = o_new0(obj, struct o_tar_file, FILES + 1);
+    for (int i = 0; i < FILES; i++) {
+        char content[4096];
+        file_content(content, sizeof content, i);
+        if (i == 0) {
+            // json for the mount test
+            o_strf_buf(content, "{\"value\": 42}");
+        }
+        snprintf(files[i].name, sizeof files[i].name, "%sdir/file_%i.txt", i % 2 ? "./" : "", i);
+        files[i].data = o_str_clone(obj, content);
+        files[i].data_size = o_strlen(content);
+    }
+    oobj array = OArray_new_dyn(obj, NULL, 1, 0, 1024);
+    oobj stream = OStreamArray_new(obj, array, true, OStreamArray_SEEKABLE);
+    test(o_tar_write_stream(stream, files, FILES));
+    return stream;
+}
+
+O_STATIC
+void check_pack(oobj pack)
+{
+    test(OTarPack_num(pack) == FILES);
+    test(!OTarPack_find(pack, "dir/missing.txt", NULL));
+
+    char expected[4096];
+    char buf[4096];
+    for (int i = 1; i < FILES; i++) {
+        char name[64];
+        o_strf_buf(name, "dir/file_%i.txt", i);
+        file_content(expected, sizeof expected, i);
+        osize len = o_strlen(expected);
+
+        struct OTarPack_entry entry;
+        test(OTarPack_find(pack, name, &entry));
+        test(entry.size == len);
+
+        // read into a buffer
+        test(OTarPack_read(pack, name, buf, sizeof buf) == len);
+        test(memcmp(buf, expected, len) == 0);
+
+        // partial read
+        test(OTarPack_read(pack, name, buf, 3) == 3);
+
+        // stream
+        oobj stream = OTarPack_stream(pack, pack, name).o;
+        test(stream && OStream_size(stream) == len);
+        test(OStream_seek(stream, 1, OStream_SEEK_SET) == 1);
+        test(OStream_read_try(stream, buf, 1, sizeof buf) == len - 1);
+        test(memcmp(buf, expected + 1, len - 1) == 0);
+        o_del(stream);
+    }
+    test(OTarPack_read(pack, "dir/missing.txt", buf, sizeof buf) == -1);
+    test(OTarPack_stream(pack, pack, "dir/missing.txt").o == NULL);
+}
+
+O_STATIC
+void check_parallel(oobj obj, oobj pack)
+{
+    struct OTarPack_read_job jobs[FILES + 1];
+    char *bufs = o_new(obj, char, 4096 * (FILES + 1));
+    char names[FILES + 1][64];
+    for (int i = 0; i <= FILES; i++) {
+        o_strf_buf(names[i], "dir/file_%i.txt", i);
+        jobs[i] = (struct OTarPack_read_job) {names[i], bufs + 4096 * i, 4096, 0};
+    }
+    // the last one does not exist
+    test(OTarPack_read_parallel(pack, jobs, FILES + 1) == FILES);
+    test(jobs[FILES].out_read == -1);
+    char expected[4096];
+    for (int i = 1; i < FILES; i++) {
+        file_content(expected, sizeof expected, i);
+        test(jobs[i].out_read == o_strlen(expected));
+        test(memcmp(jobs[i].out_data, expected, jobs[i].out_read) == 0);
+    }
+    o_free(obj, bufs);
+}
+
+O_STATIC
+void check_mount(oobj obj, oobj pack)
+{
+    test(OTarPack_mounted("pack/dir/file_1.txt", NULL).o == NULL);
+    test(OTarPack_mount(pack, "pack/"));
+    test(!OTarPack_mount(pack, "pack/"));
+
+    const char *name;
+    test(OTarPack_mounted("pack/dir/file_1.txt", &name).o == pack);
+    test(o_str_equals(name, "dir/file_1.txt"));
+    test(OTarPack_mounted("dir/file_1.txt", NULL).o == NULL);
+
+    // o_file_read and loaders resolve through the pack
+    char expected[4096];
+    file_content(expected, sizeof expected, 3);
+    oobj data = o_file_read(obj, "pack/dir/file_3.txt", false, 1).o;
+    test(data && OArray_num(data) == o_strlen(expected));
+    test(memcmp(OArray_data_void(data), expected, OArray_num(data)) == 0);
+    o_del(data);
+
+    oobj json = OJson_new_read_file(obj, NULL, "pack/dir/file_0.txt").o;
+    test(json && *OJson_number(OJson_get(json, "value").o) == 42);
+    o_del(json);
+
+    // writes are not affected
+    test(o_file_open(obj, "pack/dir/file_3.txt", "r+b").o == NULL);
+
+
+    OTarPack_unmount(pack);
+    test(OTarPack_mounted("pack/dir/file_1.txt", NULL).o == NULL);
+    test(o_file_read(obj, "pack/dir/file_3.txt", false, 1).o == NULL);
+}
+
+O_STATIC
+void test_stream(oobj obj)
+{
+    oobj pack = OTarPack_new(obj, create_archive(obj));
+    check_pack(pack);
+    check_parallel(obj, pack);
+    check_mount(obj, pack);
+
+    // mounted packs are unmounted in the deletor
+    test(OTarPack_mount(pack, NULL));
+    test(OTarPack_mounted("dir/file_1.txt", NULL).o == pack);
+    o_del(pack);
+    test(OTarPack_mounted("dir/file_1.txt", NULL).o == NULL);
+}
+
+// deletes parent, which holds the pack
+O_STATIC
+void check_outlive(oobj obj, oobj parent, oobj pack)
+{
+    test(OTarPack_mount(pack, NULL));
+    char expected[4096];
+    file_content(expected, sizeof expected, 2);
+    osize len = o_strlen(expected);
+
+    // mounted streams may be deleted after the pack, even a sibling created later
+    oobj sibling = o_file_open(parent, "dir/file_2.txt", "rb").o;
+    oobj stream = o_file_open(obj, "dir/file_2.txt", "rb").o;
+    test(sibling && stream);
+    o_del(parent);
+    test(OTarPack_mounted("dir/file_2.txt", NULL).o == NULL);
+
+    char buf[4096];
+    test(OStream_read(stream, buf, 1, sizeof buf) == len);
+    test(memcmp(buf, expected, len) == 0);
+    o_del(stream);
+}
+
+O_STATIC
+void test_outlive(oobj obj)
+{
+    oobj parent = OObj_new(obj);
+    check_outlive(obj, parent, OTarPack_new(parent, create_archive(parent)));
+}
+
+O_STATIC
+void test_file(oobj obj)
+{
+    const char *file = "OTarPack_test.tar";
+    oobj stream = create_archive(obj);
+    oobj array = ((OStreamArray *) stream)->array;
+    test(o_file_write(file, false, OArray_data_void(array), 1, OArray_num(array)) == OArray_num(array));
+
+    oobj pack = OTarPack_new_file(obj, file).o;
+    test(pack);
+    check_pack(pack);
+    check_parallel(obj, pack);
+#ifdef MIA_PLATFORM_UNIX
+    osize size;
+    const char *view = OTarPack_view(pack, "dir/file_0.txt", &size);
+    test(view && size == 13 && strncmp(view, "{\"value\": 42}", size) == 0);
+#endif
+    o_del(pack);
+
+    oobj parent = OObj_new(obj);
+    check_outlive(obj, parent, OTarPack_new_file(parent, file).o);
+    remove(file);
+
+    test(OTarPack_new_file(obj, file).o == NULL);
+}
+
+O_STATIC
+void test_invalid(oobj obj)
+{
+    char garbage[2048];
+    for (int i = 0; i < (int) sizeof garbage; i++) {
+        garbage[i] = (char) (i * 7 + 3);
+    }
+    oobj array = OArray_new(obj, garbage, 1, sizeof garbage);
+    oobj pack = OTarPack_new(obj, OStreamArray_new(obj, array, true, OStreamArray_SEEKABLE));
+    test(OTarPack_num(pack) == 0);
+    o_del(pack);
+}
+
+int OTarPack__test(oobj root)
+{
+    test_stream(root);
+    test_outlive(root);
+    test_file(root);
+    test_invalid(root);
+    return 0;
+}
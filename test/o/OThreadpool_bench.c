@@ -0,0 +1,99 @@
+#include "o/OObj.h"
+#include "o/timer.h"
+#include "o/log.h"
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "o", NULL, 0, "OThreadpool_bench", __VA_ARGS__)
+
+#ifdef MIA_OPTION_THREAD
+
+#include "o/OThreadpool.h"
+#include "o/OFuture.h"
+#include <SDL2/SDL_atomic.h>
+
+#define TASKS 20000
+#define WORK 256
+
+static SDL_atomic_t L_done;
+static oobj L_futures[TASKS];
+
+O_STATIC
+void task_work(oobj future)
+{
+    // some fine grained work, like a small image tile
+    volatile ou32 acc = 0;
+    for(int i=0; i<WORK; i++) {
+        acc = acc * 31u + (ou32) i;
+    }
+    SDL_AtomicIncRef(&L_done);
+}
+
+O_STATIC
+void task_spawn(oobj future)
+{
+    // submissions from inside of a task
+    OFuture *self = future;
+    oobj container = o_user(future);
+    for(int i=0; i<TASKS; i++) {
+        L_futures[i] = OFuture_new_run(container, task_work, self->opt_threadpool, NULL);
+    }
+}
+
+O_STATIC
+void wait_done(void)
+{
+    for(int i=0; i<TASKS; i++) {
+        OFuture_wait(L_futures[i]);
+    }
+    o_assume(SDL_AtomicGet(&L_done) == TASKS, "tasks missing");
+}
+
+O_STATIC
+void bench_workers(oobj obj, int workers)
+{
+    oobj pool = OThreadpool_new(obj, workers);
+
+    // submissions from the main thread
+    oobj container = OObj_new(obj);
+    SDL_AtomicSet(&L_done, 0);
+    ou64 start = o_timer();
+    for(int i=0; i<TASKS; i++) {
+        L_futures[i] = OFuture_new_run(container, task_work, pool, NULL);
+    }
+    wait_done();
+    double external_s = o_timer_elapsed_s(start);
+    o_del(container);
+
+    // submissions from a pool thread
+    container = OObj_new(obj);
+    SDL_AtomicSet(&L_done, 0);
+    start = o_timer();
+    oobj spawner = OFuture_new_run(obj, task_spawn, pool, container);
+    OFuture_wait(spawner);
+    wait_done();
+    double nested_s = o_timer_elapsed_s(start);
+    o_del(spawner);
+    o_del(container);
+
+    o_del(pool);
+
+    bench_log("%i workers: %.0f tasks/s submitted from main, %.0f tasks/s submitted from a task",
+              workers, TASKS / external_s, TASKS / nested_s);
+}
+
+int OThreadpool__bench(oobj root)
+{
+    for(int workers=1; workers<=8; workers*=2) {
+        bench_workers(root, workers);
+    }
+    return 0;
+}
+
+#else
+
+int OThreadpool__bench(oobj root)
+{
+    bench_log("MIA_OPTION_THREAD not set");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include "o/OObj.h"
+
+#define test(expr) o_assume(expr, "test failed")
+
+#ifdef MIA_OPTION_THREAD
+
+#include "o/OThreadpool.h"
+#include "o/OFuture.h"
+#include <SDL2/SDL_atomic.h>
+
+#define CHILDREN 64
+
+static SDL_atomic_t L_count;
+static SDL_atomic_t L_in_pool;
+
+O_STATIC
+void leaf(oobj future)
+{
+    OFuture *self = future;
+    if(OThreadpool_in_pool(self->opt_threadpool)) {
+        SDL_AtomicIncRef(&L_in_pool);
+    }
+    SDL_AtomicIncRef(&L_count);
+}
+
+O_STATIC
+void spawner(oobj future)
+{
+    // pushed into the deque of this thread, others steal
+    OFuture *self = future;
+    oobj container = o_user(self);
+    for(int i=0; i<CHILDREN; i++) {
+        OFuture_new_run(container, leaf, self->opt_threadpool, NULL);
+    }
+    SDL_AtomicIncRef(&L_count);
+}
+
+O_STATIC
+void test_nested(oobj obj, int threads)
+{
+    SDL_AtomicSet(&L_count, 0);
+    SDL_AtomicSet(&L_in_pool, 0);
+
+    oobj pool = OThreadpool_new(obj, threads);
+    test(!OThreadpool_in_pool(pool));
+
+    oobj containers[8];
+    oobj spawners[8];
+    for(int i=0; i<8; i++) {
+        containers[i] = OObj_new(obj);
+        spawners[i] = OFuture_new_run(obj, spawner, pool, containers[i]);
+    }
+    for(int i=0; i<8; i++) {
+        OFuture_wait(spawners[i]);
+    }
+
+    // deleting the pool runs all pending futures
+    o_del(pool);
+    test(SDL_AtomicGet(&L_count) == 8 * (CHILDREN + 1));
+    test(SDL_AtomicGet(&L_in_pool) == 8 * CHILDREN);
+    for(int i=0; i<8; i++) {
+        oobj *list = OObj_list(containers[i], NULL, OFuture);
+        for(oobj *it = list; *it; it++) {
+            test(OFuture_finished(*it));
+        }
+        o_free(containers[i], list);
+        o_del(containers[i]);
+        o_del(spawners[i]);
+    }
+}
+
+int OThreadpool__test(oobj root)
+{
+    test_nested(root, 1);
+    test_nested(root, 4);
+    return 0;
+}
+
+#else
+
+int OThreadpool__test(oobj root)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include "o/OObjRoot.h"
+#include "o/allocator.h"
+#include "o/timer.h"
+#include "o/log.h"
+
+#ifdef MIA_OPTION_THREAD
+#include "o/OThread.h"
+#endif
+
+#define ROUNDS 2000
+#define BLOCKS 64
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "o", NULL, 0, "o_allocator_bench", __VA_ARGS__)
+
+struct job {
+    struct o_allocator_i a;
+    ou32 seed;
+};
+
+// allocates and frees BLOCKS small pointers of random sizes, ROUNDS times
+O_STATIC
+void job_run(struct job *job)
+{
+    void *mem[BLOCKS];
+    ou32 x = job->seed;
+    for(int r=0; r<ROUNDS; r++) {
+        for(int i=0; i<BLOCKS; i++) {
+            x = x * 1103515245 + 12345;
+            mem[i] = o_allocator_i_realloc_try(job->a, NULL, 1, 8 + (x >> 16) % 248);
+            *((char *) mem[i]) = (char) i;
+        }
+        for(int i=0; i<BLOCKS; i++) {
+            o_allocator_i_realloc_try(job->a, mem[i], 0, 0);
+        }
+    }
+}
+
+#ifdef MIA_OPTION_THREAD
+O_STATIC
+void job_thread(oobj thread)
+{
+    job_run(o_user(thread));
+}
+#endif
+
+O_STATIC
+void bench_allocator(oobj obj, struct o_allocator_i a, int threads)
+{
+    struct job jobs[8];
+    for(int t=0; t<threads; t++) {
+        jobs[t] = (struct job) {a, 1234 + t};
+    }
+
+    ou64 start = o_timer();
+#ifdef MIA_OPTION_THREAD
+    oobj list[8];
+    for(int t=0; t<threads; t++) {
+        list[t] = OThread_new_run(obj, job_thread, "allocator_bench", &jobs[t]);
+    }
+    for(int t=0; t<threads; t++) {
+        o_del(list[t]);
+    }
+#else
+    for(int t=0; t<threads; t++) {
+        job_run(&jobs[t]);
+    }
+#endif
+    double s = o_timer_elapsed_s(start);
+
+    double ops = 2.0 * ROUNDS * BLOCKS * threads;
+    bench_log("%-5s %i threads: %.1f M alloc+free/s", a.name, threads, ops / s / 1e6);
+}
+
+int o_allocator__bench(oobj obj)
+{
+    for(int threads=1; threads<=8; threads*=2) {
+        struct o_allocator_i heap = o_allocator_heap_new();
+        bench_allocator(obj, heap, threads);
+
+        struct o_allocator_i pool = o_allocator_pool_new(-1, -1, -1);
+        bench_allocator(obj, pool, threads);
+        o_allocator_pool_del(&pool);
+
+        struct o_allocator_i slab = o_allocator_slab_new(-1);
+        bench_allocator(obj, slab, threads);
+        o_allocator_slab_del(&slab);
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include "o/OObjRoot.h"
+#include "o/allocator.h"
+
+#ifdef MIA_OPTION_THREAD
+#include "o/OThread.h"
+#endif
+
+#define test(expr) o_assume(expr, "test failed")
+
+O_STATIC
+void test_slab_realloc(void)
+{
+    struct o_allocator_i a = o_allocator_slab_new(256);
+    test(o_allocator_slab_block_size_max(a) == 256);
+
+    // grow from the smallest class into the heap, the content must survive
+    char *mem = o_allocator_i_realloc_try(a, NULL, 1, 8);
+    test(o_allocator_slab_pointer_slabbed(a, mem));
+    for(int i=0; i<8; i++) {
+        mem[i] = (char) i;
+    }
+    for(int n=16; n<=1024; n*=2) {
+        mem = o_allocator_i_realloc_try(a, mem, 1, n);
+        test(o_allocator_slab_pointer_slabbed(a, mem) == (n<=256));
+        for(int i=0; i<8; i++) {
+            test(mem[i] == (char) i);
+        }
+    }
+    o_allocator_i_realloc_try(a, mem, 0, 0);
+
+    // foreign pointers are never slabbed
+    int stack_val;
+    test(!o_allocator_slab_pointer_slabbed(a, &stack_val));
+    test(!o_allocator_slab_pointer_slabbed(a, NULL));
+    test(o_allocator_slab_blocks_used(a) == 0);
+
+    o_allocator_slab_del(&a);
+}
+
+O_STATIC
+void test_slab_tree(void)
+{
+    oobj root = OObjRoot_new_slab();
+    struct o_allocator_i a = OObj_allocator(root);
+    for(int i=0; i<1000; i++) {
+        oobj obj = OObj_new(root);
+        o_new(obj, char, i);
+    }
+    test(o_allocator_slab_blocks_used(a) > 0);
+    o_del(root);
+    test(o_allocator_slab_blocks_used(a) == 0);
+    o_allocator_slab_del(&a);
+}
+
+#ifdef MIA_OPTION_THREAD
+
+// allocates in the thread, the main thread frees
+O_STATIC
+void slab_thread(oobj thread)
+{
+    void **list = o_user(thread);
+    struct o_allocator_i a = *((struct o_allocator_i *) list[0]);
+    for(int i=1; i<=1000; i++) {
+        list[i] = o_allocator_i_realloc_try(a, NULL, 1, 1 + i%500);
+    }
+}
+
+O_STATIC
+void test_slab_threads(oobj obj)
+{
+    struct o_allocator_i a = o_allocator_slab_new(-1);
+    void *lists[4][1001];
+    oobj threads[4];
+    for(int t=0; t<4; t++) {
+        lists[t][0] = &a;
+        threads[t] = OThread_new_run(obj, slab_thread, "slab_test", lists[t]);
+    }
+    for(int t=0; t<4; t++) {
+        o_del(threads[t]);
+        for(int i=1; i<=1000; i++) {
+            o_allocator_i_realloc_try(a, lists[t][i], 0, 0);
+        }
+    }
+    test(o_allocator_slab_blocks_used(a) == 0);
+    o_allocator_slab_del(&a);
+}
+
+#endif
+
+O_STATIC
+void test_thread_calls(void)
+{
+    struct o_allocator_i a = o_allocator_heap_new();
+    osize calls = o_allocator_thread_calls();
+    void *mem = o_allocator_i_realloc_try(a, NULL, 1, 16);
+    o_allocator_i_realloc_try(a, mem, 0, 0);
+#ifdef MIA_OPTION_ALLOCATOR_COUNT
+    test(o_allocator_thread_calls() - calls == 2);
+#else
+    test(o_allocator_thread_calls() == 0 && calls == 0);
+#endif
+}
+
+int o_allocator__test(oobj obj)
+{
+    test_thread_calls();
+    test_slab_realloc();
+    test_slab_tree();
+#ifdef MIA_OPTION_THREAD
+    test_slab_threads(obj);
+#endif
+    return 0;
+}
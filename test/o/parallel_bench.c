@@ -0,0 +1,84 @@
+#include "o/parallel.h"
+#include "o/OObj.h"
+#include "o/timer.h"
+#include "o/log.h"
+
+#ifdef MIA_OPTION_THREAD
+#include "o/OThreadpool.h"
+#endif
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "o", NULL, 0, "o_parallel_bench", __VA_ARGS__)
+
+// 4k canvas
+#define COLS 3840
+#define ROWS 2160
+#define ROUNDS 4
+
+struct canvas {
+    obyte *rgba;
+    float *out;
+};
+
+O_STATIC
+void canvas_run(osize begin, osize end, void *user)
+{
+    // like UImg_add_scaled on a RGBA_8 image, with the conversion to float and back
+    struct canvas *c = user;
+    for(osize i=begin; i<end; i++) {
+        float sum = 0;
+        for(int ch=0; ch<4; ch++) {
+            float v = c->rgba[i*4+ch] / 255.0f;
+            v = o_clamp((v + 0.1f) * 0.9f, 0.0f, 1.0f);
+            c->rgba[i*4+ch] = (obyte) (v * 255.0f);
+            sum += v;
+        }
+        c->out[i] = sum;
+    }
+}
+
+O_STATIC
+double bench_pool(oobj opt_pool, struct canvas *c)
+{
+    ou64 start = o_timer();
+    for(int r=0; r<ROUNDS; r++) {
+        o_parallel_for(opt_pool, (osize) COLS * ROWS, 16384, canvas_run, c);
+    }
+    return o_timer_elapsed_s(start) / ROUNDS;
+}
+
+int o_parallel__bench(oobj root)
+{
+    struct canvas c;
+    c.rgba = o_new0(root, obyte, (osize) COLS * ROWS * 4);
+    c.out = o_new0(root, float, (osize) COLS * ROWS);
+
+    // warm up, touches all pages
+    canvas_run(0, (osize) COLS * ROWS, &c);
+
+    ou64 start = o_timer();
+    for(int r=0; r<ROUNDS; r++) {
+        canvas_run(0, (osize) COLS * ROWS, &c);
+    }
+    double serial_s = o_timer_elapsed_s(start) / ROUNDS;
+    bench_log("4k canvas serial: %.2f ms", serial_s * 1000.0);
+
+#ifdef MIA_OPTION_THREAD
+    // the calling thread works, too
+    for(int cores=2; cores<=8; cores*=2) {
+        oobj pool = OThreadpool_new(root, cores-1);
+        double s = bench_pool(pool, &c);
+        bench_log("4k canvas %i cores: %.2f ms, speed up: %.2fx", cores, s * 1000.0, serial_s / s);
+        o_del(pool);
+    }
+    oobj pool = o_parallel_pool();
+    if(pool) {
+        double s = bench_pool(NULL, &c);
+        bench_log("4k canvas o_parallel_pool (%i cores): %.2f ms, speed up: %.2fx",
+                  (int) OThreadpool_threads(pool) + 1, s * 1000.0, serial_s / s);
+    }
+#endif
+
+    o_free(root, c.rgba);
+    o_free(root, c.out);
+    return 0;
+}
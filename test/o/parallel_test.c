@@ -0,0 +1,96 @@
+#include "o/parallel.h"
+#include "o/OObj.h"
+
+#ifdef MIA_OPTION_THREAD
+#include "o/OThreadpool.h"
+#endif
+
+#define test(expr) o_assume(expr, "test failed")
+
+#define NUM 100003
+
+O_STATIC
+void fill_run(osize begin, osize end, void *user)
+{
+    int *data = user;
+    for(osize i=begin; i<end; i++) {
+        data[i] += (int) i;
+    }
+}
+
+O_STATIC
+void sum_run(osize begin, osize end, void *inout_partial, void *user)
+{
+    const int *data = user;
+    oi64 *sum = inout_partial;
+    for(osize i=begin; i<end; i++) {
+        *sum += data[i];
+    }
+}
+
+O_STATIC
+void sum_join(void *inout_result, const void *partial, void *user)
+{
+    *(oi64 *) inout_result += *(const oi64 *) partial;
+}
+
+struct tile_check {
+    int cols;
+    int *data;
+};
+
+O_STATIC
+void tile_run(int col_begin, int col_end, int row_begin, int row_end, void *user)
+{
+    struct tile_check *t = user;
+    for(int r=row_begin; r<row_end; r++) {
+        for(int c=col_begin; c<col_end; c++) {
+            t->data[r * t->cols + c]++;
+        }
+    }
+}
+
+O_STATIC
+void test_pool(oobj obj, oobj opt_pool)
+{
+    int *data = o_new0(obj, int, NUM);
+
+    // each index exactly once
+    for(int grain=-1; grain<=NUM*2; grain = grain<=0? 1 : grain*37) {
+        o_clear(data, sizeof *data, NUM);
+        o_parallel_for(opt_pool, NUM, grain, fill_run, data);
+        for(int i=0; i<NUM; i++) {
+            test(data[i] == i);
+        }
+
+        // initial value is neutral
+        oi64 sum = 0;
+        o_parallel_reduce(opt_pool, NUM, grain, &sum, sizeof sum, sum_run, sum_join, data);
+        test(sum == (oi64) NUM * (NUM - 1) / 2);
+    }
+
+    // tiles cover each element exactly once
+    struct tile_check t = {317, data};
+    int rows = NUM / t.cols;
+    int tiles[][2] = {{0, 0}, {1, 1}, {64, 16}, {1000, 7}, {317, 1}};
+    for(int i=0; i<5; i++) {
+        o_clear(data, sizeof *data, NUM);
+        o_parallel_for_2d(opt_pool, t.cols, rows, tiles[i][0], tiles[i][1], tile_run, &t);
+        for(int j=0; j<t.cols*rows; j++) {
+            test(data[j] == 1);
+        }
+    }
+
+    o_free(obj, data);
+}
+
+int o_parallel__test(oobj root)
+{
+    test_pool(root, NULL);
+#ifdef MIA_OPTION_THREAD
+    oobj pool = OThreadpool_new(root, 3);
+    test_pool(root, pool);
+    o_del(pool);
+#endif
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "r/RBuffer.h"
+#include "r/RObjQuad.h"
+#include "r/tex.h"
+
+O_STATIC
+void dirty_mark(void)
+{
+    struct RBuffer_dirty dirty = {0};
+
+    // the first mark forces a full upload of former unmarked changes
+    RBuffer_dirty_mark(&dirty, 10, 2);
+    assert(dirty.tracking && dirty.all);
+    assert(dirty.spans_num == 1 && dirty.spans[0].begin == 10 && dirty.spans[0].end == 12);
+
+    // touching and overlapping spans merge, far spans stay separate and sorted
+    RBuffer_dirty_mark(&dirty, 12, 3);
+    RBuffer_dirty_mark(&dirty, 90, 1);
+    RBuffer_dirty_mark(&dirty, 0, 1);
+    RBuffer_dirty_mark(&dirty, 9, 2);
+    assert(dirty.spans_num == 3);
+    assert(dirty.spans[0].begin == 0 && dirty.spans[0].end == 1);
+    assert(dirty.spans[1].begin == 9 && dirty.spans[1].end == 15);
+    assert(dirty.spans[2].begin == 90 && dirty.spans[2].end == 91);
+
+    // a span covering others absorbs them
+    RBuffer_dirty_mark(&dirty, 5, 90);
+    assert(dirty.spans_num == 2 && dirty.spans[1].begin == 5 && dirty.spans[1].end == 95);
+
+    // above the max, the closest neighbours merge
+    dirty.spans_num = 0;
+    for (int i = 0; i < RBuffer_DIRTY_SPANS_MAX; i++) {
+        RBuffer_dirty_mark(&dirty, i * 100, 1);
+    }
+    RBuffer_dirty_mark(&dirty, 103, 1);
+    assert(dirty.spans_num == RBuffer_DIRTY_SPANS_MAX);
+    assert(dirty.spans[1].begin == 100 && dirty.spans[1].end == 104);
+}
+
+O_STATIC
+void dirty_upload(oobj obj)
+{
+    const osize num = 100;
+    oobj quads = RObjQuad_new(obj, (int) num, r_tex_white(), false);
+    const osize element_size = sizeof(struct r_quad);
+    struct r_stats *stats = r_stats_frame();
+
+    // not tracked -> full uploads
+    osize bytes = stats->buffer_uploaded_bytes;
+    osize full = stats->buffer_full_uploads;
+    RObj_update(quads);
+    assert(stats->buffer_uploaded_bytes - bytes == element_size * num);
+    assert(stats->buffer_full_uploads - full == 1);
+
+    // the first mark uploads all
+    RObjQuad_mark_dirty(quads, 0, 1);
+    RObj_update(quads);
+
+    // two sprites at opposite ends only upload themselves
+    bytes = stats->buffer_uploaded_bytes;
+    full = stats->buffer_full_uploads;
+    RObjQuad_at(quads, 0)->pose.m30 += 1;
+    RObjQuad_mark_dirty(quads, 0, 1);
+    RObjQuad_at(quads, num - 1)->pose.m30 += 1;
+    RObjQuad_mark_dirty(quads, num - 1, 1);
+    RObj_update(quads);
+    assert(stats->buffer_uploaded_bytes - bytes == element_size * 2);
+    assert(stats->buffer_full_uploads == full);
+
+    // nothing marked, nothing uploaded
+    bytes = stats->buffer_uploaded_bytes;
+    RObj_update(quads);
+    assert(stats->buffer_uploaded_bytes == bytes);
+
+    // most quads changed -> a single orphaning upload
+    RObjQuad_mark_dirty(quads, 0, 30);
+    RObjQuad_mark_dirty(quads, 50, 30);
+    RObj_update(quads);
+    assert(stats->buffer_uploaded_bytes - bytes == element_size * num);
+    assert(stats->buffer_full_uploads - full == 1);
+
+    o_del(quads);
+}
+
+int RBuffer__test(oobj obj)
+{
+    dirty_mark();
+    dirty_upload(obj);
+
+    return 0;
+}
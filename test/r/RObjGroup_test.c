@@ -0,0 +1,120 @@
+#include "r/RObjGroup.h"
+#include "r/RObjQuad.h"
+#include "r/RShaderQuad.h"
+#include "r/tex.h"
+#include "u/pose.h"
+
+#define COLS 32
+#define ROWS 32
+
+// adds a RObjQuad child with num quads in a row at y
+O_STATIC
+RObjQuad *quads_add(oobj group, oobj tex, int num, float y, vec4 color)
+{
+    RObjQuad *quads = RObjQuad_new(group, num, tex, false);
+    for (int i = 0; i < num; i++) {
+        struct r_quad *q = RObjQuad_at(quads, i);
+        q->pose = u_pose_new(-12.0f + i * 6.0f, y, 4, 4);
+        q->s = color;
+    }
+    return quads;
+}
+
+O_STATIC
+void render(oobj group, oobj target, bvec4 *out_pixels, struct r_stats *out_stats)
+{
+    RTex_clear(target, vec4_(0, 0, 0, 1));
+    struct r_stats start = *r_stats_frame();
+    RObj_render(group, target);
+    struct r_stats *stats = r_stats_frame();
+    out_stats->draw_calls = stats->draw_calls - start.draw_calls;
+    out_stats->state_changes = stats->state_changes - start.state_changes;
+    RTex_get(target, out_pixels);
+}
+
+O_STATIC
+void batch(oobj obj)
+{
+    oobj target = RTex_new(obj, NULL, COLS, ROWS);
+    bvec4 red_px = bvec4_(255, 0, 0, 255);
+    oobj red = RTex_new(obj, &red_px, 1, 1);
+
+    // a and b merge, c has an other tex, d starts a new batch
+    oobj group = RObjGroup_new(obj);
+    RObjQuad *a = quads_add(group, r_tex_white(), 3, -9, vec4_(1, 1, 1, 1));
+    quads_add(group, r_tex_white(), 2, -3, vec4_(0, 1, 0, 1));
+    quads_add(group, red, 1, 3, vec4_(1, 1, 1, 1));
+    quads_add(group, r_tex_white(), 2, 9, vec4_(0, 0, 1, 0.5f));
+
+    // a different tex set on the shader must survive the batch
+    RShaderQuad *a_shader = RObjQuad_shader(a, 0);
+    a_shader->tex = red;
+
+    static bvec4 plain[COLS * ROWS], batched[COLS * ROWS];
+    struct r_stats plain_stats, batched_stats;
+    render(group, target, plain, &plain_stats);
+    a_shader->tex = red;
+
+    RObjGroup_batch_set(group, true);
+    render(group, target, batched, &batched_stats);
+    assert(a_shader->tex == red);
+
+    assert(memcmp(plain, batched, sizeof plain) == 0);
+    assert(plain_stats.draw_calls == 4);
+    assert(batched_stats.draw_calls == 3);
+    assert(batched_stats.state_changes < plain_stats.state_changes);
+
+    o_del(group);
+    o_del(red);
+    o_del(target);
+}
+
+static int override_updates, override_renders;
+
+O_STATIC
+void override_update(oobj obj)
+{
+    override_updates++;
+    RObjQuad__v_update(obj);
+}
+
+O_STATIC
+void override_render(oobj obj, oobj tex, const struct r_proj *proj)
+{
+    override_renders++;
+    RObjQuad__v_render(obj, tex, proj);
+}
+
+O_STATIC
+void batch_override(oobj obj)
+{
+    oobj target = RTex_new(obj, NULL, COLS, ROWS);
+
+    // overridden virtual functions must not be bypassed by the batch
+    oobj group = RObjGroup_new(obj);
+    quads_add(group, r_tex_white(), 2, -9, vec4_(1, 1, 1, 1));
+    RObjQuad *custom = quads_add(group, r_tex_white(), 2, 0, vec4_(0, 1, 0, 1));
+    quads_add(group, r_tex_white(), 2, 9, vec4_(0, 0, 1, 1));
+    custom->super.v_update = override_update;
+    custom->super.v_render = override_render;
+    RObjGroup_batch_set(group, true);
+
+    static bvec4 pixels[COLS * ROWS];
+    struct r_stats stats;
+    override_updates = override_renders = 0;
+    render(group, target, pixels, &stats);
+    assert(override_updates == 1);
+    assert(override_renders == 1);
+    assert(stats.draw_calls == 3);
+
+    o_del(group);
+    o_del(target);
+}
+
+int RObjGroup__test(oobj obj)
+{
+    batch(obj);
+    batch_override(obj);
+
+    return 0;
+}
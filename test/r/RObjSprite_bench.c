@@ -0,0 +1,72 @@
+#include "r/RObjQuad.h"
+#include "r/RObjSprite.h"
+#include "r/tex.h"
+#include "r/gl.h"
+#include "o/timer.h"
+#include "o/log.h"
+#include "m/flt.h"
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "r", NULL, 0, "RObjSprite_bench", __VA_ARGS__)
+
+#define NUM 20000
+#define FRAMES 30
+
+// moves all sprites each frame, so every frame needs a full upload
+O_STATIC
+void bench_quad(oobj obj, oobj target, double *out_ms, osize *out_bytes)
+{
+    RObjQuad *quads = RObjQuad_new(obj, NUM, r_tex_white(), false);
+    osize bytes_start = r_stats_frame()->buffer_uploaded_bytes;
+    ou64 start = o_timer();
+    for (int f = 0; f < FRAMES; f++) {
+        for (int i = 0; i < NUM; i++) {
+            struct r_quad *q = RObjQuad_at(quads, i);
+            q->pose.m30 = (float) ((i + f) % 128 - 64);
+            q->pose.m31 = (float) (i / 128 % 128 - 64);
+        }
+        RObj_render_ex(quads, target, NULL, true);
+    }
+    glFinish();
+    *out_ms = o_timer_elapsed_s(start) * 1000.0 / FRAMES;
+    *out_bytes = (r_stats_frame()->buffer_uploaded_bytes - bytes_start) / FRAMES;
+    o_del(quads);
+}
+
+O_STATIC
+void bench_sprite(oobj obj, oobj target, double *out_ms, osize *out_bytes)
+{
+    RObjSprite *sprites = RObjSprite_new(obj, NUM, r_tex_white(), false);
+    osize bytes_start = r_stats_frame()->buffer_uploaded_bytes;
+    ou64 start = o_timer();
+    for (int f = 0; f < FRAMES; f++) {
+        for (int i = 0; i < NUM; i++) {
+            struct r_sprite *s = RObjSprite_at(sprites, i);
+            s->pos.x = (float) ((i + f) % 128 - 64);
+            s->pos.y = (float) (i / 128 % 128 - 64);
+        }
+        RObj_render_ex(sprites, target, NULL, true);
+    }
+    glFinish();
+    *out_ms = o_timer_elapsed_s(start) * 1000.0 / FRAMES;
+    *out_bytes = (r_stats_frame()->buffer_uploaded_bytes - bytes_start) / FRAMES;
+    o_del(sprites);
+}
+
+int RObjSprite__bench(oobj obj)
+{
+    RTex *target = RTex_new(obj, NULL, 128, 128);
+    double quad_ms, sprite_ms;
+    osize quad_bytes, sprite_bytes;
+
+    bench_quad(obj, target, &quad_ms, &quad_bytes);
+    bench_sprite(obj, target, &sprite_ms, &sprite_bytes);
+
+    bench_log("%i moving sprites: r_quad: %.3f ms/frame, %.1f KiB/frame, "
+              "r_sprite: %.3f ms/frame, %.1f KiB/frame (%.1fx less)",
+              NUM,
+              quad_ms, quad_bytes / 1024.0,
+              sprite_ms, sprite_bytes / 1024.0,
+              (double) quad_bytes / o_max(1, sprite_bytes));
+    o_del(target);
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "r/RShader.h"
+#include "r/RProgram.h"
+#include "r/RTex.h"
+#include "r/program.h"
+#include "r/state.h"
+#include "r/tex.h"
+#include "u/pose.h"
+
+O_STATIC
+int resolved(void)
+{
+    return r_stats_frame()->shader_handles_resolved;
+}
+
+O_STATIC
+void handles(oobj obj)
+{
+    static const char *const names[] = {"u_s", "u_t", NULL};
+    struct RShader_handles_cache cache = {0};
+    oobj a = r_program_Quad();
+    oobj b = r_program_Quad_color();
+
+    // switching between programs hits the cache
+    int start = resolved();
+    const struct RShader_handles *ha = RShader_handles_get(&cache, a, names);
+    const struct RShader_handles *hb = RShader_handles_get(&cache, b, names);
+    assert(RShader_handles_get(&cache, a, names) == ha);
+    assert(RShader_handles_get(&cache, b, names) == hb);
+    assert(resolved() - start == 2);
+    assert(ha->generation == RProgram_generation(a) && ha->extra[2] == -1);
+
+    // a new program may reuse the address and gl name of a deleted one, but never its generation
+    oobj p = RProgram_new_file(obj, "res/r/Quad.glsl", NULL, 1);
+    ou32 generation = RProgram_generation(p);
+    RShader_handles_get(&cache, p, names);
+    o_del(p);
+    p = RProgram_new_file(obj, "res/r/Quad.glsl", NULL, 1);
+    assert(RProgram_generation(p) != generation);
+    start = resolved();
+    const struct RShader_handles *hp = RShader_handles_get(&cache, p, names);
+    assert(resolved() - start == 1);
+    assert(hp->generation == RProgram_generation(p));
+    o_del(p);
+}
+
+O_STATIC
+void shared_shader(oobj obj)
+{
+    oobj tex = RTex_new(obj, NULL, 8, 8);
+    mat4 pose = u_pose_new(0, 0, 8, 8);
+    mat4 uv = u_pose_new(0, 0, 1, 1);
+
+    // the shared RTex shader switches its program on each call, each program keeps its handles
+    int start = 0;
+    for (int round = 0; round < 2; round++) {
+        if (round == 1) {
+            start = resolved();
+        }
+        RTex_clear(tex, vec4_(0, 0, 0, 1));
+        RTex_blit_ex(tex, r_tex_white(), pose, uv);
+        RTex_blit_color_ex(tex, r_tex_white(), pose, uv, vec4_(1), vec4_(0));
+    }
+    assert(resolved() == start);
+
+    o_del(tex);
+}
+
+O_STATIC
+void state_cache(void)
+{
+    struct r_stats *stats = r_stats_frame();
+    r_state_invalidate();
+
+    r_state_blend(false);
+    int calls = stats->gl_calls;
+    int skipped = stats->gl_calls_skipped;
+
+    // redundant calls are skipped
+    r_state_blend(false);
+    r_state_blend(false);
+    assert(stats->gl_calls == calls && stats->gl_calls_skipped - skipped == 2);
+
+    // changes are issued
+    r_state_blend(true);
+    r_state_blend(false);
+    assert(stats->gl_calls > calls && stats->gl_calls_skipped - skipped == 2);
+
+    // invalidated state is issued again
+    calls = stats->gl_calls;
+    r_state_invalidate();
+    r_state_blend(false);
+    assert(stats->gl_calls == calls + 1 && stats->gl_calls_skipped - skipped == 2);
+}
+
+int RShader__test(oobj obj)
+{
+    handles(obj);
+    shared_shader(obj);
+    state_cache();
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include "r/RTex_manip.h"
+#include "r/tex.h"
+#include "r/gl.h"
+#include "u/UImg.h"
+#include "o/timer.h"
+#include "o/log.h"
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "r", NULL, 0, "RTex_blur_bench", __VA_ARGS__)
+
+#define SIZE 512
+#define RUNS 10
+
+enum mode {
+    MODE_CONV_GAUSS,
+    MODE_SEP_GAUSS,
+    MODE_SEP_BLUR,
+    MODE_LARGE_BLUR
+};
+
+O_STATIC
+double bench_gpu(oobj obj, oobj src, oobj into, enum mode mode, ivec2 size)
+{
+    oobj kernel = NULL;
+    if (mode == MODE_CONV_GAUSS) {
+        kernel = RTex_new_kernel_gauss(obj, m_2(size), vec2_(-1), 1.0f);
+    }
+
+    // warm up, creates the cached kernels and pooled textures
+    ou64 start = o_timer();
+    for (int run = -1; run < RUNS; run++) {
+        if (run == 0) {
+            glFinish();
+            start = o_timer();
+        }
+        switch (mode) {
+            case MODE_CONV_GAUSS:
+                RTex_conv_into(src, kernel, ivec2_(0), into);
+                break;
+            case MODE_SEP_GAUSS:
+                RTex_gauss_into(src, size, vec2_(-1), into);
+                break;
+            case MODE_SEP_BLUR:
+                RTex_blur_into(src, size, into);
+                break;
+            case MODE_LARGE_BLUR:
+                RTex_blur_large_into(src, size, into);
+                break;
+        }
+    }
+    glFinish();
+    double ms = o_timer_elapsed_s(start) * 1000.0 / RUNS;
+    o_del(kernel);
+    return ms;
+}
+
+O_STATIC
+double bench_cpu(UImg *img, bool gauss, ivec2 size)
+{
+    ou64 start = o_timer();
+    for (int run = 0; run < RUNS; run++) {
+        UImg *res = gauss ? UImg_gauss(img, size, vec2_(-1)) : UImg_blur(img, size);
+        o_del(res);
+    }
+    return o_timer_elapsed_s(start) * 1000.0 / RUNS;
+}
+
+int RTex_blur__bench(oobj obj)
+{
+    RTex *src = RTex_new(obj, NULL, SIZE, SIZE);
+    RTex_clear_full(src, R_WHITE);
+    RTex *into = RTex_new(obj, NULL, SIZE, SIZE);
+    UImg *img = UImg_new(obj, NULL, SIZE, SIZE, R_FORMAT_RGBA_8);
+    UImg_clear(img, R_WHITE);
+
+    ivec2 gauss_size = ivec2_(31);
+    double conv_ms = bench_gpu(obj, src, into, MODE_CONV_GAUSS, gauss_size);
+    double sep_ms = bench_gpu(obj, src, into, MODE_SEP_GAUSS, gauss_size);
+    double cpu_gauss_ms = bench_cpu(img, true, gauss_size);
+    bench_log("%ix%i gauss %ix%i: 2d conv: %.3f ms, separable: %.3f ms (x%.1f), cpu: %.3f ms",
+              SIZE, SIZE, m_2(gauss_size), conv_ms, sep_ms, conv_ms / sep_ms, cpu_gauss_ms);
+
+    ivec2 blur_size = ivec2_(63);
+    double blur_ms = bench_gpu(obj, src, into, MODE_SEP_BLUR, blur_size);
+    double large_ms = bench_gpu(obj, src, into, MODE_LARGE_BLUR, blur_size);
+    double cpu_blur_ms = bench_cpu(img, false, blur_size);
+    bench_log("%ix%i blur %ix%i: separable: %.3f ms, large (downsampled): %.3f ms (x%.1f), cpu running sum: %.3f ms",
+              SIZE, SIZE, m_2(blur_size), blur_ms, large_ms, blur_ms / large_ms, cpu_blur_ms);
+
+    o_del(img);
+    o_del(into);
+    o_del(src);
+    return 0;
+}
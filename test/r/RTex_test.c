@@ -1,8 +1,13 @@
 #include "o/img.h"
 #include "m/flt.h"
 #include "m/byte.h"
+#include "m/int.h"
 #include "r/RTex_manip.h"
 #include "r/tex.h"
+#include "r/RTexReadback.h"
+#include "r/RTexLoader.h"
+#include "r/texpool.h"
+#include "u/UImg.h"
 
 O_STATIC
 void color(oobj obj)
@@ -58,10 +63,212 @@ void outline(oobj obj)
     outline_run(obj, 16, 49);
 }
 
+static int L_readback_callbacks;
+
+O_STATIC
+void readback_callback(oobj readback)
+{
+    L_readback_callbacks++;
+}
+
+O_STATIC
+void get_async(oobj obj)
+{
+    int cols = 7, rows = 5;
+    struct o_img src = o_img_new(obj, cols, rows);
+    for (osize i = 0; i < o_img_data_size(src); i++) {
+        src.rgba_data[i] = (obyte) (i * 7);
+    }
+    oobj tex = RTex_new(obj, src.rgba_data, cols, rows);
+
+    // polling
+    L_readback_callbacks = 0;
+    oobj readback = RTex_get_async(tex, obj, R_FORMAT_RGBA_8, readback_callback);
+    assert(RTexReadback_data(readback) == NULL);
+    while (!RTexReadback_poll(readback)) {
+        o_sleep(1);
+    }
+    assert(L_readback_callbacks == 1);
+    assert(RTexReadback_data_size(readback) == o_img_data_size(src));
+    assert(memcmp(RTexReadback_data(readback), src.rgba_data, o_img_data_size(src)) == 0);
+
+    // already finished, no additional callback
+    assert(RTexReadback_poll(readback));
+    assert(L_readback_callbacks == 1);
+    o_del(readback);
+
+    // blocking
+    readback = RTex_get_async(tex, obj, R_FORMAT_RGBA_8, readback_callback);
+    RTexReadback_wait(readback);
+    assert(RTexReadback_finished(readback));
+    assert(L_readback_callbacks == 2);
+    assert(memcmp(RTexReadback_data(readback), src.rgba_data, o_img_data_size(src)) == 0);
+    o_del(readback);
+
+    // deleting a pending readback
+    readback = RTex_get_async(tex, obj, R_FORMAT_RGBA_8, readback_callback);
+    o_del(readback);
+    RTexReadback_poll_all();
+    assert(L_readback_callbacks == 2);
+
+    o_del(tex);
+    o_img_free(&src);
+}
+
+O_STATIC
+void loader(oobj obj)
+{
+    const char *file = "res/r/font35.png";
+    struct o_img src = o_img_new_file(obj, file);
+    assert(src.rgba_data);
+
+    RTexLoader *loader = RTexLoader_new(obj, NULL);
+    // a few rows per update, to test the staged upload
+    RTexLoader_budget_bytes_set(loader, src.cols * 4 * 7);
+
+    RTex *tex = RTex_new(obj, NULL, 1, 1);
+    RTexLoader_load(loader, tex, file);
+    RTex *cancelled = RTex_new(obj, NULL, 1, 1);
+    RTexLoader_load(loader, cancelled, file);
+    o_del(cancelled);
+
+    assert(RTexLoader_num(loader) == 2);
+    assert(RTexLoader_progress(loader) < 1.0f);
+    while (!RTexLoader_idle(loader)) {
+        RTexLoader_update(loader);
+        o_sleep(1);
+    }
+    assert(RTexLoader_progress(loader) == 1.0f);
+
+    assert(ivec2_equals_v(RTex_size_int(tex), ivec2_(src.cols, src.rows)));
+    struct o_img dst = o_img_new(obj, src.cols, src.rows);
+    RTex_get(tex, dst.rgba_data);
+    assert(memcmp(dst.rgba_data, src.rgba_data, o_img_data_size(src)) == 0);
+
+    o_img_free(&dst);
+    o_img_free(&src);
+    o_del(tex);
+    o_del(loader);
+}
+
+O_STATIC
+void texpool(oobj obj)
+{
+    // protected in texpool.c, called by r_frame_begin
+    void r_texpool__frame_begin(void);
+
+    oobj src = RTex_new(obj, NULL, 16, 16);
+    RTex_clear_full(src, R_WHITE);
+
+    int allocations = -1;
+    for (int frame = 0; frame < 4; frame++) {
+        r_texpool__frame_begin();
+        int start = r_stats_frame()->gl_allocations;
+
+        r_texpool_transient_begin();
+        oobj blurred = RTex_gauss(src, ivec2_(5), vec2_(-1), R_FORMAT_RGBA_8);
+        oobj outlined = RTex_outline(blurred, ivec2_(3), ivec2_(0), vec4_(0, 0, 0, 1), R_WHITE, R_FORMAT_RGBA_8);
+        r_texpool_transient_end();
+
+        assert(r_texpool_owns(blurred) && r_texpool_owns(outlined));
+        assert(blurred != outlined);
+        allocations = r_stats_frame()->gl_allocations - start;
+    }
+    // steady state
+    assert(allocations == 0);
+
+    // not in transient mode
+    oobj own = RTex_blur(src, ivec2_(3), R_FORMAT_RGBA_8);
+    assert(!r_texpool_owns(own));
+    o_del(own);
+
+    r_texpool__frame_begin();
+    r_texpool_clear();
+    o_del(src);
+}
+
+// max channel difference between two RGBA_8 images of the same size
+O_STATIC
+int max_diff(struct o_img a, struct o_img b)
+{
+    int diff = 0;
+    for (osize i = 0; i < (osize) a.cols * a.rows * 4; i++) {
+        diff = o_max(diff, o_abs((int) a.rgba_data[i] - (int) b.rgba_data[i]));
+    }
+    return diff;
+}
+
+O_STATIC
+void blur_run(oobj obj, oobj src, UImg *src_img, ivec2 size, bool gauss)
+{
+    ivec2 img_size = RTex_size_int(src);
+    struct o_img sep = o_img_new(obj, m_2(img_size));
+    struct o_img full = o_img_new(obj, m_2(img_size));
+
+    // separable fast path
+    oobj res = gauss ? RTex_gauss(src, size, vec2_(-1), R_FORMAT_RGBA_8)
+                     : RTex_blur(src, size, R_FORMAT_RGBA_8);
+    RTex_get(res, sep.rgba_data);
+    o_del(res);
+
+    // 2d convolution
+    oobj kernel = gauss ? RTex_new_kernel_gauss(obj, m_2(size), vec2_(-1), 1.0f)
+                        : RTex_new_kernel(obj, m_2(size), 1.0f, false, 1.0f);
+    res = RTex_conv(src, kernel, ivec2_(0), R_FORMAT_RGBA_8);
+    RTex_get(res, full.rgba_data);
+    o_del(res);
+    o_del(kernel);
+
+    // cpu reference
+    UImg *ref = gauss ? UImg_gauss(src_img, size, vec2_(-1)) : UImg_blur(src_img, size);
+    struct o_img ref_img = {UImg_data(ref), img_size.x, img_size.y, NULL};
+
+    // 8 bit rounding between the passes and linear filter precision
+    assert(max_diff(sep, ref_img) <= 2);
+    assert(max_diff(sep, full) <= 2);
+
+    o_del(ref);
+    o_img_free(&sep);
+    o_img_free(&full);
+}
+
+O_STATIC
+void blur(oobj obj)
+{
+    int cols = 37, rows = 23;
+    struct o_img img = o_img_new(obj, cols, rows);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            bvec4 *px = (bvec4 *) o_img_at(img, c, r);
+            *px = bvec4_((c * 37 + r * 11) % 256, (c * c + r * 7) % 256, (r * r * 3) % 256, 255);
+        }
+    }
+    oobj src = RTex_new(obj, img.rgba_data, cols, rows);
+    UImg *src_img = UImg_new(obj, img.rgba_data, cols, rows, R_FORMAT_RGBA_8);
+
+    blur_run(obj, src, src_img, ivec2_(3), false);
+    blur_run(obj, src, src_img, ivec2_(8, 5), false);
+    blur_run(obj, src, src_img, ivec2_(5), true);
+    blur_run(obj, src, src_img, ivec2_(9, 4), true);
+
+    // the large blur approximates the result on a downsampled level
+    oobj large = RTex_blur_large(src, ivec2_(24), R_FORMAT_RGBA_8);
+    assert(ivec2_equals_v(RTex_size_int(large), ivec2_(cols, rows)));
+    o_del(large);
+
+    o_del(src_img);
+    o_del(src);
+    o_img_free(&img);
+}
+
 int RTex__test(oobj obj)
 {
     color(obj);
     outline(obj);
+    get_async(obj);
+    loader(obj);
+    texpool(obj);
+    blur(obj);
     
     return 0;
 }
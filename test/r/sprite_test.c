@@ -0,0 +1,70 @@
+#include "r/sprite.h"
+#include "m/flt.h"
+
+#define test(expr) o_assume(expr, "test failed")
+
+O_STATIC
+void test_half(void)
+{
+    test(r_sprite_half_pack(0.0f) == 0x0000);
+    test(r_sprite_half_pack(-0.0f) == 0x8000);
+    test(r_sprite_half_pack(1.0f) == 0x3c00);
+    test(r_sprite_half_pack(-2.0f) == 0xc000);
+    test(r_sprite_half_pack(65504.0f) == 0x7bff);
+    test(r_sprite_half_pack(1e6f) == 0x7c00);
+    // smallest subnormal
+    test(r_sprite_half_pack(m_pow(2, -24)) == 0x0001);
+    // round to nearest even
+    test(r_sprite_half_pack(2049.0f) == r_sprite_half_pack(2048.0f));
+    test(r_sprite_half_pack(2051.0f) == r_sprite_half_pack(2052.0f));
+
+    // integers and half texels are exact
+    for (int i = -2048; i <= 2048; i++) {
+        test(r_sprite_half_unpack(r_sprite_half_pack((float) i)) == (float) i);
+        test(r_sprite_half_unpack(r_sprite_half_pack(i * 0.5f)) == i * 0.5f);
+    }
+    for (ou32 h = 0; h < 0x7c00; h++) {
+        test(r_sprite_half_pack(r_sprite_half_unpack((ou16) h)) == h);
+    }
+}
+
+O_STATIC
+void test_quad(void)
+{
+    test(sizeof(struct r_sprite) == 32);
+
+    struct r_sprite s = r_sprite_new(16, 8);
+    s.pos = vec2_(10.5f, -3.0f);
+    r_sprite_angle_set(&s, 0.5f);
+    s.uv_pos = vec2_(4, 2);
+    s.color.a = 128;
+
+    struct r_quad q = r_sprite_to_quad(s);
+    test(m_abs(q.pose.m30 - 10.5f) < 1e-5f && m_abs(q.pose.m31 + 3.0f) < 1e-5f);
+    test(m_abs(q.uv.m00 - 8.0f) < 1e-5f && m_abs(q.uv.m11 - 4.0f) < 1e-5f);
+    test(q.s.r == 1.0f && m_abs(q.s.a - 128 / 255.0f) < 1e-5f);
+
+    struct r_sprite back = r_sprite_from_quad(&q);
+    test(memcmp(&s, &back, sizeof s) == 0);
+
+    // mirrored
+    r_sprite_size_set(&s, 16, -8);
+    q = r_sprite_to_quad(s);
+    back = r_sprite_from_quad(&q);
+    test(memcmp(&s, &back, sizeof s) == 0);
+
+    // default quad
+    struct r_quad dq = r_quad_new(32, 16);
+    struct r_sprite ds = r_sprite_from_quad(&dq);
+    struct r_sprite expected = r_sprite_new(32, 16);
+    test(memcmp(&ds, &expected, sizeof ds) == 0);
+}
+
+
+int r_sprite__test(oobj obj)
+{
+    test_half();
+    test_quad();
+
+    return 0;
+}
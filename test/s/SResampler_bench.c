@@ -0,0 +1,53 @@
+#include "s/SResampler.h"
+#include "o/timer.h"
+#include "o/log.h"
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "s", NULL, 0, "SResampler_bench", __VA_ARGS__)
+
+#define BLOCK 512
+#define BLOCKS 2000
+
+O_STATIC
+void bench_run(oobj obj, enum SResampler_quality quality, struct s_audio_spec dst, struct s_audio_spec src)
+{
+    oobj resampler = SResampler_new(obj, dst, src, quality);
+    SResampler_reserve(resampler, BLOCK);
+    osize src_max = SResampler_src_ticks_max(resampler, BLOCK);
+    float *in = o_new0(obj, float, s_audio_spec_array_size(src, src_max));
+    float *out = o_new(obj, float, s_audio_spec_array_size(dst, BLOCK));
+    for (osize i = 0; i < s_audio_spec_array_size(src, src_max); i++) {
+        in[i] = (float) (i % 64) / 64.0f - 0.5f;
+    }
+
+    // audio callback sized blocks, consecutive
+    ou64 start = o_timer();
+    for (osize b = 0; b < BLOCKS; b++) {
+        osize src_time;
+        osize len = SResampler_src_ticks(resampler, BLOCK, b * BLOCK, &src_time);
+        SResampler_run(resampler, out, BLOCK, b * BLOCK, in, len);
+    }
+    double s = o_timer_elapsed_s(start);
+
+    double samples = (double) BLOCKS * BLOCK * dst.channels;
+    double realtime = (double) BLOCKS * BLOCK / dst.freq / s;
+    bench_log("%s %i/%i -> %i/%i: %.1f M samples/s, %.0fx realtime",
+              quality == SResampler_LINEAR ? "linear" : "sinc  ",
+              src.freq, src.channels, dst.freq, dst.channels, samples / s / 1e6, realtime);
+
+    o_free(obj, out);
+    o_free(obj, in);
+    o_del(resampler);
+}
+
+int SResampler__bench(oobj obj)
+{
+    struct s_audio_spec cd = {44100, 2};
+    struct s_audio_spec dvd = {48000, 2};
+    struct s_audio_spec low = {22050, 1};
+    for (int q = 0; q < SResampler_NUM_QUALITIES; q++) {
+        bench_run(obj, q, dvd, cd);
+        bench_run(obj, q, cd, dvd);
+        bench_run(obj, q, dvd, low);
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+#include "s/SResampler.h"
+#include "s/STrackArray.h"
+#include "o/OArray.h"
+#include "m/sca/dbl.h"
+#include <math.h>
+
+#define O_LOG_LIB "s"
+#include "o/log.h"
+
+#define SECONDS 0.5
+
+// interleaved sine in all channels
+O_STATIC
+float *sine_new(oobj obj, struct s_audio_spec spec, double freq, osize len)
+{
+    float *data = o_new(obj, float, s_audio_spec_array_size(spec, len));
+    for (osize i = 0; i < len; i++) {
+        for (int c = 0; c < spec.channels; c++) {
+            data[i * spec.channels + c] = (float) (0.5 * md_sin(2.0 * md_PI * freq * i / spec.freq));
+        }
+    }
+    return data;
+}
+
+// resamples src in chunks of varying size
+O_STATIC
+float *resample_chunked(oobj obj, oobj resampler, const float *src, osize src_total, osize dst_len)
+{
+    struct s_audio_spec dst = SResampler_dst_spec(resampler);
+    struct s_audio_spec spec = SResampler_src_spec(resampler);
+    float *out = o_new(obj, float, s_audio_spec_array_size(dst, dst_len));
+    const osize chunks[] = {1, 7, 256, 33, 512, 1024, 3};
+    osize time = 0;
+    for (int i = 0; time < dst_len; i++) {
+        osize len = o_min(chunks[i % 7], dst_len - time);
+        osize src_time;
+        osize src_len = SResampler_src_ticks(resampler, len, time, &src_time);
+        assert(src_time + src_len <= src_total);
+        SResampler_run(resampler, out + s_audio_spec_array_size(dst, time), len, time,
+                       src + s_audio_spec_array_size(spec, src_time), src_len);
+        time += len;
+    }
+    return out;
+}
+
+// residual of the resampled sine, relative to the ideal sine in dB
+O_STATIC
+double sine_error_db(const float *data, struct s_audio_spec spec, double freq, osize begin, osize end)
+{
+    double signal = 0, error = 0;
+    for (osize i = begin; i < end; i++) {
+        double expected = 0.5 * md_sin(2.0 * md_PI * freq * i / spec.freq);
+        for (int c = 0; c < spec.channels; c++) {
+            double d = data[i * spec.channels + c] - expected;
+            signal += expected * expected;
+            error += d * d;
+        }
+    }
+    return 10.0 * log10(error / signal);
+}
+
+O_STATIC
+double rms_db(const float *data, struct s_audio_spec spec, osize begin, osize end)
+{
+    double sum = 0;
+    for (osize i = begin * spec.channels; i < end * spec.channels; i++) {
+        sum += data[i] * data[i];
+    }
+    // relative to the rms of the 0.5 amplitude sine
+    return 10.0 * log10(sum / ((end - begin) * spec.channels) / 0.125);
+}
+
+// thd+n of a 1 kHz sine, resampled in chunks, so also tests the continuity
+O_STATIC
+double quality_thd(oobj obj, enum SResampler_quality quality, struct s_audio_spec dst, struct s_audio_spec src)
+{
+    osize src_len = (osize) (src.freq * SECONDS);
+    osize dst_len = s_resample_dst_ticks(dst, src, src_len) - 64;
+    float *data = sine_new(obj, src, 1000.0, src_len);
+    oobj resampler = SResampler_new(obj, dst, src, quality);
+    float *out = resample_chunked(obj, resampler, data, src_len, dst_len);
+
+    // skip the start, which was silent before
+    double db = sine_error_db(out, dst, 1000.0, 64, dst_len);
+    o_del(resampler);
+    o_free(obj, out);
+    o_free(obj, data);
+    return db;
+}
+
+// a tone above the dst nyquist frequency, should be filtered out instead of being mirrored
+O_STATIC
+double quality_alias(oobj obj, enum SResampler_quality quality)
+{
+    struct s_audio_spec src = {44100, 1};
+    struct s_audio_spec dst = {22050, 1};
+    osize src_len = (osize) (src.freq * SECONDS);
+    osize dst_len = s_resample_dst_ticks(dst, src, src_len) - 64;
+    float *data = sine_new(obj, src, 15000.0, src_len);
+    oobj resampler = SResampler_new(obj, dst, src, quality);
+    float *out = resample_chunked(obj, resampler, data, src_len, dst_len);
+
+    double db = rms_db(out, dst, 64, dst_len);
+    o_del(resampler);
+    o_free(obj, out);
+    o_free(obj, data);
+    return db;
+}
+
+O_STATIC
+void quality(oobj obj)
+{
+    struct s_audio_spec a = {44100, 2};
+    struct s_audio_spec b = {48000, 2};
+
+    double linear_up = quality_thd(obj, SResampler_LINEAR, b, a);
+    double sinc_up = quality_thd(obj, SResampler_SINC, b, a);
+    double sinc_down = quality_thd(obj, SResampler_SINC, a, b);
+    double linear_alias = quality_alias(obj, SResampler_LINEAR);
+    double sinc_alias = quality_alias(obj, SResampler_SINC);
+
+    o_log_info_s("SResampler_test", "1 kHz thd+n: linear: %.1f dB, sinc: %.1f dB (up), %.1f dB (down)",
+                 linear_up, sinc_up, sinc_down);
+    o_log_info_s("SResampler_test", "15 kHz at 44100 -> 22050 aliasing: linear: %.1f dB, sinc: %.1f dB",
+                 linear_alias, sinc_alias);
+
+    assert(linear_up < -30.0);
+    assert(sinc_up < -70.0 && sinc_down < -70.0);
+    assert(sinc_alias < -60.0 && sinc_alias < linear_alias);
+}
+
+O_STATIC
+void continuity(oobj obj)
+{
+    struct s_audio_spec src = {22050, 1};
+    struct s_audio_spec dst = {44100, 2};
+    osize src_len = 4096;
+    osize dst_len = s_resample_dst_ticks(dst, src, src_len) - 64;
+    float *data = sine_new(obj, src, 440.0, src_len);
+
+    // one span vs chunks
+    oobj resampler = SResampler_new(obj, dst, src, SResampler_SINC);
+    float *chunked = resample_chunked(obj, resampler, data, src_len, dst_len);
+    float *span = o_new(obj, float, s_audio_spec_array_size(dst, dst_len));
+    osize src_time;
+    osize len = SResampler_src_ticks(resampler, dst_len, 0, &src_time);
+    assert(src_time == 0);
+    SResampler_run(resampler, span, dst_len, 0, data, len);
+    for (osize i = 0; i < s_audio_spec_array_size(dst, dst_len); i++) {
+        assert(o_abs(chunked[i] - span[i]) < 0.00001f);
+    }
+
+    // STrack_retr uses an SResampler, so consecutive retr's equal a single one
+    oobj container = OObj_new(obj);
+    oobj track = STrackArray_new(container, data, src_len, &src);
+    oobj all = STrack_retr_span_ex(track, dst_len, 0, &dst, NULL);
+    float *out = o_new(container, float, s_audio_spec_array_size(dst, 256));
+    for (osize time = 0; time + 256 <= dst_len; time += 256) {
+        STrack_retr(track, out, 256, time, &dst);
+        const float *expected = o_at(all, s_audio_spec_array_size(dst, time));
+        for (osize i = 0; i < s_audio_spec_array_size(dst, 256); i++) {
+            assert(o_abs(out[i] - expected[i]) < 0.00001f);
+        }
+    }
+    o_del(container);
+    o_del(resampler);
+}
+
+O_STATIC
+void channels(oobj obj)
+{
+    // equal frequencies, only mixing
+    struct s_audio_spec stereo = {44100, 2};
+    struct s_audio_spec mono = {44100, 1};
+    float src[8] = {0.2f, 0.4f, 0.2f, 0.4f, 0.2f, 0.4f, 0.2f, 0.4f};
+    float out[8];
+    oobj down = SResampler_new(obj, mono, stereo, SResampler_SINC);
+    osize src_time;
+    osize len = SResampler_src_ticks(down, 4, 0, &src_time);
+    assert(len == 4 && src_time == 0);
+    SResampler_run(down, out, 4, 0, src, len);
+    for (int i = 0; i < 4; i++) {
+        assert(o_abs(out[i] - 0.3f) < 0.00001f);
+    }
+
+    oobj up = SResampler_new(obj, stereo, mono, SResampler_SINC);
+    len = SResampler_src_ticks(up, 4, 0, &src_time);
+    SResampler_run(up, out, 4, 0, src, len);
+    for (int i = 0; i < 4; i++) {
+        assert(out[i * 2] == src[i] && out[i * 2 + 1] == src[i]);
+    }
+
+    // dc passes with unity gain, after the filter is filled
+    struct s_audio_spec low = {22050, 2};
+    float dc[2 * 256];
+    for (int i = 0; i < 2 * 256; i++) {
+        dc[i] = 0.5f;
+    }
+    oobj resampler = SResampler_new(obj, mono, low, SResampler_SINC);
+    float dc_out[128];
+    osize src_len = SResampler_src_ticks(resampler, 128, 100, &src_time);
+    assert(src_len <= 256);
+    SResampler_run(resampler, dc_out, 128, 100, dc, src_len);
+    for (int i = 0; i < 128; i++) {
+        assert(o_abs(dc_out[i] - 0.5f) < 0.001f);
+    }
+    o_del(resampler);
+    o_del(up);
+    o_del(down);
+}
+
+int SResampler__test(oobj obj)
+{
+    quality(obj);
+    continuity(obj);
+    channels(obj);
+    return 0;
+}
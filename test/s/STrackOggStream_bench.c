@@ -0,0 +1,100 @@
+#include "s/STrackOggStream.h"
+#include "s/STrackArray.h"
+#include "s/ogg.h"
+#include "o/timer.h"
+#include "o/log.h"
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "s", NULL, 0, "STrackOggStream_bench", __VA_ARGS__)
+
+#define FILE_OGG "res/ex/thunder_5.ogg"
+#define RUNS 10
+#define BLOCK 1024
+
+O_STATIC
+void bench_load(oobj obj)
+{
+    double seconds = 0;
+    osize array_bytes = 0;
+    osize stream_bytes = 0;
+    struct s_audio_spec spec = {0};
+
+    ou64 start = o_timer();
+    for (int run = 0; run < RUNS; run++) {
+        oobj container = OObj_new(obj);
+        oobj stream = STrackOggStream_new_file(container, FILE_OGG).o;
+        assert(stream);
+        spec = STrack_spec(stream);
+        seconds = STrack_duration(stream);
+        stream_bytes = STrackOggStream_memory(stream);
+        o_del(container);
+    }
+    double stream_ms = o_timer_elapsed_s(start) * 1000.0 / RUNS;
+
+    // in the native spec, so that no resampling is measured
+    start = o_timer();
+    for (int run = 0; run < RUNS; run++) {
+        oobj container = OObj_new(obj);
+        oobj track = s_ogg_load_track(container, FILE_OGG, &spec).o;
+        assert(track);
+        array_bytes = o_num(STrackArray_array(track)) * (osize) sizeof(float);
+        o_del(container);
+    }
+    double array_ms = o_timer_elapsed_s(start) * 1000.0 / RUNS;
+
+    bench_log("%s (%.1f s, %i Hz, %i channels): load: s_ogg_load_track: %.2f ms, STrackOggStream: %.2f ms",
+              FILE_OGG, seconds, spec.freq, spec.channels, array_ms, stream_ms);
+    bench_log("resident: s_ogg_load_track: %.0f KB, STrackOggStream: %.0f KB, "
+              "pcm for 4 minutes: %.1f MB",
+              array_bytes / 1024.0, stream_bytes / 1024.0,
+              (double) s_audio_spec_buffer_size(spec, (osize) spec.freq * 240) / (1024.0 * 1024.0));
+}
+
+O_STATIC
+void bench_retr(oobj obj)
+{
+    oobj container = OObj_new(obj);
+    oobj stream = STrackOggStream_new_file(container, FILE_OGG).o;
+    assert(stream);
+    struct s_audio_spec spec = STrack_spec(stream);
+    oobj track = s_ogg_load_track(container, FILE_OGG, &spec).o;
+    osize length = STrack_duration_ticks(stream);
+    float *out = o_new(container, float, s_audio_spec_array_size(spec, BLOCK));
+
+    // like the audio callback, the decoder refills in between
+    double retr_s = 0;
+    for (osize time = 0; time < length; time += BLOCK) {
+        ou64 start = o_timer();
+        STrack_retr(stream, out, BLOCK, time, &spec);
+        retr_s += o_timer_elapsed_s(start);
+        STrackOggStream_update(stream);
+        STrackOggStream_wait(stream);
+    }
+    osize blocks = (length + BLOCK - 1) / BLOCK;
+
+    ou64 start = o_timer();
+    for (osize time = 0; time < length; time += BLOCK) {
+        STrack_retr(track, out, BLOCK, time, &spec);
+    }
+    double array_s = o_timer_elapsed_s(start);
+
+    // offline decoding speed
+    STrackOggStream_blocking_set(stream, true);
+    start = o_timer();
+    for (osize time = 0; time < length; time += BLOCK) {
+        STrack_retr(stream, out, BLOCK, time, &spec);
+    }
+    double blocking_s = o_timer_elapsed_s(start);
+
+    bench_log("retr of %i ticks: STrackArray: %.2f us, STrackOggStream: %.2f us (%i underruns), "
+              "blocking decode: %.0fx realtime",
+              BLOCK, array_s * 1e6 / blocks, retr_s * 1e6 / blocks, (int) STrackOggStream_underruns(stream),
+              STrack_duration(stream) / blocking_s);
+    o_del(container);
+}
+
+int STrackOggStream__bench(oobj obj)
+{
+    bench_load(obj);
+    bench_retr(obj);
+    return 0;
+}
@@ -0,0 +1,269 @@
+#include "s/STrack.h"
+#include "s/STrackArena.h"
+#include "s/STrackArray.h"
+#include "s/STrackOggStream.h"
+#include "s/ogg.h"
+#include "o/OArray.h"
+#include "o/file.h"
+#include <SDL2/SDL_timer.h>
+
+#define LEN 256
+
+O_STATIC
+bool all_equal(const float *data, osize n, float value)
+{
+    for (osize i = 0; i < n; i++) {
+        if (o_abs(data[i] - value) > 0.0001f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+O_STATIC
+void play_commands(oobj obj)
+{
+    struct s_audio_spec spec = s_audio_spec_default();
+    osize n = s_audio_spec_array_size(spec, LEN);
+    float *out = o_new(obj, float, n);
+    float *data = o_new(obj, float, n * 8);
+    for (osize i = 0; i < n * 8; i++) {
+        data[i] = 0.25f;
+    }
+
+    // STrack's are OJoin's, so deleted with their parent
+    oobj container = OObj_new(obj);
+    STrack *master = STrack_new(container, NULL);
+    STrack_time_ticks_auto_set(master, true);
+    oobj track = STrackArray_new(container, data, n * 8, NULL);
+
+    osize time = 0;
+    osize handle = STrack_play(master, track, 0, 1.0f);
+    assert(STrack_played_available(master, handle));
+    STrack_retr(master, out, LEN, time, NULL);
+    time += LEN;
+    assert(all_equal(out, n, 0.25f));
+
+    // applied on the next retr, ramped over that block
+    assert(STrack_played_amp_set(master, handle, 2.0f));
+    STrack_retr(master, out, LEN, time, NULL);
+    time += LEN;
+    assert(out[0] > 0.25f && out[0] < out[n / 2] && out[n / 2] < 0.5f);
+    assert(all_equal(out + n - spec.channels, spec.channels, 0.5f));
+
+    // the retr'ieving path is allocation free
+    osize calls = o_allocator_thread_calls();
+    STrack_retr(master, out, LEN, time, NULL);
+    time += LEN;
+    assert(o_allocator_thread_calls() == calls);
+    assert(all_equal(out, n, 0.5f));
+
+    assert(STrack_played_remove(master, handle));
+    assert(!STrack_played_available(master, handle));
+    STrack_retr(master, out, LEN, time, NULL);
+    time += LEN;
+    assert(all_equal(out, n, 0.0f));
+
+    // deleted by the user, the hold keeps it alive, until the retr noticed it
+    oobj parent = OObj_new(obj);
+    oobj dropped = STrackArray_new(parent, data, n * 8, NULL);
+    handle = STrack_play(master, dropped, 0, 1.0f);
+    o_del(parent);
+    STrack_retr(master, out, LEN, time, NULL);
+    time += LEN;
+    assert(all_equal(out, n, 0.0f));
+    STrack_collect(master);
+    assert(!STrack_played_available(master, handle));
+
+    // the collected hold of a removed play does not release the other play of the same track
+    osize first = STrack_play(master, track, 0, 1.0f);
+    osize second = STrack_play(master, track, 0, 1.0f);
+    assert(STrack_played_remove(master, first));
+    STrack_retr(master, out, LEN, time, NULL);
+    time += LEN;
+    STrack_collect(master);
+    STrack_retr(master, out, LEN, time, NULL);
+    time += LEN;
+    assert(STrack_played_available(master, second) && all_equal(out, n, 0.25f));
+    assert(STrack_played_remove(master, second));
+
+    // more commands than the ring buffer holds, without a retr
+    for (int i = 0; i < 200; i++) {
+        STrack_play(master, track, 0, 0.01f);
+    }
+    STrack_reset(master);
+    STrack_retr(master, out, LEN, time, NULL);
+    assert(all_equal(out, n, 0.0f));
+
+    o_del(container);
+    o_free(obj, data);
+    o_free(obj, out);
+}
+
+O_STATIC
+void arena(oobj obj)
+{
+    struct s_audio_spec spec = s_audio_spec_default();
+    osize n = s_audio_spec_array_size(spec, LEN);
+    float *out = o_new(obj, float, n);
+    float *silence = o_new0(obj, float, n * 8);
+    float *ramp = o_new(obj, float, n * 8);
+    for (osize i = 0; i < n * 8; i++) {
+        ramp[i] = (float) (i / spec.channels) / (float) (LEN * 8);
+    }
+
+    oobj container = OObj_new(obj);
+    STrackArena *arena = STrackArena_new(container, 2, NULL);
+    STrackArena_real_limit_set(arena, 1);
+    oobj quiet = STrackArray_new(container, silence, n * 8, NULL);
+    oobj rising = STrackArray_new(container, ramp, n * 8, NULL);
+
+    // the higher priority is mixed, the other one is virtual
+    osize time = 0;
+    STrackArena_play(arena, quiet, 0, 1.0f, 1);
+    osize handle = STrackArena_play(arena, rising, 0, 1.0f, 0);
+    for (int i = 0; i < 3; i++) {
+        STrack_retr(arena, out, LEN, time, NULL);
+        time += LEN;
+        assert(all_equal(out, n, 0.0f));
+    }
+    struct STrackArena_stats stats = STrackArena_stats(arena);
+    assert(stats.real_voices == 1 && stats.virtual_voices == 1 && stats.stolen == 0);
+
+    // mixed again, fades in at its advanced time
+    STrack_played_priority_set(arena, handle, 2);
+    STrack_retr(arena, out, LEN, time, NULL);
+    assert(all_equal(out + n - spec.channels, spec.channels, ramp[(time + LEN - 1) * spec.channels]));
+    time += LEN;
+    osize calls = o_allocator_thread_calls();
+    STrack_retr(arena, out, LEN, time, NULL);
+    assert(o_allocator_thread_calls() == calls);
+    for (osize i = 0; i < n; i++) {
+        assert(o_abs(out[i] - ramp[time * spec.channels + i]) < 0.0001f);
+    }
+    time += LEN;
+
+    // over limit, the lowest ranked is stolen
+    osize low = STrackArena_play(arena, quiet, 0, 1.0f, -1);
+    STrack_retr(arena, out, LEN, time, NULL);
+    time += LEN;
+    stats = STrackArena_stats(arena);
+    assert(stats.stolen == 1 && stats.real_voices + stats.virtual_voices == 2);
+    assert(!STrack_played_available(arena, low));
+
+    // ranked with its priority on its first retr
+    osize high = STrackArena_play(arena, quiet, 0, 1.0f, 10);
+    STrack_retr(arena, out, LEN, time, NULL);
+    time += LEN;
+    STrack_collect(arena);
+    stats = STrackArena_stats(arena);
+    assert(stats.stolen == 2 && STrack_played_available(arena, high));
+
+    // near silent tracks are always virtual
+    STrack_played_amp_set(arena, handle, STrackArena_VIRTUAL_AMP_DEFAULT / 2);
+    STrack_retr(arena, out, LEN, time, NULL);
+    stats = STrackArena_stats(arena);
+    assert(stats.real_voices == 1 && stats.virtual_voices == 1);
+    time += LEN;
+
+    // a load target below any measurable load reduces the budget down to one real track
+    STrackArena_real_limit_set(arena, 2);
+    STrack_retr(arena, out, LEN, time, NULL);
+    time += LEN;
+    assert(STrackArena_stats(arena).real_budget == 2);
+    STrackArena_load_target_set(arena, 1e-9f);
+    for (int i = 0; i < 2; i++) {
+        STrack_retr(arena, out, LEN, time, NULL);
+        time += LEN;
+    }
+    assert(STrackArena_stats(arena).real_budget == 1);
+
+    o_del(container);
+    o_free(obj, ramp);
+    o_free(obj, silence);
+    o_free(obj, out);
+}
+
+// compares the retr'ieved stream data with the fully decoded file
+O_STATIC
+void ogg_check(oobj stream, oobj full, float *out, osize time)
+{
+    struct s_audio_spec spec = STrack_spec(stream);
+    osize len = o_min(LEN, STrack_duration_ticks(stream) - time);
+    STrack_retr(stream, out, LEN, time, &spec);
+    const float *expected = o_at(full, s_audio_spec_array_size(spec, time));
+    for (osize i = 0; i < s_audio_spec_array_size(spec, len); i++) {
+        assert(o_abs(out[i] - expected[i]) < 0.0001f);
+    }
+}
+
+O_STATIC
+void ogg_stream(oobj obj)
+{
+    const char *file = "res/ex/tea_alarm.ogg";
+    oobj container = OObj_new(obj);
+
+    // small ring buffer, so that it wraps around and seeks back
+    oobj data = o_file_read(container, file, false, 1).o;
+    assert(data);
+    oobj stream = STrackOggStream_new_super(sizeof(STrackOggStream), container,
+                                            o_at(data, 0), o_num(data), 1000).o;
+    assert(stream);
+    struct s_audio_spec spec = STrack_spec(stream);
+    osize length = STrack_duration_ticks(stream);
+    oobj full = s_ogg_load_array(container, file, &spec).o;
+    assert(full && o_num(full) == s_audio_spec_array_size(spec, length));
+    float *out = o_new(container, float, s_audio_spec_array_size(spec, LEN));
+
+    // offline retr, decodes in the retr
+    STrackOggStream_blocking_set(stream, true);
+    for (osize time = 0; time < length; time += LEN) {
+        ogg_check(stream, full, out, time);
+    }
+    assert(STrack_retr(stream, out, LEN, length - LEN / 2, &spec));
+    ogg_check(stream, full, out, length / 2);
+    STrackOggStream_blocking_set(stream, false);
+
+    // seek ahead, then the decoder keeps the ring buffer filled
+    osize time = length / 4;
+    STrackOggStream_seek(stream, time, true);
+    for (int i = 0; i < 8; i++) {
+        ogg_check(stream, full, out, time);
+        time += LEN;
+        STrackOggStream_update(stream);
+        STrackOggStream_wait(stream);
+    }
+    assert(STrackOggStream_underruns(stream) == 0);
+
+#ifdef MIA_OPTION_THREAD
+    // the decoding thread refills on its own, without s_update or STrackOggStream_update (main thread stall)
+    for (int i = 0; i < 8; i++) {
+        for (int wait = 0; wait < 1000 && STrackOggStream_buffered(stream) < 1000; wait++) {
+            SDL_Delay(1);
+        }
+        assert(STrackOggStream_buffered(stream) == 1000);
+        ogg_check(stream, full, out, time);
+        time += LEN;
+    }
+    assert(STrackOggStream_underruns(stream) == 0);
+#endif
+
+    // not in the ring buffer, so silence until the decoder has seeked
+    time = 0;
+    STrack_retr(stream, out, LEN, time, &spec);
+    assert(all_equal(out, s_audio_spec_array_size(spec, LEN), 0.0f));
+    assert(STrackOggStream_underruns(stream) == LEN);
+    STrackOggStream_update(stream);
+    STrackOggStream_wait(stream);
+    ogg_check(stream, full, out, time);
+
+    o_del(container);
+}
+
+int STrack__test(oobj obj)
+{
+    play_commands(obj);
+    arena(obj);
+    ogg_stream(obj);
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "s/mix.h"
+#include "o/OObj.h"
+#include "o/timer.h"
+#include "o/log.h"
+
+#define bench_log(...) o_log_base(O_LOG_INFO, "s", NULL, 0, "s_mix_bench", __VA_ARGS__)
+
+#define VOICES 64
+#define FRAMES 512
+#define CHANNELS 2
+#define BLOCKS 2000
+
+// the old mixing path as reference: scalar add and clamp for each voice
+O_STATIC
+void mix_clamped(float *restrict bus, const float *restrict src, float gain, osize num)
+{
+    for (osize i = 0; i < num; i++) {
+        float mixed = bus[i] + src[i] * gain;
+        bus[i] = o_clamp(mixed, -1.0f, +1.0f);
+    }
+}
+
+int s_mix__bench(oobj obj)
+{
+    osize num = FRAMES * CHANNELS;
+    float *voices = o_new(obj, float, VOICES * num);
+    float *bus = o_new(obj, float, num);
+    for (osize i = 0; i < VOICES * num; i++) {
+        voices[i] = (float) (i % 97) / 97.0f - 0.5f;
+    }
+    volatile float sink = 0;
+
+    ou64 start = o_timer();
+    for (int b = 0; b < BLOCKS; b++) {
+        o_clear(bus, sizeof(float), num);
+        for (int v = 0; v < VOICES; v++) {
+            mix_clamped(bus, voices + v * num, 0.5f, num);
+        }
+        sink += bus[b % num];
+    }
+    double clamped_s = o_timer_elapsed_s(start);
+
+    start = o_timer();
+    for (int b = 0; b < BLOCKS; b++) {
+        o_clear(bus, sizeof(float), num);
+        for (int v = 0; v < VOICES; v++) {
+            s_mix_add(bus, voices + v * num, 0.5f, num);
+        }
+        s_mix_limit(bus, num);
+        sink += bus[b % num];
+    }
+    double bus_s = o_timer_elapsed_s(start);
+
+    start = o_timer();
+    for (int b = 0; b < BLOCKS; b++) {
+        o_clear(bus, sizeof(float), num);
+        for (int v = 0; v < VOICES; v++) {
+            s_mix_add_ramp(bus, voices + v * num, 0.5f, -0.5f / FRAMES, CHANNELS, FRAMES);
+        }
+        s_mix_limit(bus, num);
+        sink += bus[b % num];
+    }
+    double ramp_s = o_timer_elapsed_s(start);
+
+    double block_ms = 1000.0 / BLOCKS;
+    bench_log("%i voices x %i frames: add+clamp per voice: %.3f ms/block, "
+              "s_mix_add + s_mix_limit: %.3f ms/block (%.1fx), s_mix_add_ramp + s_mix_limit: %.3f ms/block",
+              VOICES, FRAMES, clamped_s * block_ms, bus_s * block_ms, clamped_s / bus_s, ramp_s * block_ms);
+
+    o_free(obj, bus);
+    o_free(obj, voices);
+    return 0;
+}
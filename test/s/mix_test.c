@@ -0,0 +1,98 @@
+#include "s/mix.h"
+#include "s/SFilterFade.h"
+
+#define O_LOG_LIB "s"
+#include "o/log.h"
+
+#define LEN 37
+
+O_STATIC
+float signal(osize i)
+{
+    return (float) ((i * 7) % 19) / 9.0f - 1.0f;
+}
+
+// kernels against plain loops, odd lengths and channel counts to hit the scalar tails
+O_STATIC
+void kernels(void)
+{
+    for (int channels = 1; channels <= 3; channels++) {
+        osize num = LEN * channels;
+        float src[LEN * 3], bus[LEN * 3], ref[LEN * 3];
+
+        for (osize i = 0; i < num; i++) {
+            src[i] = signal(i);
+            bus[i] = ref[i] = signal(i + 5);
+        }
+        s_mix_add(bus, src, 0.5f, num);
+        for (osize i = 0; i < num; i++) {
+            ref[i] += src[i] * 0.5f;
+            assert(o_abs(bus[i] - ref[i]) < 0.0001f);
+        }
+
+        s_mix_add_ramp(bus, src, 1.0f, -0.02f, channels, LEN);
+        for (osize i = 0; i < num; i++) {
+            ref[i] += src[i] * (1.0f - 0.02f * (float) (i / channels));
+            assert(o_abs(bus[i] - ref[i]) < 0.0001f);
+        }
+
+        s_mix_gain(bus, 0.25f, num);
+        s_mix_gain_ramp(bus, 0.0f, 0.03f, channels, LEN);
+        for (osize i = 0; i < num; i++) {
+            ref[i] *= 0.25f * 0.03f * (float) (i / channels);
+            assert(o_abs(bus[i] - ref[i]) < 0.0001f);
+        }
+    }
+}
+
+O_STATIC
+void limit(void)
+{
+    float data[LEN];
+    for (int i = 0; i < LEN; i++) {
+        data[i] = (float) (i - LEN / 2) / 4.0f;
+    }
+    s_mix_limit(data, LEN);
+    for (int i = 0; i < LEN; i++) {
+        float x = (float) (i - LEN / 2) / 4.0f;
+        // unchanged below the knee, odd, monotonic and in range
+        if (o_abs(x) <= S_MIX_LIMIT_KNEE) {
+            assert(data[i] == x);
+        }
+        assert(o_abs(data[i] + data[LEN - 1 - i]) < 0.0001f);
+        assert(o_abs(data[i]) < 1.0f);
+        if (i > 0) {
+            assert(data[i] > data[i - 1]);
+        }
+    }
+}
+
+// ramp of SFilterFade against the per tick formula
+O_STATIC
+void fade(oobj obj)
+{
+    oobj filter = SFilterFade_new(obj);
+    SFilterFade_set_ex(filter, 0.2f, 1.0f, 10, 30, false);
+
+    float data[LEN * 2];
+    for (osize time = 0; time < 40; time += 13) {
+        for (int i = 0; i < LEN * 2; i++) {
+            data[i] = 1.0f;
+        }
+        SFilterFade__v_apply(filter, NULL, data, 2, LEN, time);
+        for (int i = 0; i < LEN; i++) {
+            float t = o_clamp((float) (time + i - 10) / 20.0f, 0.0f, 1.0f);
+            float amp = 0.2f + 0.8f * t;
+            assert(o_abs(data[i * 2] - amp) < 0.0001f && o_abs(data[i * 2 + 1] - amp) < 0.0001f);
+        }
+    }
+    o_del(filter);
+}
+
+int s_mix__test(oobj obj)
+{
+    kernels();
+    limit();
+    fade(obj);
+    return 0;
+}
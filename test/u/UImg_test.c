@@ -0,0 +1,58 @@
+#include "u/UImg.h"
+#include "o/OObj.h"
+
+// two pass city block chamfer as reference, saturating at 255
+O_STATIC
+int reference_at(const obyte *src, int cols, int rows, int c, int r)
+{
+    int best = src[r * cols + c];
+    for (int y = -1; y <= rows; y++) {
+        for (int x = -1; x <= cols; x++) {
+            // outside is 0
+            bool outside = x < 0 || y < 0 || x >= cols || y >= rows;
+            int value = outside ? 0 : src[y * cols + x];
+            int dist = o_abs(x - c) + o_abs(y - r);
+            best = o_min(best, value + dist);
+        }
+    }
+    return o_min(best, 255);
+}
+
+O_STATIC
+void distance(oobj obj)
+{
+    enum { COLS = 23, ROWS = 17 };
+    UImg *img = UImg_new(obj, NULL, COLS, ROWS, R_FORMAT_R_8);
+    obyte *data = img->data;
+    for (int i = 0; i < COLS * ROWS; i++) {
+        data[i] = (obyte) ((i * 97) % 7 == 0 ? 0 : 255);
+    }
+    UImg *res = UImg_distance_transform(img, false);
+    const obyte *res_data = res->data;
+    for (int r = 0; r < ROWS; r++) {
+        for (int c = 0; c < COLS; c++) {
+            assert(res_data[r * COLS + c] == reference_at(data, COLS, ROWS, c, r));
+        }
+    }
+    o_del(res);
+    o_del(img);
+
+    // far from the border, the distance saturates instead of wrapping around
+    enum { BIG = 600 };
+    img = UImg_new(obj, NULL, BIG, BIG, R_FORMAT_R_8);
+    data = img->data;
+    for (int i = 0; i < BIG * BIG; i++) {
+        data[i] = 255;
+    }
+    res = UImg_distance_transform(img, false);
+    assert(*(obyte *) UImg_at(res, BIG / 2, BIG / 2) == 255);
+    assert(*(obyte *) UImg_at(res, 0, BIG / 2) == 1);
+    o_del(res);
+    o_del(img);
+}
+
+int UImg__test(oobj obj)
+{
+    distance(obj);
+    return 0;
+}